@@ -0,0 +1,51 @@
+/**
+ * @file BinaryPayloadEncoder.hpp
+ * @brief Fixed-layout little-endian binary payload encoder.
+ *
+ * The most compact format: names, units and metadata are not sent. Each
+ * record carries a schema id instead, an FNV-1a hash of the name-ordered
+ * reading names and units (ReadingLayout::schemaId()), which changes
+ * whenever the layout does. Collectors map schema ids to name lists they
+ * learned out of band, e.g. from the same sensor's JSON payload.
+ *
+ * Record layout (all integers little-endian, no padding):
+ *
+ *   offset  size  field
+ *   0       4     magic "SNR1"
+ *   4       4     u32 record size in bytes, header included
+ *   8       4     u32 schema id
+ *   12      4     u32 reading count N
+ *   16      8     i64 timestamp_ms
+ *   24      1     u8  sensor id length L (ids are cut at 255 bytes)
+ *   25      L     sensor id bytes
+ *   25+L    8*N   f64 values (IEEE 754), in name order, rounded to 2 decimals
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "IPayloadEncoder.hpp"
+#include "ReadingLayout.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class BinaryPayloadEncoder : public IPayloadEncoder {
+public:
+    static constexpr std::string_view kMagic{"SNR1"};
+    static constexpr std::size_t      kHeaderSize = 25;   // up to the sensor id
+
+    explicit BinaryPayloadEncoder(const SensorConfig& config);
+
+    void encode(const Readings& readings, std::int64_t timestampMs, std::string& out) override;
+
+    // Schema id of the last encoded record.
+    [[nodiscard]] std::uint32_t schemaId() const noexcept { return layout_.schemaId(); }
+
+private:
+    std::string   sensorId_;
+    ReadingLayout layout_;
+};
@@ -0,0 +1,170 @@
+/**
+ * @file BoundedRing.hpp
+ * @brief Bounded lock-free ring buffer for single- or multi-producer queues.
+ *
+ * Each slot carries a sequence number (Vyukov's bounded-queue scheme) so
+ * that a pop claims its slot with a CAS on the read index. That makes it
+ * safe for a *producer* to pop as well, which is how a drop-oldest producer
+ * evicts the oldest entry when the ring is full without racing the
+ * consumer. With RingProducers::Multi a push claims its slot with a CAS on
+ * the write index too, so any number of threads may push concurrently;
+ * with RingProducers::Single the one producer just stores it.
+ *
+ *   SpscRing<T>  - pipeline stages, fan-out sinks: one producer thread
+ *   MpscRing<T>  - the async logger: every thread that logs
+ *
+ * tryEmplace() and tryConsume() hand out the slot itself, so large entries
+ * (such as fixed-size log records) are filled and read in place, without a
+ * copy through the caller's stack; tryPush() and tryPop() move whole values.
+ *
+ * Capacity is rounded up to a power of two. No operation blocks or
+ * allocates after construction; waiting is left to the caller.
+ *
+ * @tparam T Element type; must be default-constructible (and
+ *           move-assignable for tryPush()/tryPop()).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+enum class RingProducers { Single, Multi };
+
+template <typename T, RingProducers Producers>
+class BoundedRing {
+public:
+    explicit BoundedRing(std::size_t capacity)
+        : slots_(roundUpToPowerOfTwo(capacity)), mask_(slots_.size() - 1)
+    {
+        for (std::size_t idx = 0; idx < slots_.size(); ++idx) {
+            slots_[idx].seq.store(idx, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedRing(const BoundedRing&) = delete;
+    BoundedRing& operator=(const BoundedRing&) = delete;
+    BoundedRing(BoundedRing&&) = delete;
+    BoundedRing& operator=(BoundedRing&&) = delete;
+    ~BoundedRing() = default;
+
+    // Producer(s). Calls fill(T&) on a claimed slot and publishes it; returns
+    // false (without calling fill) if the ring is full.
+    template <typename Fill>
+    bool tryEmplace(Fill&& fill) {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+
+        if constexpr (Producers == RingProducers::Single) {
+            slot = &slots_[pos & mask_];
+            if (slot->seq.load(std::memory_order_acquire) != pos) {
+                return false;   // slot still holds the entry from one lap ago
+            }
+        } else {
+            for (;;) {
+                slot = &slots_[pos & mask_];
+                const std::size_t seq = slot->seq.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+
+                if (diff == 0) {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;   // slot claimed
+                    }
+                } else if (diff < 0) {
+                    return false;   // slot still holds the entry from one lap ago
+                } else {
+                    pos = tail_.load(std::memory_order_relaxed);   // another producer took it; reload
+                }
+            }
+        }
+
+        std::forward<Fill>(fill)(slot->value);
+        slot->seq.store(pos + 1, std::memory_order_release);
+        if constexpr (Producers == RingProducers::Single) {
+            tail_.store(pos + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Moves from 'value' and returns true if there was room; leaves 'value'
+    // untouched and returns false if the ring is full.
+    bool tryPush(T&& value) {
+        return tryEmplace([&value](T& slot) { slot = std::move(value); });
+    }
+
+    // Consumer (or a producer evicting the oldest entry). Calls consume(T&)
+    // on the oldest published entry and frees its slot; false if empty.
+    template <typename Consume>
+    bool tryConsume(Consume&& consume) {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            const std::size_t seq = slot->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;   // slot claimed
+                }
+            } else if (diff < 0) {
+                return false;   // nothing published at 'pos' yet
+            } else {
+                pos = head_.load(std::memory_order_relaxed);   // lost a race; reload
+            }
+        }
+
+        std::forward<Consume>(consume)(slot->value);
+        slot->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        return tryConsume([&out](T& slot) { out = std::move(slot); });
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return slots_.size(); }
+
+    // Snapshot of the number of queued entries; exact only when all sides are idle.
+    [[nodiscard]] std::size_t sizeApprox() const noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : 0;
+    }
+
+private:
+    // Keep producer- and consumer-side indices on separate cache lines.
+    static constexpr std::size_t kCacheLine = 64;
+
+    struct Slot {
+        std::atomic<std::size_t> seq{0};
+        T                        value{};
+    };
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t requested) {
+        if (requested == 0) {
+            throw std::invalid_argument("BoundedRing: capacity must be > 0");
+        }
+        std::size_t capacity = 2;
+        while (capacity < requested) {
+            capacity <<= 1U;
+        }
+        return capacity;
+    }
+
+    std::vector<Slot> slots_;
+    std::size_t       mask_;
+    alignas(kCacheLine) std::atomic<std::size_t> head_{0};   // next slot to pop
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{0};   // next slot to push
+};
+
+template <typename T>
+using SpscRing = BoundedRing<T, RingProducers::Single>;
+
+template <typename T>
+using MpscRing = BoundedRing<T, RingProducers::Multi>;
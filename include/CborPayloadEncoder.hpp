@@ -0,0 +1,41 @@
+/**
+ * @file CborPayloadEncoder.hpp
+ * @brief CBOR (RFC 8949) payload encoder.
+ *
+ * Encodes the same map as the JSON payload (metadata, readings with unit and
+ * value, sensor_id, timestamp_ms), so a collector decoding CBOR into a JSON
+ * model sees the JSON payload's structure. Reading values are written as
+ * 32-bit floats when that is exact (e.g. 640.0, 0.5) and as 64-bit floats
+ * otherwise; non-finite values become null, like in JSON.
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "IPayloadEncoder.hpp"
+#include "ReadingLayout.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class CborPayloadEncoder : public IPayloadEncoder {
+public:
+    explicit CborPayloadEncoder(const SensorConfig& config);
+
+    void encode(const Readings& readings, std::int64_t timestampMs, std::string& out) override;
+
+    // CBOR primitives.
+    static void appendHead(std::string& out, std::uint8_t majorType, std::uint64_t argument);
+    static void appendText(std::string& out, std::string_view text);
+    static void appendInteger(std::string& out, std::int64_t value);
+    static void appendDouble(std::string& out, double value);
+
+private:
+    static void renderReadingPrefix(std::string& out, const std::string& name, const std::string& unit);
+
+    std::string   metadata_;   // "metadata" key and map, if any
+    std::string   tail_;       // sensor_id pair and the timestamp key
+    ReadingLayout layout_;
+};
@@ -16,4 +16,5 @@ class ConfigLoader {
 public:
     [[nodiscard]] static SensorConfig    loadSensorConfig(const std::string& path);
     static TransportConfig loadTransportConfig(const std::string& path);
+    [[nodiscard]] static DataSourceConfig loadDataSourceConfig(const std::string& path);
 };
@@ -2,23 +2,197 @@
 #pragma once
 
 #include <string>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <unordered_map>
+#include <vector>
+
+// What the run loop does with deadlines it missed because a tick overran.
+enum class OverrunPolicy : std::uint8_t {
+    SKIP,       // drop missed ticks, stay on the original phase grid
+    CATCH_UP    // run missed ticks back-to-back until caught up
+};
+
+// What a pipeline stage does when the queue to the next stage is full.
+enum class QueuePolicy : std::uint8_t {
+    DROP_OLDEST,   // evict the oldest queued entry to make room (freshest data wins)
+    DROP_NEWEST,   // discard the entry being pushed
+    BLOCK          // wait for room (back-pressures the producing stage)
+};
+
+// Severity of a log line; Logger drops anything below its minimum level.
+enum class LogLevel : std::uint8_t {
+    DEBUG,
+    INFO,
+    WARNING,
+    ERROR
+};
+
+// Sub-second digits in log timestamps (see TimestampFormatter).
+enum class TimestampPrecision : std::uint8_t {
+    SECONDS,        // 2024-01-01 00:00:00
+    MILLISECONDS,   // 2024-01-01 00:00:00.000
+    MICROSECONDS    // 2024-01-01 00:00:00.000000
+};
+
+// Wire format of each sample (see IPayloadEncoder).
+enum class PayloadFormat : std::uint8_t {
+    JSON,       // newline-delimited JSON text
+    CBOR,       // RFC 8949, same structure as the JSON object
+    MSGPACK,    // MessagePack, same structure as the JSON object
+    BINARY      // fixed-layout little-endian record (see BinaryPayloadEncoder)
+};
+
+// Send metric names and units once, as a dictionary, and only IDs per sample.
+struct MetricIdConfig {
+    bool          enabled{false};
+    std::uint32_t dictionaryEvery{0};             // also resend every N samples (0 = on connect/change only)
+};
+
+// Pack several samples into one send (one TCP write / UDP datagram).
+struct BatchConfig {
+    bool                      enabled{false};
+    std::size_t               maxSamples{32};     // flush when this many samples are queued
+    std::size_t               maxBytes{0};        // flush before exceeding this (0 = transport limit, else 64 KiB)
+    std::chrono::milliseconds linger{100};        // flush when the oldest sample is this old
+};
+
+struct PipelineQueueConfig {
+    std::size_t depth{64};                        // rounded up to a power of two
+    QueuePolicy policy{QueuePolicy::DROP_OLDEST};
+};
+
+// Optional capture -> encode -> send pipeline (one thread per stage).
+struct PipelineConfig {
+    bool                enabled{false};           // false: read/encode/send inline on one thread
+    PipelineQueueConfig captureQueue;             // capture -> encoder
+    PipelineQueueConfig sendQueue;                // encoder -> sender
+};
+
+// Log filtering and optional asynchronous logging (see Logger::startAsync).
+struct LoggingConfig {
+    LogLevel                  level{LogLevel::INFO};   // lines below this are dropped before they are built
+    TimestampPrecision        timestampPrecision{TimestampPrecision::SECONDS};
+    bool                      timestampUtc{false};      // ISO-8601 UTC ("...T00:00:00.000Z") instead of local time
+    bool                      async{false};       // false: every call formats and writes inline
+    PipelineQueueConfig       queue{4096, QueuePolicy::DROP_NEWEST};   // fixed-size records waiting for the writer
+    std::chrono::milliseconds flushInterval{50};  // writer wakes at least this often
+};
+
+// Optional periodic frame snapshots, written off the sampling path.
+struct SnapshotConfig {
+    bool          enabled{false};
+    std::string   path{"last_frame.jpg"};         // replaced atomically (write temp file, rename)
+    std::string   format{"jpg"};                  // "jpg" | "png" | "bmp"
+    int           jpegQuality{90};                // 1..100, jpg only
+    std::uint32_t everyFrames{0};                 // take one every N frames (0 = off)
+    std::chrono::milliseconds every{0};           // take one every T (0 = off)
+};
+
+// A named rectangle of the frame that gets its own set of image metrics.
+struct RegionOfInterest {
+    std::string name;       // reading prefix, e.g. "door" -> "door_brightness"
+    int x{0};
+    int y{0};
+    int width{0};
+    int height{0};
+};
+
+// How much of each frame the image metrics look at (see FrameStats.hpp for error bounds).
+struct FrameSamplingConfig {
+    int rowStep{1};                               // analyse every Nth row (1 = all)
+    int colStep{1};                               // analyse every Nth pixel of a row (1 = all)
+    std::vector<RegionOfInterest> regions;        // extra per-region metrics
+};
 
 // ---------- Sensor (identity + timing) ----------
 struct SensorConfig {
     std::string sensorId;                         // e.g., "temp-01"
-    int32_t     intervalSeconds{1};               // send cadence
+    std::chrono::microseconds interval{std::chrono::seconds(1)};  // send cadence (1 us .. 24 h)
+    OverrunPolicy overrunPolicy{OverrunPolicy::SKIP};
+    PipelineConfig pipeline;
+    SnapshotConfig snapshot;
+    FrameSamplingConfig sampling;
+    PayloadFormat payloadFormat{PayloadFormat::JSON};
+    MetricIdConfig metricIds;
+    BatchConfig batch;
+    LoggingConfig logging;
     // Optional extras (safe to leave empty):
     std::unordered_map<std::string, std::string> units;     // metric -> unit (e.g., "temperature"->"F")
     std::unordered_map<std::string, std::string> metadata;  // free-form tags (location, model, etc.)
 };
 
 // ---------- Transport (how bytes leave the device) ----------
+
+// TCP socket behaviour (see TcpSocket). Timeouts of 0 mean "wait forever".
+struct TcpOptions {
+    bool                      nonBlocking{false};           // buffer writes instead of blocking in send()
+    std::chrono::milliseconds connectTimeout{5000};
+    std::chrono::milliseconds writeTimeout{5000};           // longest time queued bytes may make no progress
+    std::size_t               sendBufferBytes{1024 * 1024}; // user-space send buffer (non-blocking only)
+    std::size_t               highWaterMark{768 * 1024};    // backpressure on at/above this many buffered bytes
+    std::size_t               lowWaterMark{256 * 1024};     // ... and off again at/below this many
+};
+
+// Unix domain socket to a local collector (see UnixSocket).
+struct UnixOptions {
+    std::string                  path;                       // socket file, or "@name" for the abstract namespace
+    bool                         datagram{false};            // SOCK_DGRAM instead of SOCK_STREAM
+    bool                         sendCredentials{false};     // SCM_CREDENTIALS with the first message after connect
+    std::optional<std::uint32_t> peerUid;                    // stream: refuse a collector running as another user
+    std::chrono::milliseconds    writeTimeout{5000};         // 0 = wait forever
+};
+
+// Shared-memory ring to a collector on the same host (see ShmTransport).
+struct ShmOptions {
+    std::string               name{"/sensor"};              // POSIX shm name: '/' then no other '/'
+    std::size_t               capacityBytes{1024 * 1024};   // ring data size if the sensor creates it
+    std::chrono::milliseconds writeTimeout{1000};           // how long a full ring may block a send (0 = forever)
+};
+
+// Crash-safe on-disk queue for payloads sent while the link is down (see DiskSpool).
+struct SpoolConfig {
+    bool                      enabled{false};
+    std::string               directory{"spool"};
+    std::size_t               segmentBytes{4U * 1024U * 1024U};   // roll to a new segment file past this
+    std::size_t               maxBytes{256U * 1024U * 1024U};     // oldest segments are dropped above this
+    std::chrono::milliseconds maxAge{std::chrono::hours(24)};     // older samples are dropped, not replayed (0 = keep)
+    std::chrono::milliseconds syncInterval{1000};                 // group fsync period (0 = every append)
+};
+
+// Keep a dropped link coming back (see ReconnectingTransport).
+struct ReconnectConfig {
+    bool                      enabled{false};
+    std::chrono::milliseconds initialBackoff{250};      // retry delay ceiling after the first failure
+    std::chrono::milliseconds maxBackoff{30000};        // ... doubling per failure up to this
+    std::uint32_t             maxAttempts{6};           // connect attempts allowed per attemptWindow
+    std::chrono::milliseconds attemptWindow{60000};
+    std::size_t               queueSamples{1024};       // sends held while down (oldest dropped first)
+    std::uint32_t             replayRate{0};            // queued payloads replayed per second (0 = no limit)
+    SpoolConfig               spool;                    // hold them on disk instead of in memory
+};
+
+struct FanoutSinkConfig;
+
 struct TransportConfig {
-    std::string kind;  // e.g., "tcp"
+    std::string kind;  // "tcp" | "udp" | "unix" | "shm" | "fanout"
     std::string host;
     uint16_t     port{0};
+    TcpOptions   tcp;                              // kind == "tcp" only
+    ShmOptions   shm;                              // kind == "shm" only
+    UnixOptions  unixSocket;                       // kind == "unix" only ("unix" is a macro in GNU mode)
+    std::vector<FanoutSinkConfig> sinks;           // kind == "fanout" only
+    ReconnectConfig reconnect;
+    std::optional<PayloadFormat> payloadFormat;   // overrides the sensor's format when set
+};
+
+// One destination of a fan-out transport (see FanoutTransport).
+struct FanoutSinkConfig {
+    std::string         name;                     // label for logs and stats
+    PipelineQueueConfig queue{256, QueuePolicy::DROP_OLDEST};   // BLOCK is not allowed
+    TransportConfig     transport;                // any kind but "fanout"
 };
 
 // ---------- Data generation (what values to produce) ----------
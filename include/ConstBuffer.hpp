@@ -0,0 +1,61 @@
+/**
+ * @file ConstBuffer.hpp
+ * @brief Non-owning view of one piece of an outgoing message.
+ *
+ * A message handed to ITransport::sendBuffers() is a sequence of
+ * ConstBuffers sent back to back, as if they had been concatenated first.
+ * TcpSocket maps the sequence onto writev() and UdpSocket onto a single
+ * sendmsg() (one datagram), so fixed parts of a payload can be sent from
+ * where they live instead of being copied into one string. fillIovecs()
+ * does that mapping for the stream and Unix sockets.
+ */
+
+#pragma once
+
+#include <sys/uio.h>   // iovec
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+struct ConstBuffer {
+    const void* data{nullptr};
+    std::size_t size{0};
+
+    ConstBuffer() = default;
+    ConstBuffer(const void* bytes, std::size_t length) : data(bytes), size(length) {}
+    ConstBuffer(std::string_view text) : data(text.data()), size(text.size()) {}            // NOLINT(google-explicit-constructor)
+    ConstBuffer(const std::string& text) : data(text.data()), size(text.size()) {}          // NOLINT(google-explicit-constructor)
+};
+
+// Sum of the buffer sizes: the length of the message they form.
+inline std::size_t totalSize(const ConstBuffer* buffers, std::size_t count) {
+    std::size_t total = 0;
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        total += buffers[idx].size;
+    }
+    return total;
+}
+
+// iovecs handed to one writev()/sendmsg() call; well below IOV_MAX everywhere
+constexpr std::size_t kMaxIovecs = 64;
+
+using Iovecs = std::array<iovec, kMaxIovecs>;
+
+// Describe buffers[...] minus their first 'skip' bytes as iovecs (empty
+// pieces left out); returns how many of 'iov' were filled.
+inline std::size_t fillIovecs(const ConstBuffer* buffers, std::size_t count, std::size_t skip, Iovecs& iov) {
+    std::size_t used = 0;
+    for (std::size_t idx = 0; idx < count && used < iov.size(); ++idx) {
+        if (skip >= buffers[idx].size) {
+            skip -= buffers[idx].size;
+            continue;
+        }
+        iov[used].iov_base = const_cast<char*>(static_cast<const char*>(buffers[idx].data) + skip);  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+        iov[used].iov_len  = buffers[idx].size - skip;
+        skip = 0;
+        ++used;
+    }
+    return used;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file DiskSpool.hpp
+ * @brief Crash-safe, append-only on-disk queue of payloads (write-ahead log).
+ *
+ * While the collector is unreachable, ReconnectingTransport spools every
+ * payload here instead of holding it in memory, and replays the spool in
+ * order once the link is back. Samples taken during an outage thus survive
+ * both the outage and a crash or restart of the sensor.
+ *
+ * Layout: a directory of segment files "<16-digit sequence>.seg", each a
+ * run of records
+ *
+ *     u32 length | u32 crc32(time + payload) | i64 wall time (ms) | payload
+ *
+ * (little-endian), plus a "cursor" file naming the segment and offset of
+ * the first record not yet replayed. Records are appended with O_APPEND
+ * writes and made durable by a group fsync every SpoolConfig::syncInterval
+ * (0 = after every append); a segment is closed (and synced) once it would
+ * grow past segmentBytes. Fully replayed segments are deleted.
+ *
+ * Recovery scans the segments after the cursor and truncates the first
+ * record that is torn or fails its CRC, and everything after it in that
+ * segment; what was appended but not yet synced when the machine went down
+ * may be lost. Replay is at-least-once: records popped after the last
+ * sync() may be replayed again after a crash.
+ *
+ * Caps: above maxBytes the oldest segments are dropped, and records older
+ * than maxAge are skipped on replay (whole segments at once where
+ * possible). Both are counted in SpoolStats.
+ *
+ * Not thread-safe: use from one thread.
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+
+struct SpoolStats {
+    std::uint64_t appended{0};
+    std::uint64_t replayed{0};           // records handed out by front() and popped
+    std::uint64_t droppedBySize{0};      // records in segments evicted by maxBytes
+    std::uint64_t droppedByAge{0};       // records skipped because they were older than maxAge
+    std::uint64_t recovered{0};          // unreplayed records found when opening the spool
+    std::uint64_t truncatedBytes{0};     // torn or corrupt tail bytes cut off during recovery
+    std::uint64_t syncs{0};
+};
+
+class DiskSpool {
+public:
+    using WallClock = std::chrono::system_clock;
+
+    // Opens (creating the directory if needed) and recovers the spool.
+    // Throws std::invalid_argument on bad limits and std::runtime_error on
+    // I/O errors.
+    explicit DiskSpool(const SpoolConfig& config);
+    ~DiskSpool();
+
+    DiskSpool(const DiskSpool&) = delete;
+    DiskSpool& operator=(const DiskSpool&) = delete;
+    DiskSpool(DiskSpool&&) = delete;
+    DiskSpool& operator=(DiskSpool&&) = delete;
+
+    // Append one record stamped with the current wall time; syncs when the
+    // group sync interval has passed. Throws std::runtime_error on I/O
+    // errors (the partial record is cut off again).
+    void append(std::string_view payload);
+
+    // Copy the oldest unreplayed, unexpired record into 'out'; false if there
+    // is none. Call pop() once it has been delivered.
+    bool front(std::string& out);
+    void pop();
+
+    // True while the record front() returned can still be popped (a size or
+    // age cap may have evicted it since).
+    [[nodiscard]] bool frontHeld() const noexcept { return frontBytes_ != 0; }
+
+    // fsync outstanding appends and persist the replay cursor.
+    void sync();
+
+    // sync() if there are changes and the group sync interval has passed;
+    // owners call this when idle so the last appends do not wait for more.
+    void syncIfDue();
+
+    [[nodiscard]] bool empty() const noexcept { return records() == 0; }
+    [[nodiscard]] std::uint64_t records() const noexcept { return records_; }
+    [[nodiscard]] std::uint64_t bytes() const noexcept { return bytes_; }   // on disk, replayed part included
+    [[nodiscard]] const SpoolStats& stats() const noexcept { return stats_; }
+
+    static constexpr std::size_t kHeaderSize = 16;
+
+private:
+    struct Segment {
+        std::uint64_t seq{0};
+        std::uint64_t bytes{0};       // valid bytes in the file
+        std::uint64_t records{0};     // records in the file
+        std::int64_t  newestMs{0};    // wall time of the newest record
+    };
+
+    void recover();
+    void scanSegment(Segment& segment, std::uint64_t cursorOffset, std::uint64_t& firstUnread,
+                     std::uint64_t& recordsBefore);
+    void openForAppend();
+    void rollSegment();
+    void dropFront(std::uint64_t& droppedCounter);
+    void expireSegments(std::int64_t cutoffMs);
+    void advance(std::uint64_t recordBytes);
+    void persistCursor();
+    [[nodiscard]] std::string segmentPath(std::uint64_t seq) const;
+    [[nodiscard]] std::int64_t cutoffMs() const;
+
+    SpoolConfig         config_;
+    std::deque<Segment> segments_;          // oldest first; back() is the one appended to
+    int                 writeFd_{-1};       // back() segment, O_APPEND
+    int                 readFd_{-1};        // front() segment
+    std::uint64_t       readSeq_{0};        // segment readFd_ belongs to
+    std::uint64_t       nextSeq_{0};        // sequence number of the next new segment
+    std::uint64_t       readOffset_{0};     // in front(): first unreplayed record
+    std::uint64_t       readRecords_{0};    // records of front() already replayed
+    std::uint64_t       frontBytes_{0};     // size of the record front() returned (0 = none)
+    std::uint64_t       records_{0};
+    std::uint64_t       bytes_{0};
+    bool                dirty_{false};      // appends or pops since the last sync()
+    std::chrono::steady_clock::time_point lastSync_{};
+    SpoolStats          stats_;
+};
@@ -0,0 +1,168 @@
+/**
+ * @file FanoutTransport.hpp
+ * @brief ITransport that copies the stream to several child transports.
+ *
+ * One sensor process feeds, say, a primary collector, a hot standby and a
+ * local archiver. Each payload is encoded once; sendString() and
+ * sendBuffers() wrap it in a single shared, immutable string and hand a
+ * reference to every sink, so adding a sink costs a queue slot, not a copy.
+ *
+ * Every sink has its own bounded SpscRing and sender thread:
+ *
+ *   sendString() -> SpscRing -> sender thread -> child transport   (x N)
+ *
+ * so one slow or dead sink never stalls the sensor or the other sinks.
+ * When a sink's queue is full its QueuePolicy drops the oldest or the
+ * newest payload (BLOCK would defeat the purpose and is rejected); a sink
+ * whose child is congested (above its high water mark) drops payloads too.
+ *
+ * Sender threads connect their child on connect() and, after a failed
+ * send, close it and retry once per kRetryInterval; payloads arriving
+ * while a sink is down are lost for that sink and counted as failed. Give
+ * a sink its own "reconnect" block (ReconnectingTransport) to queue and
+ * replay across outages instead. Every payload a sink drops or loses bumps
+ * sessionCount(), so the Sensor resends the metric dictionary with the next
+ * sample in case the lost one carried it. The session preamble is passed
+ * on to every child, each one by its own sender thread before it delivers
+ * the next payload.
+ *
+ * stats() reports per sink what was sent, dropped by the queue and lost to
+ * failures, the current queue depth and the lag (time from sendString()
+ * to the child's send returning) of the last and the slowest payload.
+ *
+ * Send, flush and close from one thread; stats() is safe from any thread.
+ */
+
+#pragma once
+
+#include "BoundedRing.hpp"
+#include "ConfigTypes.hpp"
+#include "ConstBuffer.hpp"
+#include "ITransport.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct FanoutSinkStats {
+    std::string               name;
+    bool                      connected{false};
+    std::uint64_t             sent{0};       // payloads the child transport accepted
+    std::uint64_t             dropped{0};    // evicted or refused by the full queue
+    std::uint64_t             failed{0};     // lost to a failed send or while the sink was down
+    std::size_t               queued{0};     // waiting in the queue right now
+    std::chrono::microseconds lag{0};        // of the last payload sent
+    std::chrono::microseconds maxLag{0};     // worst so far
+};
+
+class FanoutTransport : public ITransport {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // How long a sink that failed waits before connecting again.
+    static constexpr std::chrono::milliseconds kRetryInterval{1000};
+
+    // How long close() lets the sender threads work off their queues.
+    static constexpr std::chrono::milliseconds kCloseDrainTimeout{2000};
+
+    struct Sink {
+        std::string                 name;
+        std::unique_ptr<ITransport> transport;
+        PipelineQueueConfig         queue;
+    };
+
+    // Throws std::invalid_argument without sinks, on a null transport or a
+    // BLOCK queue policy.
+    explicit FanoutTransport(std::vector<Sink> sinks);
+    ~FanoutTransport() override;
+
+    FanoutTransport(const FanoutTransport&) = delete;
+    FanoutTransport& operator=(const FanoutTransport&) = delete;
+    FanoutTransport(FanoutTransport&&) = delete;
+    FanoutTransport& operator=(FanoutTransport&&) = delete;
+
+    // Starts the sender threads, which connect their sinks; never throws for
+    // an unreachable sink (it is logged and retried).
+    void connect() override;
+
+    // Queue the payload for every sink; returns its size even if some
+    // sinks dropped it. Throws only before connect().
+    std::size_t sendString(const std::string& payload) override;
+    std::size_t sendBuffers(const ConstBuffer* buffers, std::size_t count) override;
+
+    // True once every queue is empty and every child has flushed. Returns
+    // at once: the sender threads flush their children while idle.
+    bool flushUntil(Clock::time_point deadline) override;
+
+    // Handed to every child by its sender thread ahead of the next payload.
+    void setSessionPreamble(const std::string& preamble) override;
+
+    // Lets the sender threads hand what is queued to their children (up to
+    // kCloseDrainTimeout; a sink that is down fails its payloads at once),
+    // then stops them and closes the children, which flush what they
+    // buffer. Whatever a stalled sink still has queued then is dropped.
+    void close() override;
+
+    [[nodiscard]] bool isConnected() const override;            // at least one sink up
+    [[nodiscard]] std::uint64_t sessionCount() const override;  // changes when any sink reconnects or loses a payload
+    [[nodiscard]] std::size_t maxMessageSize() const override;  // smallest limit among the sinks
+
+    [[nodiscard]] std::size_t sinkCount() const noexcept { return sinks_.size(); }
+    [[nodiscard]] std::vector<FanoutSinkStats> stats() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const std::string> payload;
+        Clock::time_point                  queuedAt{};
+    };
+
+    struct SinkState {
+        explicit SinkState(Sink&& sink);
+
+        std::string                 name;
+        std::unique_ptr<ITransport> transport;
+        QueuePolicy                 policy;
+        SpscRing<Entry>             queue;
+        std::thread                 thread;
+
+        // sender thread only
+        Clock::time_point           retryAt{};
+        Clock::time_point           nextFlush{};
+        bool                        downReported{false};   // logged once per outage
+        std::uint64_t               preambleVersion{0};    // last preamble handed to the child
+
+        std::atomic<bool>           connected{false};
+        std::atomic<std::size_t>    outstanding{0};     // queued or in hand, not yet delivered
+        std::atomic<bool>           flushPending{false};   // child still holds unflushed bytes
+        std::atomic<std::uint64_t>  connects{0};
+        std::atomic<std::uint64_t>  sent{0};
+        std::atomic<std::uint64_t>  dropped{0};
+        std::atomic<std::uint64_t>  failed{0};
+        std::atomic<std::int64_t>   lagMicros{0};
+        std::atomic<std::int64_t>   maxLagMicros{0};
+    };
+
+    std::size_t publish(std::shared_ptr<const std::string> payload);
+    void push(SinkState& sink, Entry entry);
+    void senderLoop(SinkState& sink);
+    void deliver(SinkState& sink, const Entry& entry);
+    bool tryConnect(SinkState& sink);
+    void linkDown(SinkState& sink, const std::exception& error);
+    void idle(SinkState& sink);
+    void forwardPreamble(SinkState& sink);
+    [[nodiscard]] static bool drained(const SinkState& sink) noexcept;
+
+    std::vector<std::unique_ptr<SinkState>> sinks_;
+    bool                                    open_{false};
+    std::atomic<bool>                       stopping_{false};
+    std::mutex                              preambleMutex_;     // guards preamble_
+    std::shared_ptr<const std::string>      preamble_;
+    std::atomic<std::uint64_t>              preambleVersion_{0};
+};
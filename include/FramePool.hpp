@@ -0,0 +1,97 @@
+/**
+ * @file FramePool.hpp
+ * @brief Fixed set of preallocated, recycled frame buffers.
+ *
+ * Capturing into a fresh cv::Mat allocates (and, for 640x480 BGR, touches)
+ * about 900 KB per sample. The pool allocates its buffers once, sized from
+ * the camera resolution, and hands them out as RAII leases. Camera reads
+ * into a leased buffer of the right size and type reuse its memory (OpenCV's
+ * Mat::create() is a no-op then), so steady-state capture does not allocate.
+ *
+ * If every buffer is leased, acquire() falls back to a one-off buffer rather
+ * than failing; such overflows are counted, as are pooled buffers whose
+ * memory was replaced while leased (e.g. the camera changed resolution).
+ * Both counters staying at zero means capture is allocation free.
+ *
+ * Leases may be released on any thread.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <opencv2/core.hpp>
+
+class FramePool {
+public:
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        [[nodiscard]] cv::Mat& frame() noexcept { return *frame_; }
+        [[nodiscard]] bool pooled() const noexcept { return pool_ != nullptr; }
+
+    private:
+        friend class FramePool;
+        Lease(FramePool* pool, std::size_t index, cv::Mat* frame) noexcept
+            : pool_(pool), index_(index), frame_(frame) {}
+        explicit Lease(cv::Mat overflow) noexcept;
+
+        void release() noexcept;
+
+        FramePool*  pool_{nullptr};   // null for an overflow buffer
+        std::size_t index_{0};
+        cv::Mat*    frame_{nullptr};
+        cv::Mat     overflow_;
+    };
+
+    // 'buffers' buffers of rows x cols x type; rows/cols of 0 defer
+    // allocation to the first capture (see resize()).
+    FramePool(std::size_t buffers, int rows, int cols, int type);
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+    FramePool(FramePool&&) = delete;
+    FramePool& operator=(FramePool&&) = delete;
+    ~FramePool() = default;
+
+    // (Re)allocate the idle buffers for a new geometry. Cheap if unchanged.
+    void resize(int rows, int cols, int type);
+
+    [[nodiscard]] Lease acquire();
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return buffers_.size(); }
+    [[nodiscard]] std::size_t available() const;
+
+    // Leases served by a one-off buffer because the pool was exhausted.
+    [[nodiscard]] std::uint64_t overflows() const noexcept { return overflows_.load(std::memory_order_relaxed); }
+    // Pooled buffers whose memory was replaced while leased.
+    [[nodiscard]] std::uint64_t reallocations() const noexcept {
+        return reallocations_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void giveBack(std::size_t index) noexcept;
+
+    struct Buffer {
+        cv::Mat              frame;
+        const unsigned char* data{nullptr};   // buffer address when handed out
+    };
+
+    mutable std::mutex       mutex_;
+    std::vector<Buffer>      buffers_;
+    std::vector<std::size_t> free_;           // indices of idle buffers (capacity fixed)
+    int rows_{0};
+    int cols_{0};
+    int type_{0};
+
+    std::atomic<std::uint64_t> overflows_{0};
+    std::atomic<std::uint64_t> reallocations_{0};
+};
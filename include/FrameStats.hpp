@@ -0,0 +1,88 @@
+/**
+ * @file FrameStats.hpp
+ * @brief Single-pass per-channel statistics for 8-bit camera frames.
+ *
+ * computeFrameStats() sweeps the frame once and produces, for every
+ * channel, the mean, population variance, minimum and maximum, plus the
+ * frame's mean luma in both BT.601 and BT.709 weighting.
+ *
+ * The kernel walks the interleaved bytes in 48-byte blocks (a multiple of
+ * 1, 2, 3 and 4 channels, so every block starts on channel 0) and keeps
+ * one accumulator per byte position of the block: 16-bit sums, 32-bit sums
+ * of squares and 8-bit min/max in vector registers. The narrow sums are
+ * widened into 64-bit totals every 256 blocks, before they can overflow,
+ * and only at the end are byte positions folded into channels.
+ *
+ * SSE2 and AVX2 versions are selected at run time on x86-64; everywhere
+ * else (and for the ragged end of each row) a scalar loop is used. All
+ * versions give identical results.
+ *
+ * ### Decimation
+ * A FrameSampling with steps (sx, sy) analyses only pixels whose column is a
+ * multiple of sx and whose row is a multiple of sy, cutting the work by
+ * about sx * sy. Row steps skip memory entirely. Column steps still read
+ * each sampled row, but pack it before the vector kernel runs.
+ *
+ * Error bound for the channel means (W x H frame or region): let Lx and Ly
+ * be the largest absolute difference between horizontally and vertically
+ * adjacent pixels of a channel. Then
+ *
+ *   |mean_decimated - mean_full| <= Lx (sx - 1) / 2 + Ly (sy - 1) / 2
+ *                                   + 255 ((sx - 1) / W + (sy - 1) / H)
+ *
+ * Each sampled pixel stands in for an sx x sy block whose pixels are at
+ * most (sx - 1) columns and (sy - 1) rows away; averaged over the block
+ * that is half of it. The last term only applies when W or H is not a
+ * multiple of the step, because the partial last block is then
+ * over-weighted. Luma is a convex mix of the channel means and obeys the
+ * same bound. Sampled min/max are within Lx (sx - 1) + Ly (sy - 1) of the
+ * true ones (never outside them), and variance has no useful worst-case
+ * bound. For content with fine periodic detail aligned to the step (Lx, Ly
+ * large), decimation can alias, so keep steps at 1 where that matters.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <opencv2/core.hpp>
+
+enum class SimdLevel : std::uint8_t {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+struct ChannelStats {
+    double mean{0.0};
+    double variance{0.0};   // population variance
+    double min{0.0};
+    double max{0.0};
+};
+
+// Analyse every rowStep-th row and every colStep-th pixel within it (1 = all).
+struct FrameSampling {
+    int rowStep{1};
+    int colStep{1};
+};
+
+struct FrameStats {
+    int                         channels{0};
+    std::array<ChannelStats, 4> channel{};   // BGR(A) order for colour frames
+    double                      luma601{0.0};   // 0.299 R + 0.587 G + 0.114 B
+    double                      luma709{0.0};   // 0.2126 R + 0.7152 G + 0.0722 B
+};
+
+// Best kernel this CPU supports (detected once).
+[[nodiscard]] SimdLevel detectSimdLevel();
+
+// Statistics of an 8-bit frame with 1 to 4 channels (continuous or not).
+// Throws std::invalid_argument for other frame types or an empty frame.
+[[nodiscard]] FrameStats computeFrameStats(const cv::Mat& frame);
+
+// Same, forcing a kernel; a level the CPU lacks falls back to the best one it has.
+[[nodiscard]] FrameStats computeFrameStats(const cv::Mat& frame, SimdLevel level);
+
+// Decimated statistics (see "Decimation" above). Steps must be >= 1.
+[[nodiscard]] FrameStats computeFrameStats(const cv::Mat& frame, const FrameSampling& sampling);
+[[nodiscard]] FrameStats computeFrameStats(const cv::Mat& frame, const FrameSampling& sampling, SimdLevel level);
@@ -4,18 +4,21 @@
  *
  * The `HardwareDataSource` class provides a concrete implementation of a data source
  * that interfaces directly with hardware sensors using OpenCV. It captures frames from
- * a connected camera, extracts image metadata (such as resolution, channel count, and
- * brightness), and prepares the data for the Sensor subsystem.
+ * a connected camera, extracts image metadata (such as resolution, channel count, luma
+ * brightness and per-channel statistics), and prepares the data for the Sensor subsystem.
  *
- * This class is conditionally compiled when `USE_OPENCV` is enabled and is intended to
- * serve as the real-world counterpart to the `SimulationDataSource` used for development
- * and testing.
+ * This class is the camera-backed implementation of `IDataSource`. The Sensor only sees
+ * the interface, so headless deployments can run on lighter sources instead.
  *
  * ### Responsibilities:
  * - Initialize and manage an OpenCV `cv::VideoCapture` device.
  * - Verify and request camera access authorization (`ensureCameraAuthorized()`).
- * - Read and process video frames for analysis or transmission.
- * - Extract relevant metadata including frame width, height, channels, and mean intensity.
+ * - Read and process video frames for analysis or transmission, capturing into
+ *   recycled FramePool buffers so steady-state sampling does not allocate.
+ * - Extract relevant metadata including frame width, height, channels, and mean intensity,
+ *   optionally decimated and for configured regions of interest ("<name>_brightness", ...).
+ * - Optionally hand frames to a SnapshotWriter, which saves rate-limited snapshots
+ *   on its own thread (never on the sampling path).
  * - Provide the acquired data in a structured format for downstream components.
  *
  * @date Created October 2025
@@ -25,13 +28,22 @@
 
 #pragma once
 
+#include "ConfigTypes.hpp"
+#include "FramePool.hpp"
+#include "FrameStats.hpp"
 #include "ICamera.hpp"
+#include "IDataSource.hpp"
+#include "SnapshotWriter.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <random>
 #include <opencv2/core.hpp>
 
-class HardwareDataSource {
+class HardwareDataSource : public IDataSource {
 
     private:
         // --- Internal helpers ---
@@ -39,14 +51,44 @@ class HardwareDataSource {
         bool grabFrameToJpeg(const std::string& outfile);
         bool grabFrame(cv::Mat& frame);  // internal helper
 
+        // Reading names for one set of image metrics (prefix "" for the whole frame).
+        struct StatsKeys {
+            explicit StatsKeys(const std::string& prefix);
+
+            std::string brightness;
+            std::string luma709;
+            std::array<std::array<std::string, 4>, 4> colour;   // [B, G, R, A][mean, variance, min, max]
+            std::array<std::array<std::string, 4>, 2> grey;     // [gray, alpha][...]
+        };
+
+        struct Region {
+            RegionOfInterest roi;
+            StatsKeys        keys;
+            FrameStats       stats;   // latest result; channels == 0 if the region is off-frame
+        };
+
+        // Writes 'stats' under 'keys'; returns the number of readings written.
+        static std::size_t putStats(Readings& out, const FrameStats& stats, const StatsKeys& keys);
+
         std::shared_ptr<ICamera> camera_;
+        FramePool frames_;                             // recycled capture buffers
+        std::unique_ptr<SnapshotWriter> snapshots_;   // only when snapshots are enabled
+        FrameSampling sampling_;                       // decimation for every metric set
+        StatsKeys frameKeys_;
+        std::vector<Region> regions_;
 
     public:
 
         // --- Construction ---
-        explicit HardwareDataSource(std::shared_ptr<ICamera> camera);
+        explicit HardwareDataSource(std::shared_ptr<ICamera> camera,
+                                    const SnapshotConfig& snapshot = SnapshotConfig{},
+                                    const FrameSamplingConfig& sampling = FrameSamplingConfig{});
+
+        // --- Data Generation (IDataSource) ---
+        Readings readAll() override;
+        void readInto(Readings& out) override;
 
-        // --- Data Generation ---
-        std::unordered_map<std::string, double> readAll();
+        // --- Diagnostics ---
+        [[nodiscard]] const FramePool& framePool() const noexcept { return frames_; }
 
 };
\ No newline at end of file
@@ -0,0 +1,112 @@
+/**
+ * @file IDataSource.hpp
+ * @brief Interface for everything the Sensor can read metric values from.
+ *
+ * A data source produces samples: a set of named metric values taken at one
+ * point in time. Sensor depends only on this interface, so deployments that
+ * do not need a camera (simulated or other non-camera metrics) never touch
+ * the OpenCV capture stack.
+ *
+ * Three read granularities are offered:
+ *  - readAll()   returns one sample as a fresh map (simple, allocates);
+ *  - readInto()  writes one sample into a caller-owned map, letting sources
+ *                overwrite existing entries in place on the per-tick path;
+ *  - readBatch() produces many samples at once in a column-major SampleBatch,
+ *                which sources that can generate values in bulk override.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Metric name -> value for one sample.
+using Readings = std::unordered_map<std::string, double>;
+
+// Make 'out' hold exactly 'values'. Keys already present are overwritten in
+// place, so refilling the same key set every tick does not touch the heap;
+// only a changed key set rebuilds the map.
+inline void assignReadings(Readings& out,
+                           std::initializer_list<std::pair<const char*, double>> values) {
+    for (const auto& [name, value] : values) {
+        out[name] = value;
+    }
+    if (out.size() != values.size()) {
+        out.clear();
+        for (const auto& [name, value] : values) {
+            out[name] = value;
+        }
+    }
+}
+
+// Column-major block of samples: columns[i][row] is metric names[i] in sample 'row'.
+// A metric missing from a sample is stored as NaN.
+struct SampleBatch {
+    std::vector<std::string>         names;
+    std::vector<std::vector<double>> columns;
+    std::size_t                      rows{0};
+
+    // Drop all samples but keep the metric columns and their capacity.
+    void clearRows() noexcept {
+        for (auto& column : columns) {
+            column.clear();
+        }
+        rows = 0;
+    }
+
+    // Column index for 'name', adding a NaN-filled column if it is new.
+    std::size_t columnFor(const std::string& name) {
+        for (std::size_t idx = 0; idx < names.size(); ++idx) {
+            if (names[idx] == name) {
+                return idx;
+            }
+        }
+        names.push_back(name);
+        columns.emplace_back(rows, std::numeric_limits<double>::quiet_NaN());
+        return names.size() - 1;
+    }
+};
+
+class IDataSource {
+public:
+    IDataSource() = default;
+    virtual ~IDataSource() = default;
+
+    IDataSource(const IDataSource&) = delete;
+    IDataSource& operator=(const IDataSource&) = delete;
+    IDataSource(IDataSource&&) = delete;
+    IDataSource& operator=(IDataSource&&) = delete;
+
+    // Take one sample.
+    virtual Readings readAll() = 0;
+
+    // Take one sample into 'out'. On return 'out' holds exactly this sample's
+    // metrics; overrides should overwrite existing keys rather than rebuild.
+    virtual void readInto(Readings& out) { out = readAll(); }
+
+    // Replace the rows of 'batch' with 'count' new samples (metric columns are
+    // kept and extended as needed). Returns the number of samples produced.
+    virtual std::size_t readBatch(SampleBatch& batch, std::size_t count) {
+        batch.clearRows();
+        Readings sample;
+        for (std::size_t row = 0; row < count; ++row) {
+            readInto(sample);
+            for (const auto& [name, value] : sample) {
+                const std::size_t columnIdx = batch.columnFor(name);
+                auto& column = batch.columns[columnIdx];
+                column.resize(row, std::numeric_limits<double>::quiet_NaN());
+                column.push_back(value);
+            }
+            batch.rows = row + 1;
+            for (auto& column : batch.columns) {
+                column.resize(batch.rows, std::numeric_limits<double>::quiet_NaN());
+            }
+        }
+        return batch.rows;
+    }
+};
@@ -0,0 +1,56 @@
+/**
+ * @file IPayloadEncoder.hpp
+ * @brief Interface for turning one sample into the bytes sent to the collector.
+ *
+ * Every encoder carries the same logical record: sensor id, metadata,
+ * timestamp and the readings (value rounded to 2 decimals, plus unit). They
+ * differ only in wire format; see PayloadFormat and PayloadEncoderFactory.
+ *
+ * Each encoded payload is self-delimiting on a byte stream: JSON ends with
+ * a newline, CBOR and MessagePack items carry their own lengths, and binary
+ * records start with their total size.
+ */
+
+#pragma once
+
+#include "ConstBuffer.hpp"
+#include "IDataSource.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class IPayloadEncoder {
+public:
+    IPayloadEncoder() = default;
+    virtual ~IPayloadEncoder() = default;
+
+    IPayloadEncoder(const IPayloadEncoder&) = delete;
+    IPayloadEncoder& operator=(const IPayloadEncoder&) = delete;
+    IPayloadEncoder(IPayloadEncoder&&) = delete;
+    IPayloadEncoder& operator=(IPayloadEncoder&&) = delete;
+
+    // Replace 'out' with the payload for one sample. Implementations reuse
+    // out's capacity, so a long-lived buffer stops allocating.
+    virtual void encode(const Readings& readings, std::int64_t timestampMs, std::string& out) = 0;
+
+    // The same payload as pieces for ITransport::sendBuffers(), so parts the
+    // encoder keeps pre-rendered are sent from where they live instead of
+    // being copied. Pieces point into 'scratch' or into the encoder and stay
+    // valid until the next call. By default: encode() into scratch, one piece.
+    virtual void encodeBuffers(const Readings& readings, std::int64_t timestampMs,
+                               std::string& scratch, std::vector<ConstBuffer>& pieces) {
+        encode(readings, timestampMs, scratch);
+        pieces.assign(1, ConstBuffer(scratch));
+    }
+
+    // The transport (re)connected: forget what the collector was told so far.
+    virtual void resetSession() {}
+
+    // Per-connection state a collector needs before it can decode this
+    // encoder's payloads (the metric dictionary), for the transport to send
+    // ahead of payloads it replays on a new connection. Empty if there is
+    // none; sessionStateVersion() changes whenever the state does.
+    virtual void encodeSessionState(std::string& out) const { out.clear(); }
+    [[nodiscard]] virtual std::uint64_t sessionStateVersion() const { return 0; }
+};
@@ -1,7 +1,10 @@
 // ITransport.hpp
 #pragma once
+#include <chrono>
 #include <string>
 #include <cstddef>
+#include <cstdint>
+#include "ConstBuffer.hpp"
 
 class ITransport {
 public:
@@ -19,9 +22,66 @@ public:
     // blocking, send-all semantics; throws on failure
     virtual std::size_t sendString(const std::string& payload) = 0;
 
+    // same, for one message split over 'count' buffers (scatter-gather);
+    // sockets map this to writev/sendmsg. The fallback joins the pieces and
+    // calls sendString().
+    virtual std::size_t sendBuffers(const ConstBuffer* buffers, std::size_t count) {
+        std::string joined;
+        joined.reserve(totalSize(buffers, count));
+        for (std::size_t idx = 0; idx < count; ++idx) {
+            joined.append(static_cast<const char*>(buffers[idx].data), buffers[idx].size);
+        }
+        return sendString(joined);
+    }
+
+    // many messages at once, each one whole (for datagram transports: one
+    // datagram each). Returns how many were sent, in order; a result below
+    // 'count' means message [result] failed and was not sent. Throws only
+    // when not even the first one could be sent. The fallback sends them one
+    // by one through sendBuffers().
+    virtual std::size_t sendBurst(const ConstBuffer* messages, std::size_t count) {
+        for (std::size_t idx = 0; idx < count; ++idx) {
+            try {
+                sendBuffers(&messages[idx], 1);
+            } catch (...) {
+                if (idx == 0) {
+                    throw;
+                }
+                return idx;
+            }
+        }
+        return count;
+    }
+
+    // a transport that buffers writes (non-blocking TCP) hands queued bytes
+    // to the network, waiting until 'deadline' at most; true when nothing is
+    // left queued. Throws if the link has stalled. Others have nothing to do.
+    virtual bool flushUntil(std::chrono::steady_clock::time_point /*deadline*/) { return true; }
+
+    // bytes to send ahead of payloads a transport replays on a new connection
+    // (queued or spooled while the link was down), so that the collector can
+    // decode them: the encoder's per-connection state, kept current by the
+    // Sensor. Transports that never replay ignore it.
+    virtual void setSessionPreamble(const std::string& /*preamble*/) {}
+
+    // a transport that buffers writes is above its high water mark: the
+    // collector is not keeping up, so producers should shed samples until it
+    // falls back below the low mark. Others never are.
+    [[nodiscard]] virtual bool congested() const { return false; }
+
     // tear down the link; safe to call multiple times
     virtual void close() = 0;
 
     // optional helper for status
     [[nodiscard]] virtual bool isConnected() const = 0;
+
+    // how many times the link has been (re)established, plus anything else
+    // after which the collector may lack per-connection state (a payload
+    // lost on the way); encoders resend that state (metric dictionary) when
+    // it changes. Transports that never reconnect or drop leave it at 0.
+    [[nodiscard]] virtual std::uint64_t sessionCount() const { return 0; }
+
+    // largest payload worth handing to sendString() in one piece (0 = no limit);
+    // used to size batches
+    [[nodiscard]] virtual std::size_t maxMessageSize() const { return 0; }
 };
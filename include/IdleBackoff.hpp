@@ -0,0 +1,42 @@
+/**
+ * @file IdleBackoff.hpp
+ * @brief Escalating yield/sleep wait for worker threads polling a queue.
+ *
+ * Used while a queue is empty (consumer side) or full under
+ * QueuePolicy::BLOCK. Yields a few times first (cheap when the other side
+ * is about to publish), then sleeps with a doubling interval capped at
+ * kMaxSleep, so an idle thread costs next to no CPU but still reacts
+ * within ~0.2 ms.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+class IdleBackoff {
+public:
+    void pause() {
+        if (yields_ < kYields) {
+            ++yields_;
+            std::this_thread::yield();
+            return;
+        }
+        std::this_thread::sleep_for(sleep_);
+        sleep_ = std::min(sleep_ * 2, kMaxSleep);
+    }
+
+    void reset() noexcept {
+        yields_ = 0;
+        sleep_  = kMinSleep;
+    }
+
+private:
+    static constexpr int kYields = 16;
+    static constexpr std::chrono::microseconds kMinSleep{10};
+    static constexpr std::chrono::microseconds kMaxSleep{200};
+
+    int                       yields_{0};
+    std::chrono::microseconds sleep_{kMinSleep};
+};
@@ -0,0 +1,72 @@
+/**
+ * @file JsonPayloadWriter.hpp
+ * @brief Streaming encoder for the Sensor's line-delimited JSON payload.
+ *
+ * The payload used to be built as an nlohmann::json DOM (one node per
+ * reading, a copy of the metadata) and then dumped. JsonPayloadWriter
+ * appends the same text straight into a caller-owned string instead, so a
+ * reused output buffer makes steady-state encoding allocation free.
+ *
+ * The output is what the DOM produced, byte for byte:
+ *  - object keys in std::map order (byte-wise sorted), no whitespace;
+ *  - reading values rounded to 2 decimals, then printed as the shortest
+ *    decimal that round-trips (std::to_chars) in nlohmann's layout: "640.0",
+ *    "9.65", "0.01", "1e+16"; non-finite values become null. (For a small
+ *    fraction of full-precision doubles nlohmann's Grisu2 prints one digit
+ *    more than the shortest form; both parse to the same value, and
+ *    2-decimal readings are unaffected);
+ *  - strings escaped like nlohmann's dump(); input strings are expected to
+ *    be valid UTF-8 (nlohmann would throw on invalid sequences, this writer
+ *    passes them through).
+ *
+ * Everything but the readings and the timestamp is fixed per sensor, so the
+ * head ('{"metadata":{...},') and the '"sensor_id":"...","timestamp_ms":'
+ * tail are rendered once at construction and spliced around the readings;
+ * payload cost no longer grows with the amount of metadata. encodeBuffers()
+ * does not even copy them: head and tail go to the transport as their own
+ * pieces, between the readings and the timestamp.
+ *
+ * Per reading, the '"name":{"unit":"...","value":' part is cached in a
+ * ReadingLayout together with the sorted reading order.
+ *
+ * Not thread-safe: use one writer per encoding thread.
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "IPayloadEncoder.hpp"
+#include "ReadingLayout.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class JsonPayloadWriter : public IPayloadEncoder {
+public:
+    explicit JsonPayloadWriter(const SensorConfig& config);
+
+    // Payload for one sample, newline included.
+    void encode(const Readings& readings, std::int64_t timestampMs, std::string& out) override;
+
+    // Payload as head | readings | tail | timestamp; only readings and
+    // timestamp are written (into scratch).
+    void encodeBuffers(const Readings& readings, std::int64_t timestampMs,
+                       std::string& scratch, std::vector<ConstBuffer>& pieces) override;
+
+    // JSON primitives, formatted exactly like nlohmann::json::dump().
+    static void appendString(std::string& out, std::string_view text);
+    static void appendDouble(std::string& out, double value);
+    static void appendInteger(std::string& out, std::int64_t value);
+
+private:
+    void appendReadings(std::string& out, const Readings& readings);
+    static void appendTimestamp(std::string& out, std::int64_t timestampMs);
+    static void renderReadingPrefix(std::string& out, const std::string& name, const std::string& unit);
+
+    std::string   head_;   // '{' plus the metadata member, if any
+    std::string   tail_;   // sensor_id member and the timestamp key
+    ReadingLayout layout_;
+};
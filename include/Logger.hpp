@@ -7,25 +7,58 @@
  * from different threads do not interleave. Supports optional log file output
  * in addition to standard output.
  *
- * @note All log methods are safe to call from any thread.
+ * By default every call formats and writes its line before returning. After
+ * startAsync(), a call only copies its message into a fixed-size LogRecord
+ * in a lock-free MpscRing; a background writer formats the queued records
+ * and writes them in batches every flushInterval (at once for errors and
+ * when the ring is half full). Memory stays bounded by the ring, and a full
+ * ring follows the configured QueuePolicy: drop the new message, evict the
+ * oldest, or block until the writer catches up. Dropped messages are
+ * counted and reported in the log itself.
+ *
+ * Timestamps come from TimestampFormatter::now() and are rendered by a
+ * cached TimestampFormatter (seconds, milliseconds or microseconds; local
+ * time or ISO-8601 UTC; see setTimestampFormat()).
+ *
+ * Lines below the minimum level (setMinLevel(), "logging.level" in the sensor
+ * config) are dropped by an inline check before any I/O. To skip building
+ * the message as well, use the LOGGER_DEBUG()/LOGGER_INFO()/... macros: the
+ * message expression is only evaluated when its level is enabled, so a
+ * disabled statement costs one load and one branch.
+ *
+ * @note All log methods are safe to call from any thread. startAsync() and
+ * stopAsync() are meant for startup and shutdown.
  */
 
 #pragma once
 
+#include "BoundedRing.hpp"
+#include "ConfigTypes.hpp"
+#include "TimestampFormatter.hpp"
+
 #include <string>
 #include <fstream>
 #include <iostream>
 #include <mutex>
 #include <memory>
-#include <ctime>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
+#include <thread>
+#include <vector>
 
-enum class LogLevel : std::uint8_t {
-    DEBUG,
-    INFO,
-    WARNING,
-    ERROR
+// One queued message in async mode; longer messages are cut at kTextSize bytes.
+struct LogRecord {
+    static constexpr std::size_t kTextSize = 480;
+
+    std::int64_t                 timeNs{0};       // TimestampFormatter::now()
+    std::uint32_t                length{0};
+    LogLevel                     level{LogLevel::INFO};
+    bool                         truncated{false};
+    std::array<char, kTextSize>  text{};
 };
 
 class Logger {
@@ -49,17 +82,17 @@ public:
         file_.open(filename, std::ios::out | std::ios::app);
     }
 
-    void log(LogLevel level, const std::string& message) {
-        const std::lock_guard<std::mutex> lock(mutex_);
-        const std::string timestamp = getTimestamp();
-        const std::string levelStr = levelToString(level);
+    // Thread-safe; may be changed at any time.
+    void setMinLevel(LogLevel level) noexcept { minLevel_.store(level, std::memory_order_relaxed); }
+    [[nodiscard]] LogLevel minLevel() const noexcept { return minLevel_.load(std::memory_order_relaxed); }
+    [[nodiscard]] bool isEnabled(LogLevel level) const noexcept {
+        return level >= minLevel_.load(std::memory_order_relaxed);
+    }
 
-        if (file_.is_open()) {
-            file_ << "[" << timestamp << "] [" << levelStr << "] " << message << '\n';
+    void log(LogLevel level, const std::string& message) {
+        if (isEnabled(level)) {
+            write(level, message);
         }
-
-        // Also print to console
-        std::cout << "[" << timestamp << "] [" << levelStr << "] " << message << '\n';
     }
 
     void debug(const std::string& msg)   { log(LogLevel::DEBUG, msg); }
@@ -67,27 +100,37 @@ public:
     void warning(const std::string& msg) { log(LogLevel::WARNING, msg); }
     void error(const std::string& msg)   { log(LogLevel::ERROR, msg); }
 
-private:
-    Logger() = default;
-    ~Logger() {
-        if (file_.is_open()) {
-            file_.close();
-        }
+    // Thread-safe; applies to lines written from now on (queued ones included).
+    void setTimestampFormat(TimestampPrecision precision, bool utc) {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        timestamps_ = TimestampFormatter(precision, utc);
     }
 
-    static std::string getTimestamp() {
-        constexpr std::size_t kTimestampBufSize = 20; // YYYY-MM-DD HH:MM:SS + '\0'
-        const std::time_t now = std::time(nullptr);
-        std::array<char, kTimestampBufSize> buf{}; // safer than char[20]
+    // Switch to async mode and start the writer thread. Throws
+    // std::invalid_argument on a zero queue depth or flush interval.
+    void startAsync(const LoggingConfig& config);
 
-        const std::tm* local = std::localtime(&now);
-        if (local != nullptr && std::strftime(buf.data(), buf.size(), "%Y-%m-%d %H:%M:%S", local) != 0) {
-            return {buf.data()};
-        }
-        return {"unknown-time"};
-    }
+    // Write everything still queued, stop the writer and log synchronously again.
+    void stopAsync();
+
+    // Write everything queued so far before returning (no-op when synchronous).
+    void flush();
+
+    [[nodiscard]] bool isAsync() const noexcept { return async_.load(std::memory_order_acquire); }
+    [[nodiscard]] std::uint64_t droppedMessages() const noexcept { return dropped_.load(std::memory_order_relaxed); }
 
-    static std::string levelToString(LogLevel level) {
+private:
+    Logger() = default;
+    ~Logger();
+
+    void write(LogLevel level, const std::string& message);
+    bool enqueue(LogLevel level, const std::string& message);
+    void writerLoop();
+    std::size_t drainLocked();
+    void emitLocked(bool flushStreams);
+    void appendLine(std::int64_t timeNs, LogLevel level, const char* text, std::size_t length, bool truncated);
+
+    static const char* levelToString(LogLevel level) {
         switch (level) {
             case LogLevel::DEBUG:   return "DEBUG";
             case LogLevel::INFO:    return "INFO";
@@ -97,6 +140,42 @@ private:
         return "UNKNOWN";
     }
 
+    std::atomic<LogLevel> minLevel_{LogLevel::DEBUG};   // everything until configured
     std::ofstream file_;
-    std::mutex mutex_;
+    std::mutex mutex_;                             // guards the outputs (and batch_, timestamps_)
+    TimestampFormatter timestamps_;
+
+    // ----- async mode -----
+    // A ring is never freed before the Logger: a thread that saw async mode
+    // just before stopAsync() may still push into it. A restart with another
+    // depth adds a ring; older ones are drained first.
+    std::vector<std::unique_ptr<MpscRing<LogRecord>>> rings_;   // guarded by mutex_
+    std::atomic<MpscRing<LogRecord>*> ring_{nullptr};          // the one producers push to
+    std::size_t                ringDepth_{0};                  // depth ring_ was made for
+    std::atomic<bool>          async_{false};
+    QueuePolicy                overflow_{QueuePolicy::DROP_NEWEST};
+    std::chrono::milliseconds  flushInterval_{50};
+    std::thread                writer_;
+    std::mutex                 wakeMutex_;
+    std::condition_variable    wake_;
+    bool                       stopping_{false};   // guarded by wakeMutex_
+    std::atomic<bool>          wakeRequested_{false};   // write now instead of at the next interval
+    std::atomic<std::uint64_t> dropped_{0};
+    std::uint64_t              droppedReported_{0};   // guarded by mutex_
+    std::string                batch_;                // guarded by mutex_
 };
+
+// Log through the singleton, evaluating 'message' only if 'level' is enabled:
+//   LOGGER_DEBUG("Sensor tick, late " + toMicrosString(jitter));
+#define LOGGER_LOG(level, message)                                      \
+    do {                                                                \
+        Logger& loggerInstance_ = Logger::instance();                   \
+        if (loggerInstance_.isEnabled(level)) {                         \
+            loggerInstance_.log(level, message);                        \
+        }                                                               \
+    } while (false)
+
+#define LOGGER_DEBUG(message)   LOGGER_LOG(LogLevel::DEBUG, message)
+#define LOGGER_INFO(message)    LOGGER_LOG(LogLevel::INFO, message)
+#define LOGGER_WARNING(message) LOGGER_LOG(LogLevel::WARNING, message)
+#define LOGGER_ERROR(message)   LOGGER_LOG(LogLevel::ERROR, message)
@@ -0,0 +1,76 @@
+/**
+ * @file MetricIdPayloadEncoder.hpp
+ * @brief Payload encoder that sends metric names once and numeric IDs per sample.
+ *
+ * Instead of repeating every reading's name and unit, samples carry two
+ * parallel arrays: metric IDs (from a MetricRegistry) and values. The names,
+ * units and static metadata travel in a dictionary message, written in front
+ * of a sample whenever the collector may not have the current one:
+ *
+ *  - on the first sample after construction or resetSession(), which the
+ *    Sensor calls for a new connection and after a payload was dropped on
+ *    the way (pipeline queue, fan-out sink), in case it carried the dictionary;
+ *  - when a new metric or unit was registered;
+ *  - every MetricIdConfig::dictionaryEvery samples, if set (for UDP, where
+ *    any single dictionary can be lost).
+ *
+ * Messages use the sensor's JSON, CBOR or MessagePack encoding; a dictionary
+ * and the sample that follows it form one payload (two newline-terminated
+ * lines for JSON, two consecutive items otherwise):
+ *
+ *   {"dictionary":{"metadata":{...},"metrics":[["brightness",0],["frame_width",1]],
+ *                  "units":["intensity","pixels"],"version":4},"sensor_id":"cam-01"}
+ *   {"dictionary_version":4,"ids":[0,1],"sensor_id":"cam-01","timestamp_ms":1700000000123,
+ *    "values":[9.65,640.0]}
+ *
+ * metrics[id] is [name, unit id]; values are rounded to 2 decimals and
+ * non-finite ones are null. The binary format has its own schema id scheme
+ * and is not supported here.
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "IPayloadEncoder.hpp"
+#include "MetricRegistry.hpp"
+#include "ReadingLayout.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class MetricIdPayloadEncoder : public IPayloadEncoder {
+public:
+    // Throws std::invalid_argument for PayloadFormat::BINARY.
+    explicit MetricIdPayloadEncoder(const SensorConfig& config);
+
+    void encode(const Readings& readings, std::int64_t timestampMs, std::string& out) override;
+    void resetSession() override { dictionaryDue_ = true; }
+
+    // The current dictionary as a message of its own; it covers every
+    // sample encoded so far, since IDs are only ever added.
+    void encodeSessionState(std::string& out) const override;
+    [[nodiscard]] std::uint64_t sessionStateVersion() const override { return registry_.version(); }
+
+    [[nodiscard]] const MetricRegistry& registry() const noexcept { return registry_; }
+
+private:
+    void refreshIds();
+    void appendDictionary(std::string& out) const;
+
+    PayloadFormat format_;
+    std::string   sensorId_;
+    std::vector<std::pair<std::string, std::string>> metadata_;   // sorted by key
+    std::uint32_t dictionaryEvery_;
+
+    MetricRegistry registry_;
+    ReadingLayout  layout_;
+    std::uint64_t  layoutGeneration_{0};
+    std::string    ids_;                  // encoded ID array of the current layout
+
+    bool          dictionaryDue_{true};
+    std::uint64_t sentVersion_{0};        // registry version in the last dictionary
+    std::uint64_t samplesSinceDictionary_{0};
+};
@@ -0,0 +1,47 @@
+/**
+ * @file MetricRegistry.hpp
+ * @brief Interned metric names and units with small, stable integer IDs.
+ *
+ * IDs are handed out densely in first-seen order (0, 1, 2, ...) and never
+ * reused or reassigned, so a later dictionary is always a superset of an
+ * earlier one. Units are interned separately, as most metrics share a
+ * handful of them. version() changes whenever something is added, which
+ * tells the encoder that the collector needs a fresh dictionary.
+ *
+ * IDs are stable for the life of the registry (one Sensor), not across
+ * restarts; the dictionary is resent on every connection for that reason.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class MetricRegistry {
+public:
+    struct Metric {
+        std::string   name;
+        std::uint32_t unitId{0};
+    };
+
+    // ID of 'name', registering it (and 'unit') if new. A known metric whose
+    // unit changed keeps its ID and picks up the new unit.
+    std::uint32_t intern(const std::string& name, const std::string& unit);
+
+    // Indexed by ID.
+    [[nodiscard]] const std::vector<Metric>&      metrics() const noexcept { return metrics_; }
+    [[nodiscard]] const std::vector<std::string>& units() const noexcept { return units_; }
+
+    [[nodiscard]] std::uint64_t version() const noexcept { return version_; }
+
+private:
+    std::uint32_t internUnit(const std::string& unit);
+
+    std::vector<Metric>                            metrics_;
+    std::vector<std::string>                       units_;
+    std::unordered_map<std::string, std::uint32_t> metricIds_;
+    std::unordered_map<std::string, std::uint32_t> unitIds_;
+    std::uint64_t                                  version_{0};
+};
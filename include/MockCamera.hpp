@@ -27,15 +27,18 @@ public:
         if (!opened_ || index_ >= frames_.size()){
             return false;
         }
-        frame = frames_[index_++].clone();
+        frames_[index_++].copyTo(frame);   // reuses 'frame' if already sized
         return true;
     }
 
     void release() { opened_ = false; }
 
     double get(cv::VideoCaptureProperties props) {
-        (void)props; // unused
-        return 0.0;
+        switch (props) {
+            case cv::CAP_PROP_FRAME_WIDTH:  return static_cast<double>(kWidth);
+            case cv::CAP_PROP_FRAME_HEIGHT: return static_cast<double>(kHeight);
+            default:                        return 0.0;
+        }
     }
 
     std::string getBackendName() const {
@@ -49,11 +52,14 @@ private:
             // height, width, channels, color (BGR)
             // brightness = 20
             // status = 1
-            cv::Mat frame(480, 640, CV_8UC3, cv::Scalar(i * 20, i * 10, i * 5));
+            cv::Mat frame(kHeight, kWidth, CV_8UC3, cv::Scalar(i * 20, i * 10, i * 5));
             frames_.push_back(frame);
         }
     }
 
+    static constexpr int kWidth = 640;
+    static constexpr int kHeight = 480;
+
     std::vector<cv::Mat> frames_;
     size_t index_ = 0;
     bool opened_ = false;
@@ -0,0 +1,42 @@
+/**
+ * @file MsgPackPayloadEncoder.hpp
+ * @brief MessagePack payload encoder.
+ *
+ * Encodes the same map as the JSON payload (metadata, readings with unit and
+ * value, sensor_id, timestamp_ms) using the smallest MessagePack type for
+ * every item. Reading values are float32 when that is exact and float64
+ * otherwise; non-finite values become nil, like null in JSON.
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "IPayloadEncoder.hpp"
+#include "ReadingLayout.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class MsgPackPayloadEncoder : public IPayloadEncoder {
+public:
+    explicit MsgPackPayloadEncoder(const SensorConfig& config);
+
+    void encode(const Readings& readings, std::int64_t timestampMs, std::string& out) override;
+
+    // MessagePack primitives.
+    static void appendMapHeader(std::string& out, std::size_t entries);
+    static void appendArrayHeader(std::string& out, std::size_t items);
+    static void appendString(std::string& out, std::string_view text);
+    static void appendInteger(std::string& out, std::int64_t value);
+    static void appendDouble(std::string& out, double value);
+
+private:
+    static void renderReadingPrefix(std::string& out, const std::string& name, const std::string& unit);
+
+    std::string   metadata_;   // "metadata" key and map, if any
+    std::string   tail_;       // sensor_id pair and the timestamp key
+    ReadingLayout layout_;
+};
@@ -1,10 +1,19 @@
 // NetworkConstants.hpp
 #pragma once
+#include <cstddef>
 #include <cstdint>
 
 namespace NetworkConstants {
     inline constexpr std::uint16_t kMinPort = 0;
     inline constexpr std::uint16_t kMaxPort = 65535;
+
+    // Largest UDP payload that fits one Ethernet frame without IP
+    // fragmentation: 1500-byte MTU minus the IPv4 (20) and UDP (8) headers.
+    inline constexpr std::size_t kUdpUnfragmentedPayload = 1500 - 20 - 8;
+
+    // Unix datagrams are bounded by the socket send buffer (net.core.wmem_default,
+    // about 208 KiB on Linux) rather than a wire MTU; stay well below it.
+    inline constexpr std::size_t kUnixDatagramPayload = 64 * 1024;
 }
 
 inline bool isValidPortRange(int32_t port) {
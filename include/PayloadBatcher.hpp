@@ -0,0 +1,96 @@
+/**
+ * @file PayloadBatcher.hpp
+ * @brief Packs several encoded samples into one transport send.
+ *
+ * Sending every sample on its own costs one syscall and one TCP segment or
+ * UDP datagram per sample, which dominates at sub-second rates. The batcher
+ * appends payloads to one buffer and hands the whole buffer to the send
+ * callback when
+ *
+ *  - the next payload would push it past the byte limit (size),
+ *  - it holds BatchConfig::maxSamples payloads (count), or
+ *  - its oldest payload is BatchConfig::linger old (linger; the owner polls
+ *    flushIfDue() between samples), or the owner flushes on shutdown.
+ *
+ * Every payload format is self-delimiting (see IPayloadEncoder), so a batch
+ * is simply the payloads back to back: several lines of JSON, or several
+ * CBOR/MessagePack items or binary records, in one message.
+ *
+ * The byte limit is BatchConfig::maxBytes capped by the transport's
+ * maxMessageSize() (one unfragmented datagram for UDP). A payload that is
+ * larger than the limit on its own is sent alone.
+ *
+ * Not thread-safe: feed and flush it from one thread.
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+struct BatchStats {
+    std::uint64_t batches{0};
+    std::uint64_t samples{0};
+    std::uint64_t bytes{0};
+    std::uint64_t flushedBySize{0};
+    std::uint64_t flushedByCount{0};
+    std::uint64_t flushedByLinger{0};   // includes the final flush on shutdown
+    std::uint64_t oversize{0};          // payloads above the byte limit, sent alone
+    std::size_t   maxSamples{0};
+    std::size_t   maxBytes{0};
+
+    // Mean share of the sample and byte capacity each batch used (0..1).
+    [[nodiscard]] double sampleFillRatio() const {
+        return batches == 0 ? 0.0
+                            : static_cast<double>(samples) / (static_cast<double>(batches) * static_cast<double>(maxSamples));
+    }
+    [[nodiscard]] double byteFillRatio() const {
+        return batches == 0 ? 0.0
+                            : static_cast<double>(bytes) / (static_cast<double>(batches) * static_cast<double>(maxBytes));
+    }
+};
+
+class PayloadBatcher {
+public:
+    using Clock  = std::chrono::steady_clock;
+    using SendFn = std::function<void(const std::string&)>;
+
+    // Byte limit used when neither the config nor the transport sets one.
+    static constexpr std::size_t kDefaultMaxBytes = 64 * 1024;
+
+    // 'transportLimit' is ITransport::maxMessageSize() (0 = none).
+    // Throws std::invalid_argument for maxSamples == 0 or linger < 0.
+    PayloadBatcher(const BatchConfig& config, std::size_t transportLimit, SendFn send);
+
+    // Queue one payload, sending the batch first or after as the limits require.
+    void add(const std::string& payload, Clock::time_point now);
+
+    // Send the batch if its oldest payload has lingered long enough.
+    void flushIfDue(Clock::time_point now);
+
+    // Send whatever is queued (e.g. on shutdown).
+    void flush();
+
+    [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+
+    // When the queued batch is due by linger (meaningless while empty()).
+    [[nodiscard]] Clock::time_point deadline() const noexcept { return oldest_ + linger_; }
+
+    [[nodiscard]] std::size_t maxBytes() const noexcept { return stats_.maxBytes; }
+    [[nodiscard]] const BatchStats& stats() const noexcept { return stats_; }
+
+private:
+    void send(std::uint64_t& reason);
+
+    SendFn            send_;
+    Clock::duration   linger_;
+    std::string       buffer_;
+    std::size_t       count_{0};
+    Clock::time_point oldest_{};
+    BatchStats        stats_;
+};
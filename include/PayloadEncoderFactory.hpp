@@ -0,0 +1,12 @@
+// PayloadEncoderFactory.hpp
+#pragma once
+
+#include <memory>
+#include "ConfigTypes.hpp"       // SensorConfig, PayloadFormat
+#include "IPayloadEncoder.hpp"   // interface
+
+struct PayloadEncoderFactory {
+    // Build the encoder for cfg.payloadFormat (in metric-ID mode if
+    // cfg.metricIds.enabled), rendering cfg's static parts once.
+    static std::unique_ptr<IPayloadEncoder> make(const SensorConfig& cfg);
+};
@@ -0,0 +1,70 @@
+/**
+ * @file ReadingLayout.hpp
+ * @brief Cached, name-ordered view of a sample's readings for the encoders.
+ *
+ * Data sources emit the same reading names every tick, so everything that
+ * depends only on the names is worked out once: the sorted order, each
+ * reading's unit and the format-specific bytes that precede its value (for
+ * JSON: '"name":{"unit":"px","value":'). gather() then only looks up the
+ * values; the layout is rebuilt when the set of names changes.
+ *
+ * Values are rounded to 2 decimals, the precision every payload format
+ * carries.
+ */
+
+#pragma once
+
+#include "IDataSource.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class ReadingLayout {
+public:
+    using Units = std::unordered_map<std::string, std::string>;
+
+    // Appends the bytes that precede one reading's value (nullptr: none).
+    using RenderPrefix = void (*)(std::string& out, const std::string& name, const std::string& unit);
+
+    ReadingLayout(Units units, RenderPrefix renderPrefix);
+
+    // Match the layout to 'readings' (rebuilding it if the names changed)
+    // and collect their rounded values in layout order.
+    void gather(const Readings& readings);
+
+    [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
+    [[nodiscard]] const std::string& name(std::size_t idx) const { return entries_[idx].name; }
+    [[nodiscard]] const std::string& unit(std::size_t idx) const { return entries_[idx].unit; }
+    [[nodiscard]] const std::string& prefix(std::size_t idx) const { return entries_[idx].prefix; }
+    [[nodiscard]] double value(std::size_t idx) const { return values_[idx]; }
+
+    // FNV-1a hash of the ordered names and units; changes with the layout.
+    [[nodiscard]] std::uint32_t schemaId() const noexcept { return schemaId_; }
+
+    // Bumped on every rebuild, for callers caching their own per-layout data.
+    [[nodiscard]] std::uint64_t generation() const noexcept { return generation_; }
+
+    // Unit for a reading: the configured one, else a default from its name.
+    [[nodiscard]] static std::string inferUnit(const Units& units, std::string_view readingName);
+
+private:
+    struct Entry {
+        std::string name;
+        std::string unit;
+        std::string prefix;
+    };
+
+    [[nodiscard]] bool collect(const Readings& readings);
+    void rebuild(const Readings& readings);
+
+    Units               units_;
+    RenderPrefix        renderPrefix_;
+    std::vector<Entry>  entries_;    // sorted by name
+    std::vector<double> values_;     // parallel to entries_
+    std::uint32_t       schemaId_{0};
+    std::uint64_t       generation_{0};
+};
@@ -0,0 +1,163 @@
+/**
+ * @file ReconnectingTransport.hpp
+ * @brief ITransport decorator that survives collector restarts.
+ *
+ * Without it, a send to a restarted collector throws, the exception leaves
+ * Sensor::run() and main() shuts the whole process down. The wrapper
+ * catches link failures instead: it closes the inner transport, queues
+ * the payloads sent while the link is down and reconnects in the
+ * background of later sends and flushUntil() calls (so between ticks, too).
+ * Once connected again, the queue is replayed in order before new data.
+ * A send replays at most kReplayBurst queued payloads ahead of its own
+ * (which joins the end of the backlog if one is left), and flushUntil()
+ * keeps replaying until its deadline, so a long backlog drains in the idle
+ * time between ticks instead of stalling the send that found the link up.
+ *
+ * Reconnect attempts are paced so that a fleet of sensors does not hit a
+ * restarted collector all at once:
+ *
+ *  - exponential backoff with full jitter: after the n-th consecutive
+ *    failure the next attempt waits a uniformly random time in
+ *    [0, min(maxBackoff, initialBackoff * 2^n)), which spreads the fleet's
+ *    attempts over the whole interval instead of synchronising them;
+ *  - a hard cap of maxAttempts attempts per attemptWindow, whatever the
+ *    backoff says.
+ *
+ * The queue holds at most queueSamples payloads; when it is full the
+ * oldest are dropped (and counted). With ReconnectConfig::spool enabled
+ * the queue lives in a DiskSpool instead, bounded by its size and age caps,
+ * and survives a restart of the sensor: what was spooled before is
+ * replayed after the first connect. While a backlog remains, new payloads
+ * join its end so that order is kept. replayRate caps the catch-up rate
+ * (token bucket with one second of burst), so that a long outage does not
+ * end in a flood the collector has to absorb on top of the live traffic.
+ * A payload that was being written when
+ * the link broke is queued whole, so a stream collector may see its first
+ * part twice; every payload format is self-delimiting, so it can resync.
+ * A replayed payload leaves the queue (or spool) only once the inner
+ * transport has flushed it: a non-blocking TcpSocket only copies it into
+ * its user-space buffer, which dies with a broken connection or the
+ * process. Until then it stays queued and is replayed again after a link
+ * loss or restart, so replay is at-least-once. Live payloads the inner
+ * transport had accepted are not recovered that way, and neither is what
+ * the kernel held when the link broke.
+ *
+ * Queued payloads were encoded for the old session, so a new session
+ * starts with the session preamble (setSessionPreamble(): the current
+ * metric dictionary, which covers every ID sent so far) before the backlog
+ * is replayed. A spool also gets the preamble written in front of the
+ * first payload of every outage, so that what it holds after a restart
+ * still decodes; records evicted by its caps may take that copy with them.
+ * sessionCount() goes up on every successful (re)connect, which tells the
+ * Sensor to resend per-connection state with the next sample it encodes.
+ *
+ * Not thread-safe, except sessionCount(): send and flush from one thread.
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+#include "ConstBuffer.hpp"
+#include "DiskSpool.hpp"
+#include "ITransport.hpp"
+#include "Xoshiro256.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <string>
+
+struct ReconnectStats {
+    std::uint64_t attempts{0};     // connect attempts, including the first one
+    std::uint64_t connects{0};     // successful ones
+    std::uint64_t linkLosses{0};   // sends/flushes that failed on an established link
+    std::uint64_t queued{0};       // payloads queued while down
+    std::uint64_t replayed{0};     // queued payloads delivered after a reconnect
+    std::uint64_t dropped{0};      // queued payloads evicted because the queue was full
+};
+
+class ReconnectingTransport : public ITransport {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Queued payloads a send replays at most ahead of its own; a flush
+    // replays as many and then more until its deadline. Either stops early
+    // while the inner transport still holds the last one unflushed.
+    static constexpr std::size_t kReplayBurst{32};
+
+    // Throws std::invalid_argument on a null transport or inconsistent config.
+    // Jitter is seeded from std::random_device.
+    ReconnectingTransport(std::unique_ptr<ITransport> inner, const ReconnectConfig& config);
+
+    // Deterministic jitter, for tests.
+    ReconnectingTransport(std::unique_ptr<ITransport> inner, const ReconnectConfig& config, std::uint64_t seed);
+
+    // First connect; a failure is logged and retried later instead of thrown.
+    void connect() override;
+
+    // Never throw for link failures: what cannot be sent now is queued.
+    std::size_t sendString(const std::string& payload) override;
+    std::size_t sendBuffers(const ConstBuffer* buffers, std::size_t count) override;
+
+    // Reconnects if an attempt is due, replays the queue (kReplayBurst
+    // payloads, and more until 'deadline') and flushes the inner transport;
+    // false while anything is still queued.
+    bool flushUntil(Clock::time_point deadline) override;
+
+    // Stops reconnecting; still queued payloads are dropped (a spool keeps
+    // them on disk for the next run).
+    void close() override;
+
+    // Sent first on a new session that has a backlog to replay, and spooled
+    // ahead of each outage's payloads.
+    void setSessionPreamble(const std::string& preamble) override;
+
+    [[nodiscard]] bool isConnected() const override { return up_; }
+    [[nodiscard]] bool congested() const override { return up_ && inner_->congested(); }
+    [[nodiscard]] std::size_t maxMessageSize() const override { return inner_->maxMessageSize(); }
+    [[nodiscard]] std::uint64_t sessionCount() const override { return sessions_.load(std::memory_order_acquire); }
+
+    [[nodiscard]] const ReconnectStats& stats() const noexcept { return stats_; }
+    [[nodiscard]] std::size_t queuedPayloads() const noexcept;
+    [[nodiscard]] const DiskSpool* spool() const noexcept { return spool_.get(); }   // null unless enabled
+    [[nodiscard]] Clock::time_point nextAttempt() const noexcept { return nextAttempt_; }
+
+    // Jittered delay before the retry that follows 'failures' consecutive
+    // failed attempts (0 = the link just dropped).
+    std::chrono::milliseconds backoff(std::uint32_t failures);
+
+private:
+    bool ensureConnected(Clock::time_point now, Clock::time_point replayUntil);
+    void attemptConnect(Clock::time_point now);
+    bool replay(Clock::time_point until);
+    void popReplayed();
+    bool replayTokenAvailable(Clock::time_point now);
+    [[nodiscard]] bool hasQueued() const noexcept;
+    void linkDown(const std::exception& error, Clock::time_point now);
+    void queue(std::string payload);
+
+    std::unique_ptr<ITransport> inner_;
+    ReconnectConfig             config_;
+    Xoshiro256                  rng_;
+
+    bool                          open_{false};     // between connect() and close()
+    bool                          up_{false};       // inner transport connected
+    std::uint32_t                 failures_{0};     // consecutive failed attempts
+    Clock::time_point             nextAttempt_{};
+    std::deque<Clock::time_point> recentAttempts_;  // within the last attemptWindow
+    std::deque<std::string>       queue_;
+    std::unique_ptr<DiskSpool>    spool_;           // replaces queue_ when configured
+    std::string                   replayBuffer_;    // record read back from spool_
+    bool                          replayInFlight_{false};   // queue front handed over, not flushed yet
+    std::string                   preamble_;        // see setSessionPreamble()
+    bool                          preambleDue_{false};      // new session, preamble not sent yet
+    bool                          preambleSpooled_{false};  // current preamble is in the spool for this outage
+    double                        replayTokens_{0.0};
+    Clock::time_point             tokensRefilled_{};
+    std::atomic<std::uint64_t>    sessions_{0};
+    ReconnectStats                stats_;
+};
@@ -11,25 +11,34 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
+#include <vector>
 #include <cstdint>
-#include "HardwareDataSource.hpp"
+#include "IDataSource.hpp"
 #include "ITransport.hpp"
-#include "TcpSocket.hpp"
 #include "ConfigTypes.hpp"
+#include "ConstBuffer.hpp"
+#include "IPayloadEncoder.hpp"
+#include "TickScheduler.hpp"
+#include "PayloadBatcher.hpp"
+#include "SensorPipeline.hpp"
 #include <atomic>
+#include <mutex>
 #include <thread>
 
-// Sensor: reads values from an IDataGenerator at a fixed interval
-// and sends them (as JSON text) to a collector via TcpClient.
+// Sensor: reads values from an IDataSource at a fixed interval
+// and sends them (JSON text by default, see PayloadFormat) to a collector via an ITransport.
 class Sensor {
 public:
     // Construct with path to sensor_config.json and a data generator
-    Sensor(const SensorConfig& config, std::unique_ptr<HardwareDataSource> dataSource, std::unique_ptr<ITransport> transport);
+    Sensor(const SensorConfig& config, std::unique_ptr<IDataSource> dataSource, std::unique_ptr<ITransport> transport);
 
-    // Load config, create TcpClient (but don't connect yet)
-    void loadConfig();
+    // Apply a new sensor id, metadata, units and payload format; the payload
+    // prefix is re-rendered once here. Interval and pipeline settings need a restart.
+    // Not while run() is active.
+    void reloadConfig(const SensorConfig& config);
 
     // Open TCP connection to collector (blocking)
     void connect();
@@ -37,25 +46,62 @@ public:
     // Do one cycle: read→serialize→send
     void runOnce();
 
-    // Primary loop: repeatedly call runOnce() every intervalSeconds
-    // Stops when 'running' is set to false by another thread (Main in this case).
+    // Primary loop: call runOnce() on a fixed deadline grid every config interval
+    // (see TickScheduler), or hand capture/encode/send to a SensorPipeline when
+    // config.pipeline.enabled is set. Samples due while the transport is
+    // congested are shed rather than queued behind a slow collector. Stops
+    // when 'running' is set to false by another thread (Main in this case).
     void run(std::atomic<bool>& running);
 
+    // Per-stage pipeline counters (all zero when the pipeline is disabled).
+    [[nodiscard]] PipelineStats pipelineStats() const;
+
+    // Batch counters and fill ratio (all zero when batching is disabled);
+    // read once run() has returned.
+    [[nodiscard]] BatchStats batchStats() const;
+
+    // Samples dropped because the transport was congested (above its high
+    // water mark) when they were due.
+    [[nodiscard]] std::uint64_t shedSamples() const noexcept { return shed_.load(std::memory_order_relaxed); }
+
+    // Jitter/overrun counters of the last run(); read once run() has returned.
+    [[nodiscard]] const TickStats& tickStats() const noexcept { return scheduler_.stats(); }
+
     // Close TCP connection (safe to call multiple times)
     void close() noexcept;
 
 private:
     // Helpers (implementation detail)
-    [[nodiscard]] std::string buildJsonPayload(const std::unordered_map<std::string, double>& readingsMap) const;
+    void runInline(std::atomic<bool>& running);
+    void send(const std::string& payload);
+    void buildPayload(const Readings& readingsMap, std::int64_t timestampMs, std::string& out);
+    void syncEncoderSession();
+    void captureSessionState();
+    void applySessionState();
 
     // Config-derived state
     SensorConfig config_;
-    std::string configPath_;
     std::string sensorId_;
-    int32_t     intervalSeconds_ = 1;   // default to collect data every 1 second
+    std::chrono::microseconds interval_{std::chrono::seconds(1)};   // default to collect data every 1 second
 
     // Dependencies / runtime state
-    std::unique_ptr<HardwareDataSource> dataSource_;
+    std::unique_ptr<IDataSource> dataSource_;
     std::unique_ptr<ITransport>  transport_;
-    bool         loaded_ = false;
+    std::unique_ptr<IPayloadEncoder> encoder_;   // encode thread only when pipelined
+    std::uint64_t encoderSession_{0};            // transport session (plus pipeline drops) the encoder state belongs to
+    Readings     readings_;                      // reused by runOnce()
+    std::string  payload_;                       // reused by runOnce()
+    std::vector<ConstBuffer> pieces_;            // reused by runOnce(): payload_ plus encoder-owned parts
+    TickScheduler scheduler_;
+    std::unique_ptr<PayloadBatcher> batcher_;    // only when config.batch.enabled
+    std::unique_ptr<SensorPipeline> pipeline_;   // only when config.pipeline.enabled
+    std::atomic<std::uint64_t> shed_{0};         // samples dropped under backpressure
+
+    // Encoder session state handed to the transport as its session preamble:
+    // captured on the encode thread, applied on the send thread.
+    bool          stateCaptured_{false};         // encode thread: stateVersion_ is valid
+    std::uint64_t stateVersion_{0};              // encode thread: version in sessionState_
+    std::mutex    stateMutex_;                   // guards sessionState_
+    std::string   sessionState_;
+    std::atomic<bool> stateChanged_{false};      // sessionState_ not applied to the transport yet
 };
@@ -0,0 +1,131 @@
+/**
+ * @file SensorPipeline.hpp
+ * @brief Three-stage capture -> encode -> send pipeline with bounded queues.
+ *
+ * Running capture, payload encoding and the (blocking) transport send back to
+ * back on one thread lets a slow collector stall frame capture. The pipeline
+ * gives each stage its own thread and connects them with bounded lock-free
+ * rings:
+ *
+ *   capture (caller's thread, paced by TickScheduler)
+ *     -> SpscRing<Sample>      -> encoder thread
+ *     -> SpscRing<std::string> -> sender thread
+ *
+ * A full ring is handled per its QueuePolicy (drop oldest, drop newest or
+ * block), so with a dropping policy a slow network never lowers the capture
+ * rate. Every stage counts the items it processed, the items dropped at its
+ * output queue and the time it spent working, so each stage's throughput can
+ * be measured on its own.
+ *
+ * The stages themselves are plain callables supplied by the owner (Sensor).
+ */
+
+#pragma once
+
+#include "BoundedRing.hpp"
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "TickScheduler.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <string>
+
+// One captured sample travelling from the capture to the encode stage.
+struct Sample {
+    std::int64_t timestampMs{0};   // capture time, ms since epoch
+    Readings     readings;
+};
+
+// Counters of one stage since the pipeline started.
+struct StageStats {
+    std::uint64_t processed{0};                 // items the stage finished
+    std::uint64_t dropped{0};                   // items lost at the stage's output queue
+    std::chrono::nanoseconds busy{0};           // time spent inside the stage callable
+
+    // Throughput the stage could sustain on its own (items per busy second).
+    [[nodiscard]] double itemsPerBusySecond() const {
+        const auto seconds = std::chrono::duration<double>(busy).count();
+        return seconds > 0.0 ? static_cast<double>(processed) / seconds : 0.0;
+    }
+};
+
+struct PipelineStats {
+    StageStats capture;
+    StageStats encode;
+    StageStats send;
+};
+
+class SensorPipeline {
+public:
+    using CaptureFn = std::function<void(Sample&)>;
+    using EncodeFn  = std::function<void(const Sample&, std::string&)>;
+    using SendFn    = std::function<void(const std::string&)>;
+    using IdleFn    = std::function<void()>;
+
+    // 'encode' must replace the payload string's contents: it is handed an
+    // earlier payload's buffer for reuse. 'idle' (optional) runs on the
+    // sender thread whenever its queue is empty, e.g. to flush a lingering
+    // batch.
+    SensorPipeline(const PipelineConfig& config, CaptureFn capture, EncodeFn encode, SendFn send,
+                   IdleFn idle = {});
+
+    SensorPipeline(const SensorPipeline&) = delete;
+    SensorPipeline& operator=(const SensorPipeline&) = delete;
+    SensorPipeline(SensorPipeline&&) = delete;
+    SensorPipeline& operator=(SensorPipeline&&) = delete;
+    ~SensorPipeline() = default;
+
+    // Capture on the calling thread at the scheduler's cadence until 'running'
+    // is false, with encode and send on worker threads. Queued items are drained
+    // before returning. An exception thrown by any stage stops the pipeline and
+    // is rethrown here.
+    void run(std::atomic<bool>& running, TickScheduler& scheduler);
+
+    // Snapshot of the per-stage counters; safe to call from any thread.
+    [[nodiscard]] PipelineStats stats() const;
+
+    // Encoded payloads dropped before the send stage got them; cheap enough
+    // to check on every encode.
+    [[nodiscard]] std::uint64_t payloadsDropped() const noexcept {
+        return encodeCounters_.dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct StageCounters {
+        std::atomic<std::uint64_t> processed{0};
+        std::atomic<std::uint64_t> dropped{0};
+        std::atomic<std::int64_t>  busyNanos{0};
+
+        void addBusy(std::chrono::steady_clock::duration elapsed);
+        [[nodiscard]] StageStats snapshot() const;
+    };
+
+    template <typename T>
+    bool push(SpscRing<T>& ring, QueuePolicy policy, T& item, StageCounters& counters);
+
+    void encodeLoop();
+    void sendLoop();
+    void fail(std::exception_ptr error) noexcept;
+
+    PipelineConfig config_;
+    CaptureFn      capture_;
+    EncodeFn       encode_;
+    SendFn         send_;
+    IdleFn         idle_;
+
+    SpscRing<Sample>      captureQueue_;
+    SpscRing<std::string> sendQueue_;
+
+    StageCounters captureCounters_;
+    StageCounters encodeCounters_;
+    StageCounters sendCounters_;
+
+    std::atomic<bool>  captureDone_{false};    // no more samples will be pushed
+    std::atomic<bool>  encodeDone_{false};     // no more payloads will be pushed
+    std::atomic<bool>  failed_{false};         // a stage threw; everyone stops
+    std::exception_ptr error_;                 // first stage exception (guarded by failed_)
+};
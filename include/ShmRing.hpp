@@ -0,0 +1,185 @@
+/**
+ * @file ShmRing.hpp
+ * @brief Single-producer/single-consumer message ring in POSIX shared memory.
+ *
+ * Lets a collector on the same host take payloads without going through the
+ * loopback TCP stack: the sensor (ShmTransport) writes length-prefixed
+ * messages into a byte ring in a shm_open() segment and the collector reads
+ * them straight out of the mapping. The class implements both ends; the
+ * consumer half (tryConsume / tryRead / readUntil) is the reference reader
+ * for collectors.
+ *
+ * Layout: a ShmRingHeader followed by 'capacity' data bytes (a power of
+ * two). A message is stored as
+ *
+ *     u32 length | payload | padding to 8 bytes
+ *
+ * (host byte order: both ends run on the same machine). A message that
+ * would straddle the end of the data area is preceded by a wrap marker and
+ * starts at offset 0 instead, so every payload is contiguous and can be
+ * handed out in place. writePos and readPos are free-running byte counters,
+ * each on its own cache line.
+ *
+ * Waiting: a side that has nothing to do (reader: ring empty; writer: ring
+ * full) raises its "waiting" flag and sleeps on a futex in the segment
+ * (Linux; elsewhere it polls every 100 µs). The other side only makes the
+ * wake-up syscall when it sees that flag, so a ring that keeps both sides
+ * busy costs no syscalls at all.
+ *
+ * Exactly one writer and one reader at a time, in any processes. Either may
+ * restart: the positions live in the segment, so a new reader resumes after
+ * what the old one consumed and a new writer appends after what the old one
+ * published.
+ */
+
+#pragma once
+
+#include "ConstBuffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Shared between processes: only lock-free atomics of fixed size in here.
+struct ShmRingHeader {
+    static constexpr std::uint32_t kMagic   = 0x53524E47;   // "SRNG"
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::size_t   kCacheLine = 64;
+
+    std::atomic<std::uint32_t> magic{0};             // set last by the creator
+    std::uint32_t              version{0};
+    std::uint64_t              capacity{0};          // data bytes after the header
+
+    alignas(kCacheLine) std::atomic<std::uint64_t> writePos{0};   // bytes published
+    std::atomic<std::uint32_t> writeSeq{0};          // futex word the reader sleeps on
+    std::atomic<std::uint32_t> readerWaiting{0};
+
+    alignas(kCacheLine) std::atomic<std::uint64_t> readPos{0};    // bytes released
+    std::atomic<std::uint32_t> readSeq{0};           // futex word the writer sleeps on
+    std::atomic<std::uint32_t> writerWaiting{0};
+};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free && sizeof(std::atomic<std::uint32_t>) == 4,
+              "ShmRing needs address-free 32-bit atomics");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "ShmRing needs address-free 64-bit atomics");
+
+class ShmRing {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t   kMinCapacity = 4096;
+    static constexpr std::size_t   kLengthSize  = sizeof(std::uint32_t);
+    static constexpr std::uint32_t kWrapMarker  = 0xFFFFFFFFU;
+
+    // Maps the segment 'name' ("/sensor": a leading slash and no other),
+    // creating it with 'capacity' data bytes (rounded up to a power of two,
+    // at least kMinCapacity) if it does not exist yet; an existing segment
+    // keeps its own capacity. Throws std::invalid_argument on a bad name and
+    // std::runtime_error on system errors or a foreign segment.
+    ShmRing(const std::string& name, std::size_t capacity);
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+    ShmRing(ShmRing&&) = delete;
+    ShmRing& operator=(ShmRing&&) = delete;
+
+    // ----- producer -----
+
+    // Appends one message made of 'count' pieces, waiting until 'deadline'
+    // for room; false if the ring stayed full. Throws std::invalid_argument
+    // for a message longer than maxMessageSize().
+    bool write(const ConstBuffer* pieces, std::size_t count, Clock::time_point deadline);
+
+    // ----- consumer -----
+
+    // Calls fn(std::string_view) with the oldest message, in place in the
+    // mapping, and releases it when fn returns; false if the ring is empty.
+    template <typename Fn>
+    bool tryConsume(Fn&& fn);
+
+    // Copying variants of tryConsume(); readUntil() waits for a message
+    // until 'deadline' (Clock::time_point::max() = forever).
+    bool tryRead(std::string& out);
+    bool readUntil(std::string& out, Clock::time_point deadline);
+
+    // True once a message is available, false if 'deadline' passed first.
+    bool waitReadable(Clock::time_point deadline);
+
+    // ----- both -----
+
+    [[nodiscard]] const std::string& name() const noexcept { return name_; }
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+    [[nodiscard]] bool created() const noexcept { return created_; }   // this mapping initialised the segment
+
+    // Largest payload write() accepts: half the ring, so a message always
+    // fits even after a wrap marker.
+    [[nodiscard]] std::size_t maxMessageSize() const noexcept { return capacity_ / 2 - kLengthSize; }
+
+    // Bytes published but not yet released (snapshot).
+    [[nodiscard]] std::size_t bytesUsed() const noexcept {
+        return static_cast<std::size_t>(header_->writePos.load(std::memory_order_acquire) -
+                                        header_->readPos.load(std::memory_order_acquire));
+    }
+
+    // Removes the name; existing mappings stay valid until closed.
+    static void unlink(const std::string& name);
+
+    // Data bytes of a ring created for 'requested' bytes.
+    static std::size_t capacityFor(std::size_t requested) noexcept {
+        std::size_t capacity = kMinCapacity;
+        while (capacity < requested) {
+            capacity <<= 1U;
+        }
+        return capacity;
+    }
+
+    // Ring bytes a message of 'length' payload bytes takes.
+    static constexpr std::uint64_t recordSize(std::uint64_t length) {
+        return (kLengthSize + length + 7U) & ~std::uint64_t{7U};
+    }
+
+private:
+    void attach(int fd);
+    void initialise(int fd, std::size_t capacity);
+    bool waitForRoom(std::uint64_t pos, std::uint64_t bytes, Clock::time_point deadline);
+    void release(std::uint64_t newReadPos);
+
+    std::string    name_;
+    void*          mapping_{nullptr};
+    std::size_t    mappingSize_{0};
+    ShmRingHeader* header_{nullptr};
+    unsigned char* data_{nullptr};
+    std::size_t    capacity_{0};
+    std::uint64_t  mask_{0};
+    bool           created_{false};
+};
+
+template <typename Fn>
+bool ShmRing::tryConsume(Fn&& fn) {
+    std::uint64_t pos = header_->readPos.load(std::memory_order_relaxed);
+    for (;;) {
+        if (pos == header_->writePos.load(std::memory_order_acquire)) {
+            return false;
+        }
+        const std::uint64_t idx = pos & mask_;
+        std::uint32_t length = 0;
+        std::memcpy(&length, data_ + idx, kLengthSize);
+        if (length == kWrapMarker) {
+            pos += capacity_ - idx;
+            release(pos);
+            continue;
+        }
+        if (length > maxMessageSize()) {
+            throw std::runtime_error("ShmRing: corrupt message length in '" + name_ + "'");
+        }
+        fn(std::string_view(reinterpret_cast<const char*>(data_ + idx + kLengthSize), length));   // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        release(pos + recordSize(length));
+        return true;
+    }
+}
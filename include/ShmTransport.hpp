@@ -0,0 +1,44 @@
+/**
+ * @file ShmTransport.hpp
+ * @brief Transport to a collector on the same host through a shared-memory ring.
+ *
+ * Each payload becomes one message in a ShmRing: no socket, no loopback
+ * TCP stack and, while the collector keeps up, no syscall per send. The
+ * sensor creates the segment on connect() if the collector has not already
+ * done so, and leaves it in place on close() so that the collector can
+ * drain it and a restarted sensor can carry on.
+ *
+ * A full ring blocks a send for up to ShmOptions::writeTimeout and then
+ * throws, like a stalled TCP link would; wrap the transport in a
+ * ReconnectingTransport to queue instead.
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+#include "ConstBuffer.hpp"
+#include "ITransport.hpp"
+#include "ShmRing.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+class ShmTransport : public ITransport {
+public:
+    explicit ShmTransport(ShmOptions options) : options_(std::move(options)) {}
+
+    void connect() override;
+    std::size_t sendString(const std::string& payload) override;
+    std::size_t sendBuffers(const ConstBuffer* buffers, std::size_t count) override;
+    void close() override { ring_.reset(); }
+    [[nodiscard]] bool isConnected() const override { return ring_ != nullptr; }
+    [[nodiscard]] std::size_t maxMessageSize() const override;
+
+    [[nodiscard]] const ShmRing* ring() const noexcept { return ring_.get(); }
+
+private:
+    ShmOptions               options_;
+    std::unique_ptr<ShmRing> ring_;
+};
@@ -0,0 +1,60 @@
+/**
+ * @file SimulationDataSource.hpp
+ * @brief Camera-free data source that generates metric values from MetricRules.
+ *
+ * Each metric in the DataSourceConfig is either a fixed value or drawn
+ * uniformly from [min, max). With probability badProbability a ranged
+ * metric instead emits an outlier that lies outside [min, max], so
+ * collectors can be exercised with bad data as well.
+ *
+ * The source is meant for load-testing collectors without a camera:
+ * readBatch() fills one column per metric in bulk with a multi-lane
+ * xoshiro256+ generator, and places outliers by drawing the geometric gap
+ * to the next one instead of testing every sample. That keeps generation
+ * in the hundreds of millions of values per second on one core.
+ *
+ * Metrics are kept sorted by name, so batch columns come out in a stable
+ * order and a given seed always produces the same values.
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "Xoshiro256.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class SimulationDataSource : public IDataSource {
+public:
+    // Seeded from std::random_device.
+    explicit SimulationDataSource(const DataSourceConfig& config);
+
+    // Deterministic: the same config and seed produce the same values.
+    SimulationDataSource(const DataSourceConfig& config, std::uint64_t seed);
+
+    // --- Data Generation (IDataSource) ---
+    Readings readAll() override;
+    void readInto(Readings& out) override;
+
+    // Fills one column per metric (sorted by name). If 'batch' was laid out
+    // for different metrics, its columns are replaced.
+    std::size_t readBatch(SampleBatch& batch, std::size_t count) override;
+
+private:
+    struct Metric {
+        std::string name;
+        MetricRule  rule;
+    };
+
+    [[nodiscard]] double sample(const MetricRule& rule);
+    [[nodiscard]] double outlier(const MetricRule& rule);
+    [[nodiscard]] std::size_t samplesUntilOutlier(double badProbability);
+    void fillColumn(const MetricRule& rule, std::vector<double>& column, std::size_t count);
+
+    std::vector<Metric> metrics_;   // sorted by name
+    Xoshiro256          rng_;
+};
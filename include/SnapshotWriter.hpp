@@ -0,0 +1,92 @@
+/**
+ * @file SnapshotWriter.hpp
+ * @brief Rate-limited, asynchronous frame snapshots to disk.
+ *
+ * Encoding a frame to JPEG and writing it out costs far more than extracting
+ * metrics from it, so it must not happen on the sampling path. The capture
+ * thread calls offer() for every frame; offer() only checks the rate limit
+ * and, when a snapshot is due, copies the frame into a single-slot mailbox
+ * (reusing its buffer). A background thread encodes the frame, writes and
+ * fsyncs "<path>.tmp" and only then renames it over <path>, so readers never
+ * see a partial file and a full disk or a crash keeps the last good one.
+ *
+ * If the previous snapshot is still being encoded when the next one is due,
+ * the new one is skipped rather than queued: snapshots are a debugging aid,
+ * not a data stream.
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/core.hpp>
+
+struct SnapshotStats {
+    std::uint64_t written{0};       // snapshots on disk
+    std::uint64_t failed{0};        // encode or write errors
+    std::uint64_t skippedBusy{0};   // due, but the previous one was still being written
+};
+
+class SnapshotWriter {
+public:
+    // Throws std::invalid_argument for an unknown format, an empty path or
+    // a config without any rate limit.
+    explicit SnapshotWriter(SnapshotConfig config);
+
+    // Finishes a snapshot that is already queued, then stops the thread.
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+    SnapshotWriter(SnapshotWriter&&) = delete;
+    SnapshotWriter& operator=(SnapshotWriter&&) = delete;
+
+    // Capture thread only. Returns true if 'frame' was queued for writing.
+    bool offer(const cv::Mat& frame);
+
+    [[nodiscard]] SnapshotStats stats() const;
+
+    // File extension (with dot) OpenCV encodes for 'format', or "" if unsupported.
+    [[nodiscard]] static std::string extensionFor(const std::string& format);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    [[nodiscard]] bool due(Clock::time_point now) const;
+    void writerLoop();
+    bool writeFrame(const cv::Mat& frame);
+
+    SnapshotConfig   config_;
+    std::string      extension_;
+    std::vector<int> encodeParams_;
+
+    // Rate limiting (capture thread only)
+    bool              taken_{false};
+    std::uint32_t     framesSinceLast_{0};
+    Clock::time_point lastTaken_;
+
+    // Mailbox (guarded by mutex_)
+    std::mutex              mutex_;
+    std::condition_variable wake_;
+    cv::Mat                 pending_;
+    bool                    hasPending_{false};
+    bool                    stopping_{false};
+
+    // Writer thread only
+    cv::Mat                 working_;
+    std::vector<uchar>      encoded_;
+
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> failed_{0};
+    std::atomic<std::uint64_t> skippedBusy_{0};
+
+    std::thread thread_;   // last member: starts after everything above is built
+};
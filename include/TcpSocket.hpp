@@ -7,18 +7,36 @@
  * cleanup. Designed for use by higher-level transport classes such as
  * TcpTransport.
  *
+ * In non-blocking mode (TcpOptions::nonBlocking) send() never waits for the
+ * collector while there is room in a bounded user-space send buffer: what
+ * the kernel does not take at once is queued and written as the socket
+ * becomes writable, either on later sends or from poll()/flush(), which
+ * wait on epoll (poll() off Linux). Crossing the high/low water marks calls
+ * the registered callbacks, and aboveHighWater() (ITransport::congested())
+ * tells the Sensor to shed samples instead of blocking.
+ * A full buffer, or queued bytes that make no progress for writeTimeout,
+ * make send() throw and drop the connection. Whatever is still buffered
+ * then is discarded with it: send() already reported those bytes as sent,
+ * so ReconnectingTransport cannot replay them.
+ *
  * @note The socket is automatically closed when the object is destroyed.
  */
 
 #pragma once
 
+#include "ConfigTypes.hpp"
+#include "ConstBuffer.hpp"
 #include "ITransport.hpp"
 
+#include <chrono>
+#include <functional>
 #include <string>
+#include <utility>   // std::move, std::exchange
+#include <vector>
 #include <cstddef>   // std::size_t
 #include <cstdint>   // int32_t
 
-// Super-simple, blocking TCP client.
+// Simple TCP client, blocking unless options.nonBlocking is set.
 // Usage:
 //   TcpSocket cli{"127.0.0.1", 8080};
 //   cli.connect();
@@ -27,8 +45,13 @@
 
 class TcpSocket {
 public:
-    // construct with destination
-    TcpSocket(std::string host, uint16_t port);
+    using Clock = std::chrono::steady_clock;
+
+    // called with the number of bytes buffered when a water mark is crossed
+    using WaterMarkFn = std::function<void(std::size_t buffered)>;
+
+    // construct with destination; throws std::invalid_argument on inconsistent options
+    TcpSocket(std::string host, uint16_t port, TcpOptions options = {});
     ~TcpSocket();
 
     // no copies (socket ownership)
@@ -37,9 +60,11 @@ public:
 
         // Movable: transfer ownership of the underlying socket fd_
     TcpSocket(TcpSocket&& other) noexcept
-        : host_(std::move(other.host_)), port_(other.port_), fd_(other.fd_) {
-        other.fd_ = -1;
-    }
+        : host_(std::move(other.host_)), port_(other.port_), fd_(std::exchange(other.fd_, -1)),
+          options_(other.options_), epollFd_(std::exchange(other.epollFd_, -1)),
+          pending_(std::move(other.pending_)), pendingHead_(std::exchange(other.pendingHead_, 0)),
+          lastProgress_(other.lastProgress_), aboveHighWater_(std::exchange(other.aboveHighWater_, false)),
+          onHighWater_(std::move(other.onHighWater_)), onLowWater_(std::move(other.onLowWater_)) {}
 
     TcpSocket& operator=(TcpSocket&& other) noexcept {
         if (this != &other) {
@@ -47,29 +72,81 @@ public:
             close();
             host_ = std::move(other.host_);
             port_ = other.port_;
-            fd_ = other.fd_;
-            other.fd_ = -1;
+            fd_ = std::exchange(other.fd_, -1);
+            options_ = other.options_;
+            epollFd_ = std::exchange(other.epollFd_, -1);
+            pending_ = std::move(other.pending_);
+            pendingHead_ = std::exchange(other.pendingHead_, 0);
+            lastProgress_ = other.lastProgress_;
+            aboveHighWater_ = std::exchange(other.aboveHighWater_, false);
+            onHighWater_ = std::move(other.onHighWater_);
+            onLowWater_ = std::move(other.onLowWater_);
         }
         return *this;
     }
 
-    // connect to host:port (blocking). Throws on failure.
+    // connect to host:port, waiting at most options.connectTimeout. Throws on failure.
     void connect();
 
     // true if a socket is currently open
     [[nodiscard]] bool isConnected() const noexcept;
 
-    // blocking send; attempts to write all bytes. Throws on failure.
-    std::size_t send(const void* data, std::size_t len) const;
+    // blocking mode: attempts to write all bytes. Non-blocking mode: writes
+    // what the socket takes now and buffers the rest. Throws on failure.
+    std::size_t send(const void* data, std::size_t len);
 
     // convenience for text payloads (e.g., JSON)
-    [[nodiscard]] std::size_t sendString(const std::string& payload) const;
+    std::size_t sendString(const std::string& payload);
+
+    // gather send of 'count' buffers as one byte run (writev), same
+    // semantics as send(). Throws on failure.
+    std::size_t sendBuffers(const ConstBuffer* buffers, std::size_t count);
+
+    // ---- non-blocking mode: event loop and backpressure ----
+
+    // wait up to 'timeout' for the socket to take buffered bytes, write what
+    // it takes; returns the bytes still buffered. Throws when queued bytes
+    // have made no progress for options.writeTimeout.
+    std::size_t poll(std::chrono::milliseconds timeout);
 
-    // close the socket (safe to call multiple times)
+    // write what the socket takes now, then poll() until the buffer is empty
+    // or 'deadline' is less than 1 ms away (it never waits past it); true if drained
+    bool flushUntil(Clock::time_point deadline);
+
+    // bytes accepted by send() but not yet handed to the kernel
+    [[nodiscard]] std::size_t bufferedBytes() const noexcept { return pending_.size() - pendingHead_; }
+
+    // true between crossing the high water mark and falling back to the low one
+    [[nodiscard]] bool aboveHighWater() const noexcept { return aboveHighWater_; }
+
+    void onHighWater(WaterMarkFn callback) { onHighWater_ = std::move(callback); }
+    void onLowWater(WaterMarkFn callback)  { onLowWater_ = std::move(callback); }
+
+    // close the socket (safe to call multiple times); buffered bytes get up to
+    // options.writeTimeout to drain first
     void close() noexcept;
 
 private:
+    void setUpConnected();
+    std::size_t sendBlocking(const ConstBuffer* buffers, std::size_t count);
+    std::size_t enqueue(const ConstBuffer* buffers, std::size_t count);
+    std::size_t writeSome(const ConstBuffer* buffers, std::size_t count, std::size_t skip);
+    void flushPending();
+    bool waitWritable(std::chrono::milliseconds timeout) const;
+    void updateWaterMarks();
+    void throwStalled(const char* where);
+    void closeNow() noexcept;
+
     std::string host_;
     uint16_t     port_;
     int         fd_{-1};   // POSIX socket fd; -1 means "not connected"
+
+    TcpOptions        options_;
+    int               epollFd_{-1};        // writability waits (Linux, non-blocking mode)
+    std::vector<char> pending_;            // user-space send buffer; [pendingHead_, size) unsent
+    std::size_t       pendingHead_{0};
+    Clock::time_point lastProgress_{};     // last time queued bytes moved to the kernel
+    bool              aboveHighWater_{false};
+    WaterMarkFn       onHighWater_;
+    WaterMarkFn       onLowWater_;
 };
@@ -11,20 +11,31 @@
 
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <cstdint>
+#include "ConfigTypes.hpp"
 #include "ITransport.hpp"
 #include "TcpSocket.hpp"
 
 class TcpTransport : public ITransport {
 public:
 
-    TcpTransport(std::string host, u_int16_t port) : socket_{std::move(host), port} {}
+    TcpTransport(std::string host, u_int16_t port, TcpOptions options = {})
+        : socket_{std::move(host), port, options} {}
 
     void connect() override            { socket_.connect(); }
     std::size_t sendString(const std::string& payload) override { return socket_.sendString(payload); }
+    std::size_t sendBuffers(const ConstBuffer* buffers, std::size_t count) override { return socket_.sendBuffers(buffers, count); }
+    bool flushUntil(std::chrono::steady_clock::time_point deadline) override { return socket_.flushUntil(deadline); }
     void close() override              { socket_.close(); }
     [[nodiscard]] bool isConnected() const override  { return socket_.isConnected(); }
+    [[nodiscard]] bool congested() const override    { return socket_.aboveHighWater(); }
+
+    // non-blocking mode backpressure (see TcpSocket)
+    void onHighWater(TcpSocket::WaterMarkFn callback) { socket_.onHighWater(std::move(callback)); }
+    void onLowWater(TcpSocket::WaterMarkFn callback)  { socket_.onLowWater(std::move(callback)); }
+    [[nodiscard]] std::size_t bufferedBytes() const noexcept { return socket_.bufferedBytes(); }
 
 private:
     TcpSocket socket_;
@@ -0,0 +1,91 @@
+/**
+ * @file TickScheduler.hpp
+ * @brief Drift-free periodic scheduler built on steady_clock absolute deadlines.
+ *
+ * TickScheduler releases ticks on a fixed grid anchored at the first wait:
+ * deadline(k) = start + k * period. Because each wait targets an absolute
+ * deadline (`sleep_until`) instead of sleeping for a relative interval after
+ * the work is done, the time spent reading, encoding and sending does not
+ * accumulate into the cadence.
+ *
+ * When the caller's work runs past the next deadline (an overrun), the
+ * configured OverrunPolicy decides what happens to the missed deadlines:
+ *  - CATCH_UP releases every missed tick back-to-back until caught up, so no
+ *    samples are lost but they are bunched together.
+ *  - SKIP drops the missed deadlines and waits for the next deadline on the
+ *    original grid, so the phase is preserved but samples are lost.
+ *
+ * Per-tick lateness (jitter) and overrun/skip counters are kept in TickStats.
+ *
+ * Periods down to about 1 ms are supported without spinning: for short
+ * periods start() lowers the calling thread's timer slack (Linux) so that
+ * sleep_until wakes close to the deadline, and stop() puts the thread's
+ * previous slack back once the loop is done.
+ *
+ * @note Not thread-safe; a scheduler is driven by, and started and stopped
+ *       from, a single loop thread.
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+// Counters accumulated since the last start().
+struct TickStats {
+    std::uint64_t ticks{0};                   // ticks released to the caller
+    std::uint64_t overruns{0};                // deadlines the caller's work ran past
+    std::uint64_t skipped{0};                 // deadlines dropped by OverrunPolicy::SKIP
+    std::chrono::nanoseconds lastJitter{0};   // release time minus deadline, last tick
+    std::chrono::nanoseconds maxJitter{0};    // worst release lateness seen
+    std::chrono::nanoseconds totalJitter{0};  // sum of lateness (for the mean)
+
+    [[nodiscard]] std::chrono::nanoseconds meanJitter() const {
+        return ticks == 0 ? std::chrono::nanoseconds{0}
+                          : totalJitter / static_cast<std::int64_t>(ticks);
+    }
+};
+
+class TickScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TickScheduler(std::chrono::nanoseconds period, OverrunPolicy policy);
+
+    // Reset the statistics and re-anchor the deadline grid: the first
+    // waitNext() after start() returns immediately and becomes deadline 0.
+    void start();
+
+    // The loop is done: restore the timer slack start() lowered, if any.
+    // Call it from the thread that called start().
+    void stop() noexcept;
+
+    // Block until the next deadline (per the overrun policy) and return it.
+    Clock::time_point waitNext();
+
+    // waitNext() for a loop that fills the time between ticks with idle work
+    // (draining a send buffer) from 'idleSince' on. Only the work before
+    // 'idleSince' can overrun a deadline: idle work that runs late (or is
+    // preempted) releases the tick late, it never makes SKIP drop it.
+    Clock::time_point waitNext(Clock::time_point idleSince);
+
+    // Deadline the next waitNext() aims for (meaningful once started).
+    [[nodiscard]] Clock::time_point nextDeadline() const noexcept { return next_; }
+
+    [[nodiscard]] const TickStats& stats() const noexcept { return stats_; }
+    [[nodiscard]] std::chrono::nanoseconds period() const noexcept { return period_; }
+    [[nodiscard]] OverrunPolicy policy() const noexcept { return policy_; }
+
+private:
+    void recordRelease(Clock::time_point deadline, Clock::time_point released);
+
+    std::chrono::nanoseconds period_;
+    OverrunPolicy            policy_;
+    Clock::time_point        next_{};
+    bool                     anchored_{false};
+    TickStats                stats_;
+    bool                     slackLowered_{false};   // savedSlack_ is to be restored by stop()
+    unsigned long            savedSlack_{0};         // the loop thread's timer slack before start()
+};
@@ -0,0 +1,82 @@
+/**
+ * @file TimestampFormatter.hpp
+ * @brief Log timestamp rendering that calls into libc once per second.
+ *
+ * The date and time-of-day part ("YYYY-MM-DD HH:MM:SS") is rendered with
+ * localtime_r()/gmtime_r() and strftime() only when the second changes and
+ * kept in a small buffer; every other call copies it and writes the
+ * millisecond or microsecond digits by hand. With utc set the output is
+ * ISO-8601 ("2024-01-01T00:00:00.000Z").
+ *
+ * An instance keeps its own cache and is not synchronized: give each
+ * formatting thread its own, or guard it with the lock that already
+ * serializes the output (as Logger does).
+ *
+ * now() supplies the times: wall-clock nanoseconds derived from
+ * steady_clock and re-synced with system_clock once a minute, in either
+ * direction. A small backward correction is absorbed by holding the time
+ * until steady_clock catches up, so consecutive log lines do not go back;
+ * a bigger step of the system clock (someone set it, NTP stepped it) is
+ * followed at once.
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+class TimestampFormatter {
+public:
+    // "YYYY-MM-DDTHH:MM:SS.uuuuuuZ"
+    static constexpr std::size_t kMaxLength = 27;
+
+    explicit TimestampFormatter(TimestampPrecision precision = TimestampPrecision::SECONDS, bool utc = false) noexcept
+        : precision_(precision), utc_(utc) {}
+
+    // Write the timestamp of 'timeNs' (nanoseconds since the epoch) to 'out',
+    // which must hold kMaxLength chars. Returns the length; no terminator.
+    std::size_t format(std::int64_t timeNs, char* out);
+
+    [[nodiscard]] TimestampPrecision precision() const noexcept { return precision_; }
+    [[nodiscard]] bool utc() const noexcept { return utc_; }
+
+    // Nanoseconds since the epoch: system_clock as of the last re-sync (at most
+    // a minute ago) plus steady_clock time since. Steps of the system clock
+    // either way are picked up at the next re-sync; see WallClock for how a
+    // backward one shows. Thread-safe and lock-free.
+    static std::int64_t now() noexcept;
+
+    // The clock behind now(), fed explicit readings so that tests can step
+    // the system clock.
+    class WallClock {
+    public:
+        // Backward corrections smaller than this hold the time instead of
+        // letting it go back; bigger ones are applied as they are.
+        static constexpr std::int64_t kMaxHoldNs = 1000000000;
+
+        WallClock(std::int64_t systemNs, std::int64_t steadyNs) noexcept;
+
+        // Wall-clock time at 'steadyNs'; calls systemNs() only to re-sync.
+        std::int64_t read(std::int64_t steadyNs, std::int64_t (*systemNs)()) noexcept;
+
+    private:
+        std::atomic<std::int64_t> offset_;     // system_clock minus steady_clock
+        std::atomic<std::int64_t> nextSync_;   // steady time of the next re-sync
+        std::atomic<std::int64_t> latest_;     // largest time handed out so far
+    };
+
+private:
+    void renderSeconds(std::int64_t seconds);
+
+    TimestampPrecision precision_;
+    bool               utc_;
+
+    std::int64_t                     cachedSecond_{std::numeric_limits<std::int64_t>::min()};
+    std::array<char, kMaxLength>     cached_{};          // date and time of cachedSecond_
+    std::size_t                      cachedLength_{0};
+};
@@ -6,7 +6,12 @@
 #include "ITransport.hpp"    // interface
 
 struct TransportFactory {
-    // Build a concrete transport based on cfg.kind ("tcp" | "udp").
+    // Build a concrete transport based on cfg.kind ("tcp" | "udp" | "unix" | "shm" | "fanout"),
+    // wrapped in a ReconnectingTransport when cfg.reconnect.enabled. Fan-out sinks are
+    // built the same way, each with its own reconnect settings.
     // NOTE: This does NOT call connect(); the caller decides when to connect.
     static std::unique_ptr<ITransport> make(const TransportConfig& cfg);
+
+private:
+    static std::unique_ptr<ITransport> makeLink(const TransportConfig& cfg);
 };
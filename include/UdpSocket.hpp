@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include "ConstBuffer.hpp"
+
 #include <string>
 #include <cstddef>
 #include <cstdint>
@@ -47,6 +49,13 @@ public:
     [[nodiscard]] bool isConnected() const noexcept;    // fd_ >= 0
     std::size_t send(const void* data, std::size_t len) const; // send one datagram
     [[nodiscard]] std::size_t sendString(const std::string& payload) const;        // convenience
+    std::size_t sendBuffers(const ConstBuffer* buffers, std::size_t count) const;   // one datagram gathered from 'count' buffers (sendmsg)
+
+    // 'count' datagrams, one per buffer, many per syscall (sendmmsg on Linux,
+    // a send() loop elsewhere). Returns how many went out, in order: fewer
+    // than 'count' means datagram [result] failed (sending it again reports
+    // why). Throws only when the first datagram cannot be sent.
+    std::size_t sendBurst(const ConstBuffer* datagrams, std::size_t count) const;
     void close() noexcept;                // shutdown (best-effort) + close
 
 private:
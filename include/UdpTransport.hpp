@@ -24,8 +24,10 @@
 #pragma once
 
 #include <string>
+#include <cstddef>
 #include <cstdint>
 #include "ITransport.hpp"
+#include "NetworkConstants.hpp"
 #include "UdpSocket.hpp"
 
 class UdpTransport : public ITransport {
@@ -35,8 +37,11 @@ public:
 
     void connect() override                         { socket_.connect(); }
     std::size_t sendString(const std::string& payload) override { return socket_.sendString(payload); }
+    std::size_t sendBuffers(const ConstBuffer* buffers, std::size_t count) override { return socket_.sendBuffers(buffers, count); }
+    std::size_t sendBurst(const ConstBuffer* messages, std::size_t count) override { return socket_.sendBurst(messages, count); }
     void close() override                           { socket_.close(); }
     [[nodiscard]] bool isConnected() const override               { return socket_.isConnected(); }
+    [[nodiscard]] std::size_t maxMessageSize() const override     { return NetworkConstants::kUdpUnfragmentedPayload; }
 
 private:
     UdpSocket socket_;
@@ -0,0 +1,61 @@
+/**
+ * @file UnixSocket.hpp
+ * @brief RAII wrapper for a Unix domain socket to a local collector.
+ *
+ * Same-host delivery without the TCP/IP stack: no checksums, no
+ * congestion control, no loopback routing, so a sample costs noticeably
+ * less CPU than over TcpSocket to 127.0.0.1.
+ *
+ * - SOCK_STREAM behaves like TcpSocket in blocking mode: every byte is
+ *   sent, partial writes resume where they stopped, and a collector that
+ *   takes nothing for writeTimeout gets the connection dropped.
+ * - SOCK_DGRAM sends each message as one datagram, gathered from its
+ *   pieces by a single sendmsg().
+ * - A path starting with '@' names a socket in Linux's abstract
+ *   namespace: no file to create, clean up or protect.
+ * - With sendCredentials, the first message after connect() carries
+ *   SCM_CREDENTIALS (pid, uid, gid) so a collector using SO_PASSCRED can
+ *   authenticate the sensor. With peerUid, connect() checks the
+ *   collector's uid (SO_PEERCRED) before anything is sent. Both are Linux
+ *   only; elsewhere connect() throws if they are configured.
+ *
+ * Sends use MSG_NOSIGNAL, so a collector that goes away raises an
+ * exception instead of SIGPIPE.
+ *
+ * @note The socket is automatically closed when the object is destroyed.
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+#include "ConstBuffer.hpp"
+
+#include <cstddef>
+#include <string>
+
+class UnixSocket {
+public:
+    // Throws std::invalid_argument on an empty or over-long path.
+    explicit UnixSocket(UnixOptions options);
+    ~UnixSocket();
+
+    UnixSocket(const UnixSocket&) = delete;
+    UnixSocket& operator=(const UnixSocket&) = delete;
+    UnixSocket(UnixSocket&&) = delete;
+    UnixSocket& operator=(UnixSocket&&) = delete;
+
+    void connect();                                   // socket + ::connect (+ peer check)
+    [[nodiscard]] bool isConnected() const noexcept { return fd_ >= 0; }
+    [[nodiscard]] bool isDatagram() const noexcept { return options_.datagram; }
+    std::size_t sendString(const std::string& payload);
+    std::size_t sendBuffers(const ConstBuffer* buffers, std::size_t count);   // one message (datagram) from 'count' pieces
+    void close() noexcept;
+
+private:
+    std::size_t sendSome(const ConstBuffer* buffers, std::size_t count, std::size_t skip);
+    void checkPeer();
+
+    UnixOptions options_;
+    int         fd_{-1};                   // -1 = not connected
+    bool        credentialsDue_{false};    // attach SCM_CREDENTIALS to the next send
+};
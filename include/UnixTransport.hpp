@@ -0,0 +1,45 @@
+/**
+ * @file UnixTransport.hpp
+ * @brief Unix domain socket transport adapter implementing ITransport.
+ *
+ * Wraps a UnixSocket (stream or datagram, see UnixOptions) for collectors
+ * that run as local daemons.
+ *
+ * Usage example:
+ * @code{.cpp}
+ * UnixOptions options;
+ * options.path = "@sensor-collector";   // abstract namespace
+ * UnixTransport transport(options);
+ * transport.connect();
+ * transport.sendString("{\"hello\":1}\n");
+ * @endcode
+ */
+
+#pragma once
+
+#include "ConfigTypes.hpp"
+#include "ITransport.hpp"
+#include "NetworkConstants.hpp"
+#include "UnixSocket.hpp"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+class UnixTransport : public ITransport {
+public:
+
+    explicit UnixTransport(UnixOptions options) : socket_{std::move(options)} {}
+
+    void connect() override                                                          { socket_.connect(); }
+    std::size_t sendString(const std::string& payload) override                      { return socket_.sendString(payload); }
+    std::size_t sendBuffers(const ConstBuffer* buffers, std::size_t count) override  { return socket_.sendBuffers(buffers, count); }
+    void close() override                                                            { socket_.close(); }
+    [[nodiscard]] bool isConnected() const override                                  { return socket_.isConnected(); }
+    [[nodiscard]] std::size_t maxMessageSize() const override {
+        return socket_.isDatagram() ? NetworkConstants::kUnixDatagramPayload : 0;
+    }
+
+private:
+    UnixSocket socket_;
+};
@@ -0,0 +1,101 @@
+/**
+ * @file Xoshiro256.hpp
+ * @brief Small, fast PRNG (xoshiro256+) with a multi-lane bulk fill.
+ *
+ * Used by the simulated data source, where std::mt19937 and
+ * std::uniform_real_distribution would dominate the cost of generating
+ * millions of values per second. xoshiro256+ needs four 64-bit words of
+ * state, a handful of shifts/xors per output, and its upper 52 bits are
+ * of good quality, which is all a double in [0, 1) uses.
+ *
+ * The generator keeps kLanes independent streams side by side. The scalar
+ * calls step lane 0; fillUniform() steps all lanes in lockstep so that the
+ * inner loop has no dependency between lanes and the compiler can keep it
+ * in vector registers.
+ *
+ * Not suitable for anything security related.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class Xoshiro256 {
+public:
+    static constexpr std::size_t kLanes = 4;
+
+    // Expand 'seed' into the state of every lane with splitmix64, as the
+    // xoshiro authors recommend (never yields an all-zero state).
+    explicit Xoshiro256(std::uint64_t seed) noexcept {
+        for (std::size_t lane = 0; lane < kLanes; ++lane) {
+            s0_[lane] = splitMix64(seed);
+            s1_[lane] = splitMix64(seed);
+            s2_[lane] = splitMix64(seed);
+            s3_[lane] = splitMix64(seed);
+        }
+    }
+
+    // Next raw 64-bit output of lane 0.
+    std::uint64_t next() noexcept { return step(0); }
+
+    // Next double uniformly distributed in [0, 1).
+    double nextUnit() noexcept { return toUnit(step(0)); }
+
+    // Write 'count' doubles uniformly distributed in [lo, hi) to 'out'.
+    void fillUniform(double* out, std::size_t count, double lo, double hi) noexcept {
+        const double width = hi - lo;
+        std::size_t idx = 0;
+
+        for (; idx + kLanes <= count; idx += kLanes) {
+            for (std::size_t lane = 0; lane < kLanes; ++lane) {
+                out[idx + lane] = lo + width * toUnit(step(lane));
+            }
+        }
+        for (std::size_t lane = 0; idx < count; ++idx, ++lane) {
+            out[idx] = lo + width * toUnit(step(lane));
+        }
+    }
+
+private:
+    static std::uint64_t splitMix64(std::uint64_t& state) noexcept {
+        std::uint64_t value = (state += 0x9E3779B97F4A7C15ULL);
+        value = (value ^ (value >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27U)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31U);
+    }
+
+    // Top 52 bits as the mantissa of a double in [1, 2), shifted down to [0, 1).
+    static double toUnit(std::uint64_t bits) noexcept {
+        const std::uint64_t pattern = 0x3FF0000000000000ULL | (bits >> 12U);
+        double value = 0.0;
+        std::memcpy(&value, &pattern, sizeof(value));
+        return value - 1.0;
+    }
+
+    static std::uint64_t rotl(std::uint64_t value, unsigned shift) noexcept {
+        return (value << shift) | (value >> (64U - shift));
+    }
+
+    std::uint64_t step(std::size_t lane) noexcept {
+        const std::uint64_t result = s0_[lane] + s3_[lane];
+        const std::uint64_t shifted = s1_[lane] << 17U;
+
+        s2_[lane] ^= s0_[lane];
+        s3_[lane] ^= s1_[lane];
+        s1_[lane] ^= s2_[lane];
+        s0_[lane] ^= s3_[lane];
+        s2_[lane] ^= shifted;
+        s3_[lane] = rotl(s3_[lane], 45U);
+
+        return result;
+    }
+
+    // State words stored per word across lanes (structure of arrays).
+    std::array<std::uint64_t, kLanes> s0_{};
+    std::array<std::uint64_t, kLanes> s1_{};
+    std::array<std::uint64_t, kLanes> s2_{};
+    std::array<std::uint64_t, kLanes> s3_{};
+};
@@ -0,0 +1,57 @@
+/**
+ * @file BinaryPayloadEncoder.cpp
+ * @brief Implementation of the fixed-layout binary payload encoder.
+ *
+ * @see BinaryPayloadEncoder
+ */
+
+#include "BinaryPayloadEncoder.hpp"
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "ReadingLayout.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace {
+
+    constexpr std::size_t kMaxSensorIdLength = 255;
+
+    void appendLittleEndian(std::string& out, std::uint64_t value, int bytes) {
+        for (int idx = 0; idx < bytes; ++idx) {
+            out.push_back(static_cast<char>((value >> static_cast<unsigned>(idx * 8)) & 0xFFU));
+        }
+    }
+}
+
+BinaryPayloadEncoder::BinaryPayloadEncoder(const SensorConfig& config)
+    : sensorId_(config.sensorId.substr(0, std::min(config.sensorId.size(), kMaxSensorIdLength))),
+      layout_(config.units, nullptr)   // names are covered by the schema id
+{
+}
+
+void BinaryPayloadEncoder::encode(const Readings& readings, std::int64_t timestampMs, std::string& out) {
+
+    layout_.gather(readings);
+    const std::size_t count = layout_.size();
+    const std::size_t recordSize = kHeaderSize + sensorId_.size() + count * sizeof(double);
+
+    out.clear();
+    out += kMagic;
+    appendLittleEndian(out, recordSize, 4);
+    appendLittleEndian(out, layout_.schemaId(), 4);
+    appendLittleEndian(out, count, 4);
+    appendLittleEndian(out, static_cast<std::uint64_t>(timestampMs), 8);
+    appendLittleEndian(out, sensorId_.size(), 1);
+    out += sensorId_;
+
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        const double value = layout_.value(idx);
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        appendLittleEndian(out, bits, 8);
+    }
+}
@@ -0,0 +1,152 @@
+/**
+ * @file CborPayloadEncoder.cpp
+ * @brief Implementation of the CBOR payload encoder.
+ *
+ * @see CborPayloadEncoder
+ */
+
+#include "CborPayloadEncoder.hpp"
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "ReadingLayout.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    // Major types (RFC 8949, section 3.1).
+    constexpr std::uint8_t kUnsigned = 0;
+    constexpr std::uint8_t kNegative = 1;
+    constexpr std::uint8_t kText     = 3;
+    constexpr std::uint8_t kMap      = 5;
+
+    constexpr char kFloat32 = static_cast<char>(0xFA);
+    constexpr char kFloat64 = static_cast<char>(0xFB);
+    constexpr char kNull    = static_cast<char>(0xF6);
+
+    void appendBigEndian(std::string& out, std::uint64_t value, int bytes) {
+        for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<char>((value >> static_cast<unsigned>(shift)) & 0xFFU));
+        }
+    }
+}
+
+// ----- ctor -----
+
+CborPayloadEncoder::CborPayloadEncoder(const SensorConfig& config)
+    : layout_(config.units, &CborPayloadEncoder::renderReadingPrefix)
+{
+    // Same key order as the JSON payload.
+    std::vector<std::pair<std::string, std::string>> metadata(config.metadata.begin(), config.metadata.end());
+    std::sort(metadata.begin(), metadata.end());
+
+    if (!metadata.empty()) {
+        appendText(metadata_, "metadata");
+        appendHead(metadata_, kMap, metadata.size());
+        for (const auto& [key, value] : metadata) {
+            appendText(metadata_, key);
+            appendText(metadata_, value);
+        }
+    }
+
+    appendText(tail_, "sensor_id");
+    appendText(tail_, config.sensorId);
+    appendText(tail_, "timestamp_ms");
+}
+
+// ----- payload -----
+
+void CborPayloadEncoder::encode(const Readings& readings, std::int64_t timestampMs, std::string& out) {
+
+    out.clear();
+    const std::uint64_t members = 2 + (metadata_.empty() ? 0U : 1U) + (readings.empty() ? 0U : 1U);
+    appendHead(out, kMap, members);
+    out += metadata_;
+
+    if (!readings.empty()) {
+        layout_.gather(readings);
+        appendText(out, "readings");
+        appendHead(out, kMap, layout_.size());
+        for (std::size_t idx = 0; idx < layout_.size(); ++idx) {
+            out += layout_.prefix(idx);
+            appendDouble(out, layout_.value(idx));
+        }
+    }
+
+    out += tail_;
+    appendInteger(out, timestampMs);
+}
+
+void CborPayloadEncoder::renderReadingPrefix(std::string& out, const std::string& name, const std::string& unit) {
+    appendText(out, name);
+    appendHead(out, kMap, 2);
+    appendText(out, "unit");
+    appendText(out, unit);
+    appendText(out, "value");
+}
+
+// ----- primitives -----
+
+void CborPayloadEncoder::appendHead(std::string& out, std::uint8_t majorType, std::uint64_t argument) {
+    const auto major = static_cast<std::uint8_t>(majorType << 5U);
+    if (argument < 24) {
+        out.push_back(static_cast<char>(major | argument));
+    } else if (argument <= 0xFFU) {
+        out.push_back(static_cast<char>(major | 24U));
+        appendBigEndian(out, argument, 1);
+    } else if (argument <= 0xFFFFU) {
+        out.push_back(static_cast<char>(major | 25U));
+        appendBigEndian(out, argument, 2);
+    } else if (argument <= 0xFFFFFFFFU) {
+        out.push_back(static_cast<char>(major | 26U));
+        appendBigEndian(out, argument, 4);
+    } else {
+        out.push_back(static_cast<char>(major | 27U));
+        appendBigEndian(out, argument, 8);
+    }
+}
+
+void CborPayloadEncoder::appendText(std::string& out, std::string_view text) {
+    appendHead(out, kText, text.size());
+    out += text;
+}
+
+void CborPayloadEncoder::appendInteger(std::string& out, std::int64_t value) {
+    if (value >= 0) {
+        appendHead(out, kUnsigned, static_cast<std::uint64_t>(value));
+    } else {
+        // -1 - value, computed without overflowing for INT64_MIN
+        appendHead(out, kNegative, ~static_cast<std::uint64_t>(value));
+    }
+}
+
+void CborPayloadEncoder::appendDouble(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        out.push_back(kNull);
+        return;
+    }
+
+    if (std::abs(value) <= std::numeric_limits<float>::max()) {
+        const auto narrow = static_cast<float>(value);
+        if (static_cast<double>(narrow) == value) {
+            std::uint32_t bits = 0;
+            std::memcpy(&bits, &narrow, sizeof(bits));
+            out.push_back(kFloat32);
+            appendBigEndian(out, bits, 4);
+            return;
+        }
+    }
+
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    out.push_back(kFloat64);
+    appendBigEndian(out, bits, 8);
+}
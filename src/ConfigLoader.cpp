@@ -8,15 +8,23 @@
 
 #include "ConfigLoader.hpp"
 #include "ConfigTypes.hpp"
+#include "DiskSpool.hpp"
 #include "NetworkConstants.hpp"
+#include "StringUtils.hpp"
 
 #include "Logger.hpp"
 #include <fstream>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <array>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <limits>
+#include <optional>
 #include <stdexcept>
 #include <unordered_map>
+#include <utility>
 
 using json = nlohmann::json;    // NOLINT(misc-include-cleaner)
 
@@ -30,7 +38,7 @@ namespace {
             throw std::runtime_error("ConfigLoader: cannot open file: " + path);
         }
 
-        Logger::instance().debug("Reading from JSON file at " + path);
+        LOGGER_DEBUG("Reading from JSON file at " + path);
 
         json jsonObject;
         input >> jsonObject;
@@ -62,6 +70,594 @@ namespace {
         }
     }
 
+    // Largest accepted sampling interval; also keeps the microsecond count far from overflow.
+    constexpr std::chrono::microseconds kMaxInterval = std::chrono::hours(24);
+
+    // Upper bounds for "batch" settings.
+    constexpr std::uint64_t kMaxBatchSamples = 65536;
+    constexpr std::uint64_t kMaxBatchBytes   = 16U * 1024U * 1024U;
+
+    // Upper bound for a non-blocking TCP socket's user-space send buffer.
+    constexpr std::uint64_t kMaxTcpSendBuffer = 256U * 1024U * 1024U;
+
+    // sockaddr_un::sun_path is 108 bytes on Linux, NUL included.
+    constexpr std::size_t kMaxUnixPath = 107;
+
+    // Upper bound for a shared-memory ring.
+    constexpr std::uint64_t kMaxShmCapacity = 1024U * 1024U * 1024U;
+
+    // Upper bounds for "reconnect" settings.
+    constexpr std::uint64_t kMaxReconnectAttempts = 1000;
+    constexpr std::uint64_t kMaxReconnectQueue    = 1U << 20U;
+    constexpr std::uint64_t kMaxReplayRate        = 1000000;
+
+    // Upper bounds for "reconnect.spool" settings.
+    constexpr std::uint64_t kMaxSpoolBytes = std::uint64_t{1} << 40U;
+    constexpr std::chrono::milliseconds kMaxSpoolAge = std::chrono::hours(24 * 365);
+
+    // Upper bound for the number of fan-out sinks (one sender thread each).
+    constexpr std::size_t kMaxFanoutSinks = 16;
+
+    // Read the sampling interval from whichever of "interval_seconds" (may be
+    // fractional), "interval_ms" (may be fractional) or "interval_us" (integer)
+    // is present. At most one of them may be given; the default is 1 second.
+    std::chrono::microseconds readInterval(const json& jsonConfig, const std::string& path) {
+
+        struct IntervalKey {
+            const char* name;
+            double      microsPerUnit;
+            bool        integerOnly;
+        };
+        constexpr std::array<IntervalKey, 3> kIntervalKeys{{
+            {"interval_seconds", 1e6, false},
+            {"interval_ms",      1e3, false},
+            {"interval_us",      1.0, true},
+        }};
+
+        const IntervalKey* found = nullptr;
+        for (const auto& key : kIntervalKeys) {
+            if (!jsonConfig.contains(key.name)) {
+                continue;
+            }
+            if (found != nullptr) {
+                throw std::runtime_error(std::string("SensorConfig: '") + found->name + "' and '" +
+                                         key.name + "' are mutually exclusive in " + path);
+            }
+            found = &key;
+        }
+
+        if (found == nullptr) {
+            return std::chrono::seconds(1);
+        }
+
+        const auto& value = jsonConfig.at(found->name);
+        if (found->integerOnly ? !value.is_number_integer() : !value.is_number()) {
+            throw std::runtime_error(std::string("SensorConfig: '") + found->name + "' must be " +
+                                     (found->integerOnly ? "an integer" : "a number") + " in " + path);
+        }
+
+        const double micros = value.get<double>() * found->microsPerUnit;
+        if (!(micros > 0.0)) {
+            throw std::runtime_error(std::string("SensorConfig: '") + found->name + "' must be > 0 in " + path);
+        }
+        if (micros < 1.0 || micros > static_cast<double>(kMaxInterval.count())) {
+            throw std::runtime_error(std::string("SensorConfig: '") + found->name +
+                                     "' out of range (1 us .. 24 h) in " + path);
+        }
+
+        return std::chrono::microseconds(std::llround(micros));
+    }
+
+    // Upper bound for pipeline queue depths (entries, before power-of-two rounding).
+    constexpr std::int64_t kMaxQueueDepth = std::int64_t{1} << 20;
+
+    // Helper to read one queue object ({ "depth": N, "policy": "..." }) if present.
+    // 'context' starts the error messages, e.g. "SensorConfig: 'pipeline.".
+    void readQueueConfigIfPresent(
+        const json& parentJson,
+        const char* fieldName,
+        const std::string& context,
+        PipelineQueueConfig& queueConfig,
+        const std::string& path)
+    {
+        if (!parentJson.contains(fieldName)) {
+            return;
+        }
+
+        const std::string prefix = context + fieldName;
+        const auto& queueJson = parentJson.at(fieldName);
+        if (!queueJson.is_object()) {
+            throw std::runtime_error(prefix + "' must be an object in " + path);
+        }
+
+        if (queueJson.contains("depth")) {
+            const auto& depth = queueJson.at("depth");
+            if (!depth.is_number_integer() || depth.get<std::int64_t>() <= 0 ||
+                depth.get<std::int64_t>() > kMaxQueueDepth) {
+                throw std::runtime_error(prefix + ".depth' must be an integer in 1.." +
+                                         std::to_string(kMaxQueueDepth) + " in " + path);
+            }
+            queueConfig.depth = depth.get<std::size_t>();
+        }
+
+        if (queueJson.contains("policy")) {
+            const auto& policy = queueJson.at("policy");
+            if (!policy.is_string()) {
+                throw std::runtime_error(prefix + ".policy' must be a string in " + path);
+            }
+
+            const auto policyName = policy.get<std::string>();
+            if (StringUtils::iequals(policyName, "drop_oldest")) {
+                queueConfig.policy = QueuePolicy::DROP_OLDEST;
+            } else if (StringUtils::iequals(policyName, "drop_newest")) {
+                queueConfig.policy = QueuePolicy::DROP_NEWEST;
+            } else if (StringUtils::iequals(policyName, "block")) {
+                queueConfig.policy = QueuePolicy::BLOCK;
+            } else {
+                throw std::runtime_error(prefix + ".policy' unsupported value '" + policyName +
+                                         "' in " + path);
+            }
+        }
+    }
+
+    // Helper to read the optional "pipeline" object of a sensor config
+    void readPipelineConfigIfPresent(const json& jsonConfig, PipelineConfig& pipeline, const std::string& path) {
+
+        if (!jsonConfig.contains("pipeline")) {
+            return;
+        }
+
+        const auto& pipelineJson = jsonConfig.at("pipeline");
+        if (!pipelineJson.is_object()) {
+            throw std::runtime_error("SensorConfig: 'pipeline' must be an object in " + path);
+        }
+
+        if (pipelineJson.contains("enabled")) {
+            if (!pipelineJson.at("enabled").is_boolean()) {
+                throw std::runtime_error("SensorConfig: 'pipeline.enabled' must be a boolean in " + path);
+            }
+            pipeline.enabled = pipelineJson.at("enabled").get<bool>();
+        }
+
+        readQueueConfigIfPresent(pipelineJson, "capture_queue", "SensorConfig: 'pipeline.", pipeline.captureQueue, path);
+        readQueueConfigIfPresent(pipelineJson, "send_queue", "SensorConfig: 'pipeline.", pipeline.sendQueue, path);
+    }
+
+    // Helper to read the optional "logging" object of a sensor config:
+    // { "async", "queue": { "depth", "policy" }, "flush_interval_ms" }.
+    void readLoggingConfigIfPresent(const json& jsonConfig, LoggingConfig& logging, const std::string& path) {
+
+        if (!jsonConfig.contains("logging")) {
+            return;
+        }
+
+        const auto& loggingJson = jsonConfig.at("logging");
+        if (!loggingJson.is_object()) {
+            throw std::runtime_error("SensorConfig: 'logging' must be an object in " + path);
+        }
+
+        if (loggingJson.contains("async")) {
+            if (!loggingJson.at("async").is_boolean()) {
+                throw std::runtime_error("SensorConfig: 'logging.async' must be a boolean in " + path);
+            }
+            logging.async = loggingJson.at("async").get<bool>();
+        }
+
+        if (loggingJson.contains("level")) {
+            const auto& level = loggingJson.at("level");
+            if (!level.is_string()) {
+                throw std::runtime_error("SensorConfig: 'logging.level' must be a string in " + path);
+            }
+
+            const auto levelName = level.get<std::string>();
+            if (StringUtils::iequals(levelName, "debug")) {
+                logging.level = LogLevel::DEBUG;
+            } else if (StringUtils::iequals(levelName, "info")) {
+                logging.level = LogLevel::INFO;
+            } else if (StringUtils::iequals(levelName, "warning")) {
+                logging.level = LogLevel::WARNING;
+            } else if (StringUtils::iequals(levelName, "error")) {
+                logging.level = LogLevel::ERROR;
+            } else {
+                throw std::runtime_error("SensorConfig: 'logging.level' unsupported value '" + levelName +
+                                         "' in " + path);
+            }
+        }
+
+        if (loggingJson.contains("timestamp")) {
+            const auto& timestampJson = loggingJson.at("timestamp");
+            if (!timestampJson.is_object()) {
+                throw std::runtime_error("SensorConfig: 'logging.timestamp' must be an object in " + path);
+            }
+
+            if (timestampJson.contains("precision")) {
+                const auto& precision = timestampJson.at("precision");
+                if (!precision.is_string()) {
+                    throw std::runtime_error("SensorConfig: 'logging.timestamp.precision' must be a string in " + path);
+                }
+
+                const auto precisionName = precision.get<std::string>();
+                if (StringUtils::iequals(precisionName, "s")) {
+                    logging.timestampPrecision = TimestampPrecision::SECONDS;
+                } else if (StringUtils::iequals(precisionName, "ms")) {
+                    logging.timestampPrecision = TimestampPrecision::MILLISECONDS;
+                } else if (StringUtils::iequals(precisionName, "us")) {
+                    logging.timestampPrecision = TimestampPrecision::MICROSECONDS;
+                } else {
+                    throw std::runtime_error("SensorConfig: 'logging.timestamp.precision' unsupported value '" +
+                                             precisionName + "' in " + path);
+                }
+            }
+
+            if (timestampJson.contains("utc")) {
+                if (!timestampJson.at("utc").is_boolean()) {
+                    throw std::runtime_error("SensorConfig: 'logging.timestamp.utc' must be a boolean in " + path);
+                }
+                logging.timestampUtc = timestampJson.at("utc").get<bool>();
+            }
+        }
+
+        readQueueConfigIfPresent(loggingJson, "queue", "SensorConfig: 'logging.", logging.queue, path);
+
+        if (loggingJson.contains("flush_interval_ms")) {
+            const auto& millis = loggingJson.at("flush_interval_ms");
+            if (!millis.is_number_unsigned() || millis.get<std::uint64_t>() == 0 ||
+                millis.get<std::uint64_t>() > static_cast<std::uint64_t>(kMaxInterval.count() / 1000)) {
+                throw std::runtime_error("SensorConfig: 'logging.flush_interval_ms' must be a positive integer in " +
+                                         path);
+            }
+            logging.flushInterval = std::chrono::milliseconds(millis.get<std::int64_t>());
+        }
+    }
+
+    // Helper to read the optional "metric_ids" object of a sensor config
+    void readMetricIdConfigIfPresent(const json& jsonConfig, MetricIdConfig& metricIds, const std::string& path) {
+
+        if (!jsonConfig.contains("metric_ids")) {
+            return;
+        }
+
+        const auto& idsJson = jsonConfig.at("metric_ids");
+        if (!idsJson.is_object()) {
+            throw std::runtime_error("SensorConfig: 'metric_ids' must be an object in " + path);
+        }
+
+        if (idsJson.contains("enabled")) {
+            if (!idsJson.at("enabled").is_boolean()) {
+                throw std::runtime_error("SensorConfig: 'metric_ids.enabled' must be a boolean in " + path);
+            }
+            metricIds.enabled = idsJson.at("enabled").get<bool>();
+        }
+
+        if (idsJson.contains("dictionary_every")) {
+            const auto& every = idsJson.at("dictionary_every");
+            if (!every.is_number_unsigned() || every.get<std::uint64_t>() > std::numeric_limits<std::uint32_t>::max()) {
+                throw std::runtime_error("SensorConfig: 'metric_ids.dictionary_every' must be a non-negative integer in " +
+                                         path);
+            }
+            metricIds.dictionaryEvery = every.get<std::uint32_t>();
+        }
+    }
+
+    // Helper to read the optional "batch" object of a sensor config
+    void readBatchConfigIfPresent(const json& jsonConfig, BatchConfig& batch, const std::string& path) {
+
+        if (!jsonConfig.contains("batch")) {
+            return;
+        }
+
+        const auto& batchJson = jsonConfig.at("batch");
+        if (!batchJson.is_object()) {
+            throw std::runtime_error("SensorConfig: 'batch' must be an object in " + path);
+        }
+
+        if (batchJson.contains("enabled")) {
+            if (!batchJson.at("enabled").is_boolean()) {
+                throw std::runtime_error("SensorConfig: 'batch.enabled' must be a boolean in " + path);
+            }
+            batch.enabled = batchJson.at("enabled").get<bool>();
+        }
+
+        if (batchJson.contains("max_samples")) {
+            const auto& samples = batchJson.at("max_samples");
+            if (!samples.is_number_unsigned() || samples.get<std::uint64_t>() == 0 ||
+                samples.get<std::uint64_t>() > kMaxBatchSamples) {
+                throw std::runtime_error("SensorConfig: 'batch.max_samples' must be an integer in 1.." +
+                                         std::to_string(kMaxBatchSamples) + " in " + path);
+            }
+            batch.maxSamples = samples.get<std::size_t>();
+        }
+
+        if (batchJson.contains("max_bytes")) {
+            const auto& bytes = batchJson.at("max_bytes");
+            if (!bytes.is_number_unsigned() || bytes.get<std::uint64_t>() > kMaxBatchBytes) {
+                throw std::runtime_error("SensorConfig: 'batch.max_bytes' must be an integer in 0.." +
+                                         std::to_string(kMaxBatchBytes) + " in " + path);
+            }
+            batch.maxBytes = bytes.get<std::size_t>();
+        }
+
+        if (batchJson.contains("linger_ms")) {
+            const auto& linger = batchJson.at("linger_ms");
+            if (!linger.is_number_unsigned() ||
+                linger.get<std::uint64_t>() > static_cast<std::uint64_t>(kMaxInterval.count() / 1000)) {
+                throw std::runtime_error("SensorConfig: 'batch.linger_ms' must be a non-negative integer in " + path);
+            }
+            batch.linger = std::chrono::milliseconds(linger.get<std::int64_t>());
+        }
+    }
+
+    // Snapshot formats OpenCV is asked to encode (see SnapshotWriter).
+    bool isSnapshotFormat(const std::string& format) {
+        return StringUtils::iequals(format, "jpg") || StringUtils::iequals(format, "jpeg") ||
+               StringUtils::iequals(format, "png") || StringUtils::iequals(format, "bmp");
+    }
+
+    // Helper to read the optional "snapshot" object of a sensor config
+    void readSnapshotConfigIfPresent(const json& jsonConfig, SnapshotConfig& snapshot, const std::string& path) {
+
+        if (!jsonConfig.contains("snapshot")) {
+            return;
+        }
+
+        const auto& snapshotJson = jsonConfig.at("snapshot");
+        if (!snapshotJson.is_object()) {
+            throw std::runtime_error("SensorConfig: 'snapshot' must be an object in " + path);
+        }
+
+        if (snapshotJson.contains("enabled")) {
+            if (!snapshotJson.at("enabled").is_boolean()) {
+                throw std::runtime_error("SensorConfig: 'snapshot.enabled' must be a boolean in " + path);
+            }
+            snapshot.enabled = snapshotJson.at("enabled").get<bool>();
+        }
+
+        if (snapshotJson.contains("path")) {
+            const auto& pathJson = snapshotJson.at("path");
+            if (!pathJson.is_string() || pathJson.get<std::string>().empty()) {
+                throw std::runtime_error("SensorConfig: 'snapshot.path' must be a non-empty string in " + path);
+            }
+            snapshot.path = pathJson.get<std::string>();
+
+            // Without an explicit format, follow the file extension.
+            const auto dot = snapshot.path.find_last_of('.');
+            if (dot != std::string::npos && isSnapshotFormat(snapshot.path.substr(dot + 1))) {
+                snapshot.format = StringUtils::toLower(snapshot.path.substr(dot + 1));
+            }
+        }
+
+        if (snapshotJson.contains("format")) {
+            const auto& format = snapshotJson.at("format");
+            if (!format.is_string() || !isSnapshotFormat(format.get<std::string>())) {
+                throw std::runtime_error("SensorConfig: 'snapshot.format' must be one of jpg, png, bmp in " + path);
+            }
+            snapshot.format = StringUtils::toLower(format.get<std::string>());
+        }
+
+        if (snapshotJson.contains("jpeg_quality")) {
+            const auto& quality = snapshotJson.at("jpeg_quality");
+            if (!quality.is_number_integer() || quality.get<int>() < 1 || quality.get<int>() > 100) {
+                throw std::runtime_error("SensorConfig: 'snapshot.jpeg_quality' must be an integer in 1..100 in " + path);
+            }
+            snapshot.jpegQuality = quality.get<int>();
+        }
+
+        if (snapshotJson.contains("every_frames")) {
+            const auto& frames = snapshotJson.at("every_frames");
+            if (!frames.is_number_unsigned() || frames.get<std::uint64_t>() > std::numeric_limits<std::uint32_t>::max()) {
+                throw std::runtime_error("SensorConfig: 'snapshot.every_frames' must be a non-negative integer in " + path);
+            }
+            snapshot.everyFrames = frames.get<std::uint32_t>();
+        }
+
+        if (snapshotJson.contains("every_seconds")) {
+            const auto& seconds = snapshotJson.at("every_seconds");
+            if (!seconds.is_number() || !(seconds.get<double>() >= 0.0) ||
+                seconds.get<double>() * 1e6 > static_cast<double>(kMaxInterval.count())) {
+                throw std::runtime_error("SensorConfig: 'snapshot.every_seconds' must be a number in 0..86400 in " + path);
+            }
+            snapshot.every = std::chrono::milliseconds(std::llround(seconds.get<double>() * 1e3));
+        }
+
+        if (snapshot.enabled && snapshot.everyFrames == 0 && snapshot.every == std::chrono::milliseconds::zero()) {
+            throw std::runtime_error("SensorConfig: enabled 'snapshot' needs 'every_frames' or 'every_seconds' in " + path);
+        }
+    }
+
+    // Largest accepted decimation step.
+    constexpr int kMaxSamplingStep = 64;
+
+    int readSamplingStep(const json& samplingJson, const char* fieldName, const std::string& path) {
+        if (!samplingJson.contains(fieldName)) {
+            return 1;
+        }
+        const auto& step = samplingJson.at(fieldName);
+        if (!step.is_number_integer() || step.get<std::int64_t>() < 1 || step.get<std::int64_t>() > kMaxSamplingStep) {
+            throw std::runtime_error(std::string("SensorConfig: 'sampling.") + fieldName + "' must be an integer in 1.." +
+                                     std::to_string(kMaxSamplingStep) + " in " + path);
+        }
+        return step.get<int>();
+    }
+
+    RegionOfInterest parseRegion(const json& regionJson, std::size_t index, const std::string& path) {
+
+        const std::string prefix = "SensorConfig: 'sampling.regions[" + std::to_string(index) + "]";
+        if (!regionJson.is_object()) {
+            throw std::runtime_error(prefix + "' must be an object in " + path);
+        }
+
+        RegionOfInterest region;
+        if (!regionJson.contains("name") || !regionJson.at("name").is_string() ||
+            regionJson.at("name").get<std::string>().empty()) {
+            throw std::runtime_error(prefix + ".name' must be a non-empty string in " + path);
+        }
+        region.name = regionJson.at("name").get<std::string>();
+
+        auto readCoordinate = [&](const char* fieldName, int minimum) {
+            if (!regionJson.contains(fieldName) || !regionJson.at(fieldName).is_number_integer() ||
+                regionJson.at(fieldName).get<std::int64_t>() < minimum ||
+                regionJson.at(fieldName).get<std::int64_t>() > std::numeric_limits<int>::max()) {
+                throw std::runtime_error(prefix + "." + fieldName + "' must be an integer >= " +
+                                         std::to_string(minimum) + " in " + path);
+            }
+            return regionJson.at(fieldName).get<int>();
+        };
+        region.x      = readCoordinate("x", 0);
+        region.y      = readCoordinate("y", 0);
+        region.width  = readCoordinate("width", 1);
+        region.height = readCoordinate("height", 1);
+        return region;
+    }
+
+    // Helper to read the optional "sampling" object (decimation + regions of interest)
+    void readSamplingConfigIfPresent(const json& jsonConfig, FrameSamplingConfig& sampling, const std::string& path) {
+
+        if (!jsonConfig.contains("sampling")) {
+            return;
+        }
+
+        const auto& samplingJson = jsonConfig.at("sampling");
+        if (!samplingJson.is_object()) {
+            throw std::runtime_error("SensorConfig: 'sampling' must be an object in " + path);
+        }
+
+        sampling.rowStep = readSamplingStep(samplingJson, "row_step", path);
+        sampling.colStep = readSamplingStep(samplingJson, "col_step", path);
+
+        if (samplingJson.contains("regions")) {
+            const auto& regions = samplingJson.at("regions");
+            if (!regions.is_array()) {
+                throw std::runtime_error("SensorConfig: 'sampling.regions' must be an array in " + path);
+            }
+            sampling.regions.clear();
+            for (std::size_t idx = 0; idx < regions.size(); ++idx) {
+                RegionOfInterest region = parseRegion(regions.at(idx), idx, path);
+                for (const auto& existing : sampling.regions) {
+                    if (existing.name == region.name) {
+                        throw std::runtime_error("SensorConfig: duplicate region name '" + region.name +
+                                                 "' in " + path);
+                    }
+                }
+                sampling.regions.push_back(std::move(region));
+            }
+        }
+    }
+
+    // Helper to read one required number field of a metric rule
+    double readRuleNumber(const json& ruleJson, const std::string& prefix, const char* fieldName,
+                          const std::string& path) {
+        if (!ruleJson.at(fieldName).is_number()) {
+            throw std::runtime_error(prefix + "." + fieldName + "' must be a number in " + path);
+        }
+        const double value = ruleJson.at(fieldName).get<double>();
+        if (!std::isfinite(value)) {
+            throw std::runtime_error(prefix + "." + fieldName + "' must be finite in " + path);
+        }
+        return value;
+    }
+
+    // Helper to parse one metric rule: { "value": V } or { "min": A, "max": B, "bad_probability": P }
+    MetricRule parseMetricRule(const json& ruleJson, const std::string& name, const std::string& path) {
+
+        const std::string prefix = "DataSourceConfig: 'limits." + name;
+        if (!ruleJson.is_object()) {
+            throw std::runtime_error(prefix + "' must be an object in " + path);
+        }
+
+        MetricRule rule;
+
+        if (ruleJson.contains("value")) {
+            rule.hasFixed = true;
+            rule.fixed = readRuleNumber(ruleJson, prefix, "value", path);
+        }
+
+        const bool hasMin = ruleJson.contains("min");
+        const bool hasMax = ruleJson.contains("max");
+        if (hasMin != hasMax) {
+            throw std::runtime_error(prefix + "' needs both 'min' and 'max' in " + path);
+        }
+        if (hasMin) {
+            rule.hasRange = true;
+            rule.min = readRuleNumber(ruleJson, prefix, "min", path);
+            rule.max = readRuleNumber(ruleJson, prefix, "max", path);
+            if (rule.min > rule.max) {
+                throw std::runtime_error(prefix + "' has 'min' greater than 'max' in " + path);
+            }
+        }
+
+        if (rule.hasFixed == rule.hasRange) {
+            throw std::runtime_error(prefix + "' must have either 'value' or 'min'/'max' in " + path);
+        }
+
+        if (ruleJson.contains("bad_probability")) {
+            if (!rule.hasRange) {
+                throw std::runtime_error(prefix + ".bad_probability' requires 'min'/'max' in " + path);
+            }
+            rule.badProbability = readRuleNumber(ruleJson, prefix, "bad_probability", path);
+            if (rule.badProbability < 0.0 || rule.badProbability > 1.0) {
+                throw std::runtime_error(prefix + ".bad_probability' out of range (0..1) in " + path);
+            }
+        }
+
+        return rule;
+    }
+
+    // Optional non-blocking mode, timeouts and send buffer of the "tcp" object.
+    void readTcpOptions(const json& tcp, TcpOptions& options, const std::string& path) {
+
+        if (tcp.contains("non_blocking")) {
+            if (!tcp.at("non_blocking").is_boolean()) {
+                throw std::runtime_error("TransportConfig: 'tcp.non_blocking' must be a boolean in " + path);
+            }
+            options.nonBlocking = tcp.at("non_blocking").get<bool>();
+        }
+
+        const auto readMillis = [&](const char* key, std::chrono::milliseconds& out) {
+            if (!tcp.contains(key)) {
+                return;
+            }
+            const auto& millis = tcp.at(key);
+            if (!millis.is_number_unsigned() ||
+                millis.get<std::uint64_t>() > static_cast<std::uint64_t>(kMaxInterval.count() / 1000)) {
+                throw std::runtime_error(std::string("TransportConfig: 'tcp.") + key +
+                                         "' must be a non-negative integer in " + path);
+            }
+            out = std::chrono::milliseconds(millis.get<std::int64_t>());
+        };
+        readMillis("connect_timeout_ms", options.connectTimeout);
+        readMillis("write_timeout_ms", options.writeTimeout);
+
+        const auto readBytes = [&](const char* key, std::size_t& out) {
+            if (!tcp.contains(key)) {
+                return;
+            }
+            const auto& bytes = tcp.at(key);
+            if (!bytes.is_number_unsigned() || bytes.get<std::uint64_t>() > kMaxTcpSendBuffer) {
+                throw std::runtime_error(std::string("TransportConfig: 'tcp.") + key + "' must be an integer in 0.." +
+                                         std::to_string(kMaxTcpSendBuffer) + " in " + path);
+            }
+            out = bytes.get<std::size_t>();
+        };
+        readBytes("send_buffer_bytes", options.sendBufferBytes);
+        readBytes("high_water_mark", options.highWaterMark);
+        readBytes("low_water_mark", options.lowWaterMark);
+
+        // Water marks default relative to the buffer when only its size is given.
+        if (tcp.contains("send_buffer_bytes") && !tcp.contains("high_water_mark")) {
+            options.highWaterMark = options.sendBufferBytes / 4 * 3;
+        }
+        if (tcp.contains("send_buffer_bytes") && !tcp.contains("low_water_mark")) {
+            options.lowWaterMark = options.sendBufferBytes / 4;
+        }
+
+        if (options.nonBlocking &&
+            (options.highWaterMark == 0 || options.highWaterMark > options.sendBufferBytes ||
+             options.lowWaterMark > options.highWaterMark)) {
+            throw std::runtime_error("TransportConfig: need 'tcp.low_water_mark' <= 'tcp.high_water_mark' <= "
+                                     "'tcp.send_buffer_bytes', high water > 0, in " + path);
+        }
+    }
+
     void parseTcpJsonObject(const json& jsonObject, TransportConfig& cfg, const std::string& path) {
 
         if (!jsonObject.contains("tcp") || !jsonObject["tcp"].is_object()) {
@@ -83,6 +679,8 @@ namespace {
 
         cfg.host = tcp["host"].get<std::string>();
         cfg.port = tcp["port"].get<uint16_t>();
+
+        readTcpOptions(tcp, cfg.tcp, path);
     }
 
     void parseUdpJsonObject(const json& jsonObject, TransportConfig& cfg, const std::string& path) {
@@ -107,6 +705,368 @@ namespace {
         cfg.port = udp["port"].get<uint16_t>();
     }
 
+    // "unix": { "path", "type": "stream" | "dgram", "send_credentials",
+    // "peer_uid", "write_timeout_ms" }; only "path" is required. A path
+    // starting with '@' is in the abstract namespace.
+    void parseUnixJsonObject(const json& jsonObject, TransportConfig& cfg, const std::string& path) {
+
+        if (!jsonObject.contains("unix") || !jsonObject["unix"].is_object()) {
+            throw std::runtime_error("TransportConfig: missing 'unix' object for kind='unix' in " + path);
+        }
+        const auto& unixJson = jsonObject["unix"];
+        UnixOptions& options = cfg.unixSocket;
+
+        if (!unixJson.contains("path") || !unixJson["path"].is_string() ||
+            unixJson["path"].get<std::string>().size() < 2) {
+            throw std::runtime_error("TransportConfig: missing or invalid 'unix.path' in " + path);
+        }
+        options.path = unixJson["path"].get<std::string>();
+        if (options.path.size() > kMaxUnixPath) {
+            throw std::runtime_error("TransportConfig: 'unix.path' longer than " + std::to_string(kMaxUnixPath) +
+                                     " bytes in " + path);
+        }
+
+        if (unixJson.contains("type")) {
+            const auto& type = unixJson["type"];
+            if (!type.is_string() || (type.get<std::string>() != "stream" && type.get<std::string>() != "dgram")) {
+                throw std::runtime_error("TransportConfig: 'unix.type' must be \"stream\" or \"dgram\" in " + path);
+            }
+            options.datagram = type.get<std::string>() == "dgram";
+        }
+        if (unixJson.contains("send_credentials")) {
+            if (!unixJson["send_credentials"].is_boolean()) {
+                throw std::runtime_error("TransportConfig: 'unix.send_credentials' must be a boolean in " + path);
+            }
+            options.sendCredentials = unixJson["send_credentials"].get<bool>();
+        }
+        if (unixJson.contains("peer_uid")) {
+            const auto& uid = unixJson["peer_uid"];
+            if (!uid.is_number_unsigned() || uid.get<std::uint64_t>() > std::numeric_limits<std::uint32_t>::max()) {
+                throw std::runtime_error("TransportConfig: 'unix.peer_uid' must be a user id in " + path);
+            }
+            if (options.datagram) {
+                throw std::runtime_error("TransportConfig: 'unix.peer_uid' needs \"type\": \"stream\" in " + path);
+            }
+            options.peerUid = uid.get<std::uint32_t>();
+        }
+        if (unixJson.contains("write_timeout_ms")) {
+            const auto& millis = unixJson["write_timeout_ms"];
+            if (!millis.is_number_unsigned() ||
+                millis.get<std::uint64_t>() > static_cast<std::uint64_t>(kMaxInterval.count() / 1000)) {
+                throw std::runtime_error("TransportConfig: 'unix.write_timeout_ms' must be a non-negative integer in " +
+                                         path);
+            }
+            options.writeTimeout = std::chrono::milliseconds(millis.get<std::int64_t>());
+        }
+    }
+
+    // "shm": { "name", "capacity_bytes", "write_timeout_ms" }; all optional.
+    void parseShmJsonObject(const json& jsonObject, TransportConfig& cfg, const std::string& path) {
+
+        if (!jsonObject.contains("shm")) {
+            return;
+        }
+        const auto& shm = jsonObject["shm"];
+        if (!shm.is_object()) {
+            throw std::runtime_error("TransportConfig: 'shm' must be an object in " + path);
+        }
+
+        if (shm.contains("name")) {
+            const auto& name = shm["name"];
+            if (!name.is_string() || name.get<std::string>().size() < 2 || name.get<std::string>().front() != '/' ||
+                name.get<std::string>().find('/', 1) != std::string::npos) {
+                throw std::runtime_error("TransportConfig: 'shm.name' must be '/' followed by a name without "
+                                         "further '/' in " + path);
+            }
+            cfg.shm.name = name.get<std::string>();
+        }
+        if (shm.contains("capacity_bytes")) {
+            const auto& capacity = shm["capacity_bytes"];
+            if (!capacity.is_number_unsigned() || capacity.get<std::uint64_t>() > kMaxShmCapacity) {
+                throw std::runtime_error("TransportConfig: 'shm.capacity_bytes' must be an integer in 0.." +
+                                         std::to_string(kMaxShmCapacity) + " in " + path);
+            }
+            cfg.shm.capacityBytes = capacity.get<std::size_t>();
+        }
+        if (shm.contains("write_timeout_ms")) {
+            const auto& millis = shm["write_timeout_ms"];
+            if (!millis.is_number_unsigned() ||
+                millis.get<std::uint64_t>() > static_cast<std::uint64_t>(kMaxInterval.count() / 1000)) {
+                throw std::runtime_error("TransportConfig: 'shm.write_timeout_ms' must be a non-negative integer in " +
+                                         path);
+            }
+            cfg.shm.writeTimeout = std::chrono::milliseconds(millis.get<std::int64_t>());
+        }
+    }
+
+    // Optional "reconnect.spool": { "enabled", "directory", "segment_bytes",
+    // "max_bytes", "max_age_ms", "sync_interval_ms" }.
+    void readSpoolConfigIfPresent(const json& reconnectJson, SpoolConfig& spool, const std::string& path) {
+
+        if (!reconnectJson.contains("spool")) {
+            return;
+        }
+
+        const auto& spoolJson = reconnectJson.at("spool");
+        if (!spoolJson.is_object()) {
+            throw std::runtime_error("TransportConfig: 'reconnect.spool' must be an object in " + path);
+        }
+
+        if (spoolJson.contains("enabled")) {
+            if (!spoolJson.at("enabled").is_boolean()) {
+                throw std::runtime_error("TransportConfig: 'reconnect.spool.enabled' must be a boolean in " + path);
+            }
+            spool.enabled = spoolJson.at("enabled").get<bool>();
+        }
+        if (spoolJson.contains("directory")) {
+            const auto& directory = spoolJson.at("directory");
+            if (!directory.is_string() || directory.get<std::string>().empty()) {
+                throw std::runtime_error("TransportConfig: 'reconnect.spool.directory' must be a non-empty string in " +
+                                         path);
+            }
+            spool.directory = directory.get<std::string>();
+        }
+
+        const auto readBytes = [&](const char* key, std::size_t& out) {
+            if (!spoolJson.contains(key)) {
+                return;
+            }
+            const auto& bytes = spoolJson.at(key);
+            if (!bytes.is_number_unsigned() || bytes.get<std::uint64_t>() > kMaxSpoolBytes) {
+                throw std::runtime_error(std::string("TransportConfig: 'reconnect.spool.") + key +
+                                         "' must be an integer in 0.." + std::to_string(kMaxSpoolBytes) + " in " + path);
+            }
+            out = bytes.get<std::size_t>();
+        };
+        readBytes("segment_bytes", spool.segmentBytes);
+        readBytes("max_bytes", spool.maxBytes);
+
+        const auto readMillis = [&](const char* key, std::chrono::milliseconds& out) {
+            if (!spoolJson.contains(key)) {
+                return;
+            }
+            const auto& millis = spoolJson.at(key);
+            if (!millis.is_number_unsigned() ||
+                millis.get<std::uint64_t>() > static_cast<std::uint64_t>(kMaxSpoolAge.count())) {
+                throw std::runtime_error(std::string("TransportConfig: 'reconnect.spool.") + key +
+                                         "' must be a non-negative integer in " + path);
+            }
+            out = std::chrono::milliseconds(millis.get<std::int64_t>());
+        };
+        readMillis("max_age_ms", spool.maxAge);
+        readMillis("sync_interval_ms", spool.syncInterval);
+
+        if (spool.segmentBytes <= DiskSpool::kHeaderSize || spool.maxBytes < spool.segmentBytes) {
+            throw std::runtime_error("TransportConfig: need " + std::to_string(DiskSpool::kHeaderSize) +
+                                     " < 'reconnect.spool.segment_bytes' <= 'reconnect.spool.max_bytes' in " + path);
+        }
+    }
+
+    // Optional "reconnect": { "enabled", "initial_backoff_ms", "max_backoff_ms",
+    // "max_attempts", "attempt_window_ms", "queue_samples", "replay_rate",
+    // "spool" }.
+    void readReconnectConfigIfPresent(const json& jsonObject, ReconnectConfig& reconnect, const std::string& path) {
+
+        if (!jsonObject.contains("reconnect")) {
+            return;
+        }
+
+        const auto& reconnectJson = jsonObject.at("reconnect");
+        if (!reconnectJson.is_object()) {
+            throw std::runtime_error("TransportConfig: 'reconnect' must be an object in " + path);
+        }
+
+        if (reconnectJson.contains("enabled")) {
+            if (!reconnectJson.at("enabled").is_boolean()) {
+                throw std::runtime_error("TransportConfig: 'reconnect.enabled' must be a boolean in " + path);
+            }
+            reconnect.enabled = reconnectJson.at("enabled").get<bool>();
+        }
+
+        const auto readMillis = [&](const char* key, std::chrono::milliseconds& out) {
+            if (!reconnectJson.contains(key)) {
+                return;
+            }
+            const auto& millis = reconnectJson.at(key);
+            if (!millis.is_number_unsigned() ||
+                millis.get<std::uint64_t>() > static_cast<std::uint64_t>(kMaxInterval.count() / 1000)) {
+                throw std::runtime_error(std::string("TransportConfig: 'reconnect.") + key +
+                                         "' must be a non-negative integer in " + path);
+            }
+            out = std::chrono::milliseconds(millis.get<std::int64_t>());
+        };
+        readMillis("initial_backoff_ms", reconnect.initialBackoff);
+        readMillis("max_backoff_ms", reconnect.maxBackoff);
+        readMillis("attempt_window_ms", reconnect.attemptWindow);
+
+        if (reconnectJson.contains("max_attempts")) {
+            const auto& attempts = reconnectJson.at("max_attempts");
+            if (!attempts.is_number_unsigned() || attempts.get<std::uint64_t>() == 0 ||
+                attempts.get<std::uint64_t>() > kMaxReconnectAttempts) {
+                throw std::runtime_error("TransportConfig: 'reconnect.max_attempts' must be an integer in 1.." +
+                                         std::to_string(kMaxReconnectAttempts) + " in " + path);
+            }
+            reconnect.maxAttempts = attempts.get<std::uint32_t>();
+        }
+
+        if (reconnectJson.contains("queue_samples")) {
+            const auto& samples = reconnectJson.at("queue_samples");
+            if (!samples.is_number_unsigned() || samples.get<std::uint64_t>() > kMaxReconnectQueue) {
+                throw std::runtime_error("TransportConfig: 'reconnect.queue_samples' must be an integer in 0.." +
+                                         std::to_string(kMaxReconnectQueue) + " in " + path);
+            }
+            reconnect.queueSamples = samples.get<std::size_t>();
+        }
+
+        if (reconnectJson.contains("replay_rate")) {
+            const auto& rate = reconnectJson.at("replay_rate");
+            if (!rate.is_number_unsigned() || rate.get<std::uint64_t>() > kMaxReplayRate) {
+                throw std::runtime_error("TransportConfig: 'reconnect.replay_rate' must be an integer in 0.." +
+                                         std::to_string(kMaxReplayRate) + " in " + path);
+            }
+            reconnect.replayRate = rate.get<std::uint32_t>();
+        }
+
+        readSpoolConfigIfPresent(reconnectJson, reconnect.spool, path);
+
+        if (reconnect.initialBackoff.count() == 0 || reconnect.maxBackoff < reconnect.initialBackoff) {
+            throw std::runtime_error("TransportConfig: need 0 < 'reconnect.initial_backoff_ms' <= "
+                                     "'reconnect.max_backoff_ms' in " + path);
+        }
+    }
+
+    // "payload_format": "json" | "cbor" | "msgpack" | "binary" (std::nullopt if absent).
+    // 'owner' names the config in error messages ("SensorConfig", "TransportConfig").
+    std::optional<PayloadFormat> readPayloadFormatIfPresent(const json& jsonObject, const char* owner,
+                                                            const std::string& path) {
+        if (!jsonObject.contains("payload_format")) {
+            return std::nullopt;
+        }
+        const auto& format = jsonObject["payload_format"];
+        if (!format.is_string()) {
+            throw std::runtime_error(std::string(owner) + ": 'payload_format' must be a string in " + path);
+        }
+
+        const auto formatName = format.get<std::string>();
+        if (StringUtils::iequals(formatName, "json")) {
+            return PayloadFormat::JSON;
+        }
+        if (StringUtils::iequals(formatName, "cbor")) {
+            return PayloadFormat::CBOR;
+        }
+        if (StringUtils::iequals(formatName, "msgpack")) {
+            return PayloadFormat::MSGPACK;
+        }
+        if (StringUtils::iequals(formatName, "binary")) {
+            return PayloadFormat::BINARY;
+        }
+        throw std::runtime_error(std::string(owner) + ": unsupported 'payload_format' '" + formatName +
+                                 "' in " + path);
+    }
+
+    TransportConfig parseTransportJsonObject(const json& jsonObject, const std::string& path);
+
+    // "fanout": { "queue": { "depth", "policy" }, "sinks": [ { "name", "queue", <transport> }, ... ] }.
+    // Each sink is a complete transport object (kind, its options, "reconnect");
+    // "queue" defaults to the fan-out's own, which defaults to 256 / drop_oldest.
+    void parseFanoutJsonObject(const json& jsonObject, TransportConfig& cfg, const std::string& path) {
+
+        if (!jsonObject.contains("fanout") || !jsonObject["fanout"].is_object()) {
+            throw std::runtime_error("TransportConfig: missing 'fanout' object for kind='fanout' in " + path);
+        }
+        const auto& fanout = jsonObject["fanout"];
+        if (jsonObject.contains("reconnect")) {
+            throw std::runtime_error("TransportConfig: 'reconnect' goes on each fan-out sink, not on the fan-out, in " +
+                                     path);
+        }
+
+        PipelineQueueConfig defaultQueue{256, QueuePolicy::DROP_OLDEST};
+        readQueueConfigIfPresent(fanout, "queue", "TransportConfig: 'fanout.", defaultQueue, path);
+        if (defaultQueue.policy == QueuePolicy::BLOCK) {
+            throw std::runtime_error("TransportConfig: 'fanout.queue.policy' cannot be 'block' (one slow sink would "
+                                     "stall all) in " + path);
+        }
+
+        if (!fanout.contains("sinks") || !fanout["sinks"].is_array() || fanout["sinks"].empty() ||
+            fanout["sinks"].size() > kMaxFanoutSinks) {
+            throw std::runtime_error("TransportConfig: 'fanout.sinks' must be an array of 1.." +
+                                     std::to_string(kMaxFanoutSinks) + " transports in " + path);
+        }
+
+        for (std::size_t idx = 0; idx < fanout["sinks"].size(); ++idx) {
+            const auto& sinkJson = fanout["sinks"][idx];
+            const std::string where = "TransportConfig: 'fanout.sinks[" + std::to_string(idx) + "]";
+            if (!sinkJson.is_object()) {
+                throw std::runtime_error(where + "' must be an object in " + path);
+            }
+            if (sinkJson.contains("kind") && sinkJson["kind"] == "fanout") {
+                throw std::runtime_error(where + "' cannot be a fan-out in " + path);
+            }
+            if (sinkJson.contains("payload_format")) {
+                throw std::runtime_error(where + "' cannot set 'payload_format' (payloads are encoded once) in " + path);
+            }
+
+            FanoutSinkConfig sink;
+            sink.name = "sink" + std::to_string(idx);
+            if (sinkJson.contains("name")) {
+                if (!sinkJson["name"].is_string() || sinkJson["name"].get<std::string>().empty()) {
+                    throw std::runtime_error(where + ".name' must be a non-empty string in " + path);
+                }
+                sink.name = sinkJson["name"].get<std::string>();
+            }
+            sink.queue = defaultQueue;
+            readQueueConfigIfPresent(sinkJson, "queue", where + ".", sink.queue, path);
+            if (sink.queue.policy == QueuePolicy::BLOCK) {
+                throw std::runtime_error(where + ".queue.policy' cannot be 'block' (one slow sink would stall all) in " +
+                                         path);
+            }
+            sink.transport = parseTransportJsonObject(sinkJson, path);
+            cfg.sinks.push_back(std::move(sink));
+        }
+    }
+
+    // One transport object: a whole transport config file, or one fan-out sink.
+    TransportConfig parseTransportJsonObject(const json& jsonObject, const std::string& path) {
+
+        if (!jsonObject.contains("kind") || !jsonObject["kind"].is_string()) {
+            throw std::runtime_error("TransportConfig: missing or invalid 'kind' in " + path);
+        }
+
+        TransportConfig cfg;
+        cfg.kind = jsonObject["kind"].get<std::string>();
+
+        if (cfg.kind == "tcp") {
+
+            parseTcpJsonObject(jsonObject, cfg, path);
+
+        } else if (cfg.kind == "udp") {
+
+            parseUdpJsonObject(jsonObject, cfg, path);
+
+        } else if (cfg.kind == "unix") {
+
+            parseUnixJsonObject(jsonObject, cfg, path);
+
+        } else if (cfg.kind == "shm") {
+
+            parseShmJsonObject(jsonObject, cfg, path);
+
+        } else if (cfg.kind == "fanout") {
+
+            parseFanoutJsonObject(jsonObject, cfg, path);
+
+        } else {
+            throw std::runtime_error("TransportConfig: unsupported kind '" + cfg.kind + "' in " + path);
+        }
+
+        // payload_format (optional): overrides the sensor's own choice for this link
+        cfg.payloadFormat = readPayloadFormatIfPresent(jsonObject, "TransportConfig", path);
+
+        // reconnect (optional): survive collector restarts instead of exiting
+        readReconnectConfigIfPresent(jsonObject, cfg.reconnect, path);
+
+        return cfg;
+    }
 
 } // namespace
 
@@ -123,22 +1083,48 @@ SensorConfig ConfigLoader::loadSensorConfig(const std::string& path) {
     }
     cfg.sensorId = jsonObject["sensor_id"].get<std::string>();
 
-    // interval_seconds (optional int, default 1)
-    if (jsonObject.contains("interval_seconds")) {
-        if (!jsonObject["interval_seconds"].is_number_integer()) {
-            throw std::runtime_error("SensorConfig: 'interval_seconds' must be an integer in " +
-                                     path);
-        }
+    // interval_seconds | interval_ms | interval_us (optional, default 1 second)
+    cfg.interval = readInterval(jsonObject, path);
 
-        if (jsonObject["interval_seconds"] <= 0) {
-            throw std::runtime_error("SensorConfig: 'interval_seconds' must be > 0 in " + path);
+    // overrun_policy (optional string: "skip" | "catch_up", default "skip")
+    if (jsonObject.contains("overrun_policy")) {
+        const auto& policy = jsonObject["overrun_policy"];
+        if (!policy.is_string()) {
+            throw std::runtime_error("SensorConfig: 'overrun_policy' must be a string in " + path);
         }
 
-        cfg.intervalSeconds = jsonObject["interval_seconds"].get<int32_t>();
-    } else {
-        cfg.intervalSeconds = 1;
+        const auto policyName = policy.get<std::string>();
+        if (StringUtils::iequals(policyName, "skip")) {
+            cfg.overrunPolicy = OverrunPolicy::SKIP;
+        } else if (StringUtils::iequals(policyName, "catch_up")) {
+            cfg.overrunPolicy = OverrunPolicy::CATCH_UP;
+        } else {
+            throw std::runtime_error("SensorConfig: unsupported 'overrun_policy' '" + policyName +
+                                     "' in " + path);
+        }
     }
 
+    // payload_format (optional, default "json")
+    cfg.payloadFormat = readPayloadFormatIfPresent(jsonObject, "SensorConfig", path).value_or(PayloadFormat::JSON);
+
+    // Optional metric-ID dictionary mode (off by default)
+    readMetricIdConfigIfPresent(jsonObject, cfg.metricIds, path);
+
+    // Optional batching of several samples per send
+    readBatchConfigIfPresent(jsonObject, cfg.batch, path);
+
+    // Optional capture/encode/send pipeline
+    readPipelineConfigIfPresent(jsonObject, cfg.pipeline, path);
+
+    // Optional asynchronous logging (off by default)
+    readLoggingConfigIfPresent(jsonObject, cfg.logging, path);
+
+    // Optional asynchronous frame snapshots (off by default)
+    readSnapshotConfigIfPresent(jsonObject, cfg.snapshot, path);
+
+    // Optional decimation and regions of interest for image metrics
+    readSamplingConfigIfPresent(jsonObject, cfg.sampling, path);
+
     // Optional maps
     readStringMapIfPresent(jsonObject, "units", cfg.units);
     readStringMapIfPresent(jsonObject, "metadata", cfg.metadata);
@@ -150,25 +1136,26 @@ SensorConfig ConfigLoader::loadSensorConfig(const std::string& path) {
 
 TransportConfig ConfigLoader::loadTransportConfig(const std::string& path) {
 
-    const json jsonObject = readJsonFile(path);
-
-    if (!jsonObject.contains("kind") || !jsonObject["kind"].is_string()) {
-        throw std::runtime_error("TransportConfig: missing or invalid 'kind' in " + path);
-    }
+    return parseTransportJsonObject(readJsonFile(path), path);
+}
 
-    TransportConfig cfg;
-    cfg.kind = jsonObject["kind"].get<std::string>();
+// ---------------- Simulated data source ----------------
 
-    if (cfg.kind == "tcp") {
+DataSourceConfig ConfigLoader::loadDataSourceConfig(const std::string& path) {
 
-        parseTcpJsonObject(jsonObject, cfg, path);
+    const json jsonObject = readJsonFile(path);
 
-    } else if (cfg.kind == "udp") {
+    if (!jsonObject.contains("limits") || !jsonObject["limits"].is_object()) {
+        throw std::runtime_error("DataSourceConfig: missing or invalid 'limits' object in " + path);
+    }
 
-        parseUdpJsonObject(jsonObject, cfg, path);
+    DataSourceConfig cfg;
+    for (const auto& [name, ruleJson] : jsonObject["limits"].items()) {
+        cfg.metrics.emplace(name, parseMetricRule(ruleJson, name, path));
+    }
 
-    } else {
-        throw std::runtime_error("TransportConfig: unsupported kind '" + cfg.kind + "' in " + path);
+    if (cfg.metrics.empty()) {
+        throw std::runtime_error("DataSourceConfig: 'limits' must define at least one metric in " + path);
     }
 
     return cfg;
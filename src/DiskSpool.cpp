@@ -0,0 +1,551 @@
+/**
+ * @file DiskSpool.cpp
+ * @brief Implementation of the segmented on-disk payload spool.
+ *
+ * @see DiskSpool
+ */
+
+#include "DiskSpool.hpp"
+#include "ConfigTypes.hpp"
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/uio.h>     // writev
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>        // std::rename
+#include <cstring>       // std::strerror
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    constexpr const char* kSegmentSuffix = ".seg";
+    constexpr const char* kCursorName = "cursor";
+    constexpr const char* kCursorTmpName = "cursor.tmp";
+    constexpr std::size_t kSeqDigits = 16;
+
+    std::runtime_error systemErr(const std::string& where) {
+        return std::runtime_error("DiskSpool: " + where + ": " + std::strerror(errno));
+    }
+
+    // ----- CRC-32 (IEEE 802.3, reflected), table driven -----
+
+    constexpr std::array<std::uint32_t, 256> makeCrcTable() {
+        std::array<std::uint32_t, 256> table{};
+        for (std::uint32_t idx = 0; idx < 256; ++idx) {
+            std::uint32_t crc = idx;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1U) != 0 ? (crc >> 1U) ^ 0xEDB88320U : crc >> 1U;
+            }
+            table[idx] = crc;
+        }
+        return table;
+    }
+
+    constexpr auto kCrcTable = makeCrcTable();
+
+    std::uint32_t crcUpdate(std::uint32_t crc, const unsigned char* data, std::size_t len) {
+        for (std::size_t idx = 0; idx < len; ++idx) {
+            crc = kCrcTable[(crc ^ data[idx]) & 0xFFU] ^ (crc >> 8U);
+        }
+        return crc;
+    }
+
+    // CRC over the record's time stamp bytes followed by its payload.
+    std::uint32_t recordCrc(const unsigned char* timeBytes, const void* payload, std::size_t len) {
+        std::uint32_t crc = 0xFFFFFFFFU;
+        crc = crcUpdate(crc, timeBytes, 8);
+        crc = crcUpdate(crc, static_cast<const unsigned char*>(payload), len);
+        return crc ^ 0xFFFFFFFFU;
+    }
+
+    // ----- little-endian header fields -----
+
+    void putLe(unsigned char* out, std::uint64_t value, std::size_t bytes) {
+        for (std::size_t idx = 0; idx < bytes; ++idx) {
+            out[idx] = static_cast<unsigned char>(value >> (8U * idx));
+        }
+    }
+
+    std::uint64_t getLe(const unsigned char* in, std::size_t bytes) {
+        std::uint64_t value = 0;
+        for (std::size_t idx = 0; idx < bytes; ++idx) {
+            value |= static_cast<std::uint64_t>(in[idx]) << (8U * idx);
+        }
+        return value;
+    }
+
+    struct RecordHeader {
+        std::uint32_t length{0};
+        std::uint32_t crc{0};
+        std::int64_t  timeMs{0};
+    };
+
+    RecordHeader decodeHeader(const unsigned char* in) {
+        return RecordHeader{static_cast<std::uint32_t>(getLe(in, 4)),
+                            static_cast<std::uint32_t>(getLe(in + 4, 4)),
+                            static_cast<std::int64_t>(getLe(in + 8, 8))};
+    }
+
+    // pread exactly 'len' bytes; false on a short file.
+    bool readAt(int fd, void* out, std::size_t len, std::uint64_t offset) {
+        auto* dst = static_cast<char*>(out);
+        while (len > 0) {
+            const ssize_t got = ::pread(fd, dst, len, static_cast<off_t>(offset));
+            if (got < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw systemErr("read");
+            }
+            if (got == 0) {
+                return false;
+            }
+            dst += got;
+            len -= static_cast<std::size_t>(got);
+            offset += static_cast<std::uint64_t>(got);
+        }
+        return true;
+    }
+
+    void syncFd(int fd) {
+#ifdef __linux__
+        const int rc = ::fdatasync(fd);
+#else
+        const int rc = ::fsync(fd);
+#endif
+        if (rc != 0) {
+            throw systemErr("fsync");
+        }
+    }
+
+    // Make renames and newly created segment files durable.
+    void syncDirectory(const std::string& directory) {
+        const int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw systemErr("open " + directory);
+        }
+        ::fsync(fd);   // best effort: not every file system supports it on directories
+        ::close(fd);
+    }
+
+    void closeFd(int& fd) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    std::int64_t wallMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            DiskSpool::WallClock::now().time_since_epoch()).count();
+    }
+
+    // "0000000000000042.seg" -> 42; false for anything else in the directory.
+    bool parseSegmentName(const fs::path& path, std::uint64_t& seq) {
+        const std::string name = path.filename().string();
+        if (name.size() != kSeqDigits + std::strlen(kSegmentSuffix) || path.extension() != kSegmentSuffix) {
+            return false;
+        }
+        seq = 0;
+        for (std::size_t idx = 0; idx < kSeqDigits; ++idx) {
+            if (name[idx] < '0' || name[idx] > '9') {
+                return false;
+            }
+            seq = seq * 10U + static_cast<std::uint64_t>(name[idx] - '0');
+        }
+        return true;
+    }
+}
+
+// ----- ctor / dtor -----
+
+DiskSpool::DiskSpool(const SpoolConfig& config)
+    : config_(config)
+{
+    if (config_.directory.empty()) {
+        throw std::invalid_argument("DiskSpool: directory must not be empty");
+    }
+    if (config_.segmentBytes <= kHeaderSize || config_.maxBytes < config_.segmentBytes) {
+        throw std::invalid_argument("DiskSpool: need header size < segment bytes <= max bytes");
+    }
+    if (config_.maxAge.count() < 0 || config_.syncInterval.count() < 0) {
+        throw std::invalid_argument("DiskSpool: max age and sync interval must not be negative");
+    }
+
+    std::error_code error;
+    fs::create_directories(config_.directory, error);
+    if (error) {
+        throw std::runtime_error("DiskSpool: cannot create " + config_.directory + ": " + error.message());
+    }
+    recover();
+    lastSync_ = std::chrono::steady_clock::now();
+}
+
+DiskSpool::~DiskSpool() {
+    try {
+        if (dirty_) {
+            sync();
+        }
+    } catch (const std::exception&) {
+        // Nothing sensible to do while shutting down; recovery copes.
+    }
+    closeFd(writeFd_);
+    closeFd(readFd_);
+}
+
+// ----- recovery -----
+
+void DiskSpool::recover() {
+    std::vector<std::uint64_t> seqs;
+    for (const auto& entry : fs::directory_iterator(config_.directory)) {
+        std::uint64_t seq = 0;
+        if (entry.is_regular_file() && parseSegmentName(entry.path(), seq)) {
+            seqs.push_back(seq);
+        }
+    }
+    std::sort(seqs.begin(), seqs.end());
+
+    std::uint64_t cursorSeq = 0;
+    std::uint64_t cursorOffset = 0;
+    {
+        std::ifstream cursor(fs::path(config_.directory) / kCursorName);
+        if (!(cursor >> cursorSeq >> cursorOffset)) {
+            cursorSeq = 0;
+            cursorOffset = 0;
+        }
+    }
+
+    nextSeq_ = cursorSeq;
+    for (const std::uint64_t seq : seqs) {
+        nextSeq_ = std::max(nextSeq_, seq + 1);
+        if (seq < cursorSeq) {
+            fs::remove(segmentPath(seq));   // fully replayed before the crash
+            continue;
+        }
+
+        Segment segment{seq, 0, 0, 0};
+        std::uint64_t firstUnread = 0;
+        std::uint64_t recordsBefore = 0;
+        scanSegment(segment, seq == cursorSeq ? cursorOffset : 0, firstUnread, recordsBefore);
+        if (segment.records == recordsBefore) {
+            fs::remove(segmentPath(seq));   // empty, or nothing left to replay
+            continue;
+        }
+        if (segments_.empty()) {
+            readOffset_ = firstUnread;
+            readRecords_ = recordsBefore;
+        }
+        segments_.push_back(segment);
+        records_ += segment.records - (segments_.size() == 1 ? recordsBefore : 0);
+        bytes_ += segment.bytes;
+    }
+
+    stats_.recovered = records_;
+    if (!segments_.empty()) {
+        readSeq_ = segments_.front().seq;
+        openForAppend();
+    }
+}
+
+// Validates the records of one segment and cuts off a torn or corrupt tail.
+// 'firstUnread' is the first record boundary at or after 'cursorOffset' (a
+// cursor inside a record rounds up) and 'recordsBefore' the number of
+// records before it.
+void DiskSpool::scanSegment(Segment& segment, std::uint64_t cursorOffset, std::uint64_t& firstUnread,
+                            std::uint64_t& recordsBefore) {
+    const std::string path = segmentPath(segment.seq);
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw systemErr("open " + path);
+    }
+
+    // Segments are a few MiB: read each in one go and parse it in memory.
+    const std::uint64_t size = fs::file_size(path);
+    std::vector<unsigned char> data(static_cast<std::size_t>(size));
+    bool complete = false;
+    try {
+        complete = readAt(fd, data.data(), data.size(), 0);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+    if (!complete) {
+        throw std::runtime_error("DiskSpool: segment " + path + " shrank while reading it");
+    }
+
+    std::uint64_t offset = 0;
+    firstUnread = 0;
+    recordsBefore = 0;
+    while (size - offset >= kHeaderSize) {
+        const unsigned char* header = data.data() + offset;
+        const RecordHeader record = decodeHeader(header);
+        if (record.length > size - offset - kHeaderSize ||
+            recordCrc(header + 8, header + kHeaderSize, record.length) != record.crc) {
+            break;   // torn, or corrupt
+        }
+        const std::uint64_t next = offset + kHeaderSize + record.length;
+        if (offset < cursorOffset) {
+            ++recordsBefore;
+            firstUnread = next;
+        }
+        offset = next;
+        ++segment.records;
+        segment.newestMs = std::max(segment.newestMs, record.timeMs);
+    }
+
+    if (size > offset) {
+        if (::truncate(path.c_str(), static_cast<off_t>(offset)) != 0) {
+            throw systemErr("truncate " + path);
+        }
+        stats_.truncatedBytes += size - offset;
+    }
+    segment.bytes = offset;
+}
+
+// ----- appending -----
+
+void DiskSpool::openForAppend() {
+    const std::string path = segmentPath(segments_.back().seq);
+    writeFd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (writeFd_ < 0) {
+        throw systemErr("open " + path);
+    }
+}
+
+void DiskSpool::rollSegment() {
+    if (writeFd_ >= 0) {
+        syncFd(writeFd_);   // a closed segment is always durable
+        closeFd(writeFd_);
+    }
+    const bool wasEmpty = segments_.empty();
+    segments_.push_back(Segment{nextSeq_++, 0, 0, 0});
+    if (wasEmpty) {
+        closeFd(readFd_);
+        readSeq_ = segments_.front().seq;
+        readOffset_ = 0;
+        readRecords_ = 0;
+    }
+    openForAppend();
+    dirty_ = true;
+}
+
+void DiskSpool::append(std::string_view payload) {
+    if (payload.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("DiskSpool: payload too large");
+    }
+    const std::uint64_t recordBytes = kHeaderSize + payload.size();
+
+    if (segments_.empty() ||
+        (segments_.back().bytes > 0 && segments_.back().bytes + recordBytes > config_.segmentBytes)) {
+        rollSegment();
+    }
+    // Make room by evicting the oldest segments; the one being written stays.
+    while (bytes_ + recordBytes > config_.maxBytes && segments_.size() > 1) {
+        dropFront(stats_.droppedBySize);
+    }
+
+    const std::int64_t nowMs = wallMs();
+    std::array<unsigned char, kHeaderSize> header{};
+    putLe(header.data() + 8, static_cast<std::uint64_t>(nowMs), 8);
+    putLe(header.data(), payload.size(), 4);
+    putLe(header.data() + 4, recordCrc(header.data() + 8, payload.data(), payload.size()), 4);
+
+    std::array<iovec, 2> iov{};
+    iov[0].iov_base = header.data();
+    iov[0].iov_len = header.size();
+    iov[1].iov_base = const_cast<char*>(payload.data());   // NOLINT(cppcoreguidelines-pro-type-const-cast): writev does not write
+    iov[1].iov_len = payload.size();
+
+    Segment& segment = segments_.back();
+    ssize_t written = 0;
+    do {
+        written = ::writev(writeFd_, iov.data(), static_cast<int>(iov.size()));
+    } while (written < 0 && errno == EINTR);
+    if (written != static_cast<ssize_t>(recordBytes)) {
+        // Short writes on a regular file mean the disk is full or failing:
+        // cut the partial record off so the segment stays well formed.
+        const auto saved = errno;
+        if (::ftruncate(writeFd_, static_cast<off_t>(segment.bytes)) != 0) {
+            closeFd(writeFd_);   // recovery will have to cut it off
+        }
+        errno = written < 0 ? saved : ENOSPC;
+        throw systemErr("write");
+    }
+
+    segment.bytes += recordBytes;
+    ++segment.records;
+    segment.newestMs = std::max(segment.newestMs, nowMs);
+    ++records_;
+    bytes_ += recordBytes;
+    ++stats_.appended;
+    dirty_ = true;
+
+    if (config_.syncInterval.count() == 0) {
+        sync();
+    } else {
+        syncIfDue();
+    }
+}
+
+// ----- replaying -----
+
+bool DiskSpool::front(std::string& out) {
+    frontBytes_ = 0;
+    const std::int64_t cutoff = cutoffMs();
+    expireSegments(cutoff);
+
+    while (records_ > 0) {
+        const Segment& segment = segments_.front();
+        if (readFd_ < 0 || readSeq_ != segment.seq) {
+            closeFd(readFd_);
+            const std::string path = segmentPath(segment.seq);
+            readFd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (readFd_ < 0) {
+                throw systemErr("open " + path);
+            }
+            readSeq_ = segment.seq;
+        }
+
+        std::array<unsigned char, kHeaderSize> header{};
+        if (!readAt(readFd_, header.data(), header.size(), readOffset_)) {
+            throw std::runtime_error("DiskSpool: segment " + segmentPath(segment.seq) + " shrank");
+        }
+        const RecordHeader record = decodeHeader(header.data());
+        if (record.timeMs < cutoff) {
+            ++stats_.droppedByAge;
+            advance(kHeaderSize + record.length);
+            continue;
+        }
+
+        out.resize(record.length);
+        if (!readAt(readFd_, out.data(), out.size(), readOffset_ + kHeaderSize)) {
+            throw std::runtime_error("DiskSpool: segment " + segmentPath(segment.seq) + " shrank");
+        }
+        frontBytes_ = kHeaderSize + record.length;
+        return true;
+    }
+    return false;
+}
+
+void DiskSpool::pop() {
+    if (frontBytes_ == 0) {
+        throw std::logic_error("DiskSpool: pop() without a record from front()");
+    }
+    advance(frontBytes_);
+    frontBytes_ = 0;
+    ++stats_.replayed;
+}
+
+void DiskSpool::advance(std::uint64_t recordBytes) {
+    readOffset_ += recordBytes;
+    ++readRecords_;
+    --records_;
+    dirty_ = true;
+
+    // Reclaim a segment as soon as it is fully replayed; when that was the
+    // one being written, the next append starts a fresh one.
+    if (readOffset_ >= segments_.front().bytes) {
+        std::uint64_t none = 0;
+        dropFront(none);
+    }
+}
+
+void DiskSpool::expireSegments(std::int64_t cutoffMs) {
+    while (segments_.size() > 1 && segments_.front().newestMs < cutoffMs) {
+        dropFront(stats_.droppedByAge);
+    }
+}
+
+// Deletes the oldest segment, counting its unreplayed records as dropped.
+void DiskSpool::dropFront(std::uint64_t& droppedCounter) {
+    const Segment segment = segments_.front();
+    const std::uint64_t unread = segment.records - readRecords_;
+    droppedCounter += unread;
+    records_ -= unread;
+    bytes_ -= segment.bytes;
+
+    closeFd(readFd_);
+    if (segments_.size() == 1) {
+        closeFd(writeFd_);
+    }
+    std::error_code ignored;
+    fs::remove(segmentPath(segment.seq), ignored);
+    segments_.pop_front();
+
+    readOffset_ = 0;
+    readRecords_ = 0;
+    frontBytes_ = 0;
+    readSeq_ = segments_.empty() ? nextSeq_ : segments_.front().seq;
+    dirty_ = true;
+}
+
+std::int64_t DiskSpool::cutoffMs() const {
+    if (config_.maxAge.count() == 0) {
+        return std::numeric_limits<std::int64_t>::min();
+    }
+    return wallMs() - static_cast<std::int64_t>(config_.maxAge.count());
+}
+
+// ----- durability -----
+
+void DiskSpool::syncIfDue() {
+    if (dirty_ && std::chrono::steady_clock::now() - lastSync_ >= config_.syncInterval) {
+        sync();
+    }
+}
+
+void DiskSpool::sync() {
+    if (writeFd_ >= 0) {
+        syncFd(writeFd_);
+    }
+    persistCursor();
+    syncDirectory(config_.directory);
+    dirty_ = false;
+    lastSync_ = std::chrono::steady_clock::now();
+    ++stats_.syncs;
+}
+
+// Writes "<segment> <offset>" of the replay position, atomically via rename.
+void DiskSpool::persistCursor() {
+    const fs::path directory(config_.directory);
+    const std::string tmpPath = (directory / kCursorTmpName).string();
+    const std::string text = std::to_string(readSeq_) + " " + std::to_string(readOffset_) + "\n";
+
+    const int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw systemErr("open " + tmpPath);
+    }
+    const bool ok = ::write(fd, text.data(), text.size()) == static_cast<ssize_t>(text.size()) && ::fsync(fd) == 0;
+    const auto saved = errno;
+    ::close(fd);
+    if (!ok) {
+        errno = saved;
+        throw systemErr("write " + tmpPath);
+    }
+    if (std::rename(tmpPath.c_str(), (directory / kCursorName).string().c_str()) != 0) {
+        throw systemErr("rename " + tmpPath);
+    }
+}
+
+std::string DiskSpool::segmentPath(std::uint64_t seq) const {
+    std::string name = std::to_string(seq);
+    name.insert(0, kSeqDigits > name.size() ? kSeqDigits - name.size() : 0, '0');
+    return (fs::path(config_.directory) / (name + kSegmentSuffix)).string();
+}
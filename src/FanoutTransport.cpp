@@ -0,0 +1,374 @@
+/**
+ * @file FanoutTransport.cpp
+ * @brief Implementation of the fan-out transport.
+ *
+ * The sensor thread is the only producer of every sink queue and evicts
+ * the oldest entry itself under DROP_OLDEST, exactly like SensorPipeline's
+ * push(). Each sender thread waits with an IdleBackoff while its queue is
+ * empty and, while idle, gives a child that buffers writes (non-blocking
+ * TCP, ReconnectingTransport) a flushUntil() call every kIdleFlushInterval.
+ *
+ * @see FanoutTransport
+ */
+
+#include "FanoutTransport.hpp"
+#include "BoundedRing.hpp"
+#include "ConfigTypes.hpp"
+#include "ConstBuffer.hpp"
+#include "IdleBackoff.hpp"
+#include "ITransport.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>  // std::move
+#include <vector>
+
+namespace {
+
+    // How often an idle sender thread lets its child flush buffered bytes.
+    constexpr std::chrono::milliseconds kIdleFlushInterval{10};
+
+    std::int64_t micros(std::chrono::steady_clock::duration elapsed) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    }
+}
+
+// ----- ctor / dtor -----
+
+FanoutTransport::SinkState::SinkState(Sink&& sink)
+    : name(std::move(sink.name)),
+      transport(std::move(sink.transport)),
+      policy(sink.queue.policy),
+      queue(sink.queue.depth)
+{
+}
+
+FanoutTransport::FanoutTransport(std::vector<Sink> sinks) {
+    if (sinks.empty()) {
+        throw std::invalid_argument("FanoutTransport: need at least one sink");
+    }
+    sinks_.reserve(sinks.size());
+    for (auto& sink : sinks) {
+        if (!sink.transport) {
+            throw std::invalid_argument("FanoutTransport: sink '" + sink.name + "' has no transport");
+        }
+        if (sink.queue.policy == QueuePolicy::BLOCK) {
+            throw std::invalid_argument("FanoutTransport: sink '" + sink.name +
+                                        "' cannot block; use drop_oldest or drop_newest");
+        }
+        sinks_.push_back(std::make_unique<SinkState>(std::move(sink)));
+    }
+}
+
+FanoutTransport::~FanoutTransport() {
+    close();
+}
+
+// ----- producer side -----
+
+void FanoutTransport::connect() {
+    if (open_) {
+        return;
+    }
+    stopping_.store(false, std::memory_order_release);
+    for (auto& sink : sinks_) {
+        SinkState& state = *sink;
+        state.retryAt = Clock::time_point{};
+        state.thread = std::thread([this, &state] { senderLoop(state); });
+    }
+    open_ = true;
+}
+
+std::size_t FanoutTransport::sendString(const std::string& payload) {
+    return publish(std::make_shared<const std::string>(payload));
+}
+
+std::size_t FanoutTransport::sendBuffers(const ConstBuffer* buffers, std::size_t count) {
+    std::string joined;
+    joined.reserve(totalSize(buffers, count));
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        joined.append(static_cast<const char*>(buffers[idx].data), buffers[idx].size);
+    }
+    return publish(std::make_shared<const std::string>(std::move(joined)));
+}
+
+// One shared copy of the payload, referenced from every sink queue.
+std::size_t FanoutTransport::publish(std::shared_ptr<const std::string> payload) {
+    if (!open_) {
+        throw std::runtime_error("fanout send: not connected");
+    }
+    const std::size_t size = payload->size();
+    const auto now = Clock::now();
+    for (auto& sink : sinks_) {
+        push(*sink, Entry{payload, now});
+    }
+    return size;
+}
+
+/*
+ * push()
+ * - 'outstanding' goes up before the entry becomes visible, so that
+ *   flushUntil() never reports an empty queue with a payload in flight.
+ * - DROP_OLDEST: the producer pops the oldest entry itself; the sender may
+ *   win that race, and either way a slot frees up.
+ */
+void FanoutTransport::push(SinkState& sink, Entry entry) {
+    sink.outstanding.fetch_add(1);
+    if (sink.queue.tryPush(std::move(entry))) {
+        return;
+    }
+    if (sink.policy == QueuePolicy::DROP_NEWEST) {
+        sink.dropped.fetch_add(1, std::memory_order_relaxed);
+        sink.outstanding.fetch_sub(1);
+        return;
+    }
+    Entry evicted;
+    do {
+        if (sink.queue.tryPop(evicted)) {
+            sink.dropped.fetch_add(1, std::memory_order_relaxed);
+            sink.outstanding.fetch_sub(1);
+        }
+    } while (!sink.queue.tryPush(std::move(entry)));
+}
+
+void FanoutTransport::setSessionPreamble(const std::string& preamble) {
+    auto shared = std::make_shared<const std::string>(preamble);
+    const std::lock_guard<std::mutex> lock(preambleMutex_);
+    preamble_ = std::move(shared);
+    preambleVersion_.fetch_add(1, std::memory_order_release);
+}
+
+// Never waits: the sender threads deliver and flush on their own, and a
+// sink that is down (a ReconnectingTransport child keeps its backlog) may
+// not drain for a long time, so waiting on it would only make the caller's
+// next tick late.
+bool FanoutTransport::flushUntil(Clock::time_point /*deadline*/) {
+    return std::all_of(sinks_.begin(), sinks_.end(), [](const auto& sink) { return drained(*sink); });
+}
+
+bool FanoutTransport::drained(const SinkState& sink) noexcept {
+    // Senders raise flushPending before they lower outstanding.
+    return sink.outstanding.load() == 0 && !sink.flushPending.load();
+}
+
+void FanoutTransport::close() {
+    if (!open_) {
+        return;
+    }
+
+    // The last batch usually arrives right before close(): deliver it
+    // rather than drop it, but never let a stalled sink hold shutdown up.
+    const auto giveUp = Clock::now() + kCloseDrainTimeout;
+    IdleBackoff backoff;
+    while (Clock::now() < giveUp &&
+           std::any_of(sinks_.begin(), sinks_.end(), [](const auto& sink) { return sink->outstanding.load() > 0; })) {
+        backoff.pause();
+    }
+
+    stopping_.store(true, std::memory_order_release);
+    for (auto& sink : sinks_) {
+        sink->thread.join();
+        Entry left;
+        while (sink->queue.tryPop(left)) {
+            sink->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        sink->outstanding.store(0);
+        sink->flushPending.store(false);
+        sink->transport->close();
+        sink->connected.store(false, std::memory_order_release);
+    }
+    open_ = false;
+}
+
+// ----- sender threads -----
+
+void FanoutTransport::senderLoop(SinkState& sink) {
+    tryConnect(sink);
+
+    Entry       entry;
+    IdleBackoff backoff;
+    while (!stopping_.load(std::memory_order_acquire)) {
+        if (!sink.queue.tryPop(entry)) {
+            idle(sink);
+            backoff.pause();
+            continue;
+        }
+        backoff.reset();
+        deliver(sink, entry);
+        entry.payload.reset();   // let the last sink to send free the payload
+        sink.outstanding.fetch_sub(1);
+    }
+}
+
+/*
+ * deliver()
+ * - The child gets the current session preamble first, so that a payload
+ *   it queues and replays later is preceded by a dictionary that covers it.
+ * - A sink that is down gets one connect attempt per kRetryInterval;
+ *   payloads in between are counted as failed and skipped.
+ * - A child above its high water mark (congested()) sheds the payload,
+ *   counted as dropped, like a full queue would.
+ * - A failed send closes the child and starts the retry clock. Nothing is
+ *   resent: a sink that must not lose data wraps its child in a
+ *   ReconnectingTransport, which never throws.
+ */
+void FanoutTransport::deliver(SinkState& sink, const Entry& entry) {
+    forwardPreamble(sink);
+    if (!sink.connected.load(std::memory_order_relaxed) && !tryConnect(sink)) {
+        sink.failed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    try {
+        // Backpressure from a child that buffers writes: let it drain what
+        // it can, and shed the payload if it is still above its high mark.
+        if (sink.transport->congested()) {
+            (void)sink.transport->flushUntil(Clock::now());
+            if (sink.transport->congested()) {
+                sink.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        sink.transport->sendString(*entry.payload);
+    } catch (const std::exception& error) {
+        linkDown(sink, error);
+        return;
+    }
+
+    const std::int64_t lag = micros(Clock::now() - entry.queuedAt);
+    sink.lagMicros.store(lag, std::memory_order_relaxed);
+    if (lag > sink.maxLagMicros.load(std::memory_order_relaxed)) {
+        sink.maxLagMicros.store(lag, std::memory_order_relaxed);
+    }
+    sink.sent.fetch_add(1, std::memory_order_relaxed);
+    sink.flushPending.store(true);
+}
+
+// The Sensor sets the preamble before it sends the payload that needs it, so
+// checking here, per payload, is never too late.
+void FanoutTransport::forwardPreamble(SinkState& sink) {
+    const std::uint64_t version = preambleVersion_.load(std::memory_order_acquire);
+    if (version == sink.preambleVersion) {
+        return;
+    }
+    std::shared_ptr<const std::string> preamble;
+    {
+        const std::lock_guard<std::mutex> lock(preambleMutex_);
+        preamble = preamble_;
+        sink.preambleVersion = preambleVersion_.load(std::memory_order_relaxed);
+    }
+    sink.transport->setSessionPreamble(*preamble);
+}
+
+bool FanoutTransport::tryConnect(SinkState& sink) {
+    const auto now = Clock::now();
+    if (now < sink.retryAt) {
+        return false;
+    }
+    try {
+        sink.transport->connect();
+    } catch (const std::exception& error) {
+        sink.retryAt = now + kRetryInterval;
+        if (!sink.downReported) {
+            sink.downReported = true;
+            Logger::instance().warning("Fan-out sink '" + sink.name + "' unreachable: " + error.what());
+        }
+        return false;
+    }
+    sink.downReported = false;
+    sink.connects.fetch_add(1, std::memory_order_acq_rel);
+    sink.connected.store(true, std::memory_order_release);
+    Logger::instance().info("Fan-out sink '" + sink.name + "' connected.");
+    return true;
+}
+
+void FanoutTransport::linkDown(SinkState& sink, const std::exception& error) {
+    sink.failed.fetch_add(1, std::memory_order_relaxed);
+    sink.transport->close();
+    sink.connected.store(false, std::memory_order_release);
+    sink.flushPending.store(false);
+    sink.retryAt = Clock::now() + kRetryInterval;
+    sink.downReported = true;
+    Logger::instance().warning("Fan-out sink '" + sink.name + "' lost: " + error.what() +
+                               "; its payloads are dropped until it reconnects.");
+}
+
+// Queue empty: give a child that buffers writes a chance to flush them,
+// every kIdleFlushInterval while it still reports bytes queued.
+void FanoutTransport::idle(SinkState& sink) {
+    if (!sink.flushPending.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const auto now = Clock::now();
+    if (now < sink.nextFlush) {
+        return;
+    }
+    try {
+        if (sink.transport->flushUntil(now)) {
+            sink.flushPending.store(false);
+        } else {
+            sink.nextFlush = now + kIdleFlushInterval;
+        }
+    } catch (const std::exception& error) {
+        linkDown(sink, error);
+    }
+}
+
+// ----- status -----
+
+bool FanoutTransport::isConnected() const {
+    return open_ && std::any_of(sinks_.begin(), sinks_.end(), [](const auto& sink) {
+        return sink->connected.load(std::memory_order_acquire);
+    });
+}
+
+// Connects made here, those a child made on its own (ReconnectingTransport)
+// and every payload a sink dropped or lost: goes up whenever any sink starts
+// a new session or may have missed the payload that carried the dictionary.
+std::uint64_t FanoutTransport::sessionCount() const {
+    std::uint64_t sessions = 0;
+    for (const auto& sink : sinks_) {
+        sessions += sink->connects.load(std::memory_order_acquire) + sink->transport->sessionCount() +
+                    sink->dropped.load(std::memory_order_acquire) + sink->failed.load(std::memory_order_acquire);
+    }
+    return sessions;
+}
+
+std::size_t FanoutTransport::maxMessageSize() const {
+    std::size_t limit = 0;
+    for (const auto& sink : sinks_) {
+        const std::size_t sinkLimit = sink->transport->maxMessageSize();
+        if (sinkLimit != 0 && (limit == 0 || sinkLimit < limit)) {
+            limit = sinkLimit;
+        }
+    }
+    return limit;
+}
+
+std::vector<FanoutSinkStats> FanoutTransport::stats() const {
+    std::vector<FanoutSinkStats> all;
+    all.reserve(sinks_.size());
+    for (const auto& sink : sinks_) {
+        FanoutSinkStats stats;
+        stats.name      = sink->name;
+        stats.connected = sink->connected.load(std::memory_order_acquire);
+        stats.sent      = sink->sent.load(std::memory_order_relaxed);
+        stats.dropped   = sink->dropped.load(std::memory_order_relaxed);
+        stats.failed    = sink->failed.load(std::memory_order_relaxed);
+        stats.queued    = sink->queue.sizeApprox();
+        stats.lag       = std::chrono::microseconds(sink->lagMicros.load(std::memory_order_relaxed));
+        stats.maxLag    = std::chrono::microseconds(sink->maxLagMicros.load(std::memory_order_relaxed));
+        all.push_back(std::move(stats));
+    }
+    return all;
+}
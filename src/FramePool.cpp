@@ -0,0 +1,126 @@
+/**
+ * @file FramePool.cpp
+ * @brief Implementation of the recycled frame buffer pool.
+ *
+ * @see FramePool
+ */
+
+#include "FramePool.hpp"
+
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <utility>  // std::move, std::exchange
+#include <opencv2/core.hpp>
+
+// ----- Lease -----
+
+FramePool::Lease::Lease(cv::Mat overflow) noexcept
+    : overflow_(std::move(overflow))
+{
+    frame_ = &overflow_;
+}
+
+FramePool::Lease::Lease(Lease&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)),
+      index_(other.index_),
+      frame_(std::exchange(other.frame_, nullptr)),
+      overflow_(std::move(other.overflow_))
+{
+    if (pool_ == nullptr && frame_ != nullptr) {
+        frame_ = &overflow_;   // owned buffer moved along with us
+    }
+}
+
+FramePool::Lease& FramePool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_     = std::exchange(other.pool_, nullptr);
+        index_    = other.index_;
+        frame_    = std::exchange(other.frame_, nullptr);
+        overflow_ = std::move(other.overflow_);
+        if (pool_ == nullptr && frame_ != nullptr) {
+            frame_ = &overflow_;
+        }
+    }
+    return *this;
+}
+
+FramePool::Lease::~Lease() {
+    release();
+}
+
+void FramePool::Lease::release() noexcept {
+    if (pool_ != nullptr) {
+        pool_->giveBack(index_);
+        pool_ = nullptr;
+    }
+    frame_ = nullptr;
+}
+
+// ----- pool -----
+
+FramePool::FramePool(std::size_t buffers, int rows, int cols, int type)
+    : buffers_(buffers)
+{
+    if (buffers == 0) {
+        throw std::invalid_argument("FramePool: needs at least one buffer");
+    }
+
+    free_.reserve(buffers);
+    for (std::size_t idx = buffers; idx > 0; --idx) {
+        free_.push_back(idx - 1);
+    }
+    resize(rows, cols, type);
+}
+
+void FramePool::resize(int rows, int cols, int type) {
+    if (rows <= 0 || cols <= 0) {
+        return;   // geometry unknown yet
+    }
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+    rows_ = rows;
+    cols_ = cols;
+    type_ = type;
+    // Leased buffers are resized by their next capture instead.
+    for (const std::size_t idx : free_) {
+        buffers_[idx].frame.create(rows_, cols_, type_);
+    }
+}
+
+FramePool::Lease FramePool::acquire() {
+    int rows = 0;
+    int cols = 0;
+    int type = 0;
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            const std::size_t idx = free_.back();
+            free_.pop_back();
+            Buffer& buffer = buffers_[idx];
+            buffer.data = buffer.frame.data;
+            return Lease(this, idx, &buffer.frame);
+        }
+        rows = rows_;
+        cols = cols_;
+        type = type_;
+    }
+
+    overflows_.fetch_add(1, std::memory_order_relaxed);
+    return Lease(rows > 0 ? cv::Mat(rows, cols, type) : cv::Mat());
+}
+
+std::size_t FramePool::available() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return free_.size();
+}
+
+void FramePool::giveBack(std::size_t index) noexcept {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    const Buffer& buffer = buffers_[index];
+    if (buffer.data != nullptr && buffer.frame.data != buffer.data) {
+        reallocations_.fetch_add(1, std::memory_order_relaxed);
+    }
+    free_.push_back(index);   // never exceeds the reserved capacity
+}
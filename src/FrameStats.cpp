@@ -0,0 +1,342 @@
+/**
+ * @file FrameStats.cpp
+ * @brief Scalar, SSE2 and AVX2 versions of the frame statistics kernel.
+ *
+ * The vector kernels only ever see whole 48-byte blocks and accumulate per
+ * byte position; the scalar loop handles whatever is left of a row and
+ * accumulates per channel directly. Both feed the same totals, which are
+ * folded into per-channel results at the end.
+ *
+ * Overflow budget per block position, per flush interval of 256 blocks:
+ *  - sums:            255   * 256 = 65280      (fits uint16_t)
+ *  - sums of squares: 255^2 * 256 = 16646400   (fits uint32_t)
+ *
+ * @see FrameStats.hpp
+ */
+
+#include "FrameStats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>    // std::memcpy
+#include <iterator>   // std::size
+#include <stdexcept>
+#include <vector>
+#include <opencv2/core.hpp>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FRAMESTATS_HAVE_X86 1
+#include <immintrin.h>
+#else
+#define FRAMESTATS_HAVE_X86 0
+#endif
+
+namespace {
+
+    constexpr std::size_t kBlock = 48;           // bytes per vector block (3 x 16)
+    constexpr std::size_t kFlushBlocks = 256;    // blocks between widening flushes
+    constexpr std::size_t kMaxChannels = 4;
+
+    // Per-byte-position totals of the vector kernels.
+    struct BlockTotals {
+        std::array<std::uint64_t, kBlock> sum{};
+        std::array<std::uint64_t, kBlock> sumSq{};
+        std::array<std::uint8_t, kBlock>  min{};
+        std::array<std::uint8_t, kBlock>  max{};
+
+        BlockTotals() { min.fill(UINT8_MAX); }
+    };
+
+    // Per-channel totals (scalar loop, and the final fold).
+    struct ChannelTotals {
+        std::array<std::uint64_t, kMaxChannels> sum{};
+        std::array<std::uint64_t, kMaxChannels> sumSq{};
+        std::array<std::uint8_t, kMaxChannels>  min{UINT8_MAX, UINT8_MAX, UINT8_MAX, UINT8_MAX};
+        std::array<std::uint8_t, kMaxChannels>  max{};
+    };
+
+    using BlockKernel = void (*)(const std::uint8_t* data, std::size_t blocks, BlockTotals& totals);
+
+    // 'bytes' is a whole number of pixels and 'data' starts on channel 0.
+    void scalarSpan(const std::uint8_t* data, std::size_t bytes, std::size_t channels, ChannelTotals& totals) {
+        for (std::size_t idx = 0; idx < bytes; idx += channels) {
+            for (std::size_t chan = 0; chan < channels; ++chan) {
+                const std::uint8_t value = data[idx + chan];
+                totals.sum[chan]   += value;
+                totals.sumSq[chan] += static_cast<std::uint64_t>(value) * value;
+                totals.min[chan]    = std::min(totals.min[chan], value);
+                totals.max[chan]    = std::max(totals.max[chan], value);
+            }
+        }
+    }
+
+#if FRAMESTATS_HAVE_X86
+
+    // Add narrow per-position partial sums into the 64-bit totals.
+    void flushPartials(const std::array<std::uint16_t, kBlock>& sums,
+                       const std::array<std::uint32_t, kBlock>& sumsSq,
+                       BlockTotals& totals) {
+        for (std::size_t pos = 0; pos < kBlock; ++pos) {
+            totals.sum[pos]   += sums[pos];
+            totals.sumSq[pos] += sumsSq[pos];
+        }
+    }
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    void sse2Blocks(const std::uint8_t* data, std::size_t blocks, BlockTotals& totals) {
+
+        const __m128i zero = _mm_setzero_si128();
+        auto* minOut = reinterpret_cast<__m128i*>(totals.min.data());
+        auto* maxOut = reinterpret_cast<__m128i*>(totals.max.data());
+
+        while (blocks > 0) {
+            const std::size_t chunk = std::min(blocks, kFlushBlocks);
+
+            // Vector types can't be std::array elements (their alignment
+            // attributes would be dropped), hence the plain arrays.
+            // NOLINTBEGIN(modernize-avoid-c-arrays)
+            __m128i sum16[6];     // 8 x u16 each, positions 0..47
+            __m128i sumSq32[12];  // 4 x u32 each, positions 0..47
+            __m128i minV[3];
+            __m128i maxV[3];
+            // NOLINTEND(modernize-avoid-c-arrays)
+            for (auto& acc : sum16)   { acc = zero; }
+            for (auto& acc : sumSq32) { acc = zero; }
+            for (std::size_t vec = 0; vec < 3; ++vec) {
+                minV[vec] = _mm_loadu_si128(minOut + vec);
+                maxV[vec] = _mm_loadu_si128(maxOut + vec);
+            }
+
+            for (std::size_t blk = 0; blk < chunk; ++blk, data += kBlock) {
+                for (std::size_t vec = 0; vec < 3; ++vec) {
+                    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data) + vec);
+                    minV[vec] = _mm_min_epu8(minV[vec], bytes);
+                    maxV[vec] = _mm_max_epu8(maxV[vec], bytes);
+
+                    const __m128i low  = _mm_unpacklo_epi8(bytes, zero);
+                    const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+                    sum16[2 * vec]     = _mm_add_epi16(sum16[2 * vec], low);
+                    sum16[2 * vec + 1] = _mm_add_epi16(sum16[2 * vec + 1], high);
+
+                    // Squares of 0..255 fit 16 unsigned bits; widen before adding.
+                    const __m128i lowSq  = _mm_mullo_epi16(low, low);
+                    const __m128i highSq = _mm_mullo_epi16(high, high);
+                    sumSq32[4 * vec]     = _mm_add_epi32(sumSq32[4 * vec],     _mm_unpacklo_epi16(lowSq, zero));
+                    sumSq32[4 * vec + 1] = _mm_add_epi32(sumSq32[4 * vec + 1], _mm_unpackhi_epi16(lowSq, zero));
+                    sumSq32[4 * vec + 2] = _mm_add_epi32(sumSq32[4 * vec + 2], _mm_unpacklo_epi16(highSq, zero));
+                    sumSq32[4 * vec + 3] = _mm_add_epi32(sumSq32[4 * vec + 3], _mm_unpackhi_epi16(highSq, zero));
+                }
+            }
+
+            alignas(16) std::array<std::uint16_t, kBlock> sums{};
+            alignas(16) std::array<std::uint32_t, kBlock> sumsSq{};
+            for (std::size_t vec = 0; vec < std::size(sum16); ++vec) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(sums.data()) + vec, sum16[vec]);
+            }
+            for (std::size_t vec = 0; vec < std::size(sumSq32); ++vec) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(sumsSq.data()) + vec, sumSq32[vec]);
+            }
+            for (std::size_t vec = 0; vec < 3; ++vec) {
+                _mm_storeu_si128(minOut + vec, minV[vec]);
+                _mm_storeu_si128(maxOut + vec, maxV[vec]);
+            }
+            flushPartials(sums, sumsSq, totals);
+
+            blocks -= chunk;
+        }
+    }
+
+    // Same layout as sse2Blocks, with each 16-byte load widened into one
+    // 256-bit register so the accumulators fit the register file.
+    __attribute__((target("avx2")))
+    void avx2Blocks(const std::uint8_t* data, std::size_t blocks, BlockTotals& totals) {
+
+        auto* minOut = reinterpret_cast<__m128i*>(totals.min.data());
+        auto* maxOut = reinterpret_cast<__m128i*>(totals.max.data());
+
+        while (blocks > 0) {
+            const std::size_t chunk = std::min(blocks, kFlushBlocks);
+
+            // NOLINTBEGIN(modernize-avoid-c-arrays)
+            __m256i sum16[3];     // 16 x u16 each
+            __m256i sumSq32[6];   // 8 x u32 each
+            __m128i minV[3];
+            __m128i maxV[3];
+            // NOLINTEND(modernize-avoid-c-arrays)
+            for (auto& acc : sum16)   { acc = _mm256_setzero_si256(); }
+            for (auto& acc : sumSq32) { acc = _mm256_setzero_si256(); }
+            for (std::size_t vec = 0; vec < 3; ++vec) {
+                minV[vec] = _mm_loadu_si128(minOut + vec);
+                maxV[vec] = _mm_loadu_si128(maxOut + vec);
+            }
+
+            for (std::size_t blk = 0; blk < chunk; ++blk, data += kBlock) {
+                for (std::size_t vec = 0; vec < 3; ++vec) {
+                    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data) + vec);
+                    minV[vec] = _mm_min_epu8(minV[vec], bytes);
+                    maxV[vec] = _mm_max_epu8(maxV[vec], bytes);
+
+                    const __m256i wide = _mm256_cvtepu8_epi16(bytes);
+                    sum16[vec] = _mm256_add_epi16(sum16[vec], wide);
+
+                    const __m256i squares = _mm256_mullo_epi16(wide, wide);
+                    sumSq32[2 * vec] = _mm256_add_epi32(
+                        sumSq32[2 * vec], _mm256_cvtepu16_epi32(_mm256_castsi256_si128(squares)));
+                    sumSq32[2 * vec + 1] = _mm256_add_epi32(
+                        sumSq32[2 * vec + 1], _mm256_cvtepu16_epi32(_mm256_extracti128_si256(squares, 1)));
+                }
+            }
+
+            alignas(32) std::array<std::uint16_t, kBlock> sums{};
+            alignas(32) std::array<std::uint32_t, kBlock> sumsSq{};
+            for (std::size_t vec = 0; vec < std::size(sum16); ++vec) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums.data()) + vec, sum16[vec]);
+            }
+            for (std::size_t vec = 0; vec < std::size(sumSq32); ++vec) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(sumsSq.data()) + vec, sumSq32[vec]);
+            }
+            for (std::size_t vec = 0; vec < 3; ++vec) {
+                _mm_storeu_si128(minOut + vec, minV[vec]);
+                _mm_storeu_si128(maxOut + vec, maxV[vec]);
+            }
+            flushPartials(sums, sumsSq, totals);
+
+            blocks -= chunk;
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+
+#endif // FRAMESTATS_HAVE_X86
+
+    BlockKernel kernelFor(SimdLevel level) {
+#if FRAMESTATS_HAVE_X86
+        switch (level) {
+            case SimdLevel::AVX2: return avx2Blocks;
+            case SimdLevel::SSE2: return sse2Blocks;
+            case SimdLevel::SCALAR: break;
+        }
+#else
+        (void)level;
+#endif
+        return nullptr;
+    }
+
+    // Fold block positions into channels: position p belongs to channel p % channels.
+    void foldBlockTotals(const BlockTotals& blockTotals, std::size_t channels, ChannelTotals& totals) {
+        for (std::size_t pos = 0; pos < kBlock; ++pos) {
+            const std::size_t chan = pos % channels;
+            totals.sum[chan]   += blockTotals.sum[pos];
+            totals.sumSq[chan] += blockTotals.sumSq[pos];
+            totals.min[chan]    = std::min(totals.min[chan], blockTotals.min[pos]);
+            totals.max[chan]    = std::max(totals.max[chan], blockTotals.max[pos]);
+        }
+    }
+
+    FrameStats finish(const ChannelTotals& totals, std::size_t channels, std::size_t pixels) {
+
+        FrameStats stats;
+        stats.channels = static_cast<int>(channels);
+
+        const auto count = static_cast<double>(pixels);
+        for (std::size_t chan = 0; chan < channels; ++chan) {
+            ChannelStats& out = stats.channel[chan];
+            out.mean     = static_cast<double>(totals.sum[chan]) / count;
+            out.variance = std::max(0.0, static_cast<double>(totals.sumSq[chan]) / count - out.mean * out.mean);
+            out.min      = totals.min[chan];
+            out.max      = totals.max[chan];
+        }
+
+        if (channels >= 3) {
+            // OpenCV frames are BGR(A)
+            const double blue  = stats.channel[0].mean;
+            const double green = stats.channel[1].mean;
+            const double red   = stats.channel[2].mean;
+            stats.luma601 = 0.299 * red + 0.587 * green + 0.114 * blue;
+            stats.luma709 = 0.2126 * red + 0.7152 * green + 0.0722 * blue;
+        } else {
+            // Grey (plus alpha for two channels)
+            stats.luma601 = stats.channel[0].mean;
+            stats.luma709 = stats.channel[0].mean;
+        }
+        return stats;
+    }
+}
+
+SimdLevel detectSimdLevel() {
+#if FRAMESTATS_HAVE_X86
+    static const SimdLevel level = __builtin_cpu_supports("avx2") ? SimdLevel::AVX2 : SimdLevel::SSE2;
+    return level;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+FrameStats computeFrameStats(const cv::Mat& frame) {
+    return computeFrameStats(frame, FrameSampling{}, detectSimdLevel());
+}
+
+FrameStats computeFrameStats(const cv::Mat& frame, SimdLevel level) {
+    return computeFrameStats(frame, FrameSampling{}, level);
+}
+
+FrameStats computeFrameStats(const cv::Mat& frame, const FrameSampling& sampling) {
+    return computeFrameStats(frame, sampling, detectSimdLevel());
+}
+
+FrameStats computeFrameStats(const cv::Mat& frame, const FrameSampling& sampling, SimdLevel level) {
+
+    if (frame.empty()) {
+        throw std::invalid_argument("computeFrameStats: empty frame");
+    }
+    if (frame.depth() != CV_8U || frame.channels() < 1 || frame.channels() > static_cast<int>(kMaxChannels)) {
+        throw std::invalid_argument("computeFrameStats: expected an 8-bit frame with 1..4 channels");
+    }
+    if (sampling.rowStep < 1 || sampling.colStep < 1) {
+        throw std::invalid_argument("computeFrameStats: sampling steps must be >= 1");
+    }
+
+    const auto channels    = static_cast<std::size_t>(frame.channels());
+    const auto rowStep     = static_cast<std::size_t>(sampling.rowStep);
+    const auto colStep     = static_cast<std::size_t>(sampling.colStep);
+    const auto sampledRows = (static_cast<std::size_t>(frame.rows) + rowStep - 1) / rowStep;
+    const auto sampledCols = (static_cast<std::size_t>(frame.cols) + colStep - 1) / colStep;
+    const std::size_t pixels = sampledRows * sampledCols;
+
+    // A continuous, undecimated frame is one long row.
+    const bool oneRow = frame.isContinuous() && rowStep == 1 && colStep == 1;
+    const std::size_t rowBytes = (oneRow ? pixels : sampledCols) * channels;
+
+    // Column decimation packs each sampled row first, so the vector kernels
+    // still see contiguous pixels. The buffer only ever grows.
+    thread_local std::vector<std::uint8_t> packed;
+    if (colStep > 1 && packed.size() < rowBytes) {
+        packed.resize(rowBytes);
+    }
+
+    const BlockKernel kernel = kernelFor(std::min(level, detectSimdLevel()));
+
+    BlockTotals   blockTotals;
+    ChannelTotals totals;
+    const int rows = oneRow ? 1 : frame.rows;
+    for (int row = 0; row < rows; row += sampling.rowStep) {
+        const auto* data = frame.ptr<std::uint8_t>(row);
+        if (colStep > 1) {
+            const std::size_t stride = colStep * channels;
+            for (std::size_t col = 0; col < sampledCols; ++col) {
+                std::memcpy(&packed[col * channels], data + col * stride, channels);
+            }
+            data = packed.data();
+        }
+
+        const std::size_t blocks = kernel != nullptr ? rowBytes / kBlock : 0;
+        if (blocks > 0) {
+            kernel(data, blocks, blockTotals);
+        }
+        scalarSpan(data + blocks * kBlock, rowBytes - blocks * kBlock, channels, totals);
+    }
+    foldBlockTotals(blockTotals, channels, totals);
+
+    return finish(totals, channels, pixels);
+}
@@ -6,51 +6,174 @@
  *
  * @details
  * Defines the HardwareDataSource class methods, including frame capture (`grabFrame`),
- * metadata extraction (`readAll`), and snapshot writing (`grabFrameToJpeg`).
+ * metric extraction (`readInto`, via the single-pass FrameStats kernel), and
+ * snapshot writing (`grabFrameToJpeg`).
  * This component is used by the Sensor class to provide image-based readings.
  */
 #include "HardwareDataSource.hpp"
 #include "Logger.hpp"
 #include "ICamera.hpp"
+#include "IDataSource.hpp"
+#include "ConfigTypes.hpp"
+#include "FramePool.hpp"
+#include "FrameStats.hpp"
+#include "SnapshotWriter.hpp"
 
 #include <opencv2/core.hpp>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/core/types.hpp>
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
 #include <unordered_map>
 #include <string>
 #include <memory>
 #include <utility>  // std::move
 
 
-HardwareDataSource::HardwareDataSource(std::shared_ptr<ICamera> camera)
-    : camera_(std::move(camera)) {
+namespace {
+
+    // readInto() releases its lease before returning and SnapshotWriter copies
+    // the frames it keeps, so capture only ever holds one buffer at a time.
+    constexpr std::size_t kFrameBuffers = 1;
+
+    constexpr std::size_t kFrameMetrics   = 4;   // width, height, channels, status
+    constexpr std::size_t kChannelMetrics = 4;   // mean, variance, min, max
+
+    constexpr std::array<const char*, kChannelMetrics> kMetricSuffixes{"_mean", "_variance", "_min", "_max"};
+    constexpr std::array<const char*, 4> kColourChannels{"blue", "green", "red", "alpha"};
+    constexpr std::array<const char*, 2> kGreyChannels{"gray", "alpha"};
+
+    // The part of 'roi' inside the frame (empty if none).
+    cv::Rect clipToFrame(const RegionOfInterest& roi, const cv::Mat& frame) {
+        const int left   = std::max(roi.x, 0);
+        const int top    = std::max(roi.y, 0);
+        const int right  = std::min(roi.x + roi.width, frame.cols);
+        const int bottom = std::min(roi.y + roi.height, frame.rows);
+        return right > left && bottom > top ? cv::Rect(left, top, right - left, bottom - top) : cv::Rect();
+    }
+}
+
+// ----- reading names -----
+
+HardwareDataSource::StatsKeys::StatsKeys(const std::string& prefix)
+    : brightness(prefix + "brightness"),
+      luma709(prefix + "luma_709")
+{
+    for (std::size_t chan = 0; chan < colour.size(); ++chan) {
+        for (std::size_t metric = 0; metric < kChannelMetrics; ++metric) {
+            colour[chan][metric] = prefix + kColourChannels[chan] + kMetricSuffixes[metric];
+        }
+    }
+    for (std::size_t chan = 0; chan < grey.size(); ++chan) {
+        for (std::size_t metric = 0; metric < kChannelMetrics; ++metric) {
+            grey[chan][metric] = prefix + kGreyChannels[chan] + kMetricSuffixes[metric];
+        }
+    }
+}
+
+std::size_t HardwareDataSource::putStats(Readings& out, const FrameStats& stats, const StatsKeys& keys) {
+    out[keys.brightness] = stats.luma601;   // BT.601 luma
+    out[keys.luma709]    = stats.luma709;
+
+    const auto channels = static_cast<std::size_t>(stats.channels);
+    for (std::size_t chan = 0; chan < channels; ++chan) {
+        const auto& names = channels >= 3 ? keys.colour[chan] : keys.grey[chan];
+        const ChannelStats& channel = stats.channel[chan];
+        out[names[0]] = channel.mean;
+        out[names[1]] = channel.variance;
+        out[names[2]] = channel.min;
+        out[names[3]] = channel.max;
+    }
+    return 2 + kChannelMetrics * channels;
+}
+
+HardwareDataSource::HardwareDataSource(std::shared_ptr<ICamera> camera,
+                                       const SnapshotConfig& snapshot,
+                                       const FrameSamplingConfig& sampling)
+    : camera_(std::move(camera)),
+      frames_(kFrameBuffers, 0, 0, CV_8UC3),
+      sampling_{sampling.rowStep, sampling.colStep},
+      frameKeys_("") {
+        if (sampling.rowStep < 1 || sampling.colStep < 1) {
+            throw std::invalid_argument("HardwareDataSource: sampling steps must be >= 1");
+        }
+        regions_.reserve(sampling.regions.size());
+        for (const auto& roi : sampling.regions) {
+            if (roi.name.empty() || roi.width <= 0 || roi.height <= 0) {
+                throw std::invalid_argument("HardwareDataSource: region needs a name and a positive size");
+            }
+            regions_.push_back({roi, StatsKeys(roi.name + "_"), FrameStats{}});
+        }
+
+        if (camera_) {
+            // Preallocate from the advertised resolution; logCameraInfo() then
+            // corrects it from a real frame if the camera reported nothing useful.
+            frames_.resize(static_cast<int>(camera_->get(cv::CAP_PROP_FRAME_HEIGHT)),
+                           static_cast<int>(camera_->get(cv::CAP_PROP_FRAME_WIDTH)),
+                           CV_8UC3);
+        }
+        if (snapshot.enabled) {
+            snapshots_ = std::make_unique<SnapshotWriter>(snapshot);
+        }
         logCameraInfo();
 }
 
 
-std::unordered_map<std::string, double> HardwareDataSource::readAll() {
+Readings HardwareDataSource::readAll() {
+    Readings values;
+    readInto(values);
+    return values;
+}
 
-    Logger::instance().info("Reading from the hardware.");
+void HardwareDataSource::readInto(Readings& values) {
 
-    std::unordered_map<std::string, double> values;
-    cv::Mat frame;
+    // Capture into a recycled buffer: no allocation once the pool is sized.
+    FramePool::Lease lease = frames_.acquire();   // returned to the pool on exit
+    cv::Mat& frame = lease.frame();
 
     if (grabFrame(frame)) {
-        values["frame_width"]  = static_cast<double>(frame.cols);
-        values["frame_height"] = static_cast<double>(frame.rows);
-        values["channels"]     = static_cast<double>(frame.channels());
-        values["brightness"]   = cv::mean(frame)[0]; // simple metric
-        values["frame_status"] = 1.0;
-
-        // snapshot saved automatically for debugging
-        cv::imwrite("last_frame.jpg", frame);
+        // One sweep per metric set (SIMD where available), decimated as configured.
+        const FrameStats stats = computeFrameStats(frame, sampling_);
+        for (auto& region : regions_) {
+            const cv::Rect area = clipToFrame(region.roi, frame);
+            region.stats = area.width > 0 ? computeFrameStats(frame(area), sampling_) : FrameStats{};
+        }
+
+        auto fill = [this, &frame, &stats](Readings& out) {
+            out["frame_width"]  = static_cast<double>(frame.cols);
+            out["frame_height"] = static_cast<double>(frame.rows);
+            out["channels"]     = static_cast<double>(frame.channels());
+            out["frame_status"] = 1.0;
+
+            std::size_t written = kFrameMetrics + putStats(out, stats, frameKeys_);
+            for (const auto& region : regions_) {
+                if (region.stats.channels > 0) {   // off-frame regions report nothing
+                    written += putStats(out, region.stats, region.keys);
+                }
+            }
+            return written;
+        };
+
+        // Overwrite in place; rebuild only if the previous sample had other keys.
+        if (fill(values) != values.size()) {
+            values.clear();
+            fill(values);
+        }
+
+        // Rate-limited debugging snapshot; encoding and disk I/O happen on the writer's thread.
+        if (snapshots_) {
+            snapshots_->offer(frame);
+        }
     } else {
-        values["frame_width"] = 0.0;
-        values["frame_status"] = 0.0;
+        assignReadings(values, {
+            {"frame_width",  0.0},
+            {"frame_status", 0.0},
+        });
     }
-
-    return values;
 }
 
 bool HardwareDataSource::grabFrameToJpeg(const std::string& outfile) {
@@ -94,17 +217,24 @@ void HardwareDataSource::logCameraInfo() {
     cv::Mat frame;
     if(grabFrame(frame))
     {
-        Logger::instance().info("Capturing test frame...");
-        Logger::instance().debug("Backend: " + camera_->getBackendName());
+        frames_.resize(frame.rows, frame.cols, frame.type());
 
-        Logger::instance().debug("Captured a frame at resolution: " +
-                                std::to_string(frame.cols) + "x" + std::to_string(frame.rows));
-
-        cv::Scalar meanColor = cv::mean(frame);
-        Logger::instance().debug("Mean pixel intensity: [" +
-                                std::to_string(meanColor[0]) + ", " +
-                                std::to_string(meanColor[1]) + ", " +
-                                std::to_string(meanColor[2]) + "]");
+        Logger::instance().info("Capturing test frame...");
+        LOGGER_DEBUG("Backend: " + camera_->getBackendName());
+
+        LOGGER_DEBUG("Captured a frame at resolution: " +
+                     std::to_string(frame.cols) + "x" + std::to_string(frame.rows));
+
+        if (!Logger::instance().isEnabled(LogLevel::DEBUG)) {
+            return;   // the statistics below are only logged
+        }
+        const FrameStats stats = computeFrameStats(frame);
+        std::string means;
+        for (int chan = 0; chan < stats.channels; ++chan) {
+            means += (chan == 0 ? "" : ", ") + std::to_string(stats.channel[static_cast<std::size_t>(chan)].mean);
+        }
+        Logger::instance().debug("Mean pixel intensity: [" + means + "], luma " +
+                                std::to_string(stats.luma601));
     }
 }
 
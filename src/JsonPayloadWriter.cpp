@@ -0,0 +1,218 @@
+/**
+ * @file JsonPayloadWriter.cpp
+ * @brief Implementation of the streaming JSON payload encoder.
+ *
+ * @see JsonPayloadWriter
+ */
+
+#include "JsonPayloadWriter.hpp"
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "ReadingLayout.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    // nlohmann prints plain decimals for decimal exponents in (kMinExp, kMaxExp]
+    // and switches to scientific notation outside.
+    constexpr int kMinExp = -4;
+    constexpr int kMaxExp = 15;   // std::numeric_limits<double>::digits10
+
+    // Room for "-d.<16 digits>e-308" and for "0.000<17 digits>".
+    constexpr std::size_t kDoubleChars = 32;
+
+    char hexDigit(unsigned value) {
+        return "0123456789abcdef"[value & 0xFU];
+    }
+
+    // "e+05", "e-12", "e+308": at least two exponent digits, like nlohmann.
+    void appendExponent(std::string& out, int exponent) {
+        out.push_back('e');
+        out.push_back(exponent < 0 ? '-' : '+');
+        const auto magnitude = static_cast<unsigned>(exponent < 0 ? -exponent : exponent);
+        if (magnitude >= 100) {
+            out.push_back(static_cast<char>('0' + magnitude / 100));
+        }
+        out.push_back(static_cast<char>('0' + (magnitude / 10) % 10));
+        out.push_back(static_cast<char>('0' + magnitude % 10));
+    }
+}
+
+// ----- ctor -----
+
+JsonPayloadWriter::JsonPayloadWriter(const SensorConfig& config)
+    : layout_(config.units, &JsonPayloadWriter::renderReadingPrefix)
+{
+    // Keys in std::map order: metadata, readings, sensor_id, timestamp_ms.
+    std::vector<std::pair<std::string, std::string>> metadata(config.metadata.begin(), config.metadata.end());
+    std::sort(metadata.begin(), metadata.end());
+
+    head_.push_back('{');
+    if (!metadata.empty()) {
+        head_ += "\"metadata\":{";
+        for (const auto& [key, value] : metadata) {
+            appendString(head_, key);
+            head_.push_back(':');
+            appendString(head_, value);
+            head_.push_back(',');
+        }
+        head_.back() = '}';
+        head_.push_back(',');
+    }
+
+    tail_ += "\"sensor_id\":";
+    appendString(tail_, config.sensorId);
+    tail_ += ",\"timestamp_ms\":";
+}
+
+// ----- payload -----
+
+void JsonPayloadWriter::encode(const Readings& readings, std::int64_t timestampMs, std::string& out) {
+
+    out.assign(head_);
+    appendReadings(out, readings);
+    out += tail_;
+    appendTimestamp(out, timestampMs);
+}
+
+void JsonPayloadWriter::encodeBuffers(const Readings& readings, std::int64_t timestampMs,
+                                      std::string& scratch, std::vector<ConstBuffer>& pieces) {
+
+    scratch.clear();
+    appendReadings(scratch, readings);
+    const std::size_t readingsEnd = scratch.size();
+    appendTimestamp(scratch, timestampMs);
+
+    // Pointers into scratch are taken only now that it has stopped growing.
+    const std::string_view written(scratch);
+    pieces.clear();
+    pieces.emplace_back(head_);
+    if (readingsEnd > 0) {
+        pieces.emplace_back(written.substr(0, readingsEnd));
+    }
+    pieces.emplace_back(tail_);
+    pieces.emplace_back(written.substr(readingsEnd));
+}
+
+void JsonPayloadWriter::appendReadings(std::string& out, const Readings& readings) {
+    if (readings.empty()) {
+        return;
+    }
+    layout_.gather(readings);
+    out += "\"readings\":{";
+    for (std::size_t idx = 0; idx < layout_.size(); ++idx) {
+        out += layout_.prefix(idx);
+        appendDouble(out, layout_.value(idx));
+        out += "},";
+    }
+    out.back() = '}';
+    out.push_back(',');
+}
+
+void JsonPayloadWriter::appendTimestamp(std::string& out, std::int64_t timestampMs) {
+    appendInteger(out, timestampMs);
+    out += "}\n";
+}
+
+void JsonPayloadWriter::renderReadingPrefix(std::string& out, const std::string& name, const std::string& unit) {
+    appendString(out, name);
+    out += ":{\"unit\":";
+    appendString(out, unit);
+    out += ",\"value\":";
+}
+
+// ----- primitives -----
+
+void JsonPayloadWriter::appendString(std::string& out, std::string_view text) {
+    out.push_back('"');
+    for (const char cha : text) {
+        const auto byte = static_cast<unsigned char>(cha);
+        switch (byte) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b";  break;
+            case '\f': out += "\\f";  break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            default:
+                if (byte < 0x20) {
+                    out += "\\u00";
+                    out.push_back(hexDigit(byte >> 4U));
+                    out.push_back(hexDigit(byte));
+                } else {
+                    out.push_back(cha);
+                }
+                break;
+        }
+    }
+    out.push_back('"');
+}
+
+void JsonPayloadWriter::appendInteger(std::string& out, std::int64_t value) {
+    std::array<char, 24> buf{};
+    const auto result = std::to_chars(buf.data(), buf.data() + buf.size(), value);
+    out.append(buf.data(), result.ptr);
+}
+
+void JsonPayloadWriter::appendDouble(std::string& out, double value) {
+
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+
+    // Shortest round-trip digits, in scientific form: "-d.ddde+XX".
+    std::array<char, kDoubleChars> sci{};
+    const auto result = std::to_chars(sci.data(), sci.data() + sci.size(), value, std::chars_format::scientific);
+    const char* cursor = sci.data();
+    if (*cursor == '-') {
+        out.push_back('-');
+        ++cursor;
+    }
+
+    std::array<char, 20> digits{};
+    int count = 0;
+    for (; *cursor != 'e'; ++cursor) {
+        if (*cursor != '.') {
+            digits[static_cast<std::size_t>(count++)] = *cursor;
+        }
+    }
+    int exponent = 0;
+    std::from_chars(cursor + (cursor[1] == '+' ? 2 : 1), result.ptr, exponent);
+
+    // value = 0.<digits> * 10^point
+    const int point = exponent + 1;
+    const std::string_view all(digits.data(), static_cast<std::size_t>(count));
+
+    if (count <= point && point <= kMaxExp) {              // digits[000].0
+        out += all;
+        out.append(static_cast<std::size_t>(point - count), '0');
+        out += ".0";
+    } else if (0 < point && point <= kMaxExp) {            // dig.its
+        out += all.substr(0, static_cast<std::size_t>(point));
+        out.push_back('.');
+        out += all.substr(static_cast<std::size_t>(point));
+    } else if (kMinExp < point && point <= 0) {            // 0.[000]digits
+        out += "0.";
+        out.append(static_cast<std::size_t>(-point), '0');
+        out += all;
+    } else {                                               // d[.igits]e+XX
+        out.push_back(all[0]);
+        if (count > 1) {
+            out.push_back('.');
+            out += all.substr(1);
+        }
+        appendExponent(out, point - 1);
+    }
+}
@@ -0,0 +1,220 @@
+/**
+ * @file Logger.cpp
+ * @brief Output and async-mode implementation of the Logger.
+ *
+ * Every line, synchronous or not, is formatted into batch_ and written to
+ * the log file and std::cout under mutex_, so lines never interleave and
+ * leftovers of an async session go out before the next synchronous line.
+ *
+ * @see Logger
+ */
+
+#include "Logger.hpp"
+#include "BoundedRing.hpp"
+#include "ConfigTypes.hpp"
+#include "IdleBackoff.hpp"
+#include "TimestampFormatter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+Logger::~Logger() {
+    stopAsync();
+    if (file_.is_open()) {
+        file_.close();
+    }
+}
+
+// ----- logging -----
+
+void Logger::write(LogLevel level, const std::string& message) {
+    if (async_.load(std::memory_order_acquire) && enqueue(level, message)) {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+    drainLocked();   // records still queued from async mode come first
+    appendLine(TimestampFormatter::now(), level, message.data(), message.size(), false);
+    emitLocked(false);
+}
+
+/*
+ * enqueue()
+ * - Copies the message into a ring slot in place: no lock, no allocation.
+ * - Full ring: DROP_NEWEST counts the message as dropped, DROP_OLDEST
+ *   evicts queued records until it fits, BLOCK waits for the writer.
+ * - Errors, and a ring past half full, wake the writer early.
+ * - Returns false only if async mode ended while blocked; the caller then
+ *   logs synchronously.
+ */
+bool Logger::enqueue(LogLevel level, const std::string& message) {
+    MpscRing<LogRecord>& ring = *ring_.load(std::memory_order_acquire);
+    const auto fill = [&](LogRecord& record) {
+        const std::size_t length = std::min(message.size(), LogRecord::kTextSize);
+        record.timeNs    = TimestampFormatter::now();
+        record.level     = level;
+        record.length    = static_cast<std::uint32_t>(length);
+        record.truncated = length < message.size();
+        std::memcpy(record.text.data(), message.data(), length);
+    };
+
+    if (!ring.tryEmplace(fill)) {
+        switch (overflow_) {
+            case QueuePolicy::DROP_NEWEST:
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                break;
+
+            case QueuePolicy::DROP_OLDEST:
+                do {
+                    if (ring.tryConsume([](LogRecord&) {})) {
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                } while (!ring.tryEmplace(fill));
+                break;
+
+            case QueuePolicy::BLOCK: {
+                IdleBackoff backoff;
+                wakeRequested_.store(true, std::memory_order_relaxed);
+                wake_.notify_one();
+                while (!ring.tryEmplace(fill)) {
+                    if (!async_.load(std::memory_order_acquire)) {
+                        return false;
+                    }
+                    backoff.pause();
+                }
+                break;
+            }
+        }
+    }
+
+    if (level == LogLevel::ERROR) {
+        const std::lock_guard<std::mutex> lock(wakeMutex_);   // errors are rare: make sure this wake-up lands
+        wakeRequested_.store(true, std::memory_order_relaxed);
+        wake_.notify_one();
+    } else if (ring.sizeApprox() * 2 >= ring.capacity() && !wakeRequested_.exchange(true, std::memory_order_relaxed)) {
+        wake_.notify_one();   // best effort; flushInterval bounds the delay if it is missed
+    }
+    return true;
+}
+
+// ----- async mode -----
+
+void Logger::startAsync(const LoggingConfig& config) {
+    if (config.queue.depth == 0 || config.flushInterval.count() <= 0) {
+        throw std::invalid_argument("Logger: async mode needs a queue depth and a flush interval above 0");
+    }
+    stopAsync();
+
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        if (rings_.empty() || config.queue.depth != ringDepth_) {
+            rings_.push_back(std::make_unique<MpscRing<LogRecord>>(config.queue.depth));
+            ring_.store(rings_.back().get(), std::memory_order_release);
+            ringDepth_ = config.queue.depth;
+        }
+    }
+    overflow_      = config.queue.policy;
+    flushInterval_ = config.flushInterval;
+    {
+        const std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = false;
+    }
+    async_.store(true, std::memory_order_release);
+    writer_ = std::thread([this] { writerLoop(); });
+}
+
+void Logger::stopAsync() {
+    if (!writer_.joinable()) {
+        return;
+    }
+    async_.store(false, std::memory_order_release);
+    {
+        const std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    writer_.join();
+    flush();
+}
+
+void Logger::flush() {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (drainLocked() > 0) {
+        emitLocked(true);
+    }
+}
+
+void Logger::writerLoop() {
+    std::unique_lock<std::mutex> wakeLock(wakeMutex_);
+    while (!stopping_) {
+        wake_.wait_for(wakeLock, flushInterval_,
+                       [this] { return stopping_ || wakeRequested_.load(std::memory_order_relaxed); });
+        wakeRequested_.store(false, std::memory_order_relaxed);
+        wakeLock.unlock();
+        flush();
+        wakeLock.lock();
+    }
+}
+
+// Format every queued record (and a note about drops) into batch_; returns
+// how many lines were added. Caller holds mutex_.
+std::size_t Logger::drainLocked() {
+    std::size_t lines = 0;
+    for (const auto& ring : rings_) {
+        while (ring->tryConsume([&](const LogRecord& record) {
+            appendLine(record.timeNs, record.level, record.text.data(), record.length, record.truncated);
+        })) {
+            ++lines;
+        }
+    }
+
+    const std::uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != droppedReported_) {
+        const std::string note = std::to_string(dropped - droppedReported_) +
+                                 " log messages dropped: async log queue full";
+        appendLine(TimestampFormatter::now(), LogLevel::WARNING, note.data(), note.size(), false);
+        droppedReported_ = dropped;
+        ++lines;
+    }
+    return lines;
+}
+
+// ----- output -----
+
+void Logger::appendLine(std::int64_t timeNs, LogLevel level, const char* text, std::size_t length, bool truncated) {
+    std::array<char, TimestampFormatter::kMaxLength> stamp{};
+    batch_ += '[';
+    batch_.append(stamp.data(), timestamps_.format(timeNs, stamp.data()));
+    batch_ += "] [";
+    batch_ += levelToString(level);
+    batch_ += "] ";
+    batch_.append(text, length);
+    if (truncated) {
+        batch_ += "...";
+    }
+    batch_ += '\n';
+}
+
+void Logger::emitLocked(bool flushStreams) {
+    if (file_.is_open()) {
+        file_.write(batch_.data(), static_cast<std::streamsize>(batch_.size()));
+        if (flushStreams) {
+            file_.flush();
+        }
+    }
+
+    // Also print to console
+    std::cout.write(batch_.data(), static_cast<std::streamsize>(batch_.size()));
+    if (flushStreams) {
+        std::cout.flush();
+    }
+    batch_.clear();
+}
@@ -0,0 +1,246 @@
+/**
+ * @file MetricIdPayloadEncoder.cpp
+ * @brief Implementation of the dictionary + metric-ID payload encoder.
+ *
+ * @see MetricIdPayloadEncoder
+ */
+
+#include "MetricIdPayloadEncoder.hpp"
+#include "CborPayloadEncoder.hpp"
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "JsonPayloadWriter.hpp"
+#include "MetricRegistry.hpp"
+#include "MsgPackPayloadEncoder.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+
+    constexpr std::uint8_t kCborArray = 4;
+    constexpr std::uint8_t kCborMap   = 5;
+
+    // Writes one structured message in the sensor's format. CBOR and
+    // MessagePack need element counts up front; JSON needs separators,
+    // which are tracked with a single "something came before" flag.
+    class Emitter {
+    public:
+        Emitter(PayloadFormat format, std::string& out) : format_(format), out_(out) {}
+
+        void beginMap(std::size_t members) {
+            separate();
+            switch (format_) {
+                case PayloadFormat::CBOR:    CborPayloadEncoder::appendHead(out_, kCborMap, members); break;
+                case PayloadFormat::MSGPACK: MsgPackPayloadEncoder::appendMapHeader(out_, members); break;
+                default:                     out_.push_back('{'); break;
+            }
+            comma_ = false;
+        }
+
+        void beginArray(std::size_t items) {
+            separate();
+            switch (format_) {
+                case PayloadFormat::CBOR:    CborPayloadEncoder::appendHead(out_, kCborArray, items); break;
+                case PayloadFormat::MSGPACK: MsgPackPayloadEncoder::appendArrayHeader(out_, items); break;
+                default:                     out_.push_back('['); break;
+            }
+            comma_ = false;
+        }
+
+        void endMap()   { close('}'); }
+        void endArray() { close(']'); }
+
+        void key(std::string_view name) {
+            string(name);
+            if (format_ == PayloadFormat::JSON) {
+                out_.push_back(':');
+            }
+            comma_ = false;
+        }
+
+        void string(std::string_view text) {
+            separate();
+            switch (format_) {
+                case PayloadFormat::CBOR:    CborPayloadEncoder::appendText(out_, text); break;
+                case PayloadFormat::MSGPACK: MsgPackPayloadEncoder::appendString(out_, text); break;
+                default:                     JsonPayloadWriter::appendString(out_, text); break;
+            }
+            comma_ = true;
+        }
+
+        void integer(std::int64_t value) {
+            separate();
+            switch (format_) {
+                case PayloadFormat::CBOR:    CborPayloadEncoder::appendInteger(out_, value); break;
+                case PayloadFormat::MSGPACK: MsgPackPayloadEncoder::appendInteger(out_, value); break;
+                default:                     JsonPayloadWriter::appendInteger(out_, value); break;
+            }
+            comma_ = true;
+        }
+
+        void number(double value) {
+            separate();
+            switch (format_) {
+                case PayloadFormat::CBOR:    CborPayloadEncoder::appendDouble(out_, value); break;
+                case PayloadFormat::MSGPACK: MsgPackPayloadEncoder::appendDouble(out_, value); break;
+                default:                     JsonPayloadWriter::appendDouble(out_, value); break;
+            }
+            comma_ = true;
+        }
+
+        // A complete value encoded earlier by an Emitter of the same format.
+        void encoded(std::string_view bytes) {
+            separate();
+            out_ += bytes;
+            comma_ = true;
+        }
+
+        // End of a top-level message: JSON messages are newline-delimited.
+        void endMessage() {
+            if (format_ == PayloadFormat::JSON) {
+                out_.push_back('\n');
+            }
+            comma_ = false;
+        }
+
+    private:
+        void separate() {
+            if (comma_ && format_ == PayloadFormat::JSON) {
+                out_.push_back(',');
+            }
+        }
+
+        void close(char bracket) {
+            if (format_ == PayloadFormat::JSON) {
+                out_.push_back(bracket);
+            }
+            comma_ = true;
+        }
+
+        PayloadFormat format_;
+        std::string&  out_;
+        bool          comma_{false};
+    };
+}
+
+// ----- ctor -----
+
+MetricIdPayloadEncoder::MetricIdPayloadEncoder(const SensorConfig& config)
+    : format_(config.payloadFormat),
+      sensorId_(config.sensorId),
+      metadata_(config.metadata.begin(), config.metadata.end()),
+      dictionaryEvery_(config.metricIds.dictionaryEvery),
+      layout_(config.units, nullptr)
+{
+    if (format_ == PayloadFormat::BINARY) {
+        throw std::invalid_argument("MetricIdPayloadEncoder: metric IDs need the json, cbor or msgpack format");
+    }
+    std::sort(metadata_.begin(), metadata_.end());
+}
+
+// ----- payload -----
+
+void MetricIdPayloadEncoder::encode(const Readings& readings, std::int64_t timestampMs, std::string& out) {
+
+    layout_.gather(readings);
+    if (layout_.generation() != layoutGeneration_ || ids_.empty()) {
+        refreshIds();
+    }
+
+    if (dictionaryEvery_ > 0 && samplesSinceDictionary_ >= dictionaryEvery_) {
+        dictionaryDue_ = true;
+    }
+
+    out.clear();
+    if (dictionaryDue_ || registry_.version() != sentVersion_) {
+        appendDictionary(out);
+        dictionaryDue_ = false;
+        sentVersion_ = registry_.version();
+        samplesSinceDictionary_ = 0;
+    }
+    ++samplesSinceDictionary_;
+
+    // Keys in the same (sorted) order the JSON payload uses.
+    Emitter emit(format_, out);
+    emit.beginMap(5);
+    emit.key("dictionary_version");
+    emit.integer(static_cast<std::int64_t>(registry_.version()));
+    emit.key("ids");
+    emit.encoded(ids_);
+    emit.key("sensor_id");
+    emit.string(sensorId_);
+    emit.key("timestamp_ms");
+    emit.integer(timestampMs);
+    emit.key("values");
+    emit.beginArray(layout_.size());
+    for (std::size_t idx = 0; idx < layout_.size(); ++idx) {
+        emit.number(layout_.value(idx));
+    }
+    emit.endArray();
+    emit.endMap();
+    emit.endMessage();
+}
+
+void MetricIdPayloadEncoder::encodeSessionState(std::string& out) const {
+    out.clear();
+    appendDictionary(out);
+}
+
+void MetricIdPayloadEncoder::refreshIds() {
+    ids_.clear();
+    Emitter emit(format_, ids_);
+    emit.beginArray(layout_.size());
+    for (std::size_t idx = 0; idx < layout_.size(); ++idx) {
+        emit.integer(registry_.intern(layout_.name(idx), layout_.unit(idx)));
+    }
+    emit.endArray();
+    layoutGeneration_ = layout_.generation();
+}
+
+void MetricIdPayloadEncoder::appendDictionary(std::string& out) const {
+    Emitter emit(format_, out);
+    emit.beginMap(2);
+    emit.key("dictionary");
+    emit.beginMap(metadata_.empty() ? 3 : 4);
+
+    if (!metadata_.empty()) {
+        emit.key("metadata");
+        emit.beginMap(metadata_.size());
+        for (const auto& [key, value] : metadata_) {
+            emit.key(key);
+            emit.string(value);
+        }
+        emit.endMap();
+    }
+
+    emit.key("metrics");
+    emit.beginArray(registry_.metrics().size());
+    for (const MetricRegistry::Metric& metric : registry_.metrics()) {
+        emit.beginArray(2);
+        emit.string(metric.name);
+        emit.integer(metric.unitId);
+        emit.endArray();
+    }
+    emit.endArray();
+
+    emit.key("units");
+    emit.beginArray(registry_.units().size());
+    for (const std::string& unit : registry_.units()) {
+        emit.string(unit);
+    }
+    emit.endArray();
+
+    emit.key("version");
+    emit.integer(static_cast<std::int64_t>(registry_.version()));
+    emit.endMap();
+
+    emit.key("sensor_id");
+    emit.string(sensorId_);
+    emit.endMap();
+    emit.endMessage();
+}
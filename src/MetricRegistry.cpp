@@ -0,0 +1,34 @@
+/**
+ * @file MetricRegistry.cpp
+ * @brief Implementation of the metric name/unit registry.
+ *
+ * @see MetricRegistry
+ */
+
+#include "MetricRegistry.hpp"
+
+#include <cstdint>
+#include <string>
+
+std::uint32_t MetricRegistry::intern(const std::string& name, const std::string& unit) {
+    const std::uint32_t unitId = internUnit(unit);
+
+    const auto [itr, inserted] = metricIds_.try_emplace(name, static_cast<std::uint32_t>(metrics_.size()));
+    if (inserted) {
+        metrics_.push_back(Metric{name, unitId});
+        ++version_;
+    } else if (metrics_[itr->second].unitId != unitId) {
+        metrics_[itr->second].unitId = unitId;
+        ++version_;
+    }
+    return itr->second;
+}
+
+std::uint32_t MetricRegistry::internUnit(const std::string& unit) {
+    const auto [itr, inserted] = unitIds_.try_emplace(unit, static_cast<std::uint32_t>(units_.size()));
+    if (inserted) {
+        units_.push_back(unit);
+        ++version_;
+    }
+    return itr->second;
+}
@@ -37,7 +37,7 @@ bool MockCamera::read(cv::Mat& frame) {
     if (!opened_ || index_ >= frames_.size()) {
         return false;
     }
-    frame = frames_[index_++].clone();
+    frames_[index_++].copyTo(frame);   // reuses 'frame' if already sized
     return true;
 }
 
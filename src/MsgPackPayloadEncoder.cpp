@@ -0,0 +1,212 @@
+/**
+ * @file MsgPackPayloadEncoder.cpp
+ * @brief Implementation of the MessagePack payload encoder.
+ *
+ * @see MsgPackPayloadEncoder
+ */
+
+#include "MsgPackPayloadEncoder.hpp"
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "ReadingLayout.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    constexpr char kNil      = static_cast<char>(0xC0);
+    constexpr char kFloat32  = static_cast<char>(0xCA);
+    constexpr char kFloat64  = static_cast<char>(0xCB);
+    constexpr char kUint8    = static_cast<char>(0xCC);
+    constexpr char kUint16   = static_cast<char>(0xCD);
+    constexpr char kUint32   = static_cast<char>(0xCE);
+    constexpr char kUint64   = static_cast<char>(0xCF);
+    constexpr char kInt8     = static_cast<char>(0xD0);
+    constexpr char kInt16    = static_cast<char>(0xD1);
+    constexpr char kInt32    = static_cast<char>(0xD2);
+    constexpr char kInt64    = static_cast<char>(0xD3);
+    constexpr char kStr8     = static_cast<char>(0xD9);
+    constexpr char kStr16    = static_cast<char>(0xDA);
+    constexpr char kStr32    = static_cast<char>(0xDB);
+    constexpr char kArray16  = static_cast<char>(0xDC);
+    constexpr char kArray32  = static_cast<char>(0xDD);
+    constexpr char kMap16    = static_cast<char>(0xDE);
+    constexpr char kMap32    = static_cast<char>(0xDF);
+
+    constexpr unsigned kFixMap   = 0x80U;
+    constexpr unsigned kFixArray = 0x90U;
+    constexpr unsigned kFixStr   = 0xA0U;
+
+    void appendBigEndian(std::string& out, std::uint64_t value, int bytes) {
+        for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<char>((value >> static_cast<unsigned>(shift)) & 0xFFU));
+        }
+    }
+}
+
+// ----- ctor -----
+
+MsgPackPayloadEncoder::MsgPackPayloadEncoder(const SensorConfig& config)
+    : layout_(config.units, &MsgPackPayloadEncoder::renderReadingPrefix)
+{
+    // Same key order as the JSON payload.
+    std::vector<std::pair<std::string, std::string>> metadata(config.metadata.begin(), config.metadata.end());
+    std::sort(metadata.begin(), metadata.end());
+
+    if (!metadata.empty()) {
+        appendString(metadata_, "metadata");
+        appendMapHeader(metadata_, metadata.size());
+        for (const auto& [key, value] : metadata) {
+            appendString(metadata_, key);
+            appendString(metadata_, value);
+        }
+    }
+
+    appendString(tail_, "sensor_id");
+    appendString(tail_, config.sensorId);
+    appendString(tail_, "timestamp_ms");
+}
+
+// ----- payload -----
+
+void MsgPackPayloadEncoder::encode(const Readings& readings, std::int64_t timestampMs, std::string& out) {
+
+    out.clear();
+    appendMapHeader(out, 2 + (metadata_.empty() ? 0U : 1U) + (readings.empty() ? 0U : 1U));
+    out += metadata_;
+
+    if (!readings.empty()) {
+        layout_.gather(readings);
+        appendString(out, "readings");
+        appendMapHeader(out, layout_.size());
+        for (std::size_t idx = 0; idx < layout_.size(); ++idx) {
+            out += layout_.prefix(idx);
+            appendDouble(out, layout_.value(idx));
+        }
+    }
+
+    out += tail_;
+    appendInteger(out, timestampMs);
+}
+
+void MsgPackPayloadEncoder::renderReadingPrefix(std::string& out, const std::string& name, const std::string& unit) {
+    appendString(out, name);
+    appendMapHeader(out, 2);
+    appendString(out, "unit");
+    appendString(out, unit);
+    appendString(out, "value");
+}
+
+// ----- primitives -----
+
+void MsgPackPayloadEncoder::appendMapHeader(std::string& out, std::size_t entries) {
+    if (entries < 16) {
+        out.push_back(static_cast<char>(kFixMap | entries));
+    } else if (entries <= 0xFFFFU) {
+        out.push_back(kMap16);
+        appendBigEndian(out, entries, 2);
+    } else {
+        out.push_back(kMap32);
+        appendBigEndian(out, entries, 4);
+    }
+}
+
+void MsgPackPayloadEncoder::appendArrayHeader(std::string& out, std::size_t items) {
+    if (items < 16) {
+        out.push_back(static_cast<char>(kFixArray | items));
+    } else if (items <= 0xFFFFU) {
+        out.push_back(kArray16);
+        appendBigEndian(out, items, 2);
+    } else {
+        out.push_back(kArray32);
+        appendBigEndian(out, items, 4);
+    }
+}
+
+void MsgPackPayloadEncoder::appendString(std::string& out, std::string_view text) {
+    const std::size_t size = text.size();
+    if (size < 32) {
+        out.push_back(static_cast<char>(kFixStr | size));
+    } else if (size <= 0xFFU) {
+        out.push_back(kStr8);
+        appendBigEndian(out, size, 1);
+    } else if (size <= 0xFFFFU) {
+        out.push_back(kStr16);
+        appendBigEndian(out, size, 2);
+    } else {
+        out.push_back(kStr32);
+        appendBigEndian(out, size, 4);
+    }
+    out += text;
+}
+
+void MsgPackPayloadEncoder::appendInteger(std::string& out, std::int64_t value) {
+    if (value >= 0) {
+        const auto magnitude = static_cast<std::uint64_t>(value);
+        if (magnitude < 128) {
+            out.push_back(static_cast<char>(magnitude));   // positive fixint
+        } else if (magnitude <= 0xFFU) {
+            out.push_back(kUint8);
+            appendBigEndian(out, magnitude, 1);
+        } else if (magnitude <= 0xFFFFU) {
+            out.push_back(kUint16);
+            appendBigEndian(out, magnitude, 2);
+        } else if (magnitude <= 0xFFFFFFFFU) {
+            out.push_back(kUint32);
+            appendBigEndian(out, magnitude, 4);
+        } else {
+            out.push_back(kUint64);
+            appendBigEndian(out, magnitude, 8);
+        }
+        return;
+    }
+
+    const auto bits = static_cast<std::uint64_t>(value);   // two's complement
+    if (value >= -32) {
+        out.push_back(static_cast<char>(bits & 0xFFU));      // negative fixint
+    } else if (value >= std::numeric_limits<std::int8_t>::min()) {
+        out.push_back(kInt8);
+        appendBigEndian(out, bits, 1);
+    } else if (value >= std::numeric_limits<std::int16_t>::min()) {
+        out.push_back(kInt16);
+        appendBigEndian(out, bits, 2);
+    } else if (value >= std::numeric_limits<std::int32_t>::min()) {
+        out.push_back(kInt32);
+        appendBigEndian(out, bits, 4);
+    } else {
+        out.push_back(kInt64);
+        appendBigEndian(out, bits, 8);
+    }
+}
+
+void MsgPackPayloadEncoder::appendDouble(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        out.push_back(kNil);
+        return;
+    }
+
+    if (std::abs(value) <= std::numeric_limits<float>::max()) {
+        const auto narrow = static_cast<float>(value);
+        if (static_cast<double>(narrow) == value) {
+            std::uint32_t bits = 0;
+            std::memcpy(&bits, &narrow, sizeof(bits));
+            out.push_back(kFloat32);
+            appendBigEndian(out, bits, 4);
+            return;
+        }
+    }
+
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    out.push_back(kFloat64);
+    appendBigEndian(out, bits, 8);
+}
@@ -0,0 +1,90 @@
+/**
+ * @file PayloadBatcher.cpp
+ * @brief Implementation of the sample batcher.
+ *
+ * @see PayloadBatcher
+ */
+
+#include "PayloadBatcher.hpp"
+#include "ConfigTypes.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>  // std::move
+
+PayloadBatcher::PayloadBatcher(const BatchConfig& config, std::size_t transportLimit, SendFn send)
+    : send_(std::move(send)),
+      linger_(std::chrono::duration_cast<Clock::duration>(config.linger))
+{
+    if (config.maxSamples == 0) {
+        throw std::invalid_argument("PayloadBatcher: maxSamples must be > 0");
+    }
+    if (config.linger < std::chrono::milliseconds::zero()) {
+        throw std::invalid_argument("PayloadBatcher: linger must be >= 0");
+    }
+
+    std::size_t maxBytes = config.maxBytes;
+    if (transportLimit > 0) {
+        maxBytes = maxBytes == 0 ? transportLimit : std::min(maxBytes, transportLimit);
+    }
+    stats_.maxBytes   = maxBytes == 0 ? kDefaultMaxBytes : maxBytes;
+    stats_.maxSamples = config.maxSamples;
+
+    buffer_.reserve(stats_.maxBytes);
+}
+
+void PayloadBatcher::add(const std::string& payload, Clock::time_point now) {
+
+    if (count_ > 0 && buffer_.size() + payload.size() > stats_.maxBytes) {
+        send(stats_.flushedBySize);
+    }
+
+    if (count_ == 0) {
+        oldest_ = now;
+    }
+    buffer_ += payload;
+    ++count_;
+
+    if (payload.size() > stats_.maxBytes) {
+        ++stats_.oversize;
+        send(stats_.flushedBySize);
+    } else if (count_ >= stats_.maxSamples) {
+        send(stats_.flushedByCount);
+    } else {
+        flushIfDue(now);
+    }
+}
+
+void PayloadBatcher::flushIfDue(Clock::time_point now) {
+    if (count_ > 0 && now - oldest_ >= linger_) {
+        send(stats_.flushedByLinger);
+    }
+}
+
+void PayloadBatcher::flush() {
+    if (count_ > 0) {
+        send(stats_.flushedByLinger);
+    }
+}
+
+void PayloadBatcher::send(std::uint64_t& reason) {
+    // If the transport throws, the batch is dropped rather than resent forever.
+    const std::size_t samples = count_;
+    count_ = 0;
+    try {
+        send_(buffer_);
+    } catch (...) {
+        buffer_.clear();
+        throw;
+    }
+
+    ++reason;
+    ++stats_.batches;
+    stats_.samples += samples;
+    stats_.bytes   += buffer_.size();
+    buffer_.clear();
+}
@@ -0,0 +1,33 @@
+// PayloadEncoderFactory.cpp
+#include "PayloadEncoderFactory.hpp"
+#include "BinaryPayloadEncoder.hpp"
+#include "CborPayloadEncoder.hpp"
+#include "ConfigTypes.hpp"
+#include "IPayloadEncoder.hpp"
+#include "JsonPayloadWriter.hpp"
+#include "MetricIdPayloadEncoder.hpp"
+#include "MsgPackPayloadEncoder.hpp"
+
+#include <memory> // for std::make_unique
+#include <stdexcept>
+
+
+std::unique_ptr<IPayloadEncoder> PayloadEncoderFactory::make(const SensorConfig& cfg) {
+
+    if (cfg.metricIds.enabled) {
+        return std::make_unique<MetricIdPayloadEncoder>(cfg);
+    }
+
+    switch (cfg.payloadFormat) {
+        case PayloadFormat::JSON:
+            return std::make_unique<JsonPayloadWriter>(cfg);
+        case PayloadFormat::CBOR:
+            return std::make_unique<CborPayloadEncoder>(cfg);
+        case PayloadFormat::MSGPACK:
+            return std::make_unique<MsgPackPayloadEncoder>(cfg);
+        case PayloadFormat::BINARY:
+            return std::make_unique<BinaryPayloadEncoder>(cfg);
+    }
+
+    throw std::runtime_error("PayloadEncoderFactory: unsupported payload format");
+}
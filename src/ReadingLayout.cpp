@@ -0,0 +1,107 @@
+/**
+ * @file ReadingLayout.cpp
+ * @brief Implementation of the cached reading layout shared by the encoders.
+ *
+ * @see ReadingLayout
+ */
+
+#include "ReadingLayout.hpp"
+#include "IDataSource.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>  // std::move
+
+namespace {
+
+    // Decimals kept in reading values (the collector never wanted more).
+    constexpr double kValueScale = 100.0;
+
+    constexpr std::uint32_t kFnvOffset = 2166136261U;
+    constexpr std::uint32_t kFnvPrime  = 16777619U;
+
+    // Hash 'text' and a terminating NUL, so "ab"+"c" differs from "a"+"bc".
+    std::uint32_t fnv1a(std::uint32_t hash, std::string_view text) {
+        for (const char cha : text) {
+            hash = (hash ^ static_cast<unsigned char>(cha)) * kFnvPrime;
+        }
+        return hash * kFnvPrime;
+    }
+}
+
+ReadingLayout::ReadingLayout(Units units, RenderPrefix renderPrefix)
+    : units_(std::move(units)),
+      renderPrefix_(renderPrefix)
+{
+}
+
+void ReadingLayout::gather(const Readings& readings) {
+    if (readings.size() != entries_.size() || !collect(readings)) {
+        rebuild(readings);
+        (void)collect(readings);
+    }
+}
+
+bool ReadingLayout::collect(const Readings& readings) {
+    for (std::size_t idx = 0; idx < entries_.size(); ++idx) {
+        const auto itr = readings.find(entries_[idx].name);
+        if (itr == readings.end()) {
+            return false;   // key set changed with the same size
+        }
+        values_[idx] = std::round(itr->second * kValueScale) / kValueScale;
+    }
+    return true;
+}
+
+void ReadingLayout::rebuild(const Readings& readings) {
+    entries_.clear();
+    entries_.reserve(readings.size());
+    for (const auto& reading : readings) {
+        entries_.push_back(Entry{reading.first, inferUnit(units_, reading.first), {}});
+    }
+    std::sort(entries_.begin(), entries_.end(),
+              [](const Entry& lhs, const Entry& rhs) { return lhs.name < rhs.name; });
+
+    schemaId_ = kFnvOffset;
+    for (Entry& entry : entries_) {
+        if (renderPrefix_ != nullptr) {
+            renderPrefix_(entry.prefix, entry.name, entry.unit);
+        }
+        schemaId_ = fnv1a(fnv1a(schemaId_, entry.name), entry.unit);
+    }
+    values_.assign(entries_.size(), 0.0);
+    ++generation_;
+}
+
+std::string ReadingLayout::inferUnit(const Units& units, std::string_view readingName) {
+    if (auto itr = units.find(std::string(readingName)); itr != units.end()) {
+        return itr->second;
+    }
+    // sensible defaults for image-sensor fields
+    if (readingName.find("width")     != std::string_view::npos ||
+        readingName.find("height")    != std::string_view::npos) {
+            return "pixels";
+    }
+    if (readingName.find("channels")  != std::string_view::npos) {
+        return "count";
+    }
+    if (readingName.find("bytes")     != std::string_view::npos ||
+        readingName.find("size")      != std::string_view::npos) {
+            return "bytes";
+    }
+    if (readingName.find("variance")  != std::string_view::npos) {
+        return "intensity^2";
+    }
+    if (readingName.find("brightness")!= std::string_view::npos ||
+        readingName.find("luma")      != std::string_view::npos ||
+        readingName.find("_mean")     != std::string_view::npos ||
+        readingName.find("_min")      != std::string_view::npos ||
+        readingName.find("_max")      != std::string_view::npos) {
+            return "intensity";
+    }
+    return "unknown";
+}
@@ -0,0 +1,350 @@
+/**
+ * @file ReconnectingTransport.cpp
+ * @brief Implementation of the reconnecting transport decorator.
+ *
+ * @see ReconnectingTransport
+ */
+
+#include "ReconnectingTransport.hpp"
+#include "ConfigTypes.hpp"
+#include "ConstBuffer.hpp"
+#include "DiskSpool.hpp"
+#include "ITransport.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>  // std::move
+
+namespace {
+
+    // initialBackoff * 2^n saturates long before this many doublings.
+    constexpr std::uint32_t kMaxDoublings = 30;
+
+    std::uint64_t randomSeed() {
+        std::random_device device;
+        return (static_cast<std::uint64_t>(device()) << 32U) ^ device();
+    }
+}
+
+// ----- ctor -----
+
+ReconnectingTransport::ReconnectingTransport(std::unique_ptr<ITransport> inner, const ReconnectConfig& config)
+    : ReconnectingTransport(std::move(inner), config, randomSeed())
+{
+}
+
+ReconnectingTransport::ReconnectingTransport(std::unique_ptr<ITransport> inner, const ReconnectConfig& config,
+                                             std::uint64_t seed)
+    : inner_(std::move(inner)),
+      config_(config),
+      rng_(seed)
+{
+    if (!inner_) {
+        throw std::invalid_argument("ReconnectingTransport: transport must not be null");
+    }
+    if (config_.initialBackoff.count() <= 0 || config_.maxBackoff < config_.initialBackoff) {
+        throw std::invalid_argument("ReconnectingTransport: need 0 < initial backoff <= max backoff");
+    }
+    if (config_.maxAttempts == 0 || config_.attemptWindow.count() < 0) {
+        throw std::invalid_argument("ReconnectingTransport: need at least one attempt per window");
+    }
+    replayTokens_ = static_cast<double>(config_.replayRate);
+    if (config_.spool.enabled) {
+        spool_ = std::make_unique<DiskSpool>(config_.spool);
+        if (!spool_->empty()) {
+            Logger::instance().info("Spool '" + config_.spool.directory + "' holds " +
+                                    std::to_string(spool_->records()) + " payloads from an earlier run.");
+        }
+    }
+}
+
+// ----- link management -----
+
+void ReconnectingTransport::connect() {
+    open_ = true;
+    if (!up_) {
+        attemptConnect(Clock::now());
+    }
+}
+
+void ReconnectingTransport::close() {
+    open_ = false;
+    up_ = false;
+    replayInFlight_ = false;   // not flushed: stays queued (spooled) and is sent again
+    if (spool_) {
+        spool_->sync();
+        if (!spool_->empty()) {
+            Logger::instance().info("Transport closed; " + std::to_string(spool_->records()) +
+                                    " payloads stay spooled for the next run.");
+        }
+    } else if (!queue_.empty()) {
+        Logger::instance().warning("Transport closed with " + std::to_string(queue_.size()) +
+                                   " queued payloads undelivered.");
+        queue_.clear();
+    }
+    inner_->close();
+}
+
+bool ReconnectingTransport::ensureConnected(Clock::time_point now, Clock::time_point replayUntil) {
+    if (!up_ && now >= nextAttempt_) {
+        attemptConnect(now);
+    }
+    return up_ && replay(replayUntil);
+}
+
+void ReconnectingTransport::attemptConnect(Clock::time_point now) {
+
+    // Attempts older than the window no longer count against the cap.
+    while (!recentAttempts_.empty() && now - recentAttempts_.front() >= config_.attemptWindow) {
+        recentAttempts_.pop_front();
+    }
+    recentAttempts_.push_back(now);
+    ++stats_.attempts;
+
+    try {
+        inner_->connect();
+    } catch (const std::exception& error) {
+        failures_ = std::min(failures_ + 1, kMaxDoublings);
+        nextAttempt_ = now + backoff(failures_);
+        if (recentAttempts_.size() >= config_.maxAttempts) {
+            nextAttempt_ = std::max(nextAttempt_, recentAttempts_.front() + config_.attemptWindow);
+        }
+        Logger::instance().warning(std::string("Transport connect failed: ") + error.what() + "; retrying in " +
+                                   std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       nextAttempt_ - now).count()) + " ms.");
+        return;
+    }
+
+    up_ = true;
+    failures_ = 0;
+    preambleDue_ = true;
+    ++stats_.connects;
+    if (sessions_.fetch_add(1, std::memory_order_acq_rel) > 0) {
+        Logger::instance().info("Transport reconnected; replaying " + std::to_string(queuedPayloads()) +
+                                " queued payloads.");
+    }
+}
+
+// Delivers queued payloads oldest first, after the preamble they need on a
+// new session: kReplayBurst of them, then more until 'until', as fast as
+// replayRate allows. False if the link broke again or a backlog is left.
+bool ReconnectingTransport::replay(Clock::time_point until) {
+    try {
+        if (preambleDue_ && hasQueued() && !preamble_.empty()) {
+            inner_->sendString(preamble_);
+        }
+        preambleDue_ = false;   // without a backlog the next sample carries the state itself
+
+        std::size_t burst = 0;
+        while (hasQueued()) {
+            if (replayInFlight_) {
+                // Popped only once flushed: bytes the inner transport still
+                // buffers are lost with the link or the process.
+                if (!inner_->flushUntil(Clock::now())) {
+                    return false;
+                }
+                popReplayed();
+                continue;
+            }
+            if (burst >= kReplayBurst && Clock::now() >= until) {
+                return false;   // the next send or flush carries on
+            }
+            const std::string* next = &replayBuffer_;
+            if (spool_) {
+                if (!spool_->front(replayBuffer_)) {
+                    break;   // the rest had expired
+                }
+            } else {
+                next = &queue_.front();
+            }
+            if (!replayTokenAvailable(Clock::now())) {
+                return false;
+            }
+            inner_->sendString(*next);
+            replayInFlight_ = true;
+            ++burst;
+        }
+    } catch (const std::exception& error) {
+        linkDown(error, Clock::now());
+        return false;
+    }
+    return true;
+}
+
+void ReconnectingTransport::popReplayed() {
+    replayInFlight_ = false;
+    if (spool_) {
+        if (!spool_->frontHeld()) {
+            return;   // evicted by a spool cap while in flight
+        }
+        spool_->pop();
+    } else {
+        queue_.pop_front();
+    }
+    ++stats_.replayed;
+}
+
+// Token bucket: replayRate tokens per second, at most one second's worth.
+bool ReconnectingTransport::replayTokenAvailable(Clock::time_point now) {
+    if (config_.replayRate == 0) {
+        return true;
+    }
+    const double rate = static_cast<double>(config_.replayRate);
+    if (now > tokensRefilled_) {
+        const std::chrono::duration<double> elapsed = now - tokensRefilled_;
+        replayTokens_ = std::min(rate, replayTokens_ + elapsed.count() * rate);
+        tokensRefilled_ = now;
+    }
+    if (replayTokens_ < 1.0) {
+        return false;
+    }
+    replayTokens_ -= 1.0;
+    return true;
+}
+
+bool ReconnectingTransport::hasQueued() const noexcept {
+    return spool_ ? !spool_->empty() : !queue_.empty();
+}
+
+std::size_t ReconnectingTransport::queuedPayloads() const noexcept {
+    return spool_ ? static_cast<std::size_t>(spool_->records()) : queue_.size();
+}
+
+void ReconnectingTransport::linkDown(const std::exception& error, Clock::time_point now) {
+    ++stats_.linkLosses;
+    up_ = false;
+    replayInFlight_ = false;    // sent again on the next session
+    preambleSpooled_ = false;   // this outage's payloads get their own copy
+    inner_->close();
+
+    // The first retry is jittered too: sensors that lost the same collector
+    // at the same moment must not all come back at the same moment.
+    failures_ = 0;
+    nextAttempt_ = now + backoff(0);
+    Logger::instance().warning(std::string("Transport lost: ") + error.what() + "; reconnecting (" +
+                               std::to_string(queuedPayloads()) + " payloads queued).");
+}
+
+std::chrono::milliseconds ReconnectingTransport::backoff(std::uint32_t failures) {
+    const auto doublings = std::min(failures, kMaxDoublings);
+    const auto ceiling = std::min(config_.maxBackoff, config_.initialBackoff * (std::int64_t{1} << doublings));
+    return std::chrono::milliseconds(
+        static_cast<std::chrono::milliseconds::rep>(rng_.nextUnit() * static_cast<double>(ceiling.count())));
+}
+
+// ----- sending -----
+
+std::size_t ReconnectingTransport::sendString(const std::string& payload) {
+    if (!open_) {
+        throw std::runtime_error("ReconnectingTransport: not connected");
+    }
+
+    const auto now = Clock::now();
+    if (ensureConnected(now, now)) {
+        try {
+            return inner_->sendString(payload);
+        } catch (const std::exception& error) {
+            linkDown(error, now);
+        }
+    }
+    queue(payload);
+    return payload.size();
+}
+
+std::size_t ReconnectingTransport::sendBuffers(const ConstBuffer* buffers, std::size_t count) {
+    if (!open_) {
+        throw std::runtime_error("ReconnectingTransport: not connected");
+    }
+
+    const auto now = Clock::now();
+    if (ensureConnected(now, now)) {
+        try {
+            return inner_->sendBuffers(buffers, count);
+        } catch (const std::exception& error) {
+            linkDown(error, now);
+        }
+    }
+
+    std::string joined;
+    joined.reserve(totalSize(buffers, count));
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        joined.append(static_cast<const char*>(buffers[idx].data), buffers[idx].size);
+    }
+    const std::size_t len = joined.size();
+    queue(std::move(joined));
+    return len;
+}
+
+bool ReconnectingTransport::flushUntil(Clock::time_point deadline) {
+    if (!open_) {
+        return !hasQueued();
+    }
+    if (spool_) {
+        spool_->syncIfDue();   // group sync even when nothing is appended or replayed
+    }
+    const bool caughtUp = ensureConnected(Clock::now(), deadline);
+    if (!up_) {
+        return false;
+    }
+    try {
+        if (!inner_->flushUntil(deadline)) {
+            return false;
+        }
+    } catch (const std::exception& error) {
+        linkDown(error, Clock::now());
+        return false;
+    }
+    if (replayInFlight_) {
+        popReplayed();   // the last one replayed, flushed now
+    }
+    return caughtUp || !hasQueued();
+}
+
+void ReconnectingTransport::setSessionPreamble(const std::string& preamble) {
+    if (preamble != preamble_) {
+        preamble_ = preamble;
+        preambleSpooled_ = false;
+    }
+}
+
+void ReconnectingTransport::queue(std::string payload) {
+    if (spool_) {
+        try {
+            // Self-describing after a restart: the preamble goes in first.
+            if (!preambleSpooled_ && !preamble_.empty()) {
+                spool_->append(preamble_);
+                preambleSpooled_ = true;
+            }
+            spool_->append(payload);
+        } catch (const std::exception& error) {
+            Logger::instance().error(std::string("Spooling a payload failed: ") + error.what());
+            ++stats_.dropped;
+            return;
+        }
+        ++stats_.queued;
+        return;
+    }
+    if (config_.queueSamples == 0) {
+        ++stats_.dropped;
+        return;
+    }
+    if (queue_.size() >= config_.queueSamples) {
+        if (replayInFlight_) {
+            replayInFlight_ = false;   // the front was sent already, just not flushed
+            ++stats_.replayed;
+        } else {
+            ++stats_.dropped;
+        }
+        queue_.pop_front();
+    }
+    queue_.push_back(std::move(payload));
+    ++stats_.queued;
+}
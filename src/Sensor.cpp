@@ -12,46 +12,148 @@
 
 #include "Sensor.hpp"
 
-#include "HardwareDataSource.hpp"
+#include "IDataSource.hpp"
 #include "ITransport.hpp"
 #include "ConfigTypes.hpp"
+#include "IPayloadEncoder.hpp"
+#include "PayloadEncoderFactory.hpp"
 #include "Logger.hpp"
+#include "PayloadBatcher.hpp"
+#include "SensorPipeline.hpp"
+#include "TickScheduler.hpp"
 
-#include <nlohmann/json.hpp>
+#include <algorithm>  // std::min
 #include <chrono>
+#include <cstdint>
 #include <string>
-#include <unordered_map>
 #include <stdexcept>
-#include <string_view>
-#include <cmath>
-#include <thread>
 #include <atomic>
+#include <mutex>
+#include <thread>
 #include <utility>  // std::move
 #include <memory>   // std::unique_ptr
 
-using json = nlohmann::json;    // NOLINT(misc-include-cleaner)
+namespace {
+
+    // Flushing between ticks stops a tenth of a period (at most this long)
+    // before the next deadline, so that a flush returning a little late, or
+    // a thread that is not rescheduled at once, never makes the tick late.
+    constexpr std::chrono::milliseconds kMaxFlushMargin{2};
+
+    // Validated tick period; runs before the scheduler member is constructed.
+    std::chrono::nanoseconds tickPeriod(const SensorConfig& config) {
+        if (config.interval <= std::chrono::microseconds::zero()) {
+            throw std::invalid_argument("Sensor: interval must be > 0");
+        }
+        return config.interval;
+    }
+
+    // Human-readable interval in the coarsest exact unit ("2 s", "250 ms", "500 us").
+    std::string describeInterval(std::chrono::microseconds interval) {
+        using std::chrono::microseconds;
+        using std::chrono::milliseconds;
+        using std::chrono::seconds;
+        if (interval % seconds(1) == microseconds::zero()) {
+            return std::to_string(std::chrono::duration_cast<seconds>(interval).count()) + " s";
+        }
+        if (interval % milliseconds(1) == microseconds::zero()) {
+            return std::to_string(std::chrono::duration_cast<milliseconds>(interval).count()) + " ms";
+        }
+        return std::to_string(interval.count()) + " us";
+    }
+
+    std::string toMicrosString(std::chrono::nanoseconds value) {
+        return std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(value).count()) + "us";
+    }
+
+    // Wall-clock timestamp stamped on each sample (ms since epoch).
+    std::int64_t currentTimestampMs() {
+        const auto now = std::chrono::system_clock::now();
+        return std::chrono::time_point_cast<std::chrono::milliseconds>(now)
+                   .time_since_epoch()
+                   .count();
+    }
+
+    std::string describeStage(const char* name, const StageStats& stage) {
+        return std::string(name) + " " + std::to_string(stage.processed) + " (" +
+               std::to_string(stage.dropped) + " dropped, " +
+               std::to_string(static_cast<std::int64_t>(stage.itemsPerBusySecond())) + "/s busy)";
+    }
+}
 
 // ----- ctor -----
 Sensor::Sensor(const SensorConfig& config,
-               std::unique_ptr<HardwareDataSource> dataSource,
+               std::unique_ptr<IDataSource> dataSource,
                std::unique_ptr<ITransport> transport)
     : config_(config),
       sensorId_(config.sensorId),
-      intervalSeconds_(config.intervalSeconds),
+      interval_(config.interval),
       dataSource_(std::move(dataSource)),
-      transport_(std::move(transport))
+      transport_(std::move(transport)),
+      encoder_(PayloadEncoderFactory::make(config)),
+      scheduler_(tickPeriod(config), config.overrunPolicy)
 {
     if (sensorId_.empty()) {
         throw std::invalid_argument("Sensor: sensorId must not be empty");
     }
-    if (intervalSeconds_ <= 0) {
-        throw std::invalid_argument("Sensor: intervalSeconds must be > 0");
+
+    if (config_.batch.enabled) {
+        batcher_ = std::make_unique<PayloadBatcher>(
+            config_.batch, transport_->maxMessageSize(),
+            [this](const std::string& batch) { transport_->sendString(batch); });
+    }
+
+    if (config_.pipeline.enabled) {
+        pipeline_ = std::make_unique<SensorPipeline>(
+            config_.pipeline,
+            [this](Sample& sample) {
+                dataSource_->readInto(sample.readings);
+                sample.timestampMs = currentTimestampMs();
+            },
+            [this](const Sample& sample, std::string& payload) {
+                buildPayload(sample.readings, sample.timestampMs, payload);
+            },
+            [this](const std::string& payload) {
+                // Backpressure: drain what the socket takes now, shed the
+                // payload if that was not enough (see syncEncoderSession()).
+                if (transport_->congested()) {
+                    transport_->flushUntil(PayloadBatcher::Clock::now());
+                    if (transport_->congested()) {
+                        shed_.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                }
+                send(payload);
+            },
+            [this] {
+                if (batcher_) {
+                    batcher_->flushIfDue(PayloadBatcher::Clock::now());
+                }
+                transport_->flushUntil(PayloadBatcher::Clock::now());   // one non-blocking attempt
+            });
+    }
+}
+
+// ----- config reload -----
+void Sensor::reloadConfig(const SensorConfig& config) {
+    if (config.sensorId.empty()) {
+        throw std::invalid_argument("Sensor: sensorId must not be empty");
     }
+
+    encoder_ = PayloadEncoderFactory::make(config);   // re-renders the static prefix
+    config_.sensorId      = config.sensorId;
+    config_.metadata      = config.metadata;
+    config_.units         = config.units;
+    config_.payloadFormat = config.payloadFormat;
+    config_.metricIds     = config.metricIds;
+    sensorId_             = config.sensorId;
+    stateCaptured_        = false;   // the new encoder starts its own state
 }
 
 // ----- connect/close -----
 void Sensor::connect() {
     transport_->connect();
+    encoder_->resetSession();   // a new connection starts without our dictionary
 }
 
 void Sensor::close() noexcept {
@@ -60,95 +162,185 @@ void Sensor::close() noexcept {
 
 void Sensor::run(std::atomic<bool>& running) {
 
-    Logger::instance().info("Sensor started, sending every " + std::to_string(intervalSeconds_) + " seconds.");
+    Logger::instance().info("Sensor started, sending every " + describeInterval(interval_) +
+                            (pipeline_ ? " (pipelined)." : "."));
 
-    while (running) {
+    if (pipeline_) {
+        // Capture stays on this thread; encode and send get their own threads.
+        pipeline_->run(running, scheduler_);
 
-        Logger::instance().debug("Sensor tick: reading data and sending...");
-        runOnce();
-        std::this_thread::sleep_for(std::chrono::seconds(intervalSeconds_));
+        const PipelineStats stats = pipeline_->stats();
+        Logger::instance().info("Sensor pipeline: " + describeStage("captured", stats.capture) + ", " +
+                                describeStage("encoded", stats.encode) + ", " +
+                                describeStage("sent", stats.send) + ".");
+    } else {
+        runInline(running);
     }
-}
 
-// ----- one tick: read -> json -> send -----
-void Sensor::runOnce() {
-    // 1) get current readings
-    const auto values = dataSource_->readAll();
+    if (batcher_) {
+        batcher_->flush();   // don't strand the last, partly filled batch
+
+        const BatchStats& batches = batcher_->stats();
+        Logger::instance().info("Sensor batching: " + std::to_string(batches.samples) + " samples in " +
+                                std::to_string(batches.batches) + " batches, fill " +
+                                std::to_string(static_cast<int>(batches.sampleFillRatio() * 100.0)) + "% of " +
+                                std::to_string(batches.maxSamples) + " samples / " +
+                                std::to_string(static_cast<int>(batches.byteFillRatio() * 100.0)) + "% of " +
+                                std::to_string(batches.maxBytes) + " bytes.");
+    }
 
-    // 2) build payload
-    const std::string payload = buildJsonPayload(values);
+    if (const std::uint64_t shed = shedSamples(); shed > 0) {
+        Logger::instance().warning("Sensor shed " + std::to_string(shed) +
+                                   " samples while the transport was above its high water mark.");
+    }
 
-    // 3) send (blocking)
-    transport_->sendString(payload);
+    const TickStats& stats = scheduler_.stats();
+    Logger::instance().info("Sensor stopped after " + std::to_string(stats.ticks) + " ticks: " +
+                            std::to_string(stats.overruns) + " overruns, " +
+                            std::to_string(stats.skipped) + " skipped, jitter mean " +
+                            toMicrosString(stats.meanJitter()) + " / max " +
+                            toMicrosString(stats.maxJitter) + ".");
 }
 
-// ----- payload builder (minimal, line-delimited JSON) -----
-std::string Sensor::buildJsonPayload(const std::unordered_map<std::string, double>& readingsMap) const
-{
-    json payload;
+PipelineStats Sensor::pipelineStats() const {
+    return pipeline_ ? pipeline_->stats() : PipelineStats{};
+}
 
-    // identity
-    payload["sensor_id"] = sensorId_;
+BatchStats Sensor::batchStats() const {
+    return batcher_ ? batcher_->stats() : BatchStats{};
+}
 
-    // optional static metadata
-    if (!config_.metadata.empty()) {
-        payload["metadata"] = config_.metadata;
-    }
+void Sensor::runInline(std::atomic<bool>& running) {
 
-    // timestamp (ms since epoch)
-    const auto now   = std::chrono::system_clock::now();
-    const auto epoch = std::chrono::time_point_cast<std::chrono::milliseconds>(now)
-                         .time_since_epoch()
-                         .count();
-    payload["timestamp_ms"] = epoch;
+    // Deadlines are absolute (start + k * interval), so the time spent in
+    // runOnce() does not push the following ticks back.
+    scheduler_.start();
+    const auto flushMargin = std::min<std::chrono::nanoseconds>(kMaxFlushMargin, scheduler_.period() / 10);
 
-    // helpers
-    auto roundToDecimals = [](double value, int decimals) {
-        const double scale = std::pow(10.0, decimals);
-        return std::round(value * scale) / scale;
-    };
+    try {
+        while (running) {
 
-    auto inferUnitFromReadingName = [this](std::string_view readingName) -> std::string {
-        if (auto itr = config_.units.find(std::string(readingName)); itr != config_.units.end()) {
-            return itr->second;
-        }
-        // sensible defaults for image-sensor fields
-        if (readingName.find("width")     != std::string_view::npos ||
-            readingName.find("height")    != std::string_view::npos) {
-                return "pixels";
-        }
-        if (readingName.find("channels")  != std::string_view::npos) {
-            return "count";
-        }
-        if (readingName.find("bytes")     != std::string_view::npos ||
-            readingName.find("size")      != std::string_view::npos) {
-                return "bytes";
-        }
-        if (readingName.find("brightness")!= std::string_view::npos ||
-            readingName.find("luma")      != std::string_view::npos) {
-                return "intensity";
+            // Idle time until shortly before the next tick (or batch linger)
+            // drains whatever a non-blocking transport still has queued.
+            // A flush that returns late (the thread was preempted) delays the
+            // tick but does not count as an overrun.
+            const auto idleSince = TickScheduler::Clock::now();
+            auto wakeUp = scheduler_.nextDeadline();
+            if (batcher_ && !batcher_->empty() && batcher_->deadline() < wakeUp) {
+                wakeUp = batcher_->deadline();
+            }
+            transport_->flushUntil(wakeUp - flushMargin);
+
+            // A partly filled batch must not wait for the next tick when its
+            // linger runs out sooner.
+            if (batcher_ && !batcher_->empty() && batcher_->deadline() < scheduler_.nextDeadline()) {
+                std::this_thread::sleep_until(batcher_->deadline());
+                batcher_->flushIfDue(PayloadBatcher::Clock::now());
+            }
+
+            scheduler_.waitNext(idleSince);
+            if (!running) {
+                break;
+            }
+
+            // Backpressure: the collector is behind, so this sample is not even
+            // read; the tick grid stays as it is.
+            if (transport_->congested()) {
+                shed_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            LOGGER_DEBUG("Sensor tick: reading data and sending (late " +
+                         toMicrosString(scheduler_.stats().lastJitter) + ")...");
+            runOnce();
         }
-        return "unknown";
-    };
+    } catch (...) {
+        scheduler_.stop();
+        throw;
+    }
+    scheduler_.stop();   // gives the thread its timer slack back
+}
 
-    // Readings object
-    json readingsJson = json::object();
-    for (const auto& [readingName, readingValue] : readingsMap) {
+// ----- one tick: read -> encode -> send -----
+void Sensor::runOnce() {
+    // 1) get current readings (map storage is reused across ticks)
+    dataSource_->readInto(readings_);
 
-        json readingJsonObject;
-        readingJsonObject["value"] = roundToDecimals(readingValue, 2);
-        readingJsonObject["unit"]  = inferUnitFromReadingName(readingName);
+    // 2) build payload (buffer capacity is reused across ticks)
+    if (batcher_) {
+        buildPayload(readings_, currentTimestampMs(), payload_);
 
-        readingsJson[readingName] = readingJsonObject;
+        // 3) queue it into the current batch
+        send(payload_);
+        return;
     }
 
-     if (!readingsJson.empty()) {
-        payload["readings"] = readingsJson;
+    // 2+3) unbatched: hand the encoder's pieces to the transport as they are,
+    // one gathered write instead of a copy into one string first
+    syncEncoderSession();
+    encoder_->encodeBuffers(readings_, currentTimestampMs(), payload_, pieces_);
+    captureSessionState();
+    applySessionState();
+    transport_->sendBuffers(pieces_.data(), pieces_.size());
+}
+
+void Sensor::send(const std::string& payload) {
+    applySessionState();
+    if (batcher_) {
+        batcher_->add(payload, PayloadBatcher::Clock::now());
+    } else {
+        transport_->sendString(payload);
     }
+}
+
+// ----- payload builder (format chosen by config.payloadFormat, streamed into 'out') -----
+void Sensor::buildPayload(const Readings& readingsMap,
+                          std::int64_t timestampMs,
+                          std::string& out)
+{
+    syncEncoderSession();
+    encoder_->encode(readingsMap, timestampMs, out);
+    captureSessionState();
+}
 
-    std::string out = payload.dump();
-    out.push_back('\n');
-    return out;
+// A transport that reconnected on its own talks to a collector that has not
+// seen our per-connection state (metric dictionary) yet, and a payload lost
+// on the way (pipeline queue, shed by the send stage, fan-out sink) may have
+// been the one carrying it. Both bump the session, so the next sample
+// carries the state again.
+void Sensor::syncEncoderSession() {
+    std::uint64_t session = transport_->sessionCount();
+    if (pipeline_) {
+        session += pipeline_->payloadsDropped() + shed_.load(std::memory_order_relaxed);
+    }
+    if (session != encoderSession_) {
+        encoderSession_ = session;
+        encoder_->resetSession();
+    }
 }
 
+// Payloads a transport replays on a new connection were encoded for the old
+// one, so it sends the encoder's session state ahead of them. The state only
+// changes when the encoder learns something new (a metric ID), so this
+// costs a version compare per sample.
+void Sensor::captureSessionState() {
+    const std::uint64_t version = encoder_->sessionStateVersion();
+    if (stateCaptured_ && version == stateVersion_) {
+        return;
+    }
+    stateCaptured_ = true;
+    stateVersion_ = version;
+    {
+        const std::lock_guard<std::mutex> lock(stateMutex_);
+        encoder_->encodeSessionState(sessionState_);
+    }
+    stateChanged_.store(true, std::memory_order_release);
+}
 
+void Sensor::applySessionState() {
+    if (!stateChanged_.exchange(false, std::memory_order_acquire)) {
+        return;
+    }
+    const std::lock_guard<std::mutex> lock(stateMutex_);
+    transport_->setSessionPreamble(sessionState_);
+}
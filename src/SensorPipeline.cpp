@@ -0,0 +1,246 @@
+/**
+ * @file SensorPipeline.cpp
+ * @brief Implementation of the capture -> encode -> send pipeline.
+ *
+ * Stage threads never block on each other: they exchange work through
+ * SpscRing instances and wait with an IdleBackoff when there is nothing
+ * to do (or, with QueuePolicy::BLOCK, no room downstream).
+ *
+ * Shutdown drains front to back: capture stops and raises captureDone_, the
+ * encoder empties its queue and raises encodeDone_, then the sender empties
+ * its queue. A stage exception raises failed_ and every stage stops at once.
+ *
+ * @see SensorPipeline
+ */
+
+#include "SensorPipeline.hpp"
+#include "BoundedRing.hpp"
+#include "ConfigTypes.hpp"
+#include "IdleBackoff.hpp"
+#include "TickScheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <thread>
+#include <utility>  // std::move, std::swap
+
+namespace {
+
+    using SteadyClock = std::chrono::steady_clock;
+
+    // Items trade places with the ring slot instead of being moved in and
+    // out: a moved-from std::string is left unspecified, a swapped one holds
+    // the slot's old buffer, so payload buffers circulate and are reused.
+    template <typename T>
+    bool pushSwap(SpscRing<T>& ring, T& item) {
+        return ring.tryEmplace([&item](T& slot) { std::swap(slot, item); });
+    }
+
+    template <typename T>
+    bool popSwap(SpscRing<T>& ring, T& out) {
+        return ring.tryConsume([&out](T& slot) { std::swap(slot, out); });
+    }
+}
+
+// ---------- counters ----------
+
+void SensorPipeline::StageCounters::addBusy(SteadyClock::duration elapsed) {
+    busyNanos.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                        std::memory_order_relaxed);
+}
+
+StageStats SensorPipeline::StageCounters::snapshot() const {
+    StageStats stats;
+    stats.processed = processed.load(std::memory_order_relaxed);
+    stats.dropped   = dropped.load(std::memory_order_relaxed);
+    stats.busy      = std::chrono::nanoseconds(busyNanos.load(std::memory_order_relaxed));
+    return stats;
+}
+
+// ---------- ctor ----------
+
+SensorPipeline::SensorPipeline(const PipelineConfig& config,
+                               CaptureFn capture,
+                               EncodeFn encode,
+                               SendFn send,
+                               IdleFn idle)
+    : config_(config),
+      capture_(std::move(capture)),
+      encode_(std::move(encode)),
+      send_(std::move(send)),
+      idle_(std::move(idle)),
+      captureQueue_(config.captureQueue.depth),
+      sendQueue_(config.sendQueue.depth)
+{
+}
+
+PipelineStats SensorPipeline::stats() const {
+    PipelineStats stats;
+    stats.capture = captureCounters_.snapshot();
+    stats.encode  = encodeCounters_.snapshot();
+    stats.send    = sendCounters_.snapshot();
+    return stats;
+}
+
+// ---------- queueing ----------
+
+/*
+ * push()
+ * - Hand 'item' to the next stage according to 'policy'.
+ * - Returns true if the item was queued, false if it was dropped (counted
+ *   against 'counters'). DROP_OLDEST always queues the new item, counting
+ *   each evicted one as a drop.
+ */
+template <typename T>
+bool SensorPipeline::push(SpscRing<T>& ring, QueuePolicy policy, T& item, StageCounters& counters) {
+
+    if (pushSwap(ring, item)) {
+        return true;
+    }
+
+    switch (policy) {
+        case QueuePolicy::DROP_NEWEST:
+            counters.dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+
+        case QueuePolicy::DROP_OLDEST: {
+            T evicted{};
+            do {
+                // The consumer may win the race for the oldest slot; either way
+                // a slot frees up and the retry succeeds.
+                if (popSwap(ring, evicted)) {
+                    counters.dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+            } while (!pushSwap(ring, item));
+            return true;
+        }
+
+        case QueuePolicy::BLOCK: {
+            IdleBackoff backoff;
+            while (!pushSwap(ring, item)) {
+                if (failed_.load(std::memory_order_acquire)) {
+                    counters.dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                backoff.pause();
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void SensorPipeline::fail(std::exception_ptr error) noexcept {
+    if (!failed_.exchange(true, std::memory_order_acq_rel)) {
+        error_ = std::move(error);
+    }
+}
+
+// ---------- stages ----------
+
+void SensorPipeline::run(std::atomic<bool>& running, TickScheduler& scheduler) {
+
+    std::thread encoder([this] { encodeLoop(); });
+    std::thread sender([this] { sendLoop(); });
+
+    try {
+        scheduler.start();
+
+        while (running && !failed_.load(std::memory_order_acquire)) {
+
+            scheduler.waitNext();
+            if (!running) {
+                break;
+            }
+
+            Sample sample;
+            const auto begin = SteadyClock::now();
+            capture_(sample);
+            captureCounters_.addBusy(SteadyClock::now() - begin);
+            captureCounters_.processed.fetch_add(1, std::memory_order_relaxed);
+
+            push(captureQueue_, config_.captureQueue.policy, sample, captureCounters_);
+        }
+    } catch (...) {
+        fail(std::current_exception());
+    }
+    scheduler.stop();
+
+    captureDone_.store(true, std::memory_order_release);
+    encoder.join();
+    sender.join();
+
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void SensorPipeline::encodeLoop() {
+
+    try {
+        Sample      sample;
+        std::string payload;   // swapped with the ring slots (see pushSwap()), so buffers are reused
+        IdleBackoff backoff;
+
+        while (!failed_.load(std::memory_order_acquire)) {
+
+            // Read the flag before popping: if capture was already done and the
+            // pop still finds nothing, the queue is drained for good.
+            const bool upstreamDone = captureDone_.load(std::memory_order_acquire);
+            if (!popSwap(captureQueue_, sample)) {
+                if (upstreamDone) {
+                    break;
+                }
+                backoff.pause();
+                continue;
+            }
+            backoff.reset();
+
+            const auto begin = SteadyClock::now();
+            encode_(sample, payload);
+            encodeCounters_.addBusy(SteadyClock::now() - begin);
+            encodeCounters_.processed.fetch_add(1, std::memory_order_relaxed);
+
+            push(sendQueue_, config_.sendQueue.policy, payload, encodeCounters_);
+        }
+    } catch (...) {
+        fail(std::current_exception());
+    }
+
+    encodeDone_.store(true, std::memory_order_release);
+}
+
+void SensorPipeline::sendLoop() {
+
+    try {
+        std::string payload;
+        IdleBackoff backoff;
+
+        while (!failed_.load(std::memory_order_acquire)) {
+
+            const bool upstreamDone = encodeDone_.load(std::memory_order_acquire);
+            if (!popSwap(sendQueue_, payload)) {
+                if (upstreamDone) {
+                    break;
+                }
+                if (idle_) {
+                    idle_();
+                }
+                backoff.pause();
+                continue;
+            }
+            backoff.reset();
+
+            const auto begin = SteadyClock::now();
+            send_(payload);
+            sendCounters_.addBusy(SteadyClock::now() - begin);
+            sendCounters_.processed.fetch_add(1, std::memory_order_relaxed);
+        }
+    } catch (...) {
+        fail(std::current_exception());
+    }
+}
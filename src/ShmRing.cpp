@@ -0,0 +1,293 @@
+/**
+ * @file ShmRing.cpp
+ * @brief Implementation of the shared-memory message ring.
+ *
+ * @see ShmRing
+ */
+
+#include "ShmRing.hpp"
+#include "ConstBuffer.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <ctime>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>       // std::strerror, std::memcpy
+#include <new>           // placement new
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+
+    std::runtime_error systemErr(const std::string& where) {
+        return std::runtime_error("ShmRing: " + where + ": " + std::strerror(errno));
+    }
+
+    // How long an attaching side waits for the creator to finish initialising.
+    constexpr std::chrono::seconds kAttachTimeout{1};
+
+#ifndef __linux__
+    constexpr std::chrono::microseconds kPollInterval{100};
+#endif
+
+    // Sleep until 'word' may have moved away from 'seen', or until 'deadline'.
+    // Spurious returns are fine: callers re-check their condition.
+    void waitOn(std::atomic<std::uint32_t>& word, std::uint32_t seen, ShmRing::Clock::time_point deadline) {
+        const auto now = ShmRing::Clock::now();
+        if (now >= deadline) {
+            return;
+        }
+#ifdef __linux__
+        timespec timeout{};
+        timespec* timeoutPtr = nullptr;
+        if (deadline != ShmRing::Clock::time_point::max()) {
+            const auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+            timeout.tv_sec = static_cast<time_t>(left / 1000000000);
+            timeout.tv_nsec = static_cast<long>(left % 1000000000);
+            timeoutPtr = &timeout;
+        }
+        // Not FUTEX_PRIVATE_FLAG: the waker is usually another process.
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, seen, timeoutPtr, nullptr, 0);   // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+#else
+        (void)word;
+        (void)seen;
+        std::this_thread::sleep_for(std::min<ShmRing::Clock::duration>(kPollInterval, deadline - now));
+#endif
+    }
+
+    void wake(std::atomic<std::uint32_t>& word) {
+        word.fetch_add(1, std::memory_order_seq_cst);
+#ifdef __linux__
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);   // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+#endif
+    }
+}
+
+// ----- ctor / dtor -----
+
+ShmRing::ShmRing(const std::string& name, std::size_t capacity)
+    : name_(name)
+{
+    if (name_.size() < 2 || name_.front() != '/' || name_.find('/', 1) != std::string::npos || name_.size() > NAME_MAX) {
+        throw std::invalid_argument("ShmRing: name must be '/' followed by up to " + std::to_string(NAME_MAX - 1) +
+                                    " characters other than '/', got '" + name_ + "'");
+    }
+    if (capacity > (std::size_t{1} << 40U)) {
+        throw std::invalid_argument("ShmRing: capacity too large");
+    }
+
+    int fd = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd >= 0) {
+        created_ = true;
+        try {
+            initialise(fd, capacityFor(capacity));
+        } catch (...) {
+            ::close(fd);
+            ::shm_unlink(name_.c_str());
+            throw;
+        }
+    } else if (errno == EEXIST) {
+        fd = ::shm_open(name_.c_str(), O_RDWR | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            throw systemErr("shm_open " + name_);
+        }
+        try {
+            attach(fd);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+    } else {
+        throw systemErr("shm_open " + name_);
+    }
+    ::close(fd);   // the mapping keeps the segment alive
+}
+
+ShmRing::~ShmRing() {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mappingSize_);
+    }
+}
+
+void ShmRing::unlink(const std::string& name) {
+    if (::shm_unlink(name.c_str()) != 0 && errno != ENOENT) {
+        throw systemErr("shm_unlink " + name);
+    }
+}
+
+void ShmRing::initialise(int fd, std::size_t capacity) {
+    mappingSize_ = sizeof(ShmRingHeader) + capacity;
+    if (::ftruncate(fd, static_cast<off_t>(mappingSize_)) != 0) {
+        throw systemErr("ftruncate " + name_);
+    }
+    mapping_ = ::mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        throw systemErr("mmap " + name_);
+    }
+
+    header_ = new (mapping_) ShmRingHeader();
+    header_->version = ShmRingHeader::kVersion;
+    header_->capacity = capacity;
+    header_->magic.store(ShmRingHeader::kMagic, std::memory_order_release);   // attachers may go
+
+    data_ = static_cast<unsigned char*>(mapping_) + sizeof(ShmRingHeader);
+    capacity_ = capacity;
+    mask_ = capacity - 1;
+}
+
+void ShmRing::attach(int fd) {
+
+    // The creator may still be between shm_open() and ftruncate()/magic.
+    const auto giveUp = Clock::now() + kAttachTimeout;
+    struct stat info{};
+    for (;;) {
+        if (::fstat(fd, &info) != 0) {
+            throw systemErr("fstat " + name_);
+        }
+        if (static_cast<std::size_t>(info.st_size) > sizeof(ShmRingHeader)) {
+            break;
+        }
+        if (Clock::now() >= giveUp) {
+            throw std::runtime_error("ShmRing: segment '" + name_ + "' was never initialised");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    mappingSize_ = static_cast<std::size_t>(info.st_size);
+    mapping_ = ::mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        throw systemErr("mmap " + name_);
+    }
+    header_ = static_cast<ShmRingHeader*>(mapping_);
+
+    while (header_->magic.load(std::memory_order_acquire) != ShmRingHeader::kMagic) {
+        if (Clock::now() >= giveUp) {
+            throw std::runtime_error("ShmRing: segment '" + name_ + "' is not a sensor ring");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const std::uint64_t capacity = header_->capacity;
+    if (header_->version != ShmRingHeader::kVersion || capacity < kMinCapacity ||
+        (capacity & (capacity - 1)) != 0 || sizeof(ShmRingHeader) + capacity != mappingSize_) {
+        throw std::runtime_error("ShmRing: segment '" + name_ + "' has an unsupported layout");
+    }
+
+    data_ = static_cast<unsigned char*>(mapping_) + sizeof(ShmRingHeader);
+    capacity_ = static_cast<std::size_t>(capacity);
+    mask_ = capacity - 1;
+}
+
+// ----- producer -----
+
+bool ShmRing::write(const ConstBuffer* pieces, std::size_t count, Clock::time_point deadline) {
+    const std::size_t length = totalSize(pieces, count);
+    if (length > maxMessageSize()) {
+        throw std::invalid_argument("ShmRing: message of " + std::to_string(length) + " bytes exceeds " +
+                                    std::to_string(maxMessageSize()));
+    }
+
+    std::uint64_t pos = header_->writePos.load(std::memory_order_relaxed);
+    const std::uint64_t need = recordSize(length);
+    const std::uint64_t tailRoom = capacity_ - (pos & mask_);
+    if (!waitForRoom(pos, need <= tailRoom ? need : tailRoom + need, deadline)) {
+        return false;
+    }
+
+    if (need > tailRoom) {
+        // Records are 8-byte aligned, so there is always room for the marker.
+        std::memcpy(data_ + (pos & mask_), &kWrapMarker, kLengthSize);
+        pos += tailRoom;
+    }
+    unsigned char* out = data_ + (pos & mask_);
+    const auto length32 = static_cast<std::uint32_t>(length);
+    std::memcpy(out, &length32, kLengthSize);
+    out += kLengthSize;
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        if (pieces[idx].size > 0) {
+            std::memcpy(out, pieces[idx].data, pieces[idx].size);
+            out += pieces[idx].size;
+        }
+    }
+
+    // seq_cst store/load pair against the reader's flag/position pair: one of
+    // the two sides always sees the other, so no wake-up is lost.
+    header_->writePos.store(pos + need, std::memory_order_seq_cst);
+    if (header_->readerWaiting.load(std::memory_order_seq_cst) != 0) {
+        wake(header_->writeSeq);
+    }
+    return true;
+}
+
+bool ShmRing::waitForRoom(std::uint64_t pos, std::uint64_t bytes, Clock::time_point deadline) {
+    const auto hasRoom = [&] {
+        return capacity_ - (pos - header_->readPos.load(std::memory_order_seq_cst)) >= bytes;
+    };
+    while (!hasRoom()) {
+        if (Clock::now() >= deadline) {
+            return false;
+        }
+        header_->writerWaiting.store(1, std::memory_order_seq_cst);
+        const std::uint32_t seen = header_->readSeq.load(std::memory_order_seq_cst);
+        if (!hasRoom()) {
+            waitOn(header_->readSeq, seen, deadline);
+        }
+        header_->writerWaiting.store(0, std::memory_order_seq_cst);
+    }
+    return true;
+}
+
+// ----- consumer -----
+
+void ShmRing::release(std::uint64_t newReadPos) {
+    header_->readPos.store(newReadPos, std::memory_order_seq_cst);
+    if (header_->writerWaiting.load(std::memory_order_seq_cst) != 0) {
+        wake(header_->readSeq);
+    }
+}
+
+bool ShmRing::tryRead(std::string& out) {
+    return tryConsume([&out](std::string_view message) { out.assign(message.data(), message.size()); });
+}
+
+bool ShmRing::readUntil(std::string& out, Clock::time_point deadline) {
+    while (!tryRead(out)) {
+        if (!waitReadable(deadline)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ShmRing::waitReadable(Clock::time_point deadline) {
+    const auto hasData = [&] {
+        return header_->writePos.load(std::memory_order_seq_cst) != header_->readPos.load(std::memory_order_relaxed);
+    };
+    while (!hasData()) {
+        if (Clock::now() >= deadline) {
+            return false;
+        }
+        header_->readerWaiting.store(1, std::memory_order_seq_cst);
+        const std::uint32_t seen = header_->writeSeq.load(std::memory_order_seq_cst);
+        if (!hasData()) {
+            waitOn(header_->writeSeq, seen, deadline);
+        }
+        header_->readerWaiting.store(0, std::memory_order_seq_cst);
+    }
+    return true;
+}
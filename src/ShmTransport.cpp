@@ -0,0 +1,48 @@
+/**
+ * @file ShmTransport.cpp
+ * @brief Implementation of the shared-memory transport.
+ *
+ * @see ShmTransport
+ */
+
+#include "ShmTransport.hpp"
+#include "ConstBuffer.hpp"
+#include "ShmRing.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+void ShmTransport::connect() {
+    if (!ring_) {
+        ring_ = std::make_unique<ShmRing>(options_.name, options_.capacityBytes);
+    }
+}
+
+std::size_t ShmTransport::sendString(const std::string& payload) {
+    const ConstBuffer piece(payload);
+    return sendBuffers(&piece, 1);
+}
+
+std::size_t ShmTransport::sendBuffers(const ConstBuffer* buffers, std::size_t count) {
+    if (!ring_) {
+        throw std::runtime_error("ShmTransport: not connected");
+    }
+    const auto deadline = options_.writeTimeout.count() == 0
+                              ? ShmRing::Clock::time_point::max()
+                              : ShmRing::Clock::now() + options_.writeTimeout;
+    if (!ring_->write(buffers, count, deadline)) {
+        throw std::runtime_error("ShmTransport: ring '" + options_.name + "' stayed full for " +
+                                 std::to_string(options_.writeTimeout.count()) + " ms; is the collector reading?");
+    }
+    return totalSize(buffers, count);
+}
+
+std::size_t ShmTransport::maxMessageSize() const {
+    if (ring_) {
+        return ring_->maxMessageSize();
+    }
+    // Before connect(): what a ring created from the options would take.
+    return ShmRing::capacityFor(options_.capacityBytes) / 2 - ShmRing::kLengthSize;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file SimulationDataSource.cpp
+ * @brief Implementation of the rule-driven simulated data source.
+ *
+ * Per-sample reads (readInto) draw one value per metric. Batch reads fill
+ * each metric column with Xoshiro256::fillUniform and then overwrite the
+ * outlier positions, which are found by jumping geometric gaps, so the
+ * cost of outliers scales with their number rather than the batch size.
+ *
+ * @see SimulationDataSource
+ */
+
+#include "SimulationDataSource.hpp"
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "Xoshiro256.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+    std::uint64_t randomSeed() {
+        std::random_device device;
+        return (static_cast<std::uint64_t>(device()) << 32U) ^ device();
+    }
+
+    void validateRule(const std::string& name, const MetricRule& rule) {
+        if (rule.hasFixed == rule.hasRange) {
+            throw std::invalid_argument("SimulationDataSource: metric '" + name +
+                                        "' needs either a fixed value or a range");
+        }
+        if (rule.hasRange && !(rule.min <= rule.max)) {
+            throw std::invalid_argument("SimulationDataSource: metric '" + name + "' has min > max");
+        }
+        if (!(rule.badProbability >= 0.0 && rule.badProbability <= 1.0)) {
+            throw std::invalid_argument("SimulationDataSource: metric '" + name +
+                                        "' bad probability must be in 0..1");
+        }
+    }
+}
+
+// ----- ctor -----
+
+SimulationDataSource::SimulationDataSource(const DataSourceConfig& config)
+    : SimulationDataSource(config, randomSeed())
+{
+}
+
+SimulationDataSource::SimulationDataSource(const DataSourceConfig& config, std::uint64_t seed)
+    : rng_(seed)
+{
+    if (config.metrics.empty()) {
+        throw std::invalid_argument("SimulationDataSource: no metrics configured");
+    }
+
+    metrics_.reserve(config.metrics.size());
+    for (const auto& [name, rule] : config.metrics) {
+        validateRule(name, rule);
+        metrics_.push_back({name, rule});
+    }
+    std::sort(metrics_.begin(), metrics_.end(),
+              [](const Metric& lhs, const Metric& rhs) { return lhs.name < rhs.name; });
+}
+
+// ----- single samples -----
+
+Readings SimulationDataSource::readAll() {
+    Readings values;
+    readInto(values);
+    return values;
+}
+
+void SimulationDataSource::readInto(Readings& out) {
+    for (const auto& metric : metrics_) {
+        out[metric.name] = sample(metric.rule);
+    }
+    if (out.size() != metrics_.size()) {
+        // 'out' held metrics from elsewhere; keep exactly ours.
+        out.clear();
+        for (const auto& metric : metrics_) {
+            out[metric.name] = sample(metric.rule);
+        }
+    }
+}
+
+double SimulationDataSource::sample(const MetricRule& rule) {
+    if (rule.hasFixed) {
+        return rule.fixed;
+    }
+    if (rule.badProbability > 0.0 && rng_.nextUnit() < rule.badProbability) {
+        return outlier(rule);
+    }
+    return rule.min + (rule.max - rule.min) * rng_.nextUnit();
+}
+
+/*
+ * outlier()
+ * - A value strictly outside [min, max]: half to one and a half range widths
+ *   below min or above max (side chosen at random). A zero-width range uses
+ *   max(1, |max|) as its width.
+ */
+double SimulationDataSource::outlier(const MetricRule& rule) {
+    const double width = rule.max > rule.min ? rule.max - rule.min : std::max(1.0, std::abs(rule.max));
+    const double offset = (0.5 + rng_.nextUnit()) * width;
+    return (rng_.next() >> 63U) != 0 ? rule.max + offset : rule.min - offset;
+}
+
+/*
+ * samplesUntilOutlier()
+ * - Number of good samples before the next outlier. For independent trials
+ *   with probability p that gap is geometric: floor(ln(U) / ln(1 - p)) with
+ *   U uniform in (0, 1].
+ */
+std::size_t SimulationDataSource::samplesUntilOutlier(double badProbability) {
+    constexpr auto kNever = std::numeric_limits<std::size_t>::max();
+    if (badProbability <= 0.0) {
+        return kNever;
+    }
+    if (badProbability >= 1.0) {
+        return 0;
+    }
+
+    const double uniform = 1.0 - rng_.nextUnit();
+    const double gap = std::floor(std::log(uniform) / std::log1p(-badProbability));
+    return gap < static_cast<double>(kNever) ? static_cast<std::size_t>(gap) : kNever;
+}
+
+// ----- batches -----
+
+std::size_t SimulationDataSource::readBatch(SampleBatch& batch, std::size_t count) {
+
+    const bool sameLayout =
+        batch.names.size() == metrics_.size() &&
+        std::equal(metrics_.begin(), metrics_.end(), batch.names.begin(),
+                   [](const Metric& metric, const std::string& name) { return metric.name == name; });
+
+    if (!sameLayout) {
+        batch.names.clear();
+        batch.columns.clear();
+        for (const auto& metric : metrics_) {
+            batch.names.push_back(metric.name);
+        }
+        batch.columns.resize(metrics_.size());
+    }
+
+    for (std::size_t idx = 0; idx < metrics_.size(); ++idx) {
+        fillColumn(metrics_[idx].rule, batch.columns[idx], count);
+    }
+    batch.rows = count;
+    return count;
+}
+
+void SimulationDataSource::fillColumn(const MetricRule& rule, std::vector<double>& column, std::size_t count) {
+
+    column.resize(count);
+
+    if (rule.hasFixed) {
+        std::fill(column.begin(), column.end(), rule.fixed);
+        return;
+    }
+
+    rng_.fillUniform(column.data(), count, rule.min, rule.max);
+
+    for (std::size_t pos = samplesUntilOutlier(rule.badProbability); pos < count;) {
+        column[pos] = outlier(rule);
+        const std::size_t gap = samplesUntilOutlier(rule.badProbability);
+        if (gap >= count - pos) {
+            break;
+        }
+        pos += gap + 1;
+    }
+}
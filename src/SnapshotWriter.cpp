@@ -0,0 +1,206 @@
+/**
+ * @file SnapshotWriter.cpp
+ * @brief Implementation of the background snapshot writer.
+ *
+ * @see SnapshotWriter
+ */
+
+#include "SnapshotWriter.hpp"
+#include "ConfigTypes.hpp"
+#include "Logger.hpp"
+#include "StringUtils.hpp"
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <fcntl.h>    // ::open
+#include <unistd.h>   // ::write, ::fsync, ::close
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>   // std::rename, std::remove
+#include <cstring>  // std::strerror
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>  // std::move, std::swap
+
+namespace {
+
+    // Write all of 'data' to a fresh file at 'path', fsync and close it;
+    // false (errno set) if any step fails, the close included.
+    bool writeDurably(const std::string& path, const unsigned char* data, std::size_t len) {
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = true;
+        while (len > 0) {
+            const ssize_t written = ::write(fd, data, len);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                if (written == 0) {
+                    errno = EIO;
+                }
+                ok = false;
+                break;
+            }
+            data += written;
+            len -= static_cast<std::size_t>(written);
+        }
+        ok = ok && ::fsync(fd) == 0;
+        const int saved = errno;
+        if (::close(fd) != 0) {
+            return false;
+        }
+        errno = saved;
+        return ok;
+    }
+}
+
+// ----- ctor / dtor -----
+
+SnapshotWriter::SnapshotWriter(SnapshotConfig config)
+    : config_(std::move(config)),
+      extension_(extensionFor(config_.format))
+{
+    if (extension_.empty()) {
+        throw std::invalid_argument("SnapshotWriter: unsupported format '" + config_.format + "'");
+    }
+    if (config_.path.empty()) {
+        throw std::invalid_argument("SnapshotWriter: path must not be empty");
+    }
+    if (config_.everyFrames == 0 && config_.every <= std::chrono::milliseconds::zero()) {
+        throw std::invalid_argument("SnapshotWriter: needs a frame or time rate limit");
+    }
+
+    if (extension_ == ".jpg") {
+        if (config_.jpegQuality < 1 || config_.jpegQuality > 100) {
+            throw std::invalid_argument("SnapshotWriter: jpeg quality must be in 1..100");
+        }
+        encodeParams_ = {cv::IMWRITE_JPEG_QUALITY, config_.jpegQuality};
+    }
+
+    thread_ = std::thread([this] { writerLoop(); });
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+std::string SnapshotWriter::extensionFor(const std::string& format) {
+    if (StringUtils::iequals(format, "jpg") || StringUtils::iequals(format, "jpeg")) {
+        return ".jpg";
+    }
+    if (StringUtils::iequals(format, "png")) {
+        return ".png";
+    }
+    if (StringUtils::iequals(format, "bmp")) {
+        return ".bmp";
+    }
+    return "";
+}
+
+SnapshotStats SnapshotWriter::stats() const {
+    SnapshotStats stats;
+    stats.written     = written_.load(std::memory_order_relaxed);
+    stats.failed      = failed_.load(std::memory_order_relaxed);
+    stats.skippedBusy = skippedBusy_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// ----- capture thread -----
+
+bool SnapshotWriter::due(Clock::time_point now) const {
+    if (!taken_) {
+        return true;   // first frame: have a snapshot early on
+    }
+    if (config_.everyFrames > 0 && framesSinceLast_ >= config_.everyFrames) {
+        return true;
+    }
+    return config_.every > std::chrono::milliseconds::zero() && now - lastTaken_ >= config_.every;
+}
+
+bool SnapshotWriter::offer(const cv::Mat& frame) {
+
+    ++framesSinceLast_;
+
+    const auto now = Clock::now();
+    if (frame.empty() || !due(now)) {
+        return false;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        if (hasPending_) {
+            // Previous snapshot not picked up yet; try again on the next frame.
+            skippedBusy_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        frame.copyTo(pending_);   // reuses pending_'s buffer once sized
+        hasPending_ = true;
+    }
+    wake_.notify_one();
+
+    taken_ = true;
+    framesSinceLast_ = 0;
+    lastTaken_ = now;
+    return true;
+}
+
+// ----- writer thread -----
+
+void SnapshotWriter::writerLoop() {
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return hasPending_ || stopping_; });
+            if (!hasPending_) {
+                return;   // stopping and nothing left to write
+            }
+            std::swap(pending_, working_);
+            hasPending_ = false;
+        }
+
+        if (writeFrame(working_)) {
+            written_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            failed_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool SnapshotWriter::writeFrame(const cv::Mat& frame) {
+
+    if (!cv::imencode(extension_, frame, encoded_, encodeParams_)) {
+        Logger::instance().error("Snapshot: failed to encode frame as " + extension_);
+        return false;
+    }
+
+    // The tmp file is written and fsync'd in full before it may replace the
+    // last good snapshot, so neither a full disk nor a crash can leave a
+    // truncated or empty file behind.
+    const std::string tmpPath = config_.path + ".tmp";
+    if (!writeDurably(tmpPath, encoded_.data(), encoded_.size())) {
+        Logger::instance().error("Snapshot: failed to write " + tmpPath + ": " + std::strerror(errno));
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    // rename() replaces the target atomically on POSIX file systems.
+    if (std::rename(tmpPath.c_str(), config_.path.c_str()) != 0) {
+        Logger::instance().error("Snapshot: failed to rename " + tmpPath + " to " + config_.path);
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    return true;
+}
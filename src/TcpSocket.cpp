@@ -11,6 +11,7 @@
  */
 
 #include "TcpSocket.hpp"
+#include "ConstBuffer.hpp"
 
 #include <stdexcept>      // std::runtime_error
 #include <string>
@@ -18,11 +19,21 @@
 #include <cerrno>         // errno
 #include <unistd.h>       // ::close, ::shutdown, ::write
 #include <sys/socket.h>   // ::socket, ::connect, ::send, SOL_SOCKET, etc.
+#include <sys/uio.h>      // ::writev, iovec
+#include <sys/time.h>     // timeval
+#include <fcntl.h>        // ::fcntl, O_NONBLOCK
+#include <poll.h>         // ::poll
+#ifdef __linux__
+#include <sys/epoll.h>    // ::epoll_create1, ::epoll_ctl, ::epoll_wait
+#endif
 #include <netdb.h>        // ::getaddrinfo, ::freeaddrinfo, addrinfo
 #include <cstdint>        // int32_t
 #include <utility>       // std::move
 #include <cstddef>       // std::size_t
 #include <iterator>
+#include <algorithm>     // std::min
+#include <chrono>
+#include <limits>
 
 // ---------- small helpers: turn errno into a readable message ----------
 namespace {
@@ -31,17 +42,76 @@ namespace {
     std::runtime_error systemErr(const std::string& where) {
         return std::runtime_error(where + ": " + std::strerror(errno));
     }
+
+    // milliseconds for poll()/epoll_wait(); negative means "no limit"
+    int toWaitMs(std::chrono::milliseconds timeout) {
+        if (timeout.count() < 0) {
+            return -1;
+        }
+        return static_cast<int>(std::min<std::chrono::milliseconds::rep>(timeout.count(), std::numeric_limits<int>::max()));
+    }
+
+    void setNonBlocking(int sock, bool enable) {
+        const int flags = ::fcntl(sock, F_GETFL, 0);
+        if (flags < 0 || ::fcntl(sock, F_SETFL, enable ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK)) < 0) {
+            throw systemErr("fcntl");
+        }
+    }
+
+    /*
+     * Connect 'sock' with a time limit (0 = the OS default): start a
+     * non-blocking ::connect and wait for it to become writable.
+     * Returns 0 or the errno of the failure; leaves 'sock' non-blocking.
+     */
+    int connectWithTimeout(int sock, const sockaddr* addr, socklen_t addrLen, std::chrono::milliseconds timeout) {
+        setNonBlocking(sock, true);
+        if (::connect(sock, addr, addrLen) == 0) {
+            return 0;
+        }
+        if (errno != EINPROGRESS) {
+            return errno;
+        }
+
+        pollfd pfd{sock, POLLOUT, 0};
+        int ready = 0;
+        do {
+            ready = ::poll(&pfd, 1, timeout.count() > 0 ? toWaitMs(timeout) : -1);
+        } while (ready < 0 && errno == EINTR);
+        if (ready < 0) {
+            return errno;
+        }
+        if (ready == 0) {
+            return ETIMEDOUT;
+        }
+
+        int soError = 0;
+        socklen_t len = sizeof(soError);
+        if (::getsockopt(sock, SOL_SOCKET, SO_ERROR, &soError, &len) < 0) {
+            return errno;
+        }
+        return soError;
+    }
 }
 
 // ---------- ctor / dtor ----------
 
 /*
  * Constructor
- * - Just stores the host and port you want to connect to.
+ * - Just stores the host, port and options you want to connect with.
  * - Does NOT create the socket or touch the network yet.
  */
-TcpSocket::TcpSocket(std::string host, uint16_t port)
-    : host_(std::move(host)), port_(port) {}
+TcpSocket::TcpSocket(std::string host, uint16_t port, TcpOptions options)
+    : host_(std::move(host)), port_(port), options_(options)
+{
+    if (options_.connectTimeout.count() < 0 || options_.writeTimeout.count() < 0) {
+        throw std::invalid_argument("TcpSocket: timeouts must be >= 0");
+    }
+    if (options_.nonBlocking &&
+        (options_.sendBufferBytes == 0 || options_.highWaterMark == 0 ||
+         options_.highWaterMark > options_.sendBufferBytes || options_.lowWaterMark > options_.highWaterMark)) {
+        throw std::invalid_argument("TcpSocket: need low water <= high water <= send buffer size, high water > 0");
+    }
+}
 
 /*
  * Destructor
@@ -57,8 +127,10 @@ TcpSocket::~TcpSocket() {
 /*
  * connect()
  * - Resolve host + port into one or more address candidates (IPv4/IPv6).
- * - Try each candidate: create a socket, attempt ::connect().
- * - On first success, keep that socket and return.
+ * - Try each candidate: create a socket, attempt ::connect() for at most
+ *   options.connectTimeout.
+ * - On first success, keep that socket, set it up for the chosen mode
+ *   and return.
  * - On failure for all candidates, throw.
  */
 void TcpSocket::connect() {
@@ -100,16 +172,22 @@ void TcpSocket::connect() {
             continue; // try next candidate
         }
 
-        // Try to connect.
-        if (::connect(sock, ai->ai_addr, ai->ai_addrlen) == 0) {
+        // Try to connect, bounded by the connect timeout.
+        lastErrno = connectWithTimeout(sock, ai->ai_addr, ai->ai_addrlen, options_.connectTimeout);
+        if (lastErrno == 0) {
             // Success! keep the socket and stop trying others.
             fd_ = sock;
             ::freeaddrinfo(results);
+            try {
+                setUpConnected();
+            } catch (...) {
+                closeNow();
+                throw;
+            }
             return;
         }
 
-        // Failed to connect this candidate; remember errno, close, and continue.
-        lastErrno = errno;
+        // Failed to connect this candidate; close, and continue.
         ::close(sock);
     }
 
@@ -120,6 +198,48 @@ void TcpSocket::connect() {
     throw systemErr("connect");
 }
 
+/*
+ * setUpConnected()
+ * - Blocking mode: back to a blocking fd, with SO_SNDTIMEO as the write
+ *   timeout so a stalled collector cannot block send() forever.
+ * - Non-blocking mode: keep O_NONBLOCK, register the fd with epoll for
+ *   writability waits and size the send buffer once.
+ */
+void TcpSocket::setUpConnected() {
+    if (!options_.nonBlocking) {
+        setNonBlocking(fd_, false);
+        if (options_.writeTimeout.count() > 0) {
+            const auto usec = std::chrono::duration_cast<std::chrono::microseconds>(options_.writeTimeout).count();
+            timeval sndTimeout{};
+            sndTimeout.tv_sec  = static_cast<decltype(sndTimeout.tv_sec)>(usec / 1000000);
+            sndTimeout.tv_usec = static_cast<decltype(sndTimeout.tv_usec)>(usec % 1000000);
+            if (::setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &sndTimeout, sizeof(sndTimeout)) < 0) {
+                throw systemErr("setsockopt(SO_SNDTIMEO)");
+            }
+        }
+        return;
+    }
+
+#ifdef __linux__
+    epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) {
+        throw systemErr("epoll_create1");
+    }
+    epoll_event event{};
+    event.events  = EPOLLOUT;
+    event.data.fd = fd_;
+    if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd_, &event) < 0) {
+        throw systemErr("epoll_ctl");
+    }
+#endif
+
+    pending_.clear();
+    pending_.reserve(options_.sendBufferBytes);
+    pendingHead_    = 0;
+    aboveHighWater_ = false;
+    lastProgress_   = Clock::now();
+}
+
 /*
  * isConnected()
  * - True if we have an open socket file descriptor (fd_ >= 0).
@@ -131,6 +251,8 @@ bool TcpSocket::isConnected() const noexcept {
 /*
  * close()
  * - Safe to call multiple times (idempotent).
+ * - Non-blocking mode: give buffered bytes up to options.writeTimeout to
+ *   reach the kernel; whatever is left after that is dropped.
  * - If connected, try a graceful shutdown then close the fd.
  * - Never throws (noexcept).
  */
@@ -139,43 +261,184 @@ void TcpSocket::close() noexcept {
         return;
     }
 
-    // Try to be polite: shutdown both directions.
-    // If it fails (e.g., already closed by peer), we still proceed to ::close.
-    ::shutdown(fd_, SHUT_RDWR);
-    ::close(fd_);
-    fd_ = -1;
+    if (options_.nonBlocking && bufferedBytes() > 0) {
+        try {
+            (void)flushUntil(Clock::now() + options_.writeTimeout);
+        } catch (...) {
+            // the connection is being dropped anyway
+        }
+    }
+    closeNow();
+}
+
+/*
+ * closeNow()
+ * - close() without draining the send buffer.
+ */
+void TcpSocket::closeNow() noexcept {
+    if (fd_ >= 0) {
+        // Try to be polite: shutdown both directions.
+        // If it fails (e.g., already closed by peer), we still proceed to ::close.
+        ::shutdown(fd_, SHUT_RDWR);
+        ::close(fd_);
+        fd_ = -1;
+    }
+    if (epollFd_ >= 0) {
+        ::close(epollFd_);
+        epollFd_ = -1;
+    }
+    pending_.clear();
+    pendingHead_    = 0;
+    aboveHighWater_ = false;
 }
 
 // ---------- sending data ----------
 
 /*
  * send(const void* data, std::size_t len)
- * - Blocking, "send-all" semantics:
+ * - Blocking mode, "send-all" semantics:
  *   We loop until all 'len' bytes have been written or an error occurs.
- * - Handles partial writes (common in TCP) and EINTR (interrupted syscalls).
+ *   Handles partial writes (common in TCP) and EINTR (interrupted syscalls).
+ *   A write that makes no progress for options.writeTimeout drops the
+ *   connection and throws.
+ * - Non-blocking mode: see enqueue().
  * - On any real error, throws std::runtime_error.
- * - Returns total bytes written (== len on success).
+ * - Returns total bytes accepted (== len on success).
+ */
+std::size_t TcpSocket::send(const void* data, std::size_t len) {
+    const ConstBuffer piece(data, len);
+    return sendBuffers(&piece, 1);
+}
+
+/*
+ * sendString(const std::string& s)
+ * - Convenience wrapper for text payloads (e.g., your JSON).
+ * - Calls the raw send() with the string’s bytes.
  */
-std::size_t TcpSocket::send(const void* data, std::size_t len) const {
+std::size_t TcpSocket::sendString(const std::string& payload) {
+    return send(payload.data(), payload.size());
+}
+
+/*
+ * sendBuffers(const ConstBuffer* buffers, std::size_t count)
+ * - Same semantics as send(), for a message split over several buffers:
+ *   the pieces go out back to back via ::writev, without being copied into
+ *   one contiguous string first (unless they have to wait in the send
+ *   buffer in non-blocking mode).
+ */
+std::size_t TcpSocket::sendBuffers(const ConstBuffer* buffers, std::size_t count) {
     if (!isConnected()) {
         throw std::runtime_error("send: not connected");
     }
+    return options_.nonBlocking ? enqueue(buffers, count) : sendBlocking(buffers, count);
+}
+
+/*
+ * sendBlocking()
+ * - Up to kMaxIovecs pieces are passed per writev(); a partial write
+ *   resumes inside the piece where it stopped.
+ * - writeSome() returning 0 means SO_SNDTIMEO expired: the collector took
+ *   nothing for writeTimeout. Part of the message may be on the wire, so
+ *   the stream is no longer usable; drop it.
+ */
+std::size_t TcpSocket::sendBlocking(const ConstBuffer* buffers, std::size_t count) {
+    const std::size_t len = totalSize(buffers, count);
+    std::size_t sent = 0;
+    while (sent < len) {
+        const std::size_t bytesSent = writeSome(buffers, count, sent);
+        if (bytesSent == 0) {
+            closeNow();
+            throw std::runtime_error("send: write timed out");
+        }
+        sent += bytesSent;
+    }
+    return len;
+}
+
+/*
+ * enqueue() -- non-blocking send
+ * - Bytes already buffered go first (they are older); if none are left,
+ *   the new message is written straight from the caller's pieces.
+ * - What the kernel does not take now is copied into the send buffer.
+ * - Only when the buffer has no room for it does send() wait, for at most
+ *   options.writeTimeout without progress; then it drops the connection
+ *   and throws. Producers that watch the water marks never get there.
+ */
+std::size_t TcpSocket::enqueue(const ConstBuffer* buffers, std::size_t count) {
+    const std::size_t len = totalSize(buffers, count);
+
+    flushPending();
+    std::size_t written = 0;
+    if (bufferedBytes() == 0) {
+        lastProgress_ = Clock::now();   // nothing queued: nothing can be stalled
+        written = writeSome(buffers, count, 0);
+    }
 
-    const char* dataPtr = static_cast<const char*>(data);
-    std::size_t bytesLeft = len;
+    // Make room for the rest, waiting on the collector if we must.
+    while (len - written > options_.sendBufferBytes - bufferedBytes()) {
+        std::chrono::milliseconds budget(-1);   // no limit
+        if (options_.writeTimeout.count() > 0) {
+            budget = std::chrono::ceil<std::chrono::milliseconds>(lastProgress_ + options_.writeTimeout - Clock::now());
+            if (budget.count() <= 0) {
+                throwStalled("send");
+            }
+        }
+        (void)waitWritable(budget);
 
-    while (bytesLeft > 0) {
-        // ::send may write fewer bytes than requested; we must loop.
-        const ssize_t bytesSent = ::send(fd_, dataPtr, bytesLeft, 0);   // NOLINT(misc-include-cleaner)
+        if (bufferedBytes() > 0) {
+            flushPending();
+        } else if (const std::size_t bytesSent = writeSome(buffers, count, written); bytesSent > 0) {
+            written += bytesSent;           // larger than the whole buffer: written in place
+            lastProgress_ = Clock::now();
+        }
+    }
+
+    // Queue the remainder, compacting the buffer instead of growing it.
+    const std::size_t rest = len - written;
+    if (rest > 0) {
+        if (pending_.size() + rest > pending_.capacity()) {
+            pending_.erase(pending_.begin(), std::next(pending_.begin(), static_cast<std::ptrdiff_t>(pendingHead_)));
+            pendingHead_ = 0;
+        }
+        std::size_t skip = written;
+        for (std::size_t idx = 0; idx < count; ++idx) {
+            const auto* bytes = static_cast<const char*>(buffers[idx].data);
+            if (skip >= buffers[idx].size) {
+                skip -= buffers[idx].size;
+                continue;
+            }
+            pending_.insert(pending_.end(), std::next(bytes, static_cast<std::ptrdiff_t>(skip)),
+                            std::next(bytes, static_cast<std::ptrdiff_t>(buffers[idx].size)));
+            skip = 0;
+        }
+    }
+
+    updateWaterMarks();
+    return len;
+}
+
+/*
+ * writeSome()
+ * - One ::writev of the pieces after their first 'skip' bytes.
+ * - Returns the bytes the kernel took; 0 if it would block (non-blocking
+ *   mode) or SO_SNDTIMEO expired (blocking mode).
+ */
+std::size_t TcpSocket::writeSome(const ConstBuffer* buffers, std::size_t count, std::size_t skip) {
+    Iovecs iov{};
+    const std::size_t used = fillIovecs(buffers, count, skip, iov);
+    if (used == 0) {
+        return 0;   // only empty pieces left
+    }
+
+    for (;;) {
+        const ssize_t bytesSent = ::writev(fd_, iov.data(), static_cast<int>(used));
 
         if (bytesSent > 0) {
-            dataPtr = std::next(dataPtr, bytesSent);
-            bytesLeft -= static_cast<std::size_t>(bytesSent);
-            continue;
+            return static_cast<std::size_t>(bytesSent);
         }
 
         if (bytesSent == 0) {
-            // 0 from send() is unusual; treat as connection issue.
+            // 0 from writev() is unusual; treat as connection issue.
             throw std::runtime_error("send: connection closed by peer");
         }
 
@@ -184,21 +447,112 @@ std::size_t TcpSocket::send(const void* data, std::size_t len) const {
             // Interrupted by a signal; retry the send.
             continue;
         }
-
-        // EAGAIN/EWOULDBLOCK would matter on non-blocking sockets.
-        // We’re blocking, so treat other errors as fatal.
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
         throw systemErr("send");
     }
+}
 
-    // If we sent everything, return 'len'.
-    return len;
+// ---------- non-blocking mode: event loop ----------
+
+/*
+ * flushPending()
+ * - Hand buffered bytes to the kernel until it stops taking them.
+ * - Throws (and drops the connection) if they have made no progress for
+ *   options.writeTimeout: the collector is stalled.
+ */
+void TcpSocket::flushPending() {
+    while (bufferedBytes() > 0) {
+        const ConstBuffer piece(std::next(pending_.data(), static_cast<std::ptrdiff_t>(pendingHead_)), bufferedBytes());
+        const std::size_t bytesSent = writeSome(&piece, 1, 0);
+        if (bytesSent == 0) {
+            break;
+        }
+        pendingHead_ += bytesSent;
+        lastProgress_ = Clock::now();
+    }
+
+    if (bufferedBytes() == 0) {
+        pending_.clear();
+        pendingHead_ = 0;
+    } else if (options_.writeTimeout.count() > 0 && Clock::now() - lastProgress_ >= options_.writeTimeout) {
+        throwStalled("send");
+    }
+    updateWaterMarks();
+}
+
+std::size_t TcpSocket::poll(std::chrono::milliseconds timeout) {
+    if (!isConnected()) {
+        throw std::runtime_error("send: not connected");
+    }
+    if (bufferedBytes() == 0) {
+        return 0;
+    }
+    (void)waitWritable(timeout);
+    flushPending();
+    return bufferedBytes();
+}
+
+bool TcpSocket::flushUntil(Clock::time_point deadline) {
+    if (!isConnected() || bufferedBytes() == 0) {
+        return bufferedBytes() == 0;
+    }
+
+    flushPending();   // at least one attempt, even with a deadline in the past
+    while (isConnected() && bufferedBytes() > 0) {
+        // Round down: callers pass the next tick's deadline, so overshooting
+        // it makes that tick late. Less than 1 ms left is not worth a wait.
+        const auto wait = std::chrono::floor<std::chrono::milliseconds>(deadline - Clock::now());
+        if (wait.count() <= 0) {
+            break;
+        }
+        (void)poll(wait);
+    }
+    return bufferedBytes() == 0;
 }
 
 /*
- * sendString(const std::string& s)
- * - Convenience wrapper for text payloads (e.g., your JSON).
- * - Calls the raw send() with the string’s bytes.
+ * waitWritable(timeout)
+ * - Block until the socket can take more bytes or 'timeout' passes
+ *   (negative = no limit). epoll on Linux, poll() elsewhere.
+ * - Returns false on timeout (or a signal); callers re-check their state.
  */
-std::size_t TcpSocket::sendString(const std::string& payload) const {
-    return send(payload.data(), payload.size());
+bool TcpSocket::waitWritable(std::chrono::milliseconds timeout) const {
+    const int waitMs = toWaitMs(timeout);
+#ifdef __linux__
+    if (epollFd_ >= 0) {
+        epoll_event event{};
+        return ::epoll_wait(epollFd_, &event, 1, waitMs) > 0;
+    }
+#endif
+    pollfd pfd{fd_, POLLOUT, 0};
+    return ::poll(&pfd, 1, waitMs) > 0;
+}
+
+/*
+ * updateWaterMarks()
+ * - Edge-triggered: high fires once when the buffer fills to the high
+ *   mark, low fires once when it has drained back to the low mark.
+ */
+void TcpSocket::updateWaterMarks() {
+    const std::size_t buffered = bufferedBytes();
+    if (!aboveHighWater_ && buffered >= options_.highWaterMark) {
+        aboveHighWater_ = true;
+        if (onHighWater_) {
+            onHighWater_(buffered);
+        }
+    } else if (aboveHighWater_ && buffered <= options_.lowWaterMark) {
+        aboveHighWater_ = false;
+        if (onLowWater_) {
+            onLowWater_(buffered);
+        }
+    }
+}
+
+void TcpSocket::throwStalled(const char* where) {
+    const std::string message = std::string(where) + ": write timed out with " +
+                                std::to_string(bufferedBytes()) + " bytes buffered";
+    closeNow();
+    throw std::runtime_error(message);
 }
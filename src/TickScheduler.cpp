@@ -0,0 +1,132 @@
+/**
+ * @file TickScheduler.cpp
+ * @brief Implementation of the deadline-based TickScheduler.
+ *
+ * @see TickScheduler
+ */
+
+#include "TickScheduler.hpp"
+#include "ConfigTypes.hpp"
+
+#include <algorithm>  // std::min
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/prctl.h>    // ::prctl, PR_GET_TIMERSLACK, PR_SET_TIMERSLACK
+#endif
+
+namespace {
+
+    // Periods below this get the calling thread's timer slack reduced.
+    constexpr std::chrono::milliseconds kFineTimerPeriod{10};
+
+    /*
+     * Linux lets the kernel defer a sleeping thread's wakeup by its "timer
+     * slack" (50 us by default) to batch timer interrupts. At kHz tick rates that
+     * slack alone is a large share of the period, so shrink it for this thread.
+     * The thread still sleeps between ticks; nothing here busy-waits. Returns
+     * false (nothing to restore) if the slack could not be read or changed.
+     */
+    bool requestFineTimerSlack(unsigned long& previous) {
+#ifdef __linux__
+        constexpr unsigned long kSlackNanos = 1;
+        const int current = ::prctl(PR_GET_TIMERSLACK);
+        if (current < 0 || ::prctl(PR_SET_TIMERSLACK, kSlackNanos) != 0) {
+            return false;   // best effort
+        }
+        previous = static_cast<unsigned long>(current);
+        return true;
+#else
+        (void)previous;
+        return false;
+#endif
+    }
+
+    void restoreTimerSlack(unsigned long slack) noexcept {
+#ifdef __linux__
+        (void)::prctl(PR_SET_TIMERSLACK, slack);
+#else
+        (void)slack;
+#endif
+    }
+}
+
+TickScheduler::TickScheduler(std::chrono::nanoseconds period, OverrunPolicy policy)
+    : period_(period), policy_(policy)
+{
+    if (period_ <= std::chrono::nanoseconds::zero()) {
+        throw std::invalid_argument("TickScheduler: period must be > 0");
+    }
+}
+
+void TickScheduler::start() {
+    if (period_ < kFineTimerPeriod && !slackLowered_) {
+        slackLowered_ = requestFineTimerSlack(savedSlack_);
+    }
+    anchored_ = false;
+    stats_    = TickStats{};
+}
+
+void TickScheduler::stop() noexcept {
+    if (slackLowered_) {
+        restoreTimerSlack(savedSlack_);
+        slackLowered_ = false;
+    }
+}
+
+TickScheduler::Clock::time_point TickScheduler::waitNext() {
+    return waitNext(Clock::time_point::max());
+}
+
+/*
+ * waitNext(idleSince)
+ * - On time: sleep until the absolute deadline, then advance it by one period.
+ * - Overrun: the deadline had already passed when the previous tick's work
+ *   was done (at 'idleSince', or now). CATCH_UP releases it immediately (the
+ *   backlog drains on the following calls); SKIP drops every deadline missed
+ *   by then and sleeps until the next one on the original grid.
+ * - Idle work that ends after the deadline only makes the release late.
+ */
+TickScheduler::Clock::time_point TickScheduler::waitNext(Clock::time_point idleSince) {
+
+    const Clock::time_point now = Clock::now();
+    if (!anchored_) {
+        // First tick after start(): it defines the grid and is never late.
+        anchored_ = true;
+        next_     = now;
+    }
+
+    Clock::time_point deadline = next_;
+    const Clock::time_point workDone = std::min(now, idleSince);
+
+    if (workDone > deadline) {
+        ++stats_.overruns;
+
+        if (policy_ == OverrunPolicy::SKIP) {
+            const auto missed = ((workDone - deadline) / period_) + 1;
+            stats_.skipped += static_cast<std::uint64_t>(missed);
+            deadline += period_ * missed;
+        }
+    }
+
+    if (deadline > now) {
+        std::this_thread::sleep_until(deadline);
+    }
+
+    recordRelease(deadline, Clock::now());
+    next_ = deadline + period_;
+    return deadline;
+}
+
+void TickScheduler::recordRelease(Clock::time_point deadline, Clock::time_point released) {
+    const auto jitter = std::chrono::duration_cast<std::chrono::nanoseconds>(released - deadline);
+
+    ++stats_.ticks;
+    stats_.lastJitter   = jitter;
+    stats_.totalJitter += jitter;
+    if (jitter > stats_.maxJitter) {
+        stats_.maxJitter = jitter;
+    }
+}
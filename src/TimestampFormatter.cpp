@@ -0,0 +1,140 @@
+/**
+ * @file TimestampFormatter.cpp
+ * @brief Implementation of the cached log timestamp formatter.
+ *
+ * @see TimestampFormatter
+ */
+
+#include "TimestampFormatter.hpp"
+#include "ConfigTypes.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+    constexpr std::int64_t kNanosPerSecond = 1000000000;
+    constexpr std::int64_t kResyncInterval = 60 * kNanosPerSecond;
+    constexpr std::size_t  kDateTimeLength = 19;   // YYYY-MM-DD HH:MM:SS
+    constexpr char         kUnknownTime[] = "unknown-time";
+
+    std::int64_t systemNs() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    std::int64_t steadyNs() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+}
+
+std::int64_t TimestampFormatter::now() noexcept {
+    static WallClock clock(systemNs(), steadyNs());
+    return clock.read(steadyNs(), &systemNs);
+}
+
+// ----- WallClock -----
+
+TimestampFormatter::WallClock::WallClock(std::int64_t systemNs, std::int64_t steadyNs) noexcept
+    : offset_(systemNs - steadyNs),
+      nextSync_(steadyNs + kResyncInterval),
+      latest_(systemNs)
+{
+}
+
+/*
+ * read()
+ * - Once per kResyncInterval one caller re-measures the offset and stores
+ *   it whichever way it moved.
+ * - A time up to kMaxHoldNs behind the latest one handed out (drift
+ *   corrected backwards, or another thread that got here first) returns
+ *   the latest instead; anything further back is a real step of the system
+ *   clock and becomes the new latest.
+ */
+std::int64_t TimestampFormatter::WallClock::read(std::int64_t steadyNs, std::int64_t (*systemNs)()) noexcept {
+    std::int64_t nextSync = nextSync_.load(std::memory_order_relaxed);
+    if (steadyNs >= nextSync &&
+        nextSync_.compare_exchange_strong(nextSync, steadyNs + kResyncInterval, std::memory_order_relaxed)) {
+        offset_.store(systemNs() - steadyNs, std::memory_order_relaxed);
+    }
+
+    const std::int64_t time = steadyNs + offset_.load(std::memory_order_relaxed);
+    std::int64_t latest = latest_.load(std::memory_order_relaxed);
+    for (;;) {
+        if (time <= latest && latest - time < kMaxHoldNs) {
+            return latest;
+        }
+        if (latest_.compare_exchange_weak(latest, time, std::memory_order_relaxed)) {
+            return time;
+        }
+    }
+}
+
+std::size_t TimestampFormatter::format(std::int64_t timeNs, char* out) {
+    std::int64_t seconds = timeNs / kNanosPerSecond;
+    std::int64_t nanos = timeNs % kNanosPerSecond;
+    if (nanos < 0) {   // before the epoch: round the second down
+        nanos += kNanosPerSecond;
+        --seconds;
+    }
+    if (seconds != cachedSecond_) {
+        renderSeconds(seconds);
+    }
+
+    std::memcpy(out, cached_.data(), cachedLength_);
+    std::size_t length = cachedLength_;
+    if (cachedLength_ != kDateTimeLength) {
+        return length;   // "unknown-time": no fraction or zone to add
+    }
+
+    std::size_t digits = 0;
+    auto fraction = static_cast<std::uint32_t>(nanos);
+    switch (precision_) {
+        case TimestampPrecision::SECONDS:
+            break;
+        case TimestampPrecision::MILLISECONDS:
+            digits = 3;
+            fraction /= 1000000U;
+            break;
+        case TimestampPrecision::MICROSECONDS:
+            digits = 6;
+            fraction /= 1000U;
+            break;
+    }
+    if (digits > 0) {
+        out[length] = '.';
+        for (std::size_t idx = digits; idx > 0; --idx) {
+            out[length + idx] = static_cast<char>('0' + fraction % 10U);
+            fraction /= 10U;
+        }
+        length += digits + 1;
+    }
+    if (utc_) {
+        out[length++] = 'Z';
+    }
+    return length;
+}
+
+void TimestampFormatter::renderSeconds(std::int64_t seconds) {
+    const auto time = static_cast<std::time_t>(seconds);
+    std::tm parts{};
+    const bool known = utc_ ? gmtime_r(&time, &parts) != nullptr : localtime_r(&time, &parts) != nullptr;
+
+    std::size_t length = 0;
+    if (known) {
+        length = std::strftime(cached_.data(), cached_.size(), utc_ ? "%Y-%m-%dT%H:%M:%S" : "%Y-%m-%d %H:%M:%S",
+                               &parts);
+    }
+    if (length != kDateTimeLength) {   // failed, or a year past 9999
+        length = sizeof(kUnknownTime) - 1;
+        std::memcpy(cached_.data(), kUnknownTime, length);
+    }
+    cachedLength_ = length;
+    cachedSecond_ = seconds;
+}
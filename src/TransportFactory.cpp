@@ -2,9 +2,14 @@
 #include "TransportFactory.hpp"
 #include "TcpTransport.hpp"
 #include "UdpTransport.hpp"
+#include "ShmTransport.hpp"
+#include "UnixTransport.hpp"
+#include "FanoutTransport.hpp"
+#include "ReconnectingTransport.hpp"
 #include "ITransport.hpp"
 #include "ConfigTypes.hpp"
 #include "StringUtils.hpp"
+#include "Logger.hpp"
 
 
 
@@ -12,18 +17,59 @@
 #include <string>
 #include <cctype>
 #include <memory> // for std::make_unique
+#include <utility> // std::move
+#include <vector>
 
 
 std::unique_ptr<ITransport> TransportFactory::make(const TransportConfig& cfg) {
 
+    auto transport = makeLink(cfg);
+    if (cfg.reconnect.enabled) {
+        return std::make_unique<ReconnectingTransport>(std::move(transport), cfg.reconnect);
+    }
+    return transport;
+}
+
+std::unique_ptr<ITransport> TransportFactory::makeLink(const TransportConfig& cfg) {
+
     if (cfg.kind.empty()) {
         throw std::runtime_error("TransportFactory: empty 'kind'");
     }
+    // One child per sink, each built (and wrapped for reconnects) on its own.
+    if (StringUtils::iequals(cfg.kind, "fanout")) {
+        std::vector<FanoutTransport::Sink> sinks;
+        sinks.reserve(cfg.sinks.size());
+        for (const auto& sink : cfg.sinks) {
+            if (StringUtils::iequals(sink.transport.kind, "fanout")) {
+                throw std::runtime_error("TransportFactory: fan-out sink '" + sink.name + "' cannot be a fan-out");
+            }
+            sinks.push_back(FanoutTransport::Sink{sink.name, make(sink.transport), sink.queue});
+        }
+        return std::make_unique<FanoutTransport>(std::move(sinks));
+    }
+    // Same-host kinds: no network address.
+    if (StringUtils::iequals(cfg.kind, "unix")) {
+        return std::make_unique<UnixTransport>(cfg.unixSocket);
+    }
+    if (StringUtils::iequals(cfg.kind, "shm")) {
+        return std::make_unique<ShmTransport>(cfg.shm);
+    }
     if (cfg.host.empty()) {
         throw std::runtime_error("TransportFactory: empty host");
     }
     if (StringUtils::iequals(cfg.kind, "tcp")) {
-        return std::make_unique<TcpTransport>(cfg.host, cfg.port);
+        auto tcp = std::make_unique<TcpTransport>(cfg.host, cfg.port, cfg.tcp);
+        if (cfg.tcp.nonBlocking) {
+            tcp->onHighWater([](std::size_t buffered) {
+                Logger::instance().warning("TCP send buffer above high water mark (" + std::to_string(buffered) +
+                                           " bytes queued); collector is slow, shedding samples.");
+            });
+            tcp->onLowWater([](std::size_t buffered) {
+                Logger::instance().info("TCP send buffer drained to " + std::to_string(buffered) +
+                                        " bytes; sampling resumes.");
+            });
+        }
+        return tcp;
     }
     if (StringUtils::iequals(cfg.kind, "udp")) {
         return std::make_unique<UdpTransport>(cfg.host, cfg.port);
@@ -8,7 +8,11 @@
 #include <cstring>      // std::strerror, std::memset
 #include <cerrno>
 #include <cstdint>      // int32_t
-#include <sys/socket.h> // ::socket, ::connect, ::send, SOCK_DGRAM
+#include <sys/socket.h> // ::socket, ::connect, ::send, ::sendmsg, SOCK_DGRAM
+#include <sys/uio.h>    // iovec
+#include <array>
+#include <vector>
+#include <algorithm>    // std::min
 #include <netdb.h>      // ::getaddrinfo, ::freeaddrinfo, addrinfo
 
 namespace {
@@ -17,6 +21,12 @@ namespace {
     std::runtime_error systemErr(const std::string& where) {
         return std::runtime_error(where + ": " + std::strerror(errno));
     }
+
+    // pieces gathered without a heap allocation; longer lists use a vector
+    constexpr std::size_t kInlineIovecs = 16;
+
+    // datagrams submitted per sendmmsg() call (the kernel caps one call at UIO_MAXIOV = 1024)
+    constexpr std::size_t kBurstWindow = 64;
 }
 
 UdpSocket::UdpSocket(std::string host, uint16_t port)
@@ -105,6 +115,108 @@ std::size_t UdpSocket::send(const void* data, std::size_t len) const {
     }
 }
 
+std::size_t UdpSocket::sendBuffers(const ConstBuffer* buffers, std::size_t count) const {
+
+    if (!isConnected()) {
+        throw std::runtime_error("udp send: not connected");
+    }
+
+    // A datagram cannot be split over several calls: all pieces go into one
+    // sendmsg(), so the receiver sees exactly one message.
+    std::array<iovec, kInlineIovecs> inlineIov{};
+    std::vector<iovec> heapIov;
+    iovec* iov = inlineIov.data();
+    if (count > inlineIov.size()) {
+        heapIov.resize(count);
+        iov = heapIov.data();
+    }
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        iov[idx].iov_base = const_cast<void*>(buffers[idx].data);  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+        iov[idx].iov_len  = buffers[idx].size;
+    }
+
+    msghdr msg{};
+    msg.msg_iov    = iov;
+    msg.msg_iovlen = static_cast<decltype(msg.msg_iovlen)>(count);   // int on BSD, size_t on Linux
+
+    const std::size_t len = totalSize(buffers, count);
+    for (;;) {
+        const ssize_t bytesSent = ::sendmsg(fd_, &msg, 0);
+        if (bytesSent >= 0) {
+            if (static_cast<std::size_t>(bytesSent) != len) {
+                throw std::runtime_error("udp send: short datagram send");
+            }
+            return len;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        throw systemErr("udp send");
+    }
+}
+
+std::size_t UdpSocket::sendBurst(const ConstBuffer* datagrams, std::size_t count) const {
+
+    if (!isConnected()) {
+        throw std::runtime_error("udp send: not connected");
+    }
+
+    std::size_t sent = 0;
+
+#ifdef __linux__
+    std::array<mmsghdr, kBurstWindow> msgs{};
+    std::array<iovec, kBurstWindow>   iov{};
+
+    while (sent < count) {
+        const std::size_t window = std::min(count - sent, kBurstWindow);
+        for (std::size_t idx = 0; idx < window; ++idx) {
+            iov[idx].iov_base = const_cast<void*>(datagrams[sent + idx].data);  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+            iov[idx].iov_len  = datagrams[sent + idx].size;
+            msgs[idx] = mmsghdr{};
+            msgs[idx].msg_hdr.msg_iov    = &iov[idx];
+            msgs[idx].msg_hdr.msg_iovlen = 1;
+        }
+
+        // sendmmsg() stops at the first datagram that fails and returns how
+        // many went out before it; the error is only reported (as -1) when
+        // that is the very first one of the call.
+        const int rtnCode = ::sendmmsg(fd_, msgs.data(), static_cast<unsigned int>(window), 0);
+        if (rtnCode < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (sent > 0) {
+                return sent;   // partial burst: [sent] is the one that failed
+            }
+            throw systemErr("udp sendmmsg");
+        }
+
+        const auto accepted = static_cast<std::size_t>(rtnCode);
+        for (std::size_t idx = 0; idx < accepted; ++idx) {
+            if (msgs[idx].msg_len != iov[idx].iov_len) {
+                throw std::runtime_error("udp send: short datagram send");
+            }
+        }
+        sent += accepted;
+        // accepted < window: the next call resumes at the datagram that
+        // stopped this one, and either sends it or reports its error.
+    }
+#else
+    for (; sent < count; ++sent) {
+        try {
+            send(datagrams[sent].data, datagrams[sent].size);
+        } catch (const std::runtime_error&) {
+            if (sent == 0) {
+                throw;
+            }
+            return sent;
+        }
+    }
+#endif
+
+    return sent;
+}
+
 std::size_t UdpSocket::sendString(const std::string& payload) const {
     return send(payload.data(), payload.size());
 }
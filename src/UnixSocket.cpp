@@ -0,0 +1,227 @@
+/**
+ * @file UnixSocket.cpp
+ * @brief Implementation of the Unix domain socket client.
+ *
+ * @see UnixSocket
+ */
+
+#include "UnixSocket.hpp"
+#include "ConfigTypes.hpp"
+#include "ConstBuffer.hpp"
+
+#include <sys/socket.h>
+#include <sys/time.h>      // timeval
+#include <sys/uio.h>       // iovec
+#include <sys/un.h>        // sockaddr_un
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>         // std::strerror, std::memcpy
+#include <stdexcept>
+#include <string>
+#include <utility>         // std::move
+
+namespace {
+
+    std::runtime_error systemErr(const std::string& where) {
+        return std::runtime_error(where + ": " + std::strerror(errno));
+    }
+
+    // '@name' is Linux's abstract namespace: sun_path starts with a NUL
+    // byte and the name is not NUL-terminated.
+    socklen_t makeAddress(const std::string& path, sockaddr_un& addr) {
+        addr = sockaddr_un{};
+        addr.sun_family = AF_UNIX;
+        if (path.front() == '@') {
+            addr.sun_path[0] = '\0';
+            std::memcpy(addr.sun_path + 1, path.data() + 1, path.size() - 1);
+            return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size());
+        }
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size() + 1);
+    }
+
+#ifdef __linux__
+    constexpr int kSendFlags   = MSG_NOSIGNAL;
+    constexpr int kSocketFlags = SOCK_CLOEXEC;
+#else
+    constexpr int kSendFlags   = 0;
+    constexpr int kSocketFlags = 0;
+#endif
+}
+
+UnixSocket::UnixSocket(UnixOptions options)
+    : options_(std::move(options))
+{
+    if (options_.path.empty() || options_.path == "@") {
+        throw std::invalid_argument("UnixSocket: path cannot be empty");
+    }
+    if (options_.path.size() >= sizeof(sockaddr_un::sun_path)) {
+        throw std::invalid_argument("UnixSocket: path longer than " +
+                                    std::to_string(sizeof(sockaddr_un::sun_path) - 1) + " bytes: " + options_.path);
+    }
+}
+
+UnixSocket::~UnixSocket() {
+    close();
+}
+
+void UnixSocket::connect() {
+    if (isConnected()) {
+        return;
+    }
+#ifndef __linux__
+    if (options_.path.front() == '@' || options_.sendCredentials || options_.peerUid) {
+        throw std::runtime_error("unix connect: abstract addresses and credentials need Linux");
+    }
+#endif
+
+    const int type = options_.datagram ? SOCK_DGRAM : SOCK_STREAM;
+    const int sock = ::socket(AF_UNIX, type | kSocketFlags, 0);
+    if (sock < 0) {
+        throw systemErr("unix socket");
+    }
+
+    sockaddr_un addr{};
+    const socklen_t addrLen = makeAddress(options_.path, addr);
+    int rtnCode = 0;
+    do {
+        rtnCode = ::connect(sock, reinterpret_cast<const sockaddr*>(&addr), addrLen);   // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    } while (rtnCode < 0 && errno == EINTR);
+    if (rtnCode < 0) {
+        const auto saved = errno;
+        ::close(sock);
+        errno = saved;
+        throw systemErr("unix connect '" + options_.path + "'");
+    }
+    fd_ = sock;
+
+    try {
+        if (options_.writeTimeout.count() > 0) {
+            const auto usec = std::chrono::duration_cast<std::chrono::microseconds>(options_.writeTimeout).count();
+            timeval sndTimeout{};
+            sndTimeout.tv_sec  = static_cast<decltype(sndTimeout.tv_sec)>(usec / 1000000);
+            sndTimeout.tv_usec = static_cast<decltype(sndTimeout.tv_usec)>(usec % 1000000);
+            if (::setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &sndTimeout, sizeof(sndTimeout)) < 0) {
+                throw systemErr("setsockopt(SO_SNDTIMEO)");
+            }
+        }
+        if (options_.peerUid) {
+            checkPeer();
+        }
+    } catch (...) {
+        close();
+        throw;
+    }
+    credentialsDue_ = options_.sendCredentials;
+}
+
+// Refuse a collector that does not run as the configured user (for
+// example someone else's process bound to the same abstract name).
+void UnixSocket::checkPeer() {
+#ifdef __linux__
+    if (options_.datagram) {
+        return;   // SO_PEERCRED describes stream peers only
+    }
+    ucred peer{};
+    socklen_t len = sizeof(peer);
+    if (::getsockopt(fd_, SOL_SOCKET, SO_PEERCRED, &peer, &len) < 0) {
+        throw systemErr("getsockopt(SO_PEERCRED)");
+    }
+    if (peer.uid != *options_.peerUid) {
+        throw std::runtime_error("unix connect '" + options_.path + "': collector runs as uid " +
+                                 std::to_string(peer.uid) + ", expected " + std::to_string(*options_.peerUid));
+    }
+#endif
+}
+
+std::size_t UnixSocket::sendString(const std::string& payload) {
+    const ConstBuffer piece(payload);
+    return sendBuffers(&piece, 1);
+}
+
+/*
+ * sendBuffers()
+ * - Datagram: one sendmsg() for the whole message, all or nothing.
+ * - Stream: like TcpSocket's blocking send; a partial write resumes inside
+ *   the piece where it stopped. 0 from sendSome() means SO_SNDTIMEO
+ *   expired: part of the message may be out, so the stream is dropped.
+ */
+std::size_t UnixSocket::sendBuffers(const ConstBuffer* buffers, std::size_t count) {
+    if (!isConnected()) {
+        throw std::runtime_error("unix send: not connected");
+    }
+
+    const std::size_t len = totalSize(buffers, count);
+    if (options_.datagram) {
+        if (count > kMaxIovecs) {
+            throw std::invalid_argument("unix send: more than " + std::to_string(kMaxIovecs) + " pieces in a datagram");
+        }
+        const std::size_t sent = sendSome(buffers, count, 0);
+        if (sent != len) {
+            throw std::runtime_error(sent == 0 ? "unix send: write timed out" : "unix send: short datagram send");
+        }
+        return len;
+    }
+
+    std::size_t sent = 0;
+    while (sent < len) {
+        const std::size_t bytesSent = sendSome(buffers, count, sent);
+        if (bytesSent == 0) {
+            close();
+            throw std::runtime_error("unix send: write timed out");
+        }
+        sent += bytesSent;
+    }
+    return len;
+}
+
+// One sendmsg() of buffers[...] from byte 'skip' on; 0 on a send timeout.
+std::size_t UnixSocket::sendSome(const ConstBuffer* buffers, std::size_t count, std::size_t skip) {
+    Iovecs iov{};
+    const std::size_t used = fillIovecs(buffers, count, skip, iov);
+
+    msghdr msg{};
+    msg.msg_iov    = iov.data();
+    msg.msg_iovlen = static_cast<decltype(msg.msg_iovlen)>(used);   // int on BSD, size_t on Linux
+
+#ifdef __linux__
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(ucred))> control{};
+    if (credentialsDue_) {
+        msg.msg_control    = control.data();
+        msg.msg_controllen = control.size();
+        cmsghdr* cmsg   = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type  = SCM_CREDENTIALS;
+        cmsg->cmsg_len   = CMSG_LEN(sizeof(ucred));
+        const ucred self{::getpid(), ::geteuid(), ::getegid()};
+        std::memcpy(CMSG_DATA(cmsg), &self, sizeof(self));
+    }
+#endif
+
+    for (;;) {
+        const ssize_t bytesSent = ::sendmsg(fd_, &msg, kSendFlags);
+        if (bytesSent >= 0) {
+            credentialsDue_ = false;
+            return static_cast<std::size_t>(bytesSent);
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+        throw systemErr("unix send");
+    }
+}
+
+void UnixSocket::close() noexcept {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    credentialsDue_ = false;
+}
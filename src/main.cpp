@@ -33,10 +33,14 @@
 #include "Sensor.hpp"
 #include "TransportFactory.hpp"
 #include "HardwareDataSource.hpp"
+#include "IDataSource.hpp"
+#include "SimulationDataSource.hpp"
+#include "StringUtils.hpp"
 
 #include <atomic>
 #include <csignal>
 #include <chrono>
+#include <cstdint>
 #include <cstdlib> // std::getenv
 #include <exception>
 #include <string>
@@ -84,6 +88,10 @@ namespace {
     constexpr const char* kDefaultSensorEnv = "SENSOR_CONFIG";
     constexpr const char* kDefaultTransportEnv = "TRANSPORT_CONFIG";
     constexpr const char* kRunDurationEnv = "RUN_DURATION_SECONDS";
+    constexpr const char* kSimulationEnv = "SIMULATION_DATASOURCE_CONFIG";
+
+    // Metric dictionary repeat rate (samples) on UDP links unless configured.
+    constexpr std::uint32_t kUdpDictionaryEvery = 30;
 } // namespace
 
 
@@ -102,6 +110,27 @@ namespace {
         return defval;
     }
 
+    // Open the default camera (index 0) and wrap it in a HardwareDataSource
+    // (with the sensor config's snapshot and sampling settings).
+    // Returns nullptr (after logging) if the camera cannot be opened.
+    std::unique_ptr<IDataSource> openCameraDataSource(const SensorConfig& config) {
+#ifndef USE_MOCK_CAMERA
+        auto camera = std::make_shared<HardwareCamera>();
+        if (!camera->open(0)) {
+            Logger::instance().error("Failed to open camera.");
+            return nullptr;
+        }
+        Logger::instance().info("Camera opened successfully.");
+#else
+        auto camera = std::make_shared<MockCamera>();
+        if (!camera->open(0)) {
+            Logger::instance().error("Failed to open MockCamera.");
+            return nullptr;
+        }
+        Logger::instance().info("MockCamera opened successfully.");
+#endif
+        return std::make_unique<HardwareDataSource>(camera, config.snapshot, config.sampling);
+    }
 
 
 } // namespace
@@ -123,40 +152,38 @@ int main(int /*argc*/, const char* /*argv*/[]) {    // NOLINT(bugprone-exception
          // 1. Load config
         const std::string sensorCfgPath = envOrDefault(kDefaultSensorEnv, kDefaultSensorCfgFile);
         const std::string transportCfgPath = envOrDefault(kDefaultTransportEnv, kDefaultTransportCfgFile);
-        const auto sensorCfg = ConfigLoader::loadSensorConfig(sensorCfgPath);
+        auto sensorCfg = ConfigLoader::loadSensorConfig(sensorCfgPath);
         const auto transportCfg = ConfigLoader::loadTransportConfig(transportCfgPath);
+        if (transportCfg.payloadFormat) {
+            sensorCfg.payloadFormat = *transportCfg.payloadFormat;   // the link decides what it carries
+        }
+        Logger::instance().setMinLevel(sensorCfg.logging.level);
+        Logger::instance().setTimestampFormat(sensorCfg.logging.timestampPrecision, sensorCfg.logging.timestampUtc);
+        if (sensorCfg.logging.async) {
+            Logger::instance().startAsync(sensorCfg.logging);   // keep log writes off the sampling path
+        }
+        if (sensorCfg.metricIds.enabled && sensorCfg.metricIds.dictionaryEvery == 0 && StringUtils::iequals(transportCfg.kind, "udp")) {
+            sensorCfg.metricIds.dictionaryEvery = kUdpDictionaryEvery;   // datagrams get lost: repeat it
+        }
 
-#ifndef USE_MOCK_CAMERA
-
-    // Try to open the default camera (index 0)
-    // If it fails, log an error and exit.
-    auto camera = std::make_shared<HardwareCamera>();
-    if(camera->open(0)){
-        Logger::instance().info("Camera opened successfully.");
-    } else {
-        Logger::instance().error("Failed to open camera.");
-        return EXIT_FAILURE;
-    }
-
-    Logger::instance().info("Camera opened successfully.");
-
-    auto dataSource = std::make_unique<HardwareDataSource>(camera);
-
-#else
-    auto camera = std::make_shared<MockCamera>();
-    if(camera->open(0)){
-        Logger::instance().info("MockCamera opened successfully.");
-    } else {
-        Logger::instance().error("Failed to open MockCamera.");
-        return EXIT_FAILURE;
-    }
-    auto dataSource = std::make_unique<HardwareDataSource>(camera);
-#endif
+        // 2. Create data source: simulated metrics if SIMULATION_DATASOURCE_CONFIG is set, camera otherwise
+        std::unique_ptr<IDataSource> dataSource;
+        const std::string simulationCfgPath = envOrDefault(kSimulationEnv, "");
+        if (!simulationCfgPath.empty()) {
+            dataSource = std::make_unique<SimulationDataSource>(
+                ConfigLoader::loadDataSourceConfig(simulationCfgPath));
+            Logger::instance().info("Using simulated data source from " + simulationCfgPath + ".");
+        } else {
+            dataSource = openCameraDataSource(sensorCfg);
+            if (!dataSource) {
+                return EXIT_FAILURE;
+            }
+        }
 
-        // 2. Create transport
+        // 3. Create transport
         auto transport = TransportFactory::make(transportCfg);
 
-        // 3. Create sensor object and start sensor thread
+        // 4. Create sensor object and start sensor thread
         Sensor sensor{sensorCfg, std::move(dataSource), std::move(transport)};
         std::thread sensorThread([&sensor]() {
             try {
@@ -176,7 +203,7 @@ int main(int /*argc*/, const char* /*argv*/[]) {    // NOLINT(bugprone-exception
             }
         });
 
-        // 4. Main thread: wait for termination signal (Ctrl-C) or optional timeout
+        // 5. Main thread: wait for termination signal (Ctrl-C) or optional timeout
         const int runDuration = envOrDefaultInt(kRunDurationEnv, kDefaultRunDurationSecs);
         auto startTime = std::chrono::steady_clock::now();
         Logger::instance().info("Sensor running. Press Ctrl-C to stop."
@@ -205,6 +232,7 @@ int main(int /*argc*/, const char* /*argv*/[]) {    // NOLINT(bugprone-exception
         }
 
         Logger::instance().info("Sensor shutting down...");
+        Logger::instance().stopAsync();
 
     }
     catch (const std::exception& ex) {
@@ -0,0 +1,66 @@
+#include "AllocationCounter.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    thread_local bool          tracking = false;
+    thread_local std::uint64_t allocations = 0;
+
+    void* countedAlloc(std::size_t size) {
+        if (tracking) {
+            ++allocations;
+        }
+        if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+            return ptr;
+        }
+        throw std::bad_alloc();
+    }
+
+    void* countedAlignedAlloc(std::size_t size, std::align_val_t align) {
+        if (tracking) {
+            ++allocations;
+        }
+        const auto alignment = static_cast<std::size_t>(align);
+        const std::size_t rounded = (size + alignment - 1) / alignment * alignment;
+        if (void* ptr = std::aligned_alloc(alignment, rounded == 0 ? alignment : rounded)) {
+            return ptr;
+        }
+        throw std::bad_alloc();
+    }
+}
+
+// NOLINTBEGIN(misc-new-delete-overloads)
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+// NOLINTEND(misc-new-delete-overloads)
+
+namespace AllocationCounter {
+
+    ScopedAllocationCount::ScopedAllocationCount()
+        : start_(allocations), wasTracking_(tracking)
+    {
+        tracking = true;
+    }
+
+    ScopedAllocationCount::~ScopedAllocationCount() {
+        tracking = wasTracking_;
+    }
+
+    std::uint64_t ScopedAllocationCount::count() const {
+        return allocations - start_;
+    }
+}
@@ -0,0 +1,33 @@
+/**
+ * @file AllocationCounter.hpp
+ * @brief Test helper counting global operator new calls on the current thread.
+ *
+ * AllocationCounter.cpp replaces the global allocation functions for the
+ * test binary. Counting is off unless a ScopedAllocationCount is alive on
+ * the calling thread, so other tests are unaffected.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace AllocationCounter {
+
+    // Counts operator new calls made on this thread during its lifetime.
+    class ScopedAllocationCount {
+    public:
+        ScopedAllocationCount();
+        ~ScopedAllocationCount();
+
+        ScopedAllocationCount(const ScopedAllocationCount&) = delete;
+        ScopedAllocationCount& operator=(const ScopedAllocationCount&) = delete;
+        ScopedAllocationCount(ScopedAllocationCount&&) = delete;
+        ScopedAllocationCount& operator=(ScopedAllocationCount&&) = delete;
+
+        [[nodiscard]] std::uint64_t count() const;
+
+    private:
+        std::uint64_t start_;
+        bool          wasTracking_;
+    };
+}
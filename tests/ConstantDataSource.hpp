@@ -0,0 +1,16 @@
+/**
+ * @file ConstantDataSource.hpp
+ * @brief Test helper: a data source that reads the same value every tick.
+ *
+ * For Sensor tests that exercise transports and encoders rather than a
+ * real source: one "temperature" reading of 21.5.
+ */
+
+#pragma once
+
+#include "IDataSource.hpp"
+
+class ConstantDataSource : public IDataSource {
+public:
+    Readings readAll() override { return {{"temperature", 21.5}}; }
+};
@@ -1,8 +1,11 @@
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch_all.hpp>
 #include "ConfigLoader.hpp"
+#include <chrono>
 #include <fstream>
+#include <optional>
 #include <cstdio>
+#include <cstdint>
 
 // RAII wrapper for a temporary JSON file
 struct TempJsonFile {
@@ -23,7 +26,7 @@ TEST_CASE("SensorConfig loads valid minimal config", "[ConfigLoader]") {
 
     auto cfg = ConfigLoader::loadSensorConfig(tmp.path);
     REQUIRE(cfg.sensorId == "sensor123");
-    REQUIRE(cfg.intervalSeconds == 1); // default
+    REQUIRE(cfg.interval == std::chrono::seconds(1)); // default
     REQUIRE(cfg.units.empty());
     REQUIRE(cfg.metadata.empty());
 }
@@ -38,7 +41,7 @@ TEST_CASE("SensorConfig with custom interval and maps", "[ConfigLoader]") {
 
     auto cfg = ConfigLoader::loadSensorConfig(tmp.path);
     REQUIRE(cfg.sensorId == "abc");
-    REQUIRE(cfg.intervalSeconds == 5);
+    REQUIRE(cfg.interval == std::chrono::seconds(5));
     REQUIRE(cfg.units.at("temp") == "C");
     REQUIRE(cfg.metadata.at("loc") == "lab");
 }
@@ -80,6 +83,113 @@ TEST_CASE("SensorConfig interval is negative throws", "[ConfigLoader]") {
     REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
 }
 
+TEST_CASE("SensorConfig accepts fractional interval_seconds", "[ConfigLoader]") {
+    TempJsonFile tmp("sensor_fractional_interval.json", R"({
+        "sensor_id": "idFast",
+        "interval_seconds": 0.25
+    })");
+
+    auto cfg = ConfigLoader::loadSensorConfig(tmp.path);
+    REQUIRE(cfg.interval == std::chrono::milliseconds(250));
+}
+
+TEST_CASE("SensorConfig accepts interval_ms and interval_us", "[ConfigLoader]") {
+    SECTION("milliseconds, fractional") {
+        TempJsonFile tmp("sensor_interval_ms.json", R"({
+            "sensor_id": "idMs",
+            "interval_ms": 1.5
+        })");
+        REQUIRE(ConfigLoader::loadSensorConfig(tmp.path).interval == std::chrono::microseconds(1500));
+    }
+
+    SECTION("microseconds") {
+        TempJsonFile tmp("sensor_interval_us.json", R"({
+            "sensor_id": "idUs",
+            "interval_us": 1000
+        })");
+        REQUIRE(ConfigLoader::loadSensorConfig(tmp.path).interval == std::chrono::milliseconds(1));
+    }
+}
+
+TEST_CASE("SensorConfig rejects ambiguous or out-of-range intervals", "[ConfigLoader]") {
+    SECTION("two interval keys") {
+        TempJsonFile tmp("sensor_two_intervals.json", R"({
+            "sensor_id": "idBoth",
+            "interval_seconds": 1,
+            "interval_ms": 10
+        })");
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+    }
+
+    SECTION("below one microsecond") {
+        TempJsonFile tmp("sensor_sub_us_interval.json", R"({
+            "sensor_id": "idTiny",
+            "interval_ms": 0.0001
+        })");
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+    }
+
+    SECTION("fractional microseconds") {
+        TempJsonFile tmp("sensor_fractional_us.json", R"({
+            "sensor_id": "idFracUs",
+            "interval_us": 2.5
+        })");
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+    }
+
+    SECTION("longer than a day") {
+        TempJsonFile tmp("sensor_huge_interval.json", R"({
+            "sensor_id": "idHuge",
+            "interval_seconds": 100000
+        })");
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+    }
+}
+
+TEST_CASE("SensorConfig pipeline section is parsed", "[ConfigLoader]") {
+    TempJsonFile tmp("sensor_pipeline.json", R"({
+        "sensor_id": "idPipe",
+        "pipeline": {
+            "enabled": true,
+            "capture_queue": { "depth": 128, "policy": "drop_newest" },
+            "send_queue": { "policy": "block" }
+        }
+    })");
+
+    auto cfg = ConfigLoader::loadSensorConfig(tmp.path);
+    REQUIRE(cfg.pipeline.enabled);
+    REQUIRE(cfg.pipeline.captureQueue.depth == 128);
+    REQUIRE(cfg.pipeline.captureQueue.policy == QueuePolicy::DROP_NEWEST);
+    REQUIRE(cfg.pipeline.sendQueue.depth == 64);  // default
+    REQUIRE(cfg.pipeline.sendQueue.policy == QueuePolicy::BLOCK);
+}
+
+TEST_CASE("SensorConfig invalid pipeline section throws", "[ConfigLoader]") {
+    SECTION("unknown policy") {
+        TempJsonFile tmp("sensor_pipeline_bad_policy.json", R"({
+            "sensor_id": "idPipe",
+            "pipeline": { "send_queue": { "policy": "drop_all" } }
+        })");
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+    }
+
+    SECTION("zero depth") {
+        TempJsonFile tmp("sensor_pipeline_zero_depth.json", R"({
+            "sensor_id": "idPipe",
+            "pipeline": { "capture_queue": { "depth": 0 } }
+        })");
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+    }
+
+    SECTION("enabled not boolean") {
+        TempJsonFile tmp("sensor_pipeline_bad_enabled.json", R"({
+            "sensor_id": "idPipe",
+            "pipeline": { "enabled": "yes" }
+        })");
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+    }
+}
+
 TEST_CASE("SensorConfig units present but not object throws", "[ConfigLoader]") {
     TempJsonFile tmp("sensor_units_not_obj.json", R"({
         "sensor_id": "idUnits",
@@ -96,6 +206,31 @@ TEST_CASE("SensorConfig metadata present but not object throws", "[ConfigLoader]
     REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
 }
 
+TEST_CASE("SensorConfig overrun_policy defaults to skip", "[ConfigLoader]") {
+    TempJsonFile tmp("sensor_default_policy.json", R"({ "sensor_id": "idPolicy" })");
+
+    auto cfg = ConfigLoader::loadSensorConfig(tmp.path);
+    REQUIRE(cfg.overrunPolicy == OverrunPolicy::SKIP);
+}
+
+TEST_CASE("SensorConfig overrun_policy catch_up is parsed", "[ConfigLoader]") {
+    TempJsonFile tmp("sensor_catch_up_policy.json", R"({
+        "sensor_id": "idPolicy",
+        "overrun_policy": "catch_up"
+    })");
+
+    auto cfg = ConfigLoader::loadSensorConfig(tmp.path);
+    REQUIRE(cfg.overrunPolicy == OverrunPolicy::CATCH_UP);
+}
+
+TEST_CASE("SensorConfig unknown overrun_policy throws", "[ConfigLoader]") {
+    TempJsonFile tmp("sensor_bad_policy.json", R"({
+        "sensor_id": "idPolicy",
+        "overrun_policy": "burst"
+    })");
+    REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+}
+
 // ---------------- TransportConfig tests ----------------
 
 TEST_CASE("TransportConfig loads valid TCP config", "[ConfigLoader]") {
@@ -164,6 +299,180 @@ TEST_CASE("TransportConfig TCP port out of range throws", "[ConfigLoader]") {
     REQUIRE_THROWS_AS(ConfigLoader::loadTransportConfig(tmp.path), std::runtime_error);
 }
 
+TEST_CASE("TransportConfig reads non-blocking TCP options", "[ConfigLoader]") {
+    TempJsonFile tmp("tcp_nonblocking.json", R"({
+        "kind": "tcp",
+        "tcp": { "host": "localhost", "port": 8080, "non_blocking": true,
+                 "connect_timeout_ms": 1500, "write_timeout_ms": 250, "send_buffer_bytes": 4096 }
+    })");
+
+    const auto cfg = ConfigLoader::loadTransportConfig(tmp.path);
+    REQUIRE(cfg.tcp.nonBlocking);
+    REQUIRE(cfg.tcp.connectTimeout == std::chrono::milliseconds(1500));
+    REQUIRE(cfg.tcp.writeTimeout == std::chrono::milliseconds(250));
+    REQUIRE(cfg.tcp.sendBufferBytes == 4096);
+    REQUIRE(cfg.tcp.highWaterMark == 3072);   // 3/4 and 1/4 of the buffer by default
+    REQUIRE(cfg.tcp.lowWaterMark == 1024);
+
+    TempJsonFile plain("tcp_plain.json", R"({ "kind": "tcp", "tcp": { "host": "localhost", "port": 8080 } })");
+    REQUIRE_FALSE(ConfigLoader::loadTransportConfig(plain.path).tcp.nonBlocking);
+}
+
+TEST_CASE("TransportConfig rejects inconsistent TCP options", "[ConfigLoader]") {
+    TempJsonFile marks("tcp_bad_marks.json", R"({
+        "kind": "tcp",
+        "tcp": { "host": "localhost", "port": 8080, "non_blocking": true,
+                 "send_buffer_bytes": 4096, "high_water_mark": 1000, "low_water_mark": 2000 }
+    })");
+    REQUIRE_THROWS_AS(ConfigLoader::loadTransportConfig(marks.path), std::runtime_error);
+
+    TempJsonFile timeout("tcp_bad_timeout.json", R"({
+        "kind": "tcp",
+        "tcp": { "host": "localhost", "port": 8080, "write_timeout_ms": -1 }
+    })");
+    REQUIRE_THROWS_AS(ConfigLoader::loadTransportConfig(timeout.path), std::runtime_error);
+
+    TempJsonFile flag("tcp_bad_flag.json", R"({
+        "kind": "tcp",
+        "tcp": { "host": "localhost", "port": 8080, "non_blocking": "yes" }
+    })");
+    REQUIRE_THROWS_AS(ConfigLoader::loadTransportConfig(flag.path), std::runtime_error);
+}
+
+TEST_CASE("TransportConfig reads the reconnect policy", "[ConfigLoader]") {
+    TempJsonFile tmp("tcp_reconnect.json", R"({
+        "kind": "tcp",
+        "tcp": { "host": "localhost", "port": 8080 },
+        "reconnect": { "enabled": true, "initial_backoff_ms": 500, "max_backoff_ms": 60000,
+                       "max_attempts": 4, "attempt_window_ms": 120000, "queue_samples": 10 }
+    })");
+
+    const auto cfg = ConfigLoader::loadTransportConfig(tmp.path);
+    REQUIRE(cfg.reconnect.enabled);
+    REQUIRE(cfg.reconnect.initialBackoff == std::chrono::milliseconds(500));
+    REQUIRE(cfg.reconnect.maxBackoff == std::chrono::milliseconds(60000));
+    REQUIRE(cfg.reconnect.maxAttempts == 4);
+    REQUIRE(cfg.reconnect.attemptWindow == std::chrono::milliseconds(120000));
+    REQUIRE(cfg.reconnect.queueSamples == 10);
+
+    TempJsonFile bad("tcp_reconnect_bad.json", R"({
+        "kind": "tcp",
+        "tcp": { "host": "localhost", "port": 8080 },
+        "reconnect": { "enabled": true, "initial_backoff_ms": 500, "max_backoff_ms": 100 }
+    })");
+    REQUIRE_THROWS_AS(ConfigLoader::loadTransportConfig(bad.path), std::runtime_error);
+}
+
+TEST_CASE("TransportConfig reads the reconnect spool", "[ConfigLoader]") {
+    TempJsonFile tmp("tcp_spool.json", R"({
+        "kind": "tcp",
+        "tcp": { "host": "localhost", "port": 8080 },
+        "reconnect": { "enabled": true, "replay_rate": 50,
+                       "spool": { "enabled": true, "directory": "/tmp/spool", "segment_bytes": 65536,
+                                  "max_bytes": 1048576, "max_age_ms": 3600000, "sync_interval_ms": 0 } }
+    })");
+
+    const auto cfg = ConfigLoader::loadTransportConfig(tmp.path);
+    REQUIRE(cfg.reconnect.replayRate == 50);
+    REQUIRE(cfg.reconnect.spool.enabled);
+    REQUIRE(cfg.reconnect.spool.directory == "/tmp/spool");
+    REQUIRE(cfg.reconnect.spool.segmentBytes == 65536);
+    REQUIRE(cfg.reconnect.spool.maxBytes == 1048576);
+    REQUIRE(cfg.reconnect.spool.maxAge == std::chrono::milliseconds(3600000));
+    REQUIRE(cfg.reconnect.spool.syncInterval == std::chrono::milliseconds(0));
+
+    TempJsonFile bad("tcp_spool_bad.json", R"({
+        "kind": "tcp",
+        "tcp": { "host": "localhost", "port": 8080 },
+        "reconnect": { "enabled": true, "spool": { "segment_bytes": 1048576, "max_bytes": 65536 } }
+    })");
+    REQUIRE_THROWS_AS(ConfigLoader::loadTransportConfig(bad.path), std::runtime_error);
+}
+
+TEST_CASE("TransportConfig reads shm options", "[ConfigLoader]") {
+    TempJsonFile tmp("shm_valid.json", R"({
+        "kind": "shm",
+        "shm": { "name": "/collector", "capacity_bytes": 65536, "write_timeout_ms": 250 }
+    })");
+
+    const auto cfg = ConfigLoader::loadTransportConfig(tmp.path);
+    REQUIRE(cfg.kind == "shm");
+    REQUIRE(cfg.shm.name == "/collector");
+    REQUIRE(cfg.shm.capacityBytes == 65536);
+    REQUIRE(cfg.shm.writeTimeout == std::chrono::milliseconds(250));
+
+    TempJsonFile bad("shm_bad_name.json", R"({ "kind": "shm", "shm": { "name": "collector/ring" } })");
+    REQUIRE_THROWS_AS(ConfigLoader::loadTransportConfig(bad.path), std::runtime_error);
+}
+
+TEST_CASE("TransportConfig reads unix socket options", "[ConfigLoader]") {
+    TempJsonFile tmp("unix_valid.json", R"({
+        "kind": "unix",
+        "unix": { "path": "@collector", "send_credentials": true, "peer_uid": 0, "write_timeout_ms": 250 }
+    })");
+
+    const auto cfg = ConfigLoader::loadTransportConfig(tmp.path);
+    REQUIRE(cfg.kind == "unix");
+    REQUIRE(cfg.unixSocket.path == "@collector");
+    REQUIRE_FALSE(cfg.unixSocket.datagram);
+    REQUIRE(cfg.unixSocket.sendCredentials);
+    REQUIRE(cfg.unixSocket.peerUid == std::optional<std::uint32_t>(0));
+    REQUIRE(cfg.unixSocket.writeTimeout == std::chrono::milliseconds(250));
+
+    TempJsonFile dgram("unix_dgram_peer.json", R"({
+        "kind": "unix",
+        "unix": { "path": "/run/collector.sock", "type": "dgram", "peer_uid": 0 }
+    })");
+    REQUIRE_THROWS_AS(ConfigLoader::loadTransportConfig(dgram.path), std::runtime_error);
+
+    TempJsonFile noPath("unix_no_path.json", R"({ "kind": "unix", "unix": { "type": "stream" } })");
+    REQUIRE_THROWS_AS(ConfigLoader::loadTransportConfig(noPath.path), std::runtime_error);
+}
+
+TEST_CASE("TransportConfig reads fan-out sinks", "[ConfigLoader]") {
+    TempJsonFile tmp("fanout_valid.json", R"({
+        "kind": "fanout",
+        "payload_format": "cbor",
+        "fanout": {
+            "queue": { "depth": 128, "policy": "drop_newest" },
+            "sinks": [
+                { "name": "primary", "kind": "tcp", "tcp": { "host": "10.0.0.1", "port": 9000 },
+                  "reconnect": { "enabled": true } },
+                { "kind": "unix", "unix": { "path": "@archiver" }, "queue": { "depth": 4096 } }
+            ]
+        }
+    })");
+
+    const auto cfg = ConfigLoader::loadTransportConfig(tmp.path);
+    REQUIRE(cfg.kind == "fanout");
+    REQUIRE(cfg.payloadFormat == PayloadFormat::CBOR);
+    REQUIRE(cfg.sinks.size() == 2);
+    REQUIRE(cfg.sinks[0].name == "primary");
+    REQUIRE(cfg.sinks[0].queue.depth == 128);
+    REQUIRE(cfg.sinks[0].queue.policy == QueuePolicy::DROP_NEWEST);
+    REQUIRE(cfg.sinks[0].transport.host == "10.0.0.1");
+    REQUIRE(cfg.sinks[0].transport.reconnect.enabled);
+    REQUIRE(cfg.sinks[1].name == "sink1");
+    REQUIRE(cfg.sinks[1].queue.depth == 4096);
+    REQUIRE(cfg.sinks[1].queue.policy == QueuePolicy::DROP_NEWEST);
+    REQUIRE(cfg.sinks[1].transport.unixSocket.path == "@archiver");
+
+    TempJsonFile blocking("fanout_block.json", R"({
+        "kind": "fanout",
+        "fanout": { "sinks": [ { "kind": "udp", "udp": { "host": "h", "port": 1 }, "queue": { "policy": "block" } } ] }
+    })");
+    REQUIRE_THROWS_AS(ConfigLoader::loadTransportConfig(blocking.path), std::runtime_error);
+
+    TempJsonFile format("fanout_format.json", R"({
+        "kind": "fanout",
+        "fanout": { "sinks": [ { "kind": "udp", "udp": { "host": "h", "port": 1 }, "payload_format": "json" } ] }
+    })");
+    REQUIRE_THROWS_AS(ConfigLoader::loadTransportConfig(format.path), std::runtime_error);
+
+    TempJsonFile empty("fanout_empty.json", R"({ "kind": "fanout", "fanout": { "sinks": [] } })");
+    REQUIRE_THROWS_AS(ConfigLoader::loadTransportConfig(empty.path), std::runtime_error);
+}
+
 TEST_CASE("TransportConfig udp host missing throws", "[ConfigLoader]") {
     TempJsonFile tmp("udp_no_host.json", R"({
         "kind": "udp",
@@ -210,3 +519,225 @@ TEST_CASE("ConfigLoader load non-existent file throws", "[ConfigLoader]") {
     REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig("no_such_file.json"), std::runtime_error);
     REQUIRE_THROWS_AS(ConfigLoader::loadTransportConfig("no_such_file.json"), std::runtime_error);
 }
+
+TEST_CASE("SensorConfig snapshots are disabled by default", "[ConfigLoader]") {
+    TempJsonFile tmp("sensor_snapshot_default.json", R"({ "sensor_id": "s" })");
+
+    auto cfg = ConfigLoader::loadSensorConfig(tmp.path);
+    REQUIRE_FALSE(cfg.snapshot.enabled);
+}
+
+TEST_CASE("SensorConfig parses snapshot settings", "[ConfigLoader]") {
+    TempJsonFile tmp("sensor_snapshot.json", R"({
+        "sensor_id": "s",
+        "snapshot": { "enabled": true, "path": "/tmp/cam.png", "every_frames": 30, "every_seconds": 2.5 }
+    })");
+
+    auto cfg = ConfigLoader::loadSensorConfig(tmp.path);
+    REQUIRE(cfg.snapshot.enabled);
+    REQUIRE(cfg.snapshot.path == "/tmp/cam.png");
+    REQUIRE(cfg.snapshot.format == "png");   // from the extension
+    REQUIRE(cfg.snapshot.everyFrames == 30);
+    REQUIRE(cfg.snapshot.every == std::chrono::milliseconds(2500));
+}
+
+TEST_CASE("SensorConfig rejects invalid snapshot settings", "[ConfigLoader]") {
+    const char* invalid[] = {
+        R"({ "sensor_id": "s", "snapshot": true })",
+        R"({ "sensor_id": "s", "snapshot": { "enabled": true } })",
+        R"({ "sensor_id": "s", "snapshot": { "format": "gif", "every_frames": 1 } })",
+        R"({ "sensor_id": "s", "snapshot": { "jpeg_quality": 101, "every_frames": 1 } })",
+        R"({ "sensor_id": "s", "snapshot": { "every_frames": -1 } })",
+        R"({ "sensor_id": "s", "snapshot": { "every_seconds": -2 } })",
+        R"({ "sensor_id": "s", "snapshot": { "path": "" } })",
+    };
+    for (const char* contents : invalid) {
+        TempJsonFile tmp("sensor_snapshot_invalid.json", contents);
+        INFO(contents);
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+    }
+}
+
+TEST_CASE("SensorConfig parses async logging settings", "[ConfigLoader]") {
+    TempJsonFile tmp("sensor_logging.json", R"({
+        "sensor_id": "s",
+        "logging": { "level": "Warning", "async": true, "queue": { "depth": 1024, "policy": "block" },
+                     "flush_interval_ms": 20, "timestamp": { "precision": "ms", "utc": true } }
+    })");
+
+    TempJsonFile defaults("sensor_logging_default.json", R"({ "sensor_id": "s" })");
+    REQUIRE(ConfigLoader::loadSensorConfig(defaults.path).logging.level == LogLevel::INFO);
+    auto cfg = ConfigLoader::loadSensorConfig(tmp.path);
+    REQUIRE(cfg.logging.level == LogLevel::WARNING);
+    REQUIRE(cfg.logging.timestampPrecision == TimestampPrecision::MILLISECONDS);
+    REQUIRE(cfg.logging.timestampUtc);
+    REQUIRE(cfg.logging.async);
+    REQUIRE(cfg.logging.queue.depth == 1024);
+    REQUIRE(cfg.logging.queue.policy == QueuePolicy::BLOCK);
+    REQUIRE(cfg.logging.flushInterval == std::chrono::milliseconds(20));
+
+    for (const char* contents : {
+        R"({ "sensor_id": "s", "logging": true })",
+        R"({ "sensor_id": "s", "logging": { "async": "yes" } })",
+        R"({ "sensor_id": "s", "logging": { "level": "trace" } })",
+        R"({ "sensor_id": "s", "logging": { "level": 1 } })",
+        R"({ "sensor_id": "s", "logging": { "timestamp": "ms" } })",
+        R"({ "sensor_id": "s", "logging": { "timestamp": { "precision": "ns" } } })",
+        R"({ "sensor_id": "s", "logging": { "timestamp": { "utc": 1 } } })",
+        R"({ "sensor_id": "s", "logging": { "flush_interval_ms": 0 } })",
+        R"({ "sensor_id": "s", "logging": { "queue": { "depth": 0 } } })",
+    }) {
+        TempJsonFile bad("sensor_logging_invalid.json", contents);
+        INFO(contents);
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(bad.path), std::runtime_error);
+    }
+}
+
+TEST_CASE("SensorConfig parses sampling steps and regions", "[ConfigLoader]") {
+    TempJsonFile tmp("sensor_sampling.json", R"({
+        "sensor_id": "s",
+        "sampling": {
+            "row_step": 2,
+            "col_step": 4,
+            "regions": [ { "name": "door", "x": 10, "y": 20, "width": 100, "height": 50 } ]
+        }
+    })");
+
+    auto cfg = ConfigLoader::loadSensorConfig(tmp.path);
+    REQUIRE(cfg.sampling.rowStep == 2);
+    REQUIRE(cfg.sampling.colStep == 4);
+    REQUIRE(cfg.sampling.regions.size() == 1);
+    REQUIRE(cfg.sampling.regions[0].name == "door");
+    REQUIRE(cfg.sampling.regions[0].height == 50);
+}
+
+TEST_CASE("SensorConfig rejects invalid sampling", "[ConfigLoader]") {
+    const char* invalid[] = {
+        R"({ "sensor_id": "s", "sampling": { "row_step": 0 } })",
+        R"({ "sensor_id": "s", "sampling": { "col_step": 65 } })",
+        R"({ "sensor_id": "s", "sampling": { "regions": {} } })",
+        R"({ "sensor_id": "s", "sampling": { "regions": [ { "x": 0, "y": 0, "width": 1, "height": 1 } ] } })",
+        R"({ "sensor_id": "s", "sampling": { "regions": [ { "name": "a", "x": -1, "y": 0, "width": 1, "height": 1 } ] } })",
+        R"({ "sensor_id": "s", "sampling": { "regions": [ { "name": "a", "x": 0, "y": 0, "width": 0, "height": 1 } ] } })",
+        R"({ "sensor_id": "s", "sampling": { "regions": [ { "name": "a", "x": 0, "y": 0, "width": 1, "height": 1 },
+                                                          { "name": "a", "x": 1, "y": 1, "width": 1, "height": 1 } ] } })",
+    };
+    for (const char* contents : invalid) {
+        TempJsonFile tmp("sensor_sampling_invalid.json", contents);
+        INFO(contents);
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+    }
+}
+
+// ---------------- DataSourceConfig tests ----------------
+
+TEST_CASE("DataSourceConfig loads ranged and fixed metric rules", "[ConfigLoader]") {
+    TempJsonFile tmp("datasource_valid.json", R"({
+        "limits": {
+            "temperature": { "min": 0, "max": 120, "bad_probability": 0.03 },
+            "firmware":    { "value": 3 }
+        }
+    })");
+
+    auto cfg = ConfigLoader::loadDataSourceConfig(tmp.path);
+    REQUIRE(cfg.metrics.size() == 2);
+
+    const auto& temperature = cfg.metrics.at("temperature");
+    REQUIRE(temperature.hasRange);
+    REQUIRE_FALSE(temperature.hasFixed);
+    REQUIRE(temperature.min == 0.0);
+    REQUIRE(temperature.max == 120.0);
+    REQUIRE(temperature.badProbability == 0.03);
+
+    const auto& firmware = cfg.metrics.at("firmware");
+    REQUIRE(firmware.hasFixed);
+    REQUIRE(firmware.fixed == 3.0);
+}
+
+TEST_CASE("DataSourceConfig rejects invalid rules", "[ConfigLoader]") {
+    const char* invalid[] = {
+        R"({ })",
+        R"({ "limits": {} })",
+        R"({ "limits": { "x": 5 } })",
+        R"({ "limits": { "x": { "min": 0 } } })",
+        R"({ "limits": { "x": { "min": 5, "max": 1 } } })",
+        R"({ "limits": { "x": { "min": 0, "max": 1, "bad_probability": 2 } } })",
+        R"({ "limits": { "x": { "min": "0", "max": 1 } } })",
+        R"({ "limits": { "x": { "value": 1, "min": 0, "max": 1 } } })",
+        R"({ "limits": { "x": { "value": 1, "bad_probability": 0.1 } } })",
+    };
+    for (const char* contents : invalid) {
+        TempJsonFile tmp("datasource_invalid.json", contents);
+        INFO(contents);
+        REQUIRE_THROWS_AS(ConfigLoader::loadDataSourceConfig(tmp.path), std::runtime_error);
+    }
+}
+
+TEST_CASE("Sensor and transport configs select the payload format", "[ConfigLoader]") {
+    {
+        TempJsonFile tmp("sensor_format.json", R"({ "sensor_id": "s", "payload_format": "CBOR" })");
+        REQUIRE(ConfigLoader::loadSensorConfig(tmp.path).payloadFormat == PayloadFormat::CBOR);
+    }
+    {
+        TempJsonFile tmp("sensor_format_default.json", R"({ "sensor_id": "s" })");
+        REQUIRE(ConfigLoader::loadSensorConfig(tmp.path).payloadFormat == PayloadFormat::JSON);
+    }
+    {
+        TempJsonFile tmp("transport_format.json", R"({
+            "kind": "udp", "udp": { "host": "127.0.0.1", "port": 9000 }, "payload_format": "binary"
+        })");
+        const auto cfg = ConfigLoader::loadTransportConfig(tmp.path);
+        REQUIRE(cfg.payloadFormat.has_value());
+        REQUIRE(*cfg.payloadFormat == PayloadFormat::BINARY);
+    }
+    {
+        TempJsonFile tmp("transport_format_default.json", R"({
+            "kind": "udp", "udp": { "host": "127.0.0.1", "port": 9000 }
+        })");
+        REQUIRE_FALSE(ConfigLoader::loadTransportConfig(tmp.path).payloadFormat.has_value());
+    }
+    {
+        TempJsonFile tmp("sensor_format_bad.json", R"({ "sensor_id": "s", "payload_format": "xml" })");
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+    }
+    {
+        TempJsonFile tmp("sensor_format_type.json", R"({ "sensor_id": "s", "payload_format": 3 })");
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+    }
+}
+
+TEST_CASE("SensorConfig parses the metric_ids block", "[ConfigLoader]") {
+    {
+        TempJsonFile tmp("sensor_metric_ids.json", R"({
+            "sensor_id": "s", "metric_ids": { "enabled": true, "dictionary_every": 50 }
+        })");
+        const auto cfg = ConfigLoader::loadSensorConfig(tmp.path);
+        REQUIRE(cfg.metricIds.enabled);
+        REQUIRE(cfg.metricIds.dictionaryEvery == 50);
+    }
+    {
+        TempJsonFile tmp("sensor_metric_ids_bad.json", R"({
+            "sensor_id": "s", "metric_ids": { "dictionary_every": -1 }
+        })");
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+    }
+}
+
+TEST_CASE("SensorConfig parses the batch block", "[ConfigLoader]") {
+    {
+        TempJsonFile tmp("sensor_batch.json", R"({
+            "sensor_id": "s", "batch": { "enabled": true, "max_samples": 10, "max_bytes": 1200, "linger_ms": 250 }
+        })");
+        const auto cfg = ConfigLoader::loadSensorConfig(tmp.path);
+        REQUIRE(cfg.batch.enabled);
+        REQUIRE(cfg.batch.maxSamples == 10);
+        REQUIRE(cfg.batch.maxBytes == 1200);
+        REQUIRE(cfg.batch.linger == std::chrono::milliseconds(250));
+    }
+    for (const char* batch : {R"({ "max_samples": 0 })", R"({ "max_bytes": -5 })", R"({ "linger_ms": 1.5 })",
+                              R"({ "enabled": "yes" })"}) {
+        TempJsonFile tmp("sensor_batch_bad.json", std::string(R"({ "sensor_id": "s", "batch": )") + batch + "}");
+        INFO(batch);
+        REQUIRE_THROWS_AS(ConfigLoader::loadSensorConfig(tmp.path), std::runtime_error);
+    }
+}
@@ -0,0 +1,251 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ConfigTypes.hpp"
+#include "DiskSpool.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+namespace fs = std::filesystem;
+
+namespace {
+
+    // RAII spool directory under the system temp directory.
+    struct TempSpoolDir {
+        fs::path path;
+        explicit TempSpoolDir(const std::string& name) : path(fs::temp_directory_path() / ("sensor_spool_" + name)) {
+            fs::remove_all(path);
+        }
+        ~TempSpoolDir() {
+            std::error_code ignored;
+            fs::remove_all(path, ignored);
+        }
+    };
+
+    SpoolConfig spoolIn(const TempSpoolDir& dir) {
+        SpoolConfig config;
+        config.enabled      = true;
+        config.directory    = dir.path.string();
+        config.segmentBytes = 1024;
+        config.maxBytes     = 64 * 1024;
+        config.syncInterval = 0ms;
+        return config;
+    }
+
+    std::size_t segmentFiles(const TempSpoolDir& dir) {
+        std::size_t count = 0;
+        for (const auto& entry : fs::directory_iterator(dir.path)) {
+            count += entry.path().extension() == ".seg" ? 1 : 0;
+        }
+        return count;
+    }
+
+    std::string popFront(DiskSpool& spool) {
+        std::string out;
+        REQUIRE(spool.front(out));
+        spool.pop();
+        return out;
+    }
+}
+
+TEST_CASE("DiskSpool replays appended payloads in order across segments", "[DiskSpool]") {
+    TempSpoolDir dir("order");
+    DiskSpool spool(spoolIn(dir));
+
+    for (int idx = 0; idx < 100; ++idx) {
+        spool.append("payload-" + std::to_string(idx));
+    }
+    REQUIRE(spool.records() == 100);
+    REQUIRE(segmentFiles(dir) > 1);
+
+    for (int idx = 0; idx < 100; ++idx) {
+        REQUIRE(popFront(spool) == "payload-" + std::to_string(idx));
+    }
+    std::string out;
+    REQUIRE_FALSE(spool.front(out));
+    REQUIRE(spool.empty());
+    REQUIRE(segmentFiles(dir) == 0);   // replayed segments are deleted
+    REQUIRE(spool.stats().replayed == 100);
+
+    spool.append("after drain");
+    REQUIRE(popFront(spool) == "after drain");
+}
+
+TEST_CASE("DiskSpool resumes from the cursor after a restart", "[DiskSpool]") {
+    TempSpoolDir dir("restart");
+    {
+        DiskSpool spool(spoolIn(dir));
+        for (int idx = 0; idx < 50; ++idx) {
+            spool.append("p" + std::to_string(idx));
+        }
+        for (int idx = 0; idx < 20; ++idx) {
+            popFront(spool);
+        }
+        spool.sync();
+    }
+
+    DiskSpool reopened(spoolIn(dir));
+    REQUIRE(reopened.records() == 30);
+    REQUIRE(reopened.stats().recovered == 30);
+    REQUIRE(popFront(reopened) == "p20");
+
+    reopened.append("new");
+    std::string last;
+    while (!reopened.empty()) {
+        last = popFront(reopened);
+    }
+    REQUIRE(last == "new");
+}
+
+TEST_CASE("DiskSpool cuts off a torn or corrupt tail on recovery", "[DiskSpool]") {
+    TempSpoolDir dir("torn");
+    auto config = spoolIn(dir);
+    config.segmentBytes = 64 * 1024;
+    {
+        DiskSpool spool(config);
+        spool.append("first");
+        spool.append("second");
+    }
+
+    fs::path file;
+    for (const auto& entry : fs::directory_iterator(dir.path)) {
+        if (entry.path().extension() == ".seg") {
+            file = entry.path();
+        }
+    }
+    REQUIRE_FALSE(file.empty());
+    const auto goodSize = fs::file_size(file);
+
+    SECTION("a half-written record") {
+        std::ofstream(file, std::ios::binary | std::ios::app) << std::string("\x20\x00\x00\x00garbage", 11);
+    }
+    SECTION("a record whose payload does not match its CRC") {
+        DiskSpool spool(config);
+        spool.append("third");
+        spool.sync();
+    }
+
+    const auto tornSize = fs::file_size(file);
+    if (tornSize > goodSize) {
+        // Flip the last payload byte of whatever follows the two good records.
+        std::fstream stream(file, std::ios::binary | std::ios::in | std::ios::out);
+        stream.seekp(static_cast<std::streamoff>(tornSize - 1));
+        stream.put('X');
+    }
+
+    DiskSpool recovered(config);
+    REQUIRE(recovered.records() == 2);
+    REQUIRE(recovered.stats().truncatedBytes == tornSize - goodSize);
+    REQUIRE(fs::file_size(file) == goodSize);
+    REQUIRE(popFront(recovered) == "first");
+    REQUIRE(popFront(recovered) == "second");
+
+    recovered.append("fresh");
+    REQUIRE(popFront(recovered) == "fresh");
+}
+
+TEST_CASE("DiskSpool drops the oldest segments above max bytes", "[DiskSpool]") {
+    TempSpoolDir dir("size");
+    auto config = spoolIn(dir);
+    config.segmentBytes = 1024;
+    config.maxBytes = 4096;
+    DiskSpool spool(config);
+
+    const std::string payload(100, 'x');   // 116 bytes a record, 8 a segment
+    for (int idx = 0; idx < 100; ++idx) {
+        spool.append(std::to_string(idx % 10) + payload);
+    }
+    REQUIRE(spool.bytes() <= config.maxBytes);
+    REQUIRE(spool.stats().droppedBySize > 0);
+    REQUIRE(spool.records() + spool.stats().droppedBySize == 100);
+
+    // What is left is the newest records, still in order.
+    std::string last;
+    while (!spool.empty()) {
+        last = popFront(spool);
+    }
+    REQUIRE(last == "9" + payload);
+}
+
+TEST_CASE("DiskSpool skips records older than max age", "[DiskSpool]") {
+    TempSpoolDir dir("age");
+    auto config = spoolIn(dir);
+    config.maxAge = 30ms;
+    DiskSpool spool(config);
+
+    for (int idx = 0; idx < 30; ++idx) {
+        spool.append("old" + std::to_string(idx));
+    }
+    std::this_thread::sleep_for(60ms);
+    spool.append("fresh");
+
+    REQUIRE(popFront(spool) == "fresh");
+    REQUIRE(spool.stats().droppedByAge == 30);
+    REQUIRE(spool.empty());
+}
+
+TEST_CASE("DiskSpool rejects inconsistent limits", "[DiskSpool]") {
+    TempSpoolDir dir("limits");
+    auto config = spoolIn(dir);
+    config.maxBytes = config.segmentBytes - 1;
+    REQUIRE_THROWS_AS(DiskSpool(config), std::invalid_argument);
+
+    config = spoolIn(dir);
+    config.directory.clear();
+    REQUIRE_THROWS_AS(DiskSpool(config), std::invalid_argument);
+
+    DiskSpool spool(spoolIn(dir));
+    REQUIRE_THROWS_AS(spool.pop(), std::logic_error);
+}
+
+// Run explicitly with: SensorTests "[DiskSpool][benchmark]"
+TEST_CASE("DiskSpool append, replay and recovery throughput", "[.][benchmark][DiskSpool]") {
+    constexpr std::size_t kRecords = 200000;
+    TempSpoolDir dir("benchmark");
+    auto config = spoolIn(dir);
+    config.segmentBytes = 4U * 1024U * 1024U;
+    config.maxBytes = 1024U * 1024U * 1024U;
+    config.syncInterval = 1000ms;
+
+    const std::string payload(200, 'p');   // a typical small sample
+    const auto seconds = [](auto since) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+    };
+
+    {
+        DiskSpool spool(config);
+        const auto begin = std::chrono::steady_clock::now();
+        for (std::size_t idx = 0; idx < kRecords; ++idx) {
+            spool.append(payload);
+        }
+        spool.sync();
+        const double elapsed = seconds(begin);
+        WARN("append: " << static_cast<double>(kRecords) / elapsed << " records/s, "
+             << static_cast<double>(spool.bytes()) / elapsed / 1e6 << " MB/s, "
+             << spool.stats().syncs << " syncs");
+    }
+
+    const auto recoverBegin = std::chrono::steady_clock::now();
+    DiskSpool spool(config);
+    const double recovery = seconds(recoverBegin);
+    WARN("recovery: " << recovery * 1e3 << " ms for " << spool.records() << " records ("
+         << static_cast<double>(spool.bytes()) / 1e6 << " MB)");
+    REQUIRE(spool.records() == kRecords);
+
+    const auto begin = std::chrono::steady_clock::now();
+    std::string out;
+    std::size_t replayed = 0;
+    while (spool.front(out)) {
+        spool.pop();
+        ++replayed;
+    }
+    const double elapsed = seconds(begin);
+    WARN("replay: " << static_cast<double>(replayed) / elapsed << " records/s");
+    REQUIRE(replayed == kRecords);
+}
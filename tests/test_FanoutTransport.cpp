@@ -0,0 +1,257 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ConfigTypes.hpp"
+#include "ConstantDataSource.hpp"
+#include "ConstBuffer.hpp"
+#include "FanoutTransport.hpp"
+#include "ITransport.hpp"
+#include "Sensor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+    // A collector the test can slow down, stop or take away. Called from the
+    // fan-out's sender thread, inspected from the test thread.
+    class FakeSink : public ITransport {
+    public:
+        std::atomic<bool> reachable{true};
+        std::atomic<bool> stalled{false};     // sends block while set
+        std::size_t       limit{0};
+
+        void connect() override {
+            if (!reachable) {
+                throw std::runtime_error("connect: Connection refused");
+            }
+            connected_ = true;
+        }
+        std::size_t sendString(const std::string& payload) override {
+            while (stalled) {
+                std::this_thread::sleep_for(1ms);
+            }
+            if (!reachable) {
+                throw std::runtime_error("send: Broken pipe");
+            }
+            const std::lock_guard<std::mutex> lock(mutex_);
+            delivered_.push_back(payload);
+            return payload.size();
+        }
+        void close() override { connected_ = false; }
+        bool isConnected() const override { return connected_; }
+        std::size_t maxMessageSize() const override { return limit; }
+
+        std::vector<std::string> delivered() const {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            return delivered_;
+        }
+
+    private:
+        std::atomic<bool>        connected_{false};
+        mutable std::mutex       mutex_;
+        std::vector<std::string> delivered_;
+    };
+
+    struct Harness {
+        explicit Harness(std::size_t count, PipelineQueueConfig queue = {8, QueuePolicy::DROP_OLDEST}) {
+            std::vector<FanoutTransport::Sink> sinks;
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                auto owned = std::make_unique<FakeSink>();
+                fakes.push_back(owned.get());
+                sinks.push_back({"sink" + std::to_string(idx), std::move(owned), queue});
+            }
+            transport = std::make_unique<FanoutTransport>(std::move(sinks));
+        }
+        std::vector<FakeSink*> fakes;
+        std::unique_ptr<FanoutTransport> transport;
+    };
+
+    // flushUntil() only reports; give the sender threads time to drain.
+    bool waitDrained(FanoutTransport& transport, std::chrono::milliseconds timeout = 5s) {
+        const auto deadline = FanoutTransport::Clock::now() + timeout;
+        while (!transport.flushUntil(FanoutTransport::Clock::now())) {
+            if (FanoutTransport::Clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+
+    std::vector<std::string> numbered(int count) {
+        std::vector<std::string> out;
+        for (int idx = 0; idx < count; ++idx) {
+            out.push_back("p" + std::to_string(idx));
+        }
+        return out;
+    }
+}
+
+TEST_CASE("FanoutTransport delivers every payload to every sink in order", "[FanoutTransport]") {
+    Harness harness(3, {64, QueuePolicy::DROP_OLDEST});
+    auto& transport = *harness.transport;
+    REQUIRE_THROWS_AS(transport.sendString("early"), std::runtime_error);
+
+    transport.connect();
+    for (const auto& payload : numbered(20)) {
+        REQUIRE(transport.sendString(payload) == payload.size());
+    }
+    const ConstBuffer pieces[] = {ConstBuffer(std::string_view("p")), ConstBuffer(std::string_view("20"))};
+    REQUIRE(transport.sendBuffers(pieces, 2) == 3);
+
+    REQUIRE(waitDrained(transport));
+    REQUIRE(transport.isConnected());
+    for (const auto* fake : harness.fakes) {
+        REQUIRE(fake->delivered() == numbered(21));
+    }
+    for (const auto& stats : transport.stats()) {
+        REQUIRE(stats.connected);
+        REQUIRE(stats.sent == 21);
+        REQUIRE(stats.dropped == 0);
+        REQUIRE(stats.failed == 0);
+        REQUIRE(stats.queued == 0);
+    }
+    transport.close();
+    REQUIRE_FALSE(transport.isConnected());
+}
+
+TEST_CASE("FanoutTransport close() delivers what is still queued", "[FanoutTransport]") {
+    Harness harness(2, {64, QueuePolicy::DROP_OLDEST});
+    auto& transport = *harness.transport;
+    harness.fakes[1]->reachable = false;
+    transport.connect();
+
+    for (const auto& payload : numbered(20)) {
+        transport.sendString(payload);
+    }
+    transport.close();   // no flushUntil() in between, as at shutdown
+
+    REQUIRE(harness.fakes[0]->delivered() == numbered(20));
+    const auto stats = transport.stats();
+    REQUIRE(stats[0].sent == 20);
+    REQUIRE(stats[0].dropped == 0);
+    REQUIRE(stats[1].failed + stats[1].dropped == 20);   // a dead sink does not hold close() up
+}
+
+TEST_CASE("FanoutTransport keeps feeding the others while one sink stalls", "[FanoutTransport]") {
+    Harness harness(2, {4, QueuePolicy::DROP_OLDEST});
+    auto& transport = *harness.transport;
+    transport.connect();
+
+    harness.fakes[1]->stalled = true;
+    for (const auto& payload : numbered(50)) {
+        transport.sendString(payload);
+        std::this_thread::sleep_for(100us);
+    }
+    // The healthy sink is done even though the stalled one holds a payload,
+    // and a flush reports that at once instead of waiting for the stalled one.
+    std::this_thread::sleep_for(200ms);
+    const auto begin = FanoutTransport::Clock::now();
+    REQUIRE_FALSE(transport.flushUntil(begin + 1s));
+    REQUIRE(FanoutTransport::Clock::now() - begin < 100ms);
+    REQUIRE(harness.fakes[0]->delivered() == numbered(50));
+
+    harness.fakes[1]->stalled = false;
+    REQUIRE(waitDrained(transport));
+
+    const auto stats = transport.stats();
+    REQUIRE(stats[0].dropped == 0);
+    REQUIRE(stats[1].dropped > 0);
+    REQUIRE(stats[1].sent + stats[1].dropped == 50);
+    REQUIRE(stats[1].maxLag >= 100ms);
+    // Drop-oldest: whatever survived is the newest, in order.
+    const auto slow = harness.fakes[1]->delivered();
+    REQUIRE(slow.back() == "p49");
+}
+
+TEST_CASE("FanoutTransport drop-newest keeps the oldest payloads of a stalled sink", "[FanoutTransport]") {
+    Harness harness(1, {2, QueuePolicy::DROP_NEWEST});
+    auto& transport = *harness.transport;
+    transport.connect();
+    REQUIRE(waitDrained(transport));
+
+    harness.fakes[0]->stalled = true;
+    transport.sendString("p0");
+    std::this_thread::sleep_for(20ms);   // p0 is in hand, the queue is empty
+    for (const auto& payload : {"p1", "p2", "p3", "p4"}) {
+        transport.sendString(payload);
+    }
+    harness.fakes[0]->stalled = false;
+    REQUIRE(waitDrained(transport));
+
+    REQUIRE(harness.fakes[0]->delivered() == std::vector<std::string>{"p0", "p1", "p2"});
+    REQUIRE(transport.stats()[0].dropped == 2);
+}
+
+TEST_CASE("FanoutTransport counts a failing sink without stopping the others", "[FanoutTransport]") {
+    Harness harness(2, {64, QueuePolicy::DROP_OLDEST});
+    auto& transport = *harness.transport;
+    harness.fakes[1]->reachable = false;
+    transport.connect();
+
+    for (const auto& payload : numbered(10)) {
+        transport.sendString(payload);
+    }
+    REQUIRE(waitDrained(transport));
+    REQUIRE(transport.isConnected());
+    REQUIRE(harness.fakes[0]->delivered() == numbered(10));
+
+    const auto stats = transport.stats();
+    REQUIRE(stats[1].name == "sink1");
+    REQUIRE_FALSE(stats[1].connected);
+    REQUIRE(stats[1].sent == 0);
+    REQUIRE(stats[1].failed == 10);
+}
+
+TEST_CASE("Sensor resends the metric dictionary after a fan-out sink dropped it", "[FanoutTransport]") {
+    Harness harness(1, {2, QueuePolicy::DROP_OLDEST});
+    FanoutTransport* fanout = harness.transport.get();
+    SensorConfig config;
+    config.sensorId = "fanout-01";
+    config.metricIds.enabled = true;
+    Sensor sensor(config, std::make_unique<ConstantDataSource>(), std::move(harness.transport));
+    sensor.connect();
+
+    harness.fakes[0]->stalled = true;
+    fanout->sendString("warm");
+    std::this_thread::sleep_for(20ms);   // "warm" is in hand, the queue is empty
+    sensor.runOnce();                    // carries the dictionary
+    sensor.runOnce();
+    sensor.runOnce();                    // evicts the first sample
+    REQUIRE(fanout->stats()[0].dropped == 1);
+    sensor.runOnce();                    // encoded after the drop; evicts the second
+    harness.fakes[0]->stalled = false;
+    REQUIRE(waitDrained(*fanout));
+
+    const auto delivered = harness.fakes[0]->delivered();
+    REQUIRE(delivered.size() == 3);      // "warm" and the two newest samples
+    REQUIRE(delivered[1].find("\"dictionary\"") == std::string::npos);
+    REQUIRE(delivered[2].find("\"dictionary\"") != std::string::npos);
+}
+
+TEST_CASE("FanoutTransport reports the tightest message limit and rejects bad sinks", "[FanoutTransport]") {
+    Harness harness(3);
+    harness.fakes[0]->limit = 0;
+    harness.fakes[1]->limit = 65507;
+    harness.fakes[2]->limit = 8192;
+    REQUIRE(harness.transport->maxMessageSize() == 8192);
+    REQUIRE(harness.transport->sinkCount() == 3);
+
+    REQUIRE_THROWS_AS(FanoutTransport(std::vector<FanoutTransport::Sink>{}), std::invalid_argument);
+
+    std::vector<FanoutTransport::Sink> blocking;
+    blocking.push_back({"archive", std::make_unique<FakeSink>(), {8, QueuePolicy::BLOCK}});
+    REQUIRE_THROWS_AS(FanoutTransport(std::move(blocking)), std::invalid_argument);
+}
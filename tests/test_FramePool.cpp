@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+#include <opencv2/core.hpp>
+
+#include "AllocationCounter.hpp"
+#include "FramePool.hpp"
+#include "HardwareDataSource.hpp"
+#include "MockCamera.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+TEST_CASE("FramePool preallocates and recycles its buffers", "[FramePool]") {
+    FramePool pool(2, 48, 64, CV_8UC3);
+    REQUIRE(pool.capacity() == 2);
+    REQUIRE(pool.available() == 2);
+
+    const unsigned char* first = nullptr;
+    {
+        FramePool::Lease lease = pool.acquire();
+        REQUIRE(lease.pooled());
+        REQUIRE(lease.frame().rows == 48);
+        REQUIRE(lease.frame().cols == 64);
+        first = lease.frame().data;
+        REQUIRE(pool.available() == 1);
+    }
+    REQUIRE(pool.available() == 2);
+
+    FramePool::Lease again = pool.acquire();
+    REQUIRE(again.frame().data == first);
+}
+
+TEST_CASE("FramePool overflows to a one-off buffer when exhausted", "[FramePool]") {
+    FramePool pool(1, 4, 4, CV_8UC1);
+
+    FramePool::Lease held = pool.acquire();
+    FramePool::Lease extra = pool.acquire();
+    REQUIRE_FALSE(extra.pooled());
+    REQUIRE(extra.frame().rows == 4);
+    REQUIRE(pool.overflows() == 1);
+
+    // Moving a lease keeps its buffer valid and returns it exactly once.
+    FramePool::Lease moved = std::move(held);
+    REQUIRE(moved.pooled());
+    REQUIRE(pool.available() == 0);
+}
+
+TEST_CASE("FramePool counts buffers replaced while leased", "[FramePool]") {
+    FramePool pool(1, 4, 4, CV_8UC1);
+    {
+        FramePool::Lease lease = pool.acquire();
+        lease.frame().create(8, 8, CV_8UC1);   // e.g. the camera changed resolution
+    }
+    REQUIRE(pool.reallocations() == 1);
+    REQUIRE_THROWS_AS(FramePool(0, 4, 4, CV_8UC1), std::invalid_argument);
+}
+
+TEST_CASE("HardwareDataSource steady-state capture does not allocate", "[FramePool]") {
+    std::shared_ptr<ICamera> camera = std::make_shared<MockCamera>();
+    camera->open(0);
+    HardwareDataSource ds(camera);
+
+    // Warm up: the readings map gets its keys.
+    Readings values;
+    ds.readInto(values);
+    ds.readInto(values);
+
+    {
+        // The counter itself is live.
+        const AllocationCounter::ScopedAllocationCount counter;
+        const auto probe = std::make_unique<int>(1);
+        REQUIRE(counter.count() == 1);
+    }
+
+    std::uint64_t allocations = 0;
+    {
+        const AllocationCounter::ScopedAllocationCount counter;
+        for (int tick = 0; tick < 5; ++tick) {
+            ds.readInto(values);
+        }
+        allocations = counter.count();
+    }
+
+    REQUIRE(values.at("frame_status") == 1.0);
+    REQUIRE(allocations == 0);
+    REQUIRE(ds.framePool().overflows() == 0);
+    REQUIRE(ds.framePool().reallocations() == 0);
+}
@@ -0,0 +1,195 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <opencv2/core.hpp>
+
+#include "FrameStats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace {
+
+    cv::Mat randomFrame(int rows, int cols, int type, std::uint32_t seed) {
+        cv::Mat frame(rows, cols, type);
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> byte(0, 255);
+        for (int row = 0; row < frame.rows; ++row) {
+            auto* data = frame.ptr<std::uint8_t>(row);
+            for (int idx = 0; idx < frame.cols * frame.channels(); ++idx) {
+                data[idx] = static_cast<std::uint8_t>(byte(rng));
+            }
+        }
+        return frame;
+    }
+
+    // Straightforward two-pass reference.
+    FrameStats referenceStats(const cv::Mat& frame) {
+        const int channels = frame.channels();
+        const double count = static_cast<double>(frame.rows) * frame.cols;
+        FrameStats stats;
+        stats.channels = channels;
+
+        for (int chan = 0; chan < channels; ++chan) {
+            auto& out = stats.channel[static_cast<std::size_t>(chan)];
+            double sum = 0.0;
+            out.min = 255.0;
+            out.max = 0.0;
+            for (int row = 0; row < frame.rows; ++row) {
+                const auto* data = frame.ptr<std::uint8_t>(row);
+                for (int col = 0; col < frame.cols; ++col) {
+                    const double value = data[col * channels + chan];
+                    sum += value;
+                    out.min = std::min(out.min, value);
+                    out.max = std::max(out.max, value);
+                }
+            }
+            out.mean = sum / count;
+            double squares = 0.0;
+            for (int row = 0; row < frame.rows; ++row) {
+                const auto* data = frame.ptr<std::uint8_t>(row);
+                for (int col = 0; col < frame.cols; ++col) {
+                    const double diff = data[col * channels + chan] - out.mean;
+                    squares += diff * diff;
+                }
+            }
+            out.variance = squares / count;
+        }
+        return stats;
+    }
+
+    void requireMatches(const FrameStats& actual, const FrameStats& expected) {
+        REQUIRE(actual.channels == expected.channels);
+        for (std::size_t chan = 0; chan < static_cast<std::size_t>(expected.channels); ++chan) {
+            REQUIRE_THAT(actual.channel[chan].mean, WithinAbs(expected.channel[chan].mean, 1e-9));
+            REQUIRE_THAT(actual.channel[chan].variance, WithinRel(expected.channel[chan].variance, 1e-9));
+            REQUIRE(actual.channel[chan].min == expected.channel[chan].min);
+            REQUIRE(actual.channel[chan].max == expected.channel[chan].max);
+        }
+    }
+
+    constexpr std::array<SimdLevel, 3> kLevels{SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2};
+}
+
+TEST_CASE("FrameStats luma follows BT.601 and BT.709 on BGR frames", "[FrameStats]") {
+    const cv::Mat frame(48, 64, CV_8UC3, cv::Scalar(20, 10, 5));
+
+    for (const SimdLevel level : kLevels) {
+        const FrameStats stats = computeFrameStats(frame, level);
+        REQUIRE_THAT(stats.luma601, WithinAbs(0.299 * 5 + 0.587 * 10 + 0.114 * 20, 1e-12));
+        REQUIRE_THAT(stats.luma709, WithinAbs(0.2126 * 5 + 0.7152 * 10 + 0.0722 * 20, 1e-12));
+        REQUIRE(stats.channel[0].variance == 0.0);
+    }
+}
+
+TEST_CASE("FrameStats kernels agree with a reference for 1, 3 and 4 channels", "[FrameStats]") {
+    // 643 columns: rows are not a multiple of the 48-byte block, so every
+    // kernel also runs its scalar tail; 480 rows crosses several flushes.
+    const int type = GENERATE(CV_8UC1, CV_8UC3, CV_8UC4);
+    const cv::Mat frame = randomFrame(480, 643, type, 11);
+    const FrameStats expected = referenceStats(frame);
+
+    for (const SimdLevel level : kLevels) {
+        INFO("level " << static_cast<int>(level));
+        requireMatches(computeFrameStats(frame, level), expected);
+    }
+}
+
+TEST_CASE("FrameStats handles non-continuous frames", "[FrameStats]") {
+    const cv::Mat full = randomFrame(120, 200, CV_8UC3, 5);
+    const cv::Mat roi = full(cv::Rect(3, 7, 150, 100));
+    REQUIRE_FALSE(roi.isContinuous());
+
+    const FrameStats expected = referenceStats(roi);
+    for (const SimdLevel level : kLevels) {
+        requireMatches(computeFrameStats(roi, level), expected);
+    }
+}
+
+TEST_CASE("FrameStats saturated frames do not overflow the narrow sums", "[FrameStats]") {
+    const cv::Mat frame(1080, 1920, CV_8UC3, cv::Scalar(255, 255, 255));
+
+    for (const SimdLevel level : kLevels) {
+        const FrameStats stats = computeFrameStats(frame, level);
+        REQUIRE(stats.channel[2].mean == 255.0);
+        REQUIRE(stats.channel[2].variance == 0.0);
+    }
+}
+
+TEST_CASE("FrameStats decimation matches stats of the sampled pixels", "[FrameStats]") {
+    const cv::Mat frame = randomFrame(97, 331, CV_8UC3, 21);
+    const FrameSampling sampling{3, 4};
+
+    // Build the decimated frame by hand and take its full statistics.
+    cv::Mat sampled((frame.rows + 2) / 3, (frame.cols + 3) / 4, CV_8UC3);
+    for (int row = 0; row < sampled.rows; ++row) {
+        for (int col = 0; col < sampled.cols; ++col) {
+            for (int chan = 0; chan < 3; ++chan) {
+                sampled.ptr<std::uint8_t>(row)[col * 3 + chan] = frame.ptr<std::uint8_t>(row * 3)[col * 12 + chan];
+            }
+        }
+    }
+    const FrameStats expected = referenceStats(sampled);
+
+    for (const SimdLevel level : kLevels) {
+        requireMatches(computeFrameStats(frame, sampling, level), expected);
+    }
+}
+
+TEST_CASE("FrameStats decimated mean stays within the documented bound", "[FrameStats]") {
+    // Smooth gradient: value = col / 4 + row / 8, so adjacent pixels differ
+    // by at most Lx = 1 horizontally and Ly = 1 vertically.
+    cv::Mat frame(301, 643, CV_8UC1);
+    for (int row = 0; row < frame.rows; ++row) {
+        for (int col = 0; col < frame.cols; ++col) {
+            frame.ptr<std::uint8_t>(row)[col] = static_cast<std::uint8_t>(col / 4 + row / 8);
+        }
+    }
+    const double fullMean = computeFrameStats(frame).channel[0].mean;
+
+    for (const int step : {2, 4, 8}) {
+        const FrameStats decimated = computeFrameStats(frame, FrameSampling{step, step});
+        const double bound = 1.0 * (step - 1) / 2.0 + 1.0 * (step - 1) / 2.0 +
+                             255.0 * ((step - 1) / 643.0 + (step - 1) / 301.0);
+        INFO("step " << step);
+        REQUIRE(std::abs(decimated.channel[0].mean - fullMean) <= bound);
+        REQUIRE(decimated.channel[0].min >= 0.0);
+    }
+}
+
+TEST_CASE("FrameStats rejects invalid sampling steps", "[FrameStats]") {
+    const cv::Mat frame(4, 4, CV_8UC1, cv::Scalar(1));
+    REQUIRE_THROWS_AS(computeFrameStats(frame, FrameSampling{0, 1}), std::invalid_argument);
+}
+
+TEST_CASE("FrameStats rejects unsupported frames", "[FrameStats]") {
+    REQUIRE_THROWS_AS(computeFrameStats(cv::Mat()), std::invalid_argument);
+    REQUIRE_THROWS_AS(computeFrameStats(cv::Mat(4, 4, CV_16UC1)), std::invalid_argument);
+}
+
+// Run explicitly with: SensorTests "[benchmark]"
+TEST_CASE("FrameStats kernel throughput per SIMD level", "[.][benchmark]") {
+    const cv::Mat frame = randomFrame(480, 640, CV_8UC3, 1);
+    constexpr int kFrames = 200;
+
+    for (const SimdLevel level : kLevels) {
+        double checksum = 0.0;
+        const auto begin = std::chrono::steady_clock::now();
+        for (int idx = 0; idx < kFrames; ++idx) {
+            checksum += computeFrameStats(frame, level).luma601;
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        WARN("level " << static_cast<int>(level) << ": " << seconds * 1e6 / kFrames << " us/frame");
+        REQUIRE(checksum > 0.0);
+    }
+}
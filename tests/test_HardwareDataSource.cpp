@@ -17,7 +17,10 @@ TEST_CASE("HardwareDataSource happy path using MockCamera", "[HardwareDataSource
     REQUIRE_THAT(values["frame_width"], Catch::Matchers::WithinAbs(640.0, 0));
     REQUIRE_THAT(values["frame_height"], Catch::Matchers::WithinAbs(480.0, 0));
     REQUIRE_THAT(values["channels"], Catch::Matchers::WithinAbs(3.0, 0));
-    REQUIRE_THAT(values["brightness"], Catch::Matchers::WithinAbs(20.0, 0));
+    REQUIRE_THAT(values["brightness"], Catch::Matchers::WithinAbs(9.645, 1e-9));   // BT.601 luma of BGR (20, 10, 5)
+    REQUIRE_THAT(values["blue_mean"], Catch::Matchers::WithinAbs(20.0, 0));
+    REQUIRE_THAT(values["red_max"], Catch::Matchers::WithinAbs(5.0, 0));
+    REQUIRE_THAT(values["green_variance"], Catch::Matchers::WithinAbs(0.0, 0));
 }
 
 TEST_CASE("HardwareDataSource handles camera not opened", "[HardwareDataSource]") {
@@ -26,4 +29,38 @@ TEST_CASE("HardwareDataSource handles camera not opened", "[HardwareDataSource]"
 
     auto values = ds.readAll();
     REQUIRE_THAT(values["frame_status"], Catch::Matchers::WithinAbs(0.0, 0));
-}
\ No newline at end of file
+}
+
+TEST_CASE("HardwareDataSource reports regions of interest", "[HardwareDataSource]") {
+    std::shared_ptr<ICamera> camera = std::make_shared<MockCamera>();
+    camera->open(0);
+
+    FrameSamplingConfig sampling;
+    sampling.rowStep = 2;
+    sampling.colStep = 2;
+    sampling.regions = {
+        {"door", 10, 20, 100, 50},
+        {"edge", 600, 400, 100, 100},    // partly outside: clipped
+        {"away", 1000, 1000, 10, 10},    // fully outside: not reported
+    };
+    HardwareDataSource ds(camera, SnapshotConfig{}, sampling);
+
+    auto values = ds.readAll();
+    REQUIRE_THAT(values["brightness"], Catch::Matchers::WithinAbs(9.645, 1e-9));
+    REQUIRE_THAT(values["door_brightness"], Catch::Matchers::WithinAbs(9.645, 1e-9));
+    REQUIRE_THAT(values["door_red_mean"], Catch::Matchers::WithinAbs(5.0, 0));
+    REQUIRE(values.count("edge_luma_709") == 1);
+    REQUIRE(values.count("away_brightness") == 0);
+}
+
+TEST_CASE("HardwareDataSource rejects invalid sampling", "[HardwareDataSource]") {
+    std::shared_ptr<ICamera> camera = std::make_shared<MockCamera>();
+
+    FrameSamplingConfig badStep;
+    badStep.rowStep = 0;
+    REQUIRE_THROWS_AS(HardwareDataSource(camera, SnapshotConfig{}, badStep), std::invalid_argument);
+
+    FrameSamplingConfig badRegion;
+    badRegion.regions = {{"empty", 0, 0, 0, 10}};
+    REQUIRE_THROWS_AS(HardwareDataSource(camera, SnapshotConfig{}, badRegion), std::invalid_argument);
+}
@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstddef>
+#include <string>
+
+#include "IDataSource.hpp"
+
+namespace {
+    // Counts up on every read; emits "odd" only on odd reads.
+    class CountingDataSource : public IDataSource {
+    public:
+        Readings readAll() override {
+            ++reads_;
+            Readings values{{"count", static_cast<double>(reads_)}};
+            if (reads_ % 2 == 1) {
+                values["odd"] = 1.0;
+            }
+            return values;
+        }
+
+    private:
+        int reads_{0};
+    };
+}
+
+TEST_CASE("IDataSource readInto defaults to readAll", "[IDataSource]") {
+    CountingDataSource source;
+    Readings values{{"stale", 42.0}};
+
+    source.readInto(values);
+    REQUIRE(values.size() == 2);
+    REQUIRE(values.at("count") == 1.0);
+    REQUIRE(values.count("stale") == 0);
+}
+
+TEST_CASE("IDataSource readBatch lays samples out column-major", "[IDataSource]") {
+    CountingDataSource source;
+    SampleBatch batch;
+
+    REQUIRE(source.readBatch(batch, 4) == 4);
+    REQUIRE(batch.rows == 4);
+    REQUIRE(batch.names.size() == 2);
+
+    const auto& count = batch.columns[batch.columnFor("count")];
+    const auto& odd   = batch.columns[batch.columnFor("odd")];
+    REQUIRE(count.size() == 4);
+    REQUIRE(odd.size() == 4);
+    for (std::size_t row = 0; row < 4; ++row) {
+        REQUIRE(count[row] == static_cast<double>(row + 1));
+        REQUIRE((row % 2 == 0 ? odd[row] == 1.0 : std::isnan(odd[row])));
+    }
+
+    // A second batch replaces the rows but keeps the columns.
+    REQUIRE(source.readBatch(batch, 2) == 2);
+    REQUIRE(batch.names.size() == 2);
+    REQUIRE(batch.columns[batch.columnFor("count")][0] == 5.0);
+}
+
+TEST_CASE("assignReadings keeps exactly the given keys", "[IDataSource]") {
+    Readings values{{"a", 1.0}, {"b", 2.0}, {"c", 3.0}};
+
+    assignReadings(values, {{"a", 10.0}, {"b", 20.0}});
+    REQUIRE(values.size() == 2);
+    REQUIRE(values.at("a") == 10.0);
+    REQUIRE(values.at("b") == 20.0);
+
+    assignReadings(values, {{"a", 11.0}, {"b", 21.0}});
+    REQUIRE(values.size() == 2);
+    REQUIRE(values.at("a") == 11.0);
+}
@@ -0,0 +1,245 @@
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+
+#include "AllocationCounter.hpp"
+#include "ConstBuffer.hpp"
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "JsonPayloadWriter.hpp"
+#include "ReadingLayout.hpp"
+#include "SensorPipeline.hpp"
+#include "TickScheduler.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+    // The DOM-based encoder JsonPayloadWriter replaced, kept as the reference.
+    std::string referencePayload(const SensorConfig& config, const Readings& readings, std::int64_t timestampMs) {
+        json payload;
+        payload["sensor_id"] = config.sensorId;
+        if (!config.metadata.empty()) {
+            payload["metadata"] = config.metadata;
+        }
+        payload["timestamp_ms"] = timestampMs;
+
+        json readingsJson = json::object();
+        for (const auto& [name, value] : readings) {
+            json reading;
+            reading["value"] = std::round(value * std::pow(10.0, 2)) / std::pow(10.0, 2);
+            reading["unit"]  = ReadingLayout::inferUnit(config.units, name);
+            readingsJson[name] = reading;
+        }
+        if (!readingsJson.empty()) {
+            payload["readings"] = readingsJson;
+        }
+
+        std::string out = payload.dump();
+        out.push_back('\n');
+        return out;
+    }
+
+    SensorConfig cameraConfig() {
+        SensorConfig config;
+        config.sensorId = "cam-01";
+        config.metadata = {{"location", "dock 4"}, {"model", "X\"1\"\n"}, {"az", "\x01\x1f\x7f"}};
+        config.units    = {{"frame_width", "px"}};
+        return config;
+    }
+
+    Readings cameraReadings() {
+        return {{"frame_width", 640.0}, {"frame_height", 480.0}, {"brightness", 9.645},
+                {"luma_709", 127.123456}, {"red_variance", 1234.5678}, {"frame_status", 1.0},
+                {"temperature", -3.14159}};
+    }
+
+    std::string doubleText(double value) {
+        std::string out;
+        JsonPayloadWriter::appendDouble(out, value);
+        return out;
+    }
+}
+
+TEST_CASE("JsonPayloadWriter matches the DOM encoder byte for byte", "[JsonPayloadWriter]") {
+    const SensorConfig config = cameraConfig();
+    JsonPayloadWriter writer(config);
+    std::string out;
+
+    writer.encode(cameraReadings(), 1700000000123, out);
+    REQUIRE(out == referencePayload(config, cameraReadings(), 1700000000123));
+
+    // A different key set invalidates the cached order and units.
+    const Readings other{{"zeta", 1.0}, {"alpha_size", 2.5}};
+    writer.encode(other, -5, out);
+    REQUIRE(out == referencePayload(config, other, -5));
+
+    writer.encode(Readings{}, 0, out);
+    REQUIRE(out == referencePayload(config, Readings{}, 0));
+
+    SensorConfig bare;
+    bare.sensorId = "bare";
+    JsonPayloadWriter bareWriter(bare);
+    bareWriter.encode(other, 42, out);
+    REQUIRE(out == referencePayload(bare, other, 42));
+}
+
+TEST_CASE("JsonPayloadWriter encodeBuffers pieces join to the encode() payload", "[JsonPayloadWriter]") {
+    JsonPayloadWriter writer(cameraConfig());
+    std::string out;
+    std::string scratch;
+    std::vector<ConstBuffer> pieces;
+
+    for (const Readings& readings : {cameraReadings(), Readings{}, Readings{{"zeta", 1.0}}}) {
+        writer.encode(readings, 1700000000123, out);
+        writer.encodeBuffers(readings, 1700000000123, scratch, pieces);
+
+        std::string joined;
+        for (const ConstBuffer& piece : pieces) {
+            joined.append(static_cast<const char*>(piece.data), piece.size);
+        }
+        REQUIRE(joined == out);
+        REQUIRE(totalSize(pieces.data(), pieces.size()) == out.size());
+        // The metadata head is sent in place, not copied into scratch.
+        REQUIRE(scratch.find("location") == std::string::npos);
+    }
+}
+
+TEST_CASE("JsonPayloadWriter formats doubles like nlohmann", "[JsonPayloadWriter]") {
+    const double fixed[] = {0.0, -0.0, 1.0, 0.5, 0.01, 0.0001, 0.00001, 1e15, 1e16, 123456789012345.0,
+                            1234567890123456.0, -9.65, 1e-300, 2.5e300, 1.7976931348623157e308,
+                            std::numeric_limits<double>::denorm_min(),
+                            std::numeric_limits<double>::quiet_NaN(),
+                            std::numeric_limits<double>::infinity()};
+    for (const double value : fixed) {
+        INFO(value);
+        REQUIRE(doubleText(value) == json(value).dump());
+    }
+
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> reading(-1e6, 1e6);
+    for (int idx = 0; idx < 20000; ++idx) {
+        // Rounded readings (what payloads carry) and arbitrary bit patterns.
+        const double rounded = std::round(reading(rng) * 100.0) / 100.0;
+        const std::uint64_t bits = rng();
+        double raw = 0.0;
+        std::memcpy(&raw, &bits, sizeof(raw));
+
+        INFO(rounded << " / " << raw);
+        REQUIRE(doubleText(rounded) == json(rounded).dump());
+        // Grisu2 (nlohmann) occasionally emits one digit more than needed
+        // for full-precision values; both forms parse back to the same double.
+        const std::string text = doubleText(raw);
+        const std::string expected = json(raw).dump();
+        if (text != expected) {
+            REQUIRE(text.size() <= expected.size());
+            REQUIRE(json::parse(text).get<double>() == json::parse(expected).get<double>());
+        }
+    }
+}
+
+TEST_CASE("JsonPayloadWriter steady-state encoding does not allocate", "[JsonPayloadWriter]") {
+    JsonPayloadWriter writer(cameraConfig());
+    const Readings readings = cameraReadings();
+    std::string out;
+    writer.encode(readings, 1, out);   // sizes the cache and the buffer
+
+    const AllocationCounter::ScopedAllocationCount allocations;
+    for (std::int64_t tick = 2; tick < 100; ++tick) {
+        writer.encode(readings, tick, out);
+    }
+    REQUIRE(allocations.count() == 0);
+}
+
+TEST_CASE("JsonPayloadWriter pipelined encoding does not allocate once the ring is warm", "[JsonPayloadWriter]") {
+    JsonPayloadWriter writer(cameraConfig());
+    const Readings readings = cameraReadings();
+
+    // Every ring slot and both stage buffers hold a sized string after this many.
+    constexpr std::uint64_t kWarmUp = 16;
+    std::uint64_t encoded = 0;
+    std::uint64_t steadyAllocations = 0;
+
+    PipelineConfig config;
+    config.enabled = true;
+    config.captureQueue = {4, QueuePolicy::BLOCK};
+    config.sendQueue    = {4, QueuePolicy::BLOCK};
+    SensorPipeline pipeline(
+        config,
+        [&](Sample& sample) { sample.timestampMs = 1700000000000; },
+        [&](const Sample& sample, std::string& payload) {
+            const AllocationCounter::ScopedAllocationCount allocations;   // encode thread only
+            writer.encode(readings, sample.timestampMs, payload);
+            if (++encoded > kWarmUp) {
+                steadyAllocations += allocations.count();
+            }
+        },
+        [](const std::string&) {});
+
+    TickScheduler scheduler(std::chrono::milliseconds(1), OverrunPolicy::SKIP);
+    std::atomic<bool> running{true};
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        running = false;
+    });
+    pipeline.run(running, scheduler);
+    stopper.join();
+
+    REQUIRE(encoded > kWarmUp);
+    REQUIRE(steadyAllocations == 0);
+}
+
+// Run explicitly with: SensorTests "[benchmark]"
+TEST_CASE("JsonPayloadWriter cost compared with the DOM encoder", "[.][benchmark]") {
+    SensorConfig heavy = cameraConfig();
+    for (int idx = 0; idx < 40; ++idx) {
+        heavy.metadata["tag_" + std::to_string(idx)] = "value for tag " + std::to_string(idx);
+    }
+    const Readings readings = cameraReadings();
+    constexpr int kPayloads = 20000;
+
+    for (const SensorConfig& config : {cameraConfig(), heavy}) {
+        std::size_t bytes = 0;
+        std::uint64_t domAllocations = 0;
+        const auto domBegin = std::chrono::steady_clock::now();
+        {
+            const AllocationCounter::ScopedAllocationCount allocations;
+            for (int idx = 0; idx < kPayloads; ++idx) {
+                bytes += referencePayload(config, readings, idx).size();
+            }
+            domAllocations = allocations.count();
+        }
+        const double domSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - domBegin).count();
+
+        JsonPayloadWriter writer(config);
+        std::string out;
+        std::uint64_t streamAllocations = 0;
+        const auto streamBegin = std::chrono::steady_clock::now();
+        {
+            const AllocationCounter::ScopedAllocationCount allocations;
+            for (int idx = 0; idx < kPayloads; ++idx) {
+                writer.encode(readings, idx, out);
+                bytes += out.size();
+            }
+            streamAllocations = allocations.count();
+        }
+        const double streamSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - streamBegin).count();
+
+        WARN(config.metadata.size() << " metadata entries, " << out.size() << " bytes");
+        WARN("DOM:       " << domSeconds * 1e9 / kPayloads << " ns/payload, "
+                           << static_cast<double>(domAllocations) / kPayloads << " allocations/payload");
+        WARN("streaming: " << streamSeconds * 1e9 / kPayloads << " ns/payload, "
+                           << static_cast<double>(streamAllocations) / kPayloads << " allocations/payload");
+        REQUIRE(bytes > 0);
+    }
+}
@@ -0,0 +1,305 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "ConfigTypes.hpp"
+#include "Logger.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+    // Sends std::cout into a string for the lifetime of the object.
+    struct CaptureStdout {
+        std::ostringstream captured;
+        std::streambuf*    previous;
+        CaptureStdout() : previous(std::cout.rdbuf(captured.rdbuf())) {}
+        ~CaptureStdout() { std::cout.rdbuf(previous); }
+    };
+
+    // Sends std::cout into a string, but holds the first write until open().
+    class GatedStdout : public std::streambuf {
+    public:
+        GatedStdout() : previous_(std::cout.rdbuf(this)) {}
+        ~GatedStdout() override { std::cout.rdbuf(previous_); }
+
+        GatedStdout(const GatedStdout&) = delete;
+        GatedStdout& operator=(const GatedStdout&) = delete;
+        GatedStdout(GatedStdout&&) = delete;
+        GatedStdout& operator=(GatedStdout&&) = delete;
+
+        void waitUntilBlocked() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            changed_.wait(lock, [this] { return blocked_; });
+        }
+        void open() {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            open_ = true;
+            changed_.notify_all();
+        }
+        std::string text() {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            return text_;
+        }
+
+    protected:
+        std::streamsize xsputn(const char* data, std::streamsize count) override {
+            std::unique_lock<std::mutex> lock(mutex_);
+            blocked_ = true;
+            changed_.notify_all();
+            changed_.wait(lock, [this] { return open_; });
+            text_.append(data, static_cast<std::size_t>(count));
+            return count;
+        }
+        int_type overflow(int_type ch) override {
+            const char byte = traits_type::to_char_type(ch);
+            xsputn(&byte, 1);
+            return ch;
+        }
+
+    private:
+        std::streambuf*         previous_;
+        std::mutex              mutex_;
+        std::condition_variable changed_;
+        bool                    blocked_{false};
+        bool                    open_{false};
+        std::string             text_;
+    };
+
+    LoggingConfig asyncConfig(std::size_t depth, QueuePolicy policy, std::chrono::milliseconds interval = 5ms) {
+        LoggingConfig config;
+        config.async         = true;
+        config.queue         = {depth, policy};
+        config.flushInterval = interval;
+        return config;
+    }
+
+    std::vector<std::string> lines(const std::string& text) {
+        std::vector<std::string> out;
+        std::istringstream stream(text);
+        for (std::string line; std::getline(stream, line);) {
+            out.push_back(line);
+        }
+        return out;
+    }
+
+    // Message part of "[timestamp] [LEVEL] message".
+    std::string messageOf(const std::string& line) {
+        const auto level = line.find("] [");
+        return line.substr(line.find("] ", level + 3) + 2);
+    }
+}
+
+TEST_CASE("Logger async mode writes every line in order and in the usual format", "[Logger]") {
+    auto& logger = Logger::instance();
+    CaptureStdout capture;
+
+    logger.startAsync(asyncConfig(1024, QueuePolicy::DROP_NEWEST));
+    REQUIRE(logger.isAsync());
+    for (int idx = 0; idx < 100; ++idx) {
+        logger.info("line " + std::to_string(idx));
+    }
+    logger.error("boom");
+    logger.stopAsync();
+    REQUIRE_FALSE(logger.isAsync());
+    logger.warning("synchronous again");
+
+    const auto written = lines(capture.captured.str());
+    REQUIRE(written.size() == 102);
+    for (int idx = 0; idx < 100; ++idx) {
+        REQUIRE(messageOf(written[static_cast<std::size_t>(idx)]) == "line " + std::to_string(idx));
+    }
+    REQUIRE(written[0].size() == std::string("[2024-01-01 00:00:00] [INFO] line 0").size());
+    REQUIRE(written[100].find("] [ERROR] boom") != std::string::npos);
+    REQUIRE(written[101].find("] [WARNING] synchronous again") != std::string::npos);
+}
+
+TEST_CASE("Logger async mode keeps up to the queue depth and reports drops", "[Logger]") {
+    auto& logger = Logger::instance();
+    const auto policy = GENERATE(QueuePolicy::DROP_NEWEST, QueuePolicy::DROP_OLDEST);
+
+    // Hold the writer inside its first write so that the ring fills up.
+    GatedStdout gated;
+    const auto droppedBefore = logger.droppedMessages();
+    logger.startAsync(asyncConfig(8, policy, 10s));
+    logger.error("gate");
+    gated.waitUntilBlocked();
+    for (int idx = 0; idx < 20; ++idx) {
+        logger.debug("m" + std::to_string(idx));
+    }
+    gated.open();
+    logger.stopAsync();
+
+    const auto written = lines(gated.text());
+    REQUIRE(logger.droppedMessages() - droppedBefore == 12);
+    REQUIRE(written.size() == 10);
+    REQUIRE(messageOf(written[0]) == "gate");
+    const int first = policy == QueuePolicy::DROP_NEWEST ? 0 : 12;
+    for (int idx = 0; idx < 8; ++idx) {
+        REQUIRE(messageOf(written[static_cast<std::size_t>(idx + 1)]) == "m" + std::to_string(first + idx));
+    }
+    REQUIRE(messageOf(written[9]) == "12 log messages dropped: async log queue full");
+}
+
+TEST_CASE("Logger async mode loses nothing from many threads when blocking", "[Logger]") {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 2000;
+    auto& logger = Logger::instance();
+    CaptureStdout capture;
+
+    logger.startAsync(asyncConfig(64, QueuePolicy::BLOCK, 1ms));
+    std::vector<std::thread> producers;
+    for (int thread = 0; thread < kThreads; ++thread) {
+        producers.emplace_back([&logger, thread] {
+            for (int idx = 0; idx < kPerThread; ++idx) {
+                logger.info("t" + std::to_string(thread) + " " + std::to_string(idx));
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    logger.stopAsync();
+
+    std::vector<int> next(kThreads, 0);
+    const auto written = lines(capture.captured.str());
+    REQUIRE(written.size() == kThreads * kPerThread);
+    for (const auto& line : written) {
+        const std::string message = messageOf(line);
+        const auto thread = static_cast<std::size_t>(message[1] - '0');
+        REQUIRE(message == "t" + std::to_string(thread) + " " + std::to_string(next[thread]));
+        ++next[thread];
+    }
+}
+
+TEST_CASE("Logger async mode cuts over-long messages", "[Logger]") {
+    auto& logger = Logger::instance();
+    CaptureStdout capture;
+
+    logger.startAsync(asyncConfig(16, QueuePolicy::DROP_NEWEST));
+    logger.info(std::string(LogRecord::kTextSize + 100, 'x'));
+    logger.flush();
+    const auto written = lines(capture.captured.str());
+    logger.stopAsync();
+
+    REQUIRE(written.size() == 1);
+    REQUIRE(messageOf(written[0]) == std::string(LogRecord::kTextSize, 'x') + "...");
+    REQUIRE_THROWS_AS(logger.startAsync(asyncConfig(0, QueuePolicy::DROP_NEWEST)), std::invalid_argument);
+}
+
+TEST_CASE("Logger drops lines below the minimum level without building them", "[Logger]") {
+    auto& logger = Logger::instance();
+    CaptureStdout capture;
+    int built = 0;
+    const auto message = [&built](const char* text) {
+        ++built;
+        return std::string(text);
+    };
+
+    logger.setMinLevel(LogLevel::WARNING);
+    REQUIRE_FALSE(logger.isEnabled(LogLevel::INFO));
+    LOGGER_DEBUG(message("debug"));
+    LOGGER_INFO(message("info"));
+    logger.info("plain info");
+    LOGGER_WARNING(message("warning"));
+    LOGGER_ERROR(message("error"));
+    logger.setMinLevel(LogLevel::DEBUG);
+    LOGGER_DEBUG(message("debug again"));
+
+    REQUIRE(built == 3);
+    const auto written = lines(capture.captured.str());
+    REQUIRE(written.size() == 3);
+    REQUIRE(messageOf(written[0]) == "warning");
+    REQUIRE(messageOf(written[1]) == "error");
+    REQUIRE(messageOf(written[2]) == "debug again");
+}
+
+TEST_CASE("Logger writes sub-second UTC timestamps when configured", "[Logger]") {
+    auto& logger = Logger::instance();
+    CaptureStdout capture;
+
+    logger.setTimestampFormat(TimestampPrecision::MICROSECONDS, true);
+    logger.info("first");
+    logger.info("second");
+    logger.setTimestampFormat(TimestampPrecision::SECONDS, false);
+
+    const auto written = lines(capture.captured.str());
+    REQUIRE(written.size() == 2);
+    for (const auto& line : written) {
+        // [2024-01-01T00:00:00.000000Z] [INFO] ...
+        REQUIRE(line.size() > 29);
+        REQUIRE(line[11] == 'T');
+        REQUIRE(line[20] == '.');
+        REQUIRE(line.substr(27, 3) == "Z] ");
+    }
+    REQUIRE(written[0].substr(0, 28) <= written[1].substr(0, 28));
+}
+
+// Run explicitly with: SensorTests "[Logger][benchmark]"
+TEST_CASE("Logger cost of a disabled debug statement", "[.][benchmark][Logger]") {
+    constexpr int kCalls = 10000000;
+    auto& logger = Logger::instance();
+    const std::chrono::microseconds jitter(42);
+
+    const auto perCall = [](auto&& statement) {
+        const auto begin = std::chrono::steady_clock::now();
+        for (int idx = 0; idx < kCalls; ++idx) {
+            statement(idx);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - begin;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / kCalls;
+    };
+
+    logger.setMinLevel(LogLevel::INFO);
+    const double eager = perCall([&](int idx) {
+        logger.debug("Sensor tick: reading data and sending (late " + std::to_string(jitter.count() + idx) + " us)...");
+    });
+    const double lazy = perCall([&](int idx) {
+        LOGGER_DEBUG("Sensor tick: reading data and sending (late " + std::to_string(jitter.count() + idx) + " us)...");
+    });
+    logger.setMinLevel(LogLevel::DEBUG);
+
+    WARN("disabled debug(): " << eager << " ns/call building the message, " << lazy << " ns/call with LOGGER_DEBUG");
+    REQUIRE(lazy > 0.0);
+}
+
+// Run explicitly with: SensorTests "[Logger][benchmark]"
+TEST_CASE("Logger call cost, synchronous against async", "[.][benchmark][Logger]") {
+    constexpr int kMessages = 200000;
+    auto& logger = Logger::instance();
+    CaptureStdout capture;
+    const std::string message = "Sample sent: {\"temperature\": 21.5, \"humidity\": 40.1}";
+
+    const auto perCall = [&] {
+        const auto begin = std::chrono::steady_clock::now();
+        for (int idx = 0; idx < kMessages; ++idx) {
+            logger.info(message);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - begin;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / kMessages;
+    };
+
+    const double sync = perCall();
+    capture.captured.str({});
+    // Room for the whole burst: this measures the caller, not the writer.
+    logger.startAsync(asyncConfig(1U << 18U, QueuePolicy::BLOCK, 20ms));
+    const double async = perCall();
+    const auto drainBegin = std::chrono::steady_clock::now();
+    logger.stopAsync();
+    const double drain = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - drainBegin).count();
+
+    WARN("synchronous " << sync << " ns/call, async " << async << " ns/call (writer finished " << drain
+         << " ms later)");
+    REQUIRE(async > 0.0);
+}
@@ -0,0 +1,178 @@
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+
+#include "AllocationCounter.hpp"
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "JsonPayloadWriter.hpp"
+#include "MetricIdPayloadEncoder.hpp"
+#include "MetricRegistry.hpp"
+#include "PayloadEncoderFactory.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+    SensorConfig idConfig(PayloadFormat format, std::uint32_t dictionaryEvery = 0) {
+        SensorConfig config;
+        config.sensorId = "cam-01";
+        config.metadata = {{"location", "dock 4"}};
+        config.units    = {{"frame_width", "px"}};
+        config.payloadFormat = format;
+        config.metricIds.enabled = true;
+        config.metricIds.dictionaryEvery = dictionaryEvery;
+        return config;
+    }
+
+    Readings sampleReadings() {
+        return {{"frame_width", 640.0}, {"frame_height", 480.0}, {"brightness", 9.645}, {"frame_status", 1.0}};
+    }
+
+    // Split newline-delimited JSON messages.
+    std::vector<json> jsonLines(const std::string& payload) {
+        std::vector<json> lines;
+        std::size_t begin = 0;
+        for (std::size_t end = payload.find('\n'); end != std::string::npos; end = payload.find('\n', begin)) {
+            lines.push_back(json::parse(payload.substr(begin, end - begin)));
+            begin = end + 1;
+        }
+        REQUIRE(begin == payload.size());
+        return lines;
+    }
+
+    // Readings rebuilt the way a collector would: ids -> dictionary names.
+    json resolve(const json& dictionary, const json& sample) {
+        json readings = json::object();
+        const auto& ids = sample["ids"];
+        for (std::size_t idx = 0; idx < ids.size(); ++idx) {
+            const auto& metric = dictionary["metrics"][ids[idx].get<std::size_t>()];
+            readings[metric[0].get<std::string>()] = {
+                {"unit", dictionary["units"][metric[1].get<std::size_t>()]},
+                {"value", sample["values"][idx]}};
+        }
+        return readings;
+    }
+}
+
+TEST_CASE("MetricRegistry assigns dense, stable IDs", "[MetricIdPayloadEncoder]") {
+    MetricRegistry registry;
+    REQUIRE(registry.intern("brightness", "intensity") == 0);
+    REQUIRE(registry.intern("frame_width", "pixels") == 1);
+    REQUIRE(registry.intern("frame_height", "pixels") == 2);
+    REQUIRE(registry.units().size() == 2);
+
+    const std::uint64_t version = registry.version();
+    REQUIRE(registry.intern("frame_width", "pixels") == 1);
+    REQUIRE(registry.version() == version);
+
+    // A changed unit keeps the ID but bumps the version.
+    REQUIRE(registry.intern("frame_width", "px") == 1);
+    REQUIRE(registry.version() > version);
+    REQUIRE(registry.units()[registry.metrics()[1].unitId] == "px");
+}
+
+TEST_CASE("MetricIdPayloadEncoder sends the dictionary once and IDs per sample", "[MetricIdPayloadEncoder]") {
+    const SensorConfig config = idConfig(PayloadFormat::JSON);
+    auto encoder = PayloadEncoderFactory::make(config);
+    std::string out;
+
+    encoder->encode(sampleReadings(), 1700000000123, out);
+    auto lines = jsonLines(out);
+    REQUIRE(lines.size() == 2);
+    const json dictionary = lines[0]["dictionary"];
+    REQUIRE(lines[0]["sensor_id"] == "cam-01");
+    REQUIRE(dictionary["metadata"]["location"] == "dock 4");
+    REQUIRE(dictionary["version"] == lines[1]["dictionary_version"]);
+    REQUIRE_FALSE(lines[1].contains("metadata"));
+
+    // Same readings as the name-keyed JSON payload.
+    SensorConfig plain = config;
+    plain.metricIds.enabled = false;
+    JsonPayloadWriter writer(plain);
+    std::string reference;
+    writer.encode(sampleReadings(), 1700000000123, reference);
+    const json expected = json::parse(reference);
+    REQUIRE(resolve(dictionary, lines[1]) == expected["readings"]);
+    REQUIRE(lines[1]["timestamp_ms"] == expected["timestamp_ms"]);
+
+    // Later samples carry only IDs and are much smaller.
+    encoder->encode(sampleReadings(), 1700000000124, out);
+    lines = jsonLines(out);
+    REQUIRE(lines.size() == 1);
+    REQUIRE(resolve(dictionary, lines[0]) == expected["readings"]);
+    REQUIRE(out.size() * 2 < reference.size());
+
+    // A reconnect resends it.
+    encoder->resetSession();
+    encoder->encode(sampleReadings(), 1700000000125, out);
+    REQUIRE(jsonLines(out).size() == 2);
+}
+
+TEST_CASE("MetricIdPayloadEncoder resends the dictionary on new metrics and periodically", "[MetricIdPayloadEncoder]") {
+    auto encoder = PayloadEncoderFactory::make(idConfig(PayloadFormat::JSON, 3));
+    std::string out;
+
+    std::vector<std::size_t> messages;
+    for (int tick = 0; tick < 7; ++tick) {
+        encoder->encode(sampleReadings(), tick, out);
+        messages.push_back(jsonLines(out).size());
+    }
+    REQUIRE(messages == std::vector<std::size_t>{2, 1, 1, 2, 1, 1, 2});
+
+    Readings more = sampleReadings();
+    more["temperature"] = 21.5;
+    encoder->encode(more, 8, out);
+    const auto lines = jsonLines(out);
+    REQUIRE(lines.size() == 2);
+
+    // Existing IDs keep their meaning; the new metric gets the next one.
+    const json& metrics = lines[0]["dictionary"]["metrics"];
+    REQUIRE(metrics.size() == 5);
+    REQUIRE(metrics[4][0] == "temperature");
+    REQUIRE(resolve(lines[0]["dictionary"], lines[1])["temperature"]["value"] == 21.5);
+}
+
+TEST_CASE("MetricIdPayloadEncoder CBOR and MessagePack carry the same messages", "[MetricIdPayloadEncoder]") {
+    auto jsonEncoder = PayloadEncoderFactory::make(idConfig(PayloadFormat::JSON));
+    std::string jsonOut;
+    jsonEncoder->encode(sampleReadings(), 42, jsonOut);
+    const auto expected = jsonLines(jsonOut);
+    jsonEncoder->encode(sampleReadings(), 43, jsonOut);
+    const json expectedSample = jsonLines(jsonOut)[0];
+
+    for (const PayloadFormat format : {PayloadFormat::CBOR, PayloadFormat::MSGPACK}) {
+        auto encoder = PayloadEncoderFactory::make(idConfig(format));
+        std::string out;
+        const auto decode = [format](const std::string& bytes, bool strict) {
+            return format == PayloadFormat::CBOR ? json::from_cbor(bytes, strict) : json::from_msgpack(bytes, strict);
+        };
+
+        encoder->encode(sampleReadings(), 42, out);
+        REQUIRE(decode(out, false) == expected[0]);   // dictionary first
+
+        encoder->encode(sampleReadings(), 43, out);
+        REQUIRE(decode(out, true) == expectedSample);
+    }
+}
+
+TEST_CASE("MetricIdPayloadEncoder steady state does not allocate", "[MetricIdPayloadEncoder]") {
+    auto encoder = PayloadEncoderFactory::make(idConfig(PayloadFormat::CBOR));
+    const Readings readings = sampleReadings();
+    std::string out;
+    encoder->encode(readings, 1, out);
+
+    const AllocationCounter::ScopedAllocationCount allocations;
+    for (std::int64_t tick = 2; tick < 50; ++tick) {
+        encoder->encode(readings, tick, out);
+    }
+    REQUIRE(allocations.count() == 0);
+}
+
+TEST_CASE("MetricIdPayloadEncoder rejects the binary format", "[MetricIdPayloadEncoder]") {
+    REQUIRE_THROWS_AS(MetricIdPayloadEncoder(idConfig(PayloadFormat::BINARY)), std::invalid_argument);
+}
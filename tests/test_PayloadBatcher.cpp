@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "ConfigTypes.hpp"
+#include "NetworkConstants.hpp"
+#include "PayloadBatcher.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+using namespace std::chrono_literals;
+
+namespace {
+
+    BatchConfig batchConfig(std::size_t maxSamples, std::size_t maxBytes, std::chrono::milliseconds linger) {
+        BatchConfig config;
+        config.enabled    = true;
+        config.maxSamples = maxSamples;
+        config.maxBytes   = maxBytes;
+        config.linger     = linger;
+        return config;
+    }
+}
+
+TEST_CASE("PayloadBatcher flushes when the sample count is reached", "[PayloadBatcher]") {
+    std::vector<std::string> sent;
+    PayloadBatcher batcher(batchConfig(3, 0, 1h), 0, [&](const std::string& batch) { sent.push_back(batch); });
+    const auto now = PayloadBatcher::Clock::now();
+
+    for (int idx = 0; idx < 7; ++idx) {
+        batcher.add("line" + std::to_string(idx) + "\n", now);
+    }
+    REQUIRE(sent == std::vector<std::string>{"line0\nline1\nline2\n", "line3\nline4\nline5\n"});
+    REQUIRE_FALSE(batcher.empty());
+
+    batcher.flush();
+    REQUIRE(sent.back() == "line6\n");
+
+    const BatchStats& stats = batcher.stats();
+    REQUIRE(stats.batches == 3);
+    REQUIRE(stats.samples == 7);
+    REQUIRE(stats.flushedByCount == 2);
+    REQUIRE(stats.flushedByLinger == 1);
+    REQUIRE(stats.maxBytes == PayloadBatcher::kDefaultMaxBytes);
+    REQUIRE_THAT(stats.sampleFillRatio(), WithinAbs(7.0 / 9.0, 1e-12));
+}
+
+TEST_CASE("PayloadBatcher keeps batches within the transport's message size", "[PayloadBatcher]") {
+    std::vector<std::string> sent;
+    // Configured 4000 bytes, but the UDP transport caps it to one datagram.
+    PayloadBatcher batcher(batchConfig(1000, 4000, 1h), NetworkConstants::kUdpUnfragmentedPayload,
+                           [&](const std::string& batch) { sent.push_back(batch); });
+    REQUIRE(batcher.maxBytes() == NetworkConstants::kUdpUnfragmentedPayload);
+
+    const std::string payload(100, 'x');
+    const auto now = PayloadBatcher::Clock::now();
+    for (int idx = 0; idx < 30; ++idx) {
+        batcher.add(payload, now);
+    }
+    batcher.flush();
+
+    REQUIRE(sent.size() == 3);   // 14 + 14 + 2 payloads
+    for (const std::string& batch : sent) {
+        REQUIRE(batch.size() <= NetworkConstants::kUdpUnfragmentedPayload);
+    }
+    REQUIRE(batcher.stats().flushedBySize == 2);
+    REQUIRE(batcher.stats().byteFillRatio() > 0.6);
+
+    // A payload too large for any batch goes out alone.
+    batcher.add(std::string(2000, 'y'), now);
+    REQUIRE(sent.back().size() == 2000);
+    REQUIRE(batcher.stats().oversize == 1);
+    REQUIRE(batcher.empty());
+}
+
+TEST_CASE("PayloadBatcher flushes lingering samples", "[PayloadBatcher]") {
+    std::vector<std::string> sent;
+    PayloadBatcher batcher(batchConfig(100, 0, 50ms), 0, [&](const std::string& batch) { sent.push_back(batch); });
+    const auto start = PayloadBatcher::Clock::now();
+
+    batcher.add("a", start);
+    batcher.add("b", start + 10ms);
+    batcher.flushIfDue(start + 49ms);
+    REQUIRE(sent.empty());
+    REQUIRE(batcher.deadline() == start + 50ms);
+
+    batcher.flushIfDue(start + 50ms);
+    REQUIRE(sent == std::vector<std::string>{"ab"});
+
+    // An arriving sample also triggers the check.
+    batcher.add("c", start + 60ms);
+    batcher.add("d", start + 200ms);
+    REQUIRE(sent.back() == "cd");
+}
+
+TEST_CASE("PayloadBatcher drops a batch the transport rejected", "[PayloadBatcher]") {
+    bool fail = true;
+    std::vector<std::string> sent;
+    PayloadBatcher batcher(batchConfig(2, 0, 1h), 0, [&](const std::string& batch) {
+        if (fail) {
+            throw std::runtime_error("link down");
+        }
+        sent.push_back(batch);
+    });
+    const auto now = PayloadBatcher::Clock::now();
+
+    batcher.add("a", now);
+    REQUIRE_THROWS_AS(batcher.add("b", now), std::runtime_error);
+    REQUIRE(batcher.empty());
+
+    fail = false;
+    batcher.add("c", now);
+    batcher.add("d", now);
+    REQUIRE(sent == std::vector<std::string>{"cd"});
+
+    REQUIRE_THROWS_AS(PayloadBatcher(batchConfig(0, 0, 1ms), 0, [](const std::string&) {}), std::invalid_argument);
+}
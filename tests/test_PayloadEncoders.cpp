@@ -0,0 +1,205 @@
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+
+#include "AllocationCounter.hpp"
+#include "BinaryPayloadEncoder.hpp"
+#include "CborPayloadEncoder.hpp"
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "IPayloadEncoder.hpp"
+#include "JsonPayloadWriter.hpp"
+#include "MsgPackPayloadEncoder.hpp"
+#include "PayloadEncoderFactory.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+    SensorConfig sensorConfig(PayloadFormat format) {
+        SensorConfig config;
+        config.sensorId = "cam-01";
+        config.metadata = {{"location", "dock 4"}, {"model", "alpha-proto"}};
+        config.units    = {{"frame_width", "px"}};
+        config.payloadFormat = format;
+        return config;
+    }
+
+    Readings sampleReadings() {
+        return {{"frame_width", 640.0}, {"frame_height", 480.0}, {"brightness", 9.645},
+                {"luma_709", 127.123456}, {"red_variance", 1234.5678}, {"temperature", -3.14159},
+                {"broken", std::numeric_limits<double>::quiet_NaN()}};
+    }
+
+    std::vector<std::uint8_t> bytesOf(const std::string& payload) {
+        return {payload.begin(), payload.end()};
+    }
+
+    template <typename T>
+    T readLittleEndian(const std::string& data, std::size_t offset) {
+        std::uint64_t bits = 0;
+        for (std::size_t idx = 0; idx < sizeof(T); ++idx) {
+            bits |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[offset + idx])) << (8 * idx);
+        }
+        T value{};
+        std::memcpy(&value, &bits, sizeof(T));
+        return value;
+    }
+
+    std::string encodeWith(PayloadFormat format, const Readings& readings, std::int64_t timestampMs) {
+        auto encoder = PayloadEncoderFactory::make(sensorConfig(format));
+        std::string out;
+        encoder->encode(readings, timestampMs, out);
+        return out;
+    }
+}
+
+TEST_CASE("CBOR and MessagePack payloads decode to the JSON payload", "[PayloadEncoder]") {
+    const Readings readings = sampleReadings();
+    const json expected = json::parse(encodeWith(PayloadFormat::JSON, readings, 1700000000123));
+
+    REQUIRE(json::from_cbor(bytesOf(encodeWith(PayloadFormat::CBOR, readings, 1700000000123))) == expected);
+    REQUIRE(json::from_msgpack(bytesOf(encodeWith(PayloadFormat::MSGPACK, readings, 1700000000123))) == expected);
+
+    // No readings, no metadata: the optional members are left out.
+    SensorConfig bare;
+    bare.sensorId = "bare";
+    for (const PayloadFormat format : {PayloadFormat::CBOR, PayloadFormat::MSGPACK}) {
+        bare.payloadFormat = format;
+        auto encoder = PayloadEncoderFactory::make(bare);
+        std::string out;
+        encoder->encode(Readings{}, -7, out);
+        const json decoded = format == PayloadFormat::CBOR ? json::from_cbor(bytesOf(out))
+                                                           : json::from_msgpack(bytesOf(out));
+        REQUIRE(decoded == json{{"sensor_id", "bare"}, {"timestamp_ms", -7}});
+    }
+}
+
+TEST_CASE("CBOR and MessagePack primitives round-trip at every size class", "[PayloadEncoder]") {
+    const std::int64_t integers[] = {0, 1, 23, 24, 127, 128, 255, 256, 65535, 65536, 4294967295LL, 4294967296LL,
+                                     std::numeric_limits<std::int64_t>::max(), -1, -24, -25, -32, -33, -128, -129,
+                                     -32768, -32769, -2147483648LL, -2147483649LL,
+                                     std::numeric_limits<std::int64_t>::min()};
+    for (const std::int64_t value : integers) {
+        INFO(value);
+        std::string cbor;
+        CborPayloadEncoder::appendInteger(cbor, value);
+        REQUIRE(json::from_cbor(bytesOf(cbor)).get<std::int64_t>() == value);
+
+        std::string msgpack;
+        MsgPackPayloadEncoder::appendInteger(msgpack, value);
+        REQUIRE(json::from_msgpack(bytesOf(msgpack)).get<std::int64_t>() == value);
+    }
+
+    for (const double value : {0.0, 640.0, 0.5, 9.65, -1e300, 3.4028234663852886e38, 1e39}) {
+        INFO(value);
+        std::string cbor;
+        CborPayloadEncoder::appendDouble(cbor, value);
+        REQUIRE(json::from_cbor(bytesOf(cbor)).get<double>() == value);
+
+        std::string msgpack;
+        MsgPackPayloadEncoder::appendDouble(msgpack, value);
+        REQUIRE(json::from_msgpack(bytesOf(msgpack)).get<double>() == value);
+    }
+
+    // Exact float32 values take 5 bytes, others 9.
+    std::string narrow;
+    CborPayloadEncoder::appendDouble(narrow, 640.0);
+    REQUIRE(narrow.size() == 5);
+    std::string wide;
+    CborPayloadEncoder::appendDouble(wide, 9.65);
+    REQUIRE(wide.size() == 9);
+
+    for (const std::size_t size : {0U, 23U, 24U, 31U, 32U, 255U, 256U, 70000U}) {
+        const std::string text(size, 'x');
+        std::string cbor;
+        CborPayloadEncoder::appendText(cbor, text);
+        REQUIRE(json::from_cbor(bytesOf(cbor)) == text);
+
+        std::string msgpack;
+        MsgPackPayloadEncoder::appendString(msgpack, text);
+        REQUIRE(json::from_msgpack(bytesOf(msgpack)) == text);
+    }
+}
+
+TEST_CASE("Binary payload follows the documented record layout", "[PayloadEncoder]") {
+    BinaryPayloadEncoder encoder(sensorConfig(PayloadFormat::BINARY));
+    const Readings readings{{"b", 2.0}, {"a", 1.004}, {"c", -3.5}};
+    std::string out;
+    encoder.encode(readings, 1700000000123, out);
+
+    const std::size_t valuesAt = BinaryPayloadEncoder::kHeaderSize + 6;
+    REQUIRE(out.compare(0, 4, "SNR1") == 0);
+    REQUIRE(readLittleEndian<std::uint32_t>(out, 4) == out.size());
+    REQUIRE(readLittleEndian<std::uint32_t>(out, 8) == encoder.schemaId());
+    REQUIRE(readLittleEndian<std::uint32_t>(out, 12) == 3);
+    REQUIRE(readLittleEndian<std::int64_t>(out, 16) == 1700000000123);
+    REQUIRE(static_cast<unsigned char>(out[24]) == 6);
+    REQUIRE(out.compare(25, 6, "cam-01") == 0);
+    REQUIRE(out.size() == valuesAt + 3 * sizeof(double));
+
+    // Values in name order, rounded to 2 decimals.
+    REQUIRE(readLittleEndian<double>(out, valuesAt) == 1.0);
+    REQUIRE(readLittleEndian<double>(out, valuesAt + 8) == 2.0);
+    REQUIRE(readLittleEndian<double>(out, valuesAt + 16) == -3.5);
+
+    // The schema id follows the set of names.
+    const std::uint32_t first = encoder.schemaId();
+    encoder.encode(readings, 0, out);
+    REQUIRE(encoder.schemaId() == first);
+    encoder.encode(Readings{{"a", 1.0}, {"b", 2.0}, {"d", 3.0}}, 0, out);
+    REQUIRE(encoder.schemaId() != first);
+}
+
+TEST_CASE("Payload encoders do not allocate in steady state", "[PayloadEncoder]") {
+    const Readings readings = sampleReadings();
+    for (const PayloadFormat format : {PayloadFormat::JSON, PayloadFormat::CBOR,
+                                       PayloadFormat::MSGPACK, PayloadFormat::BINARY}) {
+        auto encoder = PayloadEncoderFactory::make(sensorConfig(format));
+        std::string out;
+        encoder->encode(readings, 1, out);
+
+        const AllocationCounter::ScopedAllocationCount allocations;
+        for (std::int64_t tick = 2; tick < 50; ++tick) {
+            encoder->encode(readings, tick, out);
+        }
+        REQUIRE(allocations.count() == 0);
+    }
+}
+
+// Run explicitly with: SensorTests "[benchmark]"
+TEST_CASE("Payload size and encode cost per format", "[.][benchmark]") {
+    Readings readings = sampleReadings();
+    for (int idx = 0; idx < 24; ++idx) {
+        readings["metric_" + std::to_string(idx)] = idx * 10.25;
+    }
+    constexpr int kPayloads = 50000;
+
+    const char* names[] = {"json", "cbor", "msgpack", "binary"};
+    const PayloadFormat formats[] = {PayloadFormat::JSON, PayloadFormat::CBOR,
+                                     PayloadFormat::MSGPACK, PayloadFormat::BINARY};
+    for (std::size_t idx = 0; idx < std::size(formats); ++idx) {
+        auto encoder = PayloadEncoderFactory::make(sensorConfig(formats[idx]));
+        std::string out;
+        std::size_t bytes = 0;
+
+        const auto begin = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < kPayloads; ++tick) {
+            encoder->encode(readings, 1700000000000 + tick, out);
+            bytes += out.size();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        WARN(names[idx] << ": " << out.size() << " bytes, " << seconds * 1e9 / kPayloads << " ns/payload");
+        REQUIRE(bytes > 0);
+    }
+}
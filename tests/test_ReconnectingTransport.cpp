@@ -0,0 +1,429 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ConfigTypes.hpp"
+#include "ConstantDataSource.hpp"
+#include "ConstBuffer.hpp"
+#include "ITransport.hpp"
+#include "ReconnectingTransport.hpp"
+#include "Sensor.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+    // A link to a collector the test can take down and bring back.
+    class FakeLink : public ITransport {
+    public:
+        bool collectorUp = true;
+        bool connected = false;
+        bool buffering = false;   // sends sit unflushed in a user-space buffer
+        int connectCalls = 0;
+        std::vector<std::string> delivered;
+
+        void connect() override {
+            ++connectCalls;
+            if (!collectorUp) {
+                throw std::runtime_error("connect: Connection refused");
+            }
+            connected = true;
+        }
+        std::size_t sendString(const std::string& payload) override {
+            if (!connected || !collectorUp) {
+                throw std::runtime_error("send: Broken pipe");
+            }
+            delivered.push_back(payload);
+            return payload.size();
+        }
+        bool flushUntil(std::chrono::steady_clock::time_point /*deadline*/) override {
+            if (connected && !collectorUp) {
+                throw std::runtime_error("send: Broken pipe");
+            }
+            return !buffering;
+        }
+        void close() override { connected = false; }
+        bool isConnected() const override { return connected; }
+    };
+
+    ReconnectConfig fastRetries() {
+        ReconnectConfig config;
+        config.enabled        = true;
+        config.initialBackoff = 1ms;
+        config.maxBackoff     = 2ms;
+        config.maxAttempts    = 1000;
+        config.attemptWindow  = 1s;
+        config.queueSamples   = 100;
+        return config;
+    }
+
+    struct Harness {
+        explicit Harness(const ReconnectConfig& config) {
+            auto owned = std::make_unique<FakeLink>();
+            link = owned.get();
+            transport = std::make_unique<ReconnectingTransport>(std::move(owned), config, 42);
+        }
+        FakeLink* link{nullptr};
+        std::unique_ptr<ReconnectingTransport> transport;
+    };
+
+    // Past any backoff fastRetries() can produce.
+    void waitOutBackoff() { std::this_thread::sleep_for(5ms); }
+}
+
+TEST_CASE("ReconnectingTransport queues while the collector is down and replays in order", "[ReconnectingTransport]") {
+    Harness harness(fastRetries());
+    auto& transport = *harness.transport;
+
+    transport.connect();
+    REQUIRE(transport.sessionCount() == 1);
+    REQUIRE(transport.sendString("a") == 1);
+
+    harness.link->collectorUp = false;
+    REQUIRE_NOTHROW(transport.sendString("b"));   // fails on the link: queued, no exception
+    waitOutBackoff();
+    REQUIRE_NOTHROW(transport.sendString("c"));   // reconnect attempt fails: queued
+    REQUIRE_FALSE(transport.isConnected());
+    REQUIRE(transport.queuedPayloads() == 2);
+
+    harness.link->collectorUp = true;
+    waitOutBackoff();
+    transport.sendString("d");
+
+    REQUIRE(harness.link->delivered == std::vector<std::string>{"a", "b", "c", "d"});
+    REQUIRE(transport.sessionCount() == 2);
+    const ReconnectStats& stats = transport.stats();
+    REQUIRE(stats.linkLosses == 1);
+    REQUIRE(stats.queued == 2);
+    REQUIRE(stats.replayed == 2);
+    REQUIRE(stats.dropped == 0);
+}
+
+TEST_CASE("ReconnectingTransport survives a collector that is down at startup", "[ReconnectingTransport]") {
+    Harness harness(fastRetries());
+    harness.link->collectorUp = false;
+
+    REQUIRE_NOTHROW(harness.transport->connect());
+    REQUIRE_FALSE(harness.transport->isConnected());
+    const ConstBuffer pieces[] = {ConstBuffer(std::string_view("he")), ConstBuffer(std::string_view("llo"))};
+    REQUIRE(harness.transport->sendBuffers(pieces, 2) == 5);
+
+    harness.link->collectorUp = true;
+    waitOutBackoff();
+    // Reconnects between ticks too, without new data to send.
+    REQUIRE(harness.transport->flushUntil(ReconnectingTransport::Clock::now()));
+    REQUIRE(harness.link->delivered == std::vector<std::string>{"hello"});
+}
+
+TEST_CASE("ReconnectingTransport caps connect attempts per window", "[ReconnectingTransport]") {
+    ReconnectConfig config = fastRetries();
+    config.maxAttempts   = 3;
+    config.attemptWindow = 60s;
+    Harness harness(config);
+    harness.link->collectorUp = false;
+
+    const auto begin = ReconnectingTransport::Clock::now();
+    harness.transport->connect();
+    for (int tick = 0; tick < 100; ++tick) {
+        harness.transport->sendString("x");
+        std::this_thread::sleep_for(1ms);
+    }
+
+    // Backoff alone would have allowed dozens; the window allows three.
+    REQUIRE(harness.link->connectCalls == 3);
+    REQUIRE(harness.transport->nextAttempt() >= begin + 60s);
+}
+
+TEST_CASE("ReconnectingTransport drops the oldest queued payloads when full", "[ReconnectingTransport]") {
+    ReconnectConfig config = fastRetries();
+    config.queueSamples = 2;
+    Harness harness(config);
+
+    harness.transport->connect();
+    harness.link->collectorUp = false;
+    for (const char* payload : {"1", "2", "3"}) {
+        harness.transport->sendString(payload);
+    }
+    harness.link->collectorUp = true;
+    waitOutBackoff();
+    REQUIRE(harness.transport->flushUntil(ReconnectingTransport::Clock::now()));
+
+    REQUIRE(harness.link->delivered == std::vector<std::string>{"2", "3"});
+    REQUIRE(harness.transport->stats().dropped == 1);
+}
+
+TEST_CASE("ReconnectingTransport spools to disk and replays after a restart", "[ReconnectingTransport]") {
+    const auto directory = std::filesystem::temp_directory_path() / "sensor_spool_reconnect";
+    std::filesystem::remove_all(directory);
+    ReconnectConfig config = fastRetries();
+    config.spool.enabled = true;
+    config.spool.directory = directory.string();
+    config.spool.segmentBytes = 1024;
+    config.spool.maxBytes = 64 * 1024;
+
+    {
+        Harness harness(config);
+        harness.link->collectorUp = false;
+        harness.transport->connect();
+        for (const char* payload : {"1", "2", "3"}) {
+            harness.transport->sendString(payload);
+        }
+        REQUIRE(harness.transport->queuedPayloads() == 3);
+        harness.transport->close();   // the sensor stops with the collector still down
+    }
+
+    Harness restarted(config);
+    REQUIRE(restarted.transport->queuedPayloads() == 3);
+    restarted.transport->connect();
+    restarted.transport->sendString("4");
+    REQUIRE(restarted.link->delivered == std::vector<std::string>{"1", "2", "3", "4"});
+    REQUIRE(restarted.transport->spool()->empty());
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("ReconnectingTransport sends the session preamble ahead of a replay", "[ReconnectingTransport]") {
+    Harness harness(fastRetries());
+    auto& transport = *harness.transport;
+
+    transport.setSessionPreamble("D");
+    transport.connect();
+    transport.sendString("a");             // nothing to replay: no preamble
+
+    harness.link->collectorUp = false;
+    transport.sendString("b");
+    harness.link->collectorUp = true;
+    waitOutBackoff();
+    transport.sendString("c");
+
+    REQUIRE(harness.link->delivered == std::vector<std::string>{"a", "D", "b", "c"});
+}
+
+TEST_CASE("ReconnectingTransport spools the session preamble with the payloads", "[ReconnectingTransport]") {
+    const auto directory = std::filesystem::temp_directory_path() / "sensor_spool_preamble";
+    std::filesystem::remove_all(directory);
+    ReconnectConfig config = fastRetries();
+    config.spool.enabled = true;
+    config.spool.directory = directory.string();
+    config.spool.segmentBytes = 1024;
+    config.spool.maxBytes = 64 * 1024;
+
+    {
+        Harness harness(config);
+        harness.link->collectorUp = false;
+        harness.transport->setSessionPreamble("D1");
+        harness.transport->connect();
+        harness.transport->sendString("1");
+        harness.transport->setSessionPreamble("D2");   // a new metric showed up
+        harness.transport->sendString("2");
+        harness.transport->close();
+    }
+
+    // The restarted process has not encoded anything yet, so only the spool
+    // knows which dictionary the payloads need.
+    Harness restarted(config);
+    restarted.transport->connect();
+    restarted.transport->sendString("3");
+    REQUIRE(restarted.link->delivered == std::vector<std::string>{"D1", "1", "D2", "2", "3"});
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("ReconnectingTransport paces replay at the configured rate", "[ReconnectingTransport]") {
+    ReconnectConfig config = fastRetries();
+    config.replayRate = 5;   // a one-second bucket holds 5 tokens
+    Harness harness(config);
+
+    harness.transport->connect();
+    harness.link->collectorUp = false;
+    for (int idx = 0; idx < 20; ++idx) {
+        harness.transport->sendString(std::to_string(idx));
+    }
+    harness.link->collectorUp = true;
+    waitOutBackoff();
+
+    REQUIRE_FALSE(harness.transport->flushUntil(ReconnectingTransport::Clock::now()));
+    REQUIRE(harness.link->delivered.size() == 5);
+
+    // New data waits behind the backlog, so order is kept.
+    harness.transport->sendString("new");
+    REQUIRE(harness.link->delivered.size() == 5);
+    REQUIRE(harness.transport->queuedPayloads() == 16);
+
+    std::this_thread::sleep_for(450ms);   // about two more tokens
+    harness.transport->flushUntil(ReconnectingTransport::Clock::now());
+    REQUIRE(harness.link->delivered.size() >= 6);
+    REQUIRE(harness.link->delivered.size() <= 8);
+    REQUIRE(harness.link->delivered.back() == std::to_string(harness.link->delivered.size() - 1));
+}
+
+TEST_CASE("ReconnectingTransport replays a long backlog in bursts, not in one send", "[ReconnectingTransport]") {
+    ReconnectConfig config = fastRetries();
+    config.queueSamples = 1000;
+    Harness harness(config);
+    auto& transport = *harness.transport;
+
+    transport.connect();
+    harness.link->collectorUp = false;
+    for (int idx = 0; idx < 200; ++idx) {
+        transport.sendString(std::to_string(idx));
+    }
+    harness.link->collectorUp = true;
+    waitOutBackoff();
+
+    // The send that finds the link up replays one burst and queues itself.
+    transport.sendString("new");
+    REQUIRE(harness.link->delivered.size() == ReconnectingTransport::kReplayBurst);
+    REQUIRE(transport.queuedPayloads() == 200 - ReconnectingTransport::kReplayBurst + 1);
+
+    // Idle time between ticks works off the rest.
+    const auto giveUp = ReconnectingTransport::Clock::now() + 5s;
+    while (!transport.flushUntil(ReconnectingTransport::Clock::now() + 1ms) &&
+           ReconnectingTransport::Clock::now() < giveUp) {
+    }
+    REQUIRE(harness.link->delivered.size() == 201);
+    for (std::size_t idx = 0; idx < 200; ++idx) {
+        REQUIRE(harness.link->delivered[idx] == std::to_string(idx));
+    }
+    REQUIRE(harness.link->delivered.back() == "new");
+}
+
+TEST_CASE("ReconnectingTransport keeps a replayed payload queued until it is flushed", "[ReconnectingTransport]") {
+    Harness harness(fastRetries());
+    auto& transport = *harness.transport;
+
+    transport.connect();
+    harness.link->collectorUp = false;
+    transport.sendString("1");
+    transport.sendString("2");
+    harness.link->collectorUp = true;
+    harness.link->buffering = true;
+    waitOutBackoff();
+
+    // "1" was handed over but still sits in the link's buffer.
+    REQUIRE_FALSE(transport.flushUntil(ReconnectingTransport::Clock::now()));
+    REQUIRE(harness.link->delivered == std::vector<std::string>{"1"});
+    REQUIRE(transport.queuedPayloads() == 2);
+
+    // The link breaks before flushing it: "1" is replayed again.
+    harness.link->collectorUp = false;
+    transport.sendString("3");
+    harness.link->collectorUp = true;
+    harness.link->buffering = false;
+    waitOutBackoff();
+    REQUIRE(transport.flushUntil(ReconnectingTransport::Clock::now()));
+    REQUIRE(harness.link->delivered == std::vector<std::string>{"1", "1", "2", "3"});
+    REQUIRE(transport.stats().replayed == 3);
+}
+
+TEST_CASE("ReconnectingTransport leaves an unflushed replay in the spool at close", "[ReconnectingTransport]") {
+    const auto directory = std::filesystem::temp_directory_path() / "sensor_spool_unflushed";
+    std::filesystem::remove_all(directory);
+    ReconnectConfig config = fastRetries();
+    config.spool.enabled = true;
+    config.spool.directory = directory.string();
+
+    {
+        Harness harness(config);
+        harness.link->collectorUp = false;
+        harness.transport->connect();
+        harness.transport->sendString("1");
+        harness.transport->sendString("2");
+        harness.link->collectorUp = true;
+        harness.link->buffering = true;
+        waitOutBackoff();
+        REQUIRE_FALSE(harness.transport->flushUntil(ReconnectingTransport::Clock::now()));
+        REQUIRE(harness.link->delivered == std::vector<std::string>{"1"});
+        harness.transport->close();   // the buffer is gone with the process
+    }
+
+    Harness restarted(config);
+    REQUIRE(restarted.transport->queuedPayloads() == 2);
+    restarted.transport->connect();
+    REQUIRE(restarted.transport->flushUntil(ReconnectingTransport::Clock::now()));
+    REQUIRE(restarted.link->delivered == std::vector<std::string>{"1", "2"});
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("ReconnectingTransport backoff is full jitter below an exponential ceiling", "[ReconnectingTransport]") {
+    ReconnectConfig config = fastRetries();
+    config.initialBackoff = 100ms;
+    config.maxBackoff     = 1000ms;
+    Harness harness(config);
+
+    for (std::uint32_t failures = 0; failures < 8; ++failures) {
+        const std::int64_t ceiling = std::min<std::int64_t>(1000, 100LL << failures);
+        std::int64_t lowest = ceiling;
+        std::int64_t highest = 0;
+        double sum = 0.0;
+        constexpr int kDraws = 4000;
+        for (int draw = 0; draw < kDraws; ++draw) {
+            const std::int64_t delay = harness.transport->backoff(failures).count();
+            REQUIRE(delay >= 0);
+            REQUIRE(delay < ceiling);
+            lowest = std::min(lowest, delay);
+            highest = std::max(highest, delay);
+            sum += static_cast<double>(delay);
+        }
+        // Spread over the whole interval, not clustered near the ceiling.
+        INFO("failures " << failures);
+        REQUIRE(lowest <= ceiling / 20);
+        REQUIRE(highest >= ceiling - ceiling / 20 - 1);
+        const double mean = sum / kDraws;
+        REQUIRE(mean > 0.45 * static_cast<double>(ceiling));
+        REQUIRE(mean < 0.55 * static_cast<double>(ceiling));
+    }
+}
+
+TEST_CASE("ReconnectingTransport validates its configuration", "[ReconnectingTransport]") {
+    ReconnectConfig config = fastRetries();
+    REQUIRE_THROWS_AS(ReconnectingTransport(nullptr, config), std::invalid_argument);
+
+    config.maxBackoff = 0ms;
+    REQUIRE_THROWS_AS(ReconnectingTransport(std::make_unique<FakeLink>(), config), std::invalid_argument);
+
+    config = fastRetries();
+    config.maxAttempts = 0;
+    REQUIRE_THROWS_AS(ReconnectingTransport(std::make_unique<FakeLink>(), config), std::invalid_argument);
+
+    // Sending after close() is a caller bug, not a link failure.
+    ReconnectingTransport transport(std::make_unique<FakeLink>(), fastRetries());
+    REQUIRE_THROWS_AS(transport.sendString("x"), std::runtime_error);
+}
+
+TEST_CASE("Sensor resends the metric dictionary after the transport reconnects", "[ReconnectingTransport]") {
+    auto owned = std::make_unique<FakeLink>();
+    FakeLink* link = owned.get();
+    SensorConfig config;
+    config.sensorId = "reconnect-01";
+    config.metricIds.enabled = true;
+    Sensor sensor(config, std::make_unique<ConstantDataSource>(),
+                  std::make_unique<ReconnectingTransport>(std::move(owned), fastRetries(), 7));
+
+    sensor.connect();
+    sensor.runOnce();
+    sensor.runOnce();
+    REQUIRE(link->delivered.size() == 2);
+    REQUIRE(link->delivered[0].find("\"dictionary\"") != std::string::npos);
+    REQUIRE(link->delivered[1].find("\"dictionary\"") == std::string::npos);
+
+    link->collectorUp = false;
+    sensor.runOnce();                 // lost; queued
+    link->collectorUp = true;
+    waitOutBackoff();
+    sensor.runOnce();                 // reconnects, replays behind the dictionary, sends the new sample
+    sensor.runOnce();                 // first sample encoded for the new session
+
+    // The replayed sample was encoded without the dictionary, so the new
+    // session starts with it on its own.
+    REQUIRE(link->delivered.size() == 6);
+    REQUIRE(link->delivered[2].find("\"dictionary\"") != std::string::npos);
+    REQUIRE(link->delivered[2].find("\"values\"") == std::string::npos);
+    REQUIRE(link->delivered[3].find("\"dictionary\"") == std::string::npos);
+    REQUIRE(link->delivered[5].find("\"dictionary\"") != std::string::npos);
+}
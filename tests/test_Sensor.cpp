@@ -6,12 +6,17 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #include "Sensor.hpp"
+#include "TcpTransport.hpp"
 #include "HardwareDataSource.hpp"
 #include "MockCamera.hpp"
 #include "ITransport.hpp"
 #include "ConfigTypes.hpp"
+#include "ConstantDataSource.hpp"
 #include "Logger.hpp"
 
 using json = nlohmann::json;
@@ -24,6 +29,7 @@ class DummyTransport : public ITransport {
 public:
     bool connected = false;
     std::string lastSent;
+    std::size_t sends = 0;
 
     void connect() override { connected = true; }
     void close() noexcept override { connected = false; }
@@ -31,6 +37,7 @@ public:
     // ✅ Return type now matches real ITransport
     std::size_t sendString(const std::string& data) override {
         lastSent = data;
+        ++sends;
         return data.size();
     }
 
@@ -44,7 +51,7 @@ public:
 TEST_CASE("Sensor constructor validates configuration", "[Sensor]") {
     SensorConfig cfg{};
     cfg.sensorId = "";
-    cfg.intervalSeconds = 1;
+    cfg.interval = std::chrono::seconds(1);
     cfg.metadata = {};  // map, not string
 
     std::shared_ptr<ICamera> camera = std::make_shared<MockCamera>();
@@ -54,7 +61,7 @@ TEST_CASE("Sensor constructor validates configuration", "[Sensor]") {
     REQUIRE_THROWS_AS(Sensor(cfg, std::move(ds), std::move(tx)), std::invalid_argument);
 
     cfg.sensorId = "unit_sensor";
-    cfg.intervalSeconds = 0;
+    cfg.interval = std::chrono::microseconds::zero();
     cfg.metadata = {};
     camera = std::make_shared<MockCamera>();
     ds = std::make_unique<HardwareDataSource>(camera);
@@ -66,7 +73,7 @@ TEST_CASE("Sensor constructor validates configuration", "[Sensor]") {
 TEST_CASE("Sensor runOnce builds a valid JSON payload", "[Sensor]") {
     SensorConfig cfg;
     cfg.sensorId = "mock_sensor";
-    cfg.intervalSeconds = 1;
+    cfg.interval = std::chrono::seconds(1);
     cfg.metadata = {{"environment", "unit-test"}};
     cfg.units = {
         {"frame_width", "px"},
@@ -103,7 +110,7 @@ TEST_CASE("Sensor runOnce builds a valid JSON payload", "[Sensor]") {
 TEST_CASE("Sensor connect and close update transport state", "[Sensor]") {
     SensorConfig cfg;
     cfg.sensorId = "sensor_test";
-    cfg.intervalSeconds = 1;
+    cfg.interval = std::chrono::seconds(1);
     cfg.metadata = {};
     cfg.units = {};
 
@@ -126,7 +133,7 @@ TEST_CASE("Sensor connect and close update transport state", "[Sensor]") {
 TEST_CASE("Sensor run loop executes and stops cleanly", "[Sensor]") {
     SensorConfig cfg;
     cfg.sensorId = "loop_sensor";
-    cfg.intervalSeconds = 1;
+    cfg.interval = std::chrono::seconds(1);
     cfg.metadata = {};
     cfg.units = {};
 
@@ -146,3 +153,284 @@ TEST_CASE("Sensor run loop executes and stops cleanly", "[Sensor]") {
 
     REQUIRE_FALSE(txPtr->lastSent.empty());
 }
+
+TEST_CASE("Sensor run loop keeps a millisecond cadence", "[Sensor]") {
+    SensorConfig cfg;
+    cfg.sensorId = "fast_sensor";
+    cfg.interval = std::chrono::milliseconds(2);
+
+    std::shared_ptr<ICamera> camera = std::make_shared<MockCamera>();
+    auto ds = std::make_unique<HardwareDataSource>(camera);
+    auto tx = std::make_unique<DummyTransport>();
+
+    Sensor sensor(cfg, std::move(ds), std::move(tx));
+
+    std::atomic<bool> running{true};
+    std::thread worker([&] { sensor.run(running); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    running = false;
+    worker.join();
+
+    // ~100 deadlines elapsed; leave generous room for a loaded CI machine.
+    const auto& stats = sensor.tickStats();
+    REQUIRE(stats.ticks + stats.skipped >= 50);
+    REQUIRE(stats.ticks + stats.skipped <= 110);
+}
+
+TEST_CASE("Sensor run loop with pipeline enabled sends payloads", "[Sensor]") {
+    SensorConfig cfg;
+    cfg.sensorId = "pipelined_sensor";
+    cfg.interval = std::chrono::milliseconds(5);
+    cfg.pipeline.enabled = true;
+
+    std::shared_ptr<ICamera> camera = std::make_shared<MockCamera>();
+    camera->open(0);
+    auto ds = std::make_unique<HardwareDataSource>(camera);
+    auto tx = std::make_unique<DummyTransport>();
+    DummyTransport* txPtr = tx.get();
+
+    Sensor sensor(cfg, std::move(ds), std::move(tx));
+
+    std::atomic<bool> running{true};
+    std::thread worker([&] { sensor.run(running); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    running = false;
+    worker.join();
+
+    REQUIRE_FALSE(txPtr->lastSent.empty());
+    json payload = json::parse(txPtr->lastSent);
+    REQUIRE(payload["sensor_id"] == "pipelined_sensor");
+
+    const PipelineStats stats = sensor.pipelineStats();
+    REQUIRE(stats.capture.processed > 0);
+    REQUIRE(stats.send.processed == stats.encode.processed);
+}
+
+TEST_CASE("Sensor runs against a data source without a camera", "[Sensor]") {
+    SensorConfig cfg;
+    cfg.sensorId = "headless_sensor";
+    cfg.units = {{"temperature", "C"}};
+
+    auto tx = std::make_unique<DummyTransport>();
+    DummyTransport* txPtr = tx.get();
+
+    Sensor sensor(cfg, std::make_unique<ConstantDataSource>(), std::move(tx));
+    sensor.runOnce();
+    sensor.runOnce();
+
+    json payload = json::parse(txPtr->lastSent);
+    REQUIRE(payload["sensor_id"] == "headless_sensor");
+    REQUIRE(payload["readings"].size() == 1);
+    REQUIRE(payload["readings"]["temperature"]["unit"] == "C");
+    REQUIRE_THAT(payload["readings"]["temperature"]["value"].get<double>(), WithinAbs(21.5, 0.0));
+}
+
+TEST_CASE("Sensor reloadConfig re-renders identity, metadata and units", "[Sensor]") {
+    SensorConfig cfg;
+    cfg.sensorId = "before";
+    cfg.metadata = {{"site", "a"}};
+
+    auto tx = std::make_unique<DummyTransport>();
+    DummyTransport* txPtr = tx.get();
+
+    Sensor sensor(cfg, std::make_unique<ConstantDataSource>(), std::move(tx));
+    sensor.runOnce();
+    REQUIRE(json::parse(txPtr->lastSent)["metadata"]["site"] == "a");
+
+    SensorConfig reloaded = cfg;
+    reloaded.sensorId = "after";
+    reloaded.metadata = {{"site", "b"}, {"rack", "7"}};
+    reloaded.units    = {{"temperature", "K"}};
+    sensor.reloadConfig(reloaded);
+    sensor.runOnce();
+
+    json payload = json::parse(txPtr->lastSent);
+    REQUIRE(payload["sensor_id"] == "after");
+    REQUIRE(payload["metadata"]["site"] == "b");
+    REQUIRE(payload["metadata"]["rack"] == "7");
+    REQUIRE(payload["readings"]["temperature"]["unit"] == "K");
+
+    reloaded.sensorId.clear();
+    REQUIRE_THROWS_AS(sensor.reloadConfig(reloaded), std::invalid_argument);
+}
+
+TEST_CASE("Sensor batching packs several samples into one send", "[Sensor]") {
+    SensorConfig cfg;
+    cfg.sensorId = "batched";
+    cfg.batch.enabled = true;
+    cfg.batch.maxSamples = 4;
+    cfg.batch.linger = std::chrono::hours(1);
+
+    auto tx = std::make_unique<DummyTransport>();
+    DummyTransport* txPtr = tx.get();
+
+    Sensor sensor(cfg, std::make_unique<ConstantDataSource>(), std::move(tx));
+    for (int tick = 0; tick < 8; ++tick) {
+        sensor.runOnce();
+    }
+
+    REQUIRE(txPtr->sends == 2);
+    std::size_t lines = 0;
+    for (const char cha : txPtr->lastSent) {
+        lines += cha == '\n' ? 1U : 0U;
+    }
+    REQUIRE(lines == 4);
+
+    const BatchStats stats = sensor.batchStats();
+    REQUIRE(stats.samples == 8);
+    REQUIRE_THAT(stats.sampleFillRatio(), WithinAbs(1.0, 1e-12));
+}
+
+TEST_CASE("Sensor run loop flushes a lingering batch between ticks", "[Sensor]") {
+    class CountingTransport : public DummyTransport {
+    public:
+        std::atomic<int> batches{0};
+        std::size_t sendString(const std::string& data) override {
+            batches.fetch_add(1);
+            return data.size();
+        }
+    };
+
+    SensorConfig cfg;
+    cfg.sensorId = "lingering";
+    cfg.interval = std::chrono::seconds(1);
+    cfg.batch.enabled = true;
+    cfg.batch.maxSamples = 100;
+    cfg.batch.linger = std::chrono::milliseconds(20);
+
+    auto tx = std::make_unique<CountingTransport>();
+    CountingTransport* txPtr = tx.get();
+
+    Sensor sensor(cfg, std::make_unique<ConstantDataSource>(), std::move(tx));
+    std::atomic<bool> running{true};
+    std::thread worker([&] { sensor.run(running); });
+
+    // The first tick's sample must not wait for the second tick (1 s away).
+    const auto giveUp = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while (txPtr->batches.load() == 0 && std::chrono::steady_clock::now() < giveUp) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    const int sentBeforeStop = txPtr->batches.load();
+    running = false;
+    worker.join();
+
+    REQUIRE(sentBeforeStop == 1);
+}
+
+
+//
+// ─── SENSOR OVER A NON-BLOCKING TCP LINK ────────────────────────────────────────
+//
+namespace {
+    // Loopback collector that accepts the sensor's connection and never reads.
+    struct StalledCollector {
+        explicit StalledCollector(uint16_t port) {
+            fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            int opt = 1;
+            ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = htons(port);
+            REQUIRE(::bind(fd, (sockaddr*)&addr, sizeof(addr)) == 0);
+            REQUIRE(::listen(fd, 1) == 0);
+        }
+        ~StalledCollector() { ::close(fd); }
+        int accept() const { return ::accept(fd, nullptr, nullptr); }
+        int fd{-1};
+    };
+
+    TcpOptions bufferedLinkOptions() {
+        TcpOptions options;
+        options.nonBlocking     = true;
+        options.writeTimeout    = std::chrono::milliseconds(0);   // a collector that never reads is not "stalled"
+        options.sendBufferBytes = 32U * 1024U * 1024U;
+        options.highWaterMark   = 8U * 1024U * 1024U;
+        options.lowWaterMark    = 1024U * 1024U;
+        return options;
+    }
+}
+
+TEST_CASE("Sensor keeps its cadence while a non-blocking TCP link stays buffered", "[Sensor]") {
+    const uint16_t testPort = 45683;
+    StalledCollector collector(testPort);
+
+    auto owned = std::make_unique<TcpTransport>("127.0.0.1", testPort, bufferedLinkOptions());
+    TcpTransport* transport = owned.get();
+
+    SensorConfig config;
+    config.sensorId = "buffered-01";
+    config.interval = std::chrono::milliseconds(5);
+    config.overrunPolicy = OverrunPolicy::SKIP;
+    Sensor sensor(config, std::make_unique<ConstantDataSource>(), std::move(owned));
+    sensor.connect();
+    const int peer = collector.accept();   // never reads
+
+    // Fill the kernel buffers, and then some, so every flush between ticks
+    // runs to its deadline.
+    const std::string chunk(64 * 1024, 'x');
+    while (transport->bufferedBytes() < 1024U * 1024U) {
+        transport->sendString(chunk);
+    }
+
+    // At the deployed log level: a debug line per tick written to a pipe
+    // wakes its reader, which on a single CPU preempts the loop.
+    Logger::instance().setMinLevel(LogLevel::INFO);
+    std::atomic<bool> running{true};
+    std::thread worker([&] { sensor.run(running); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    running = false;
+    worker.join();
+    Logger::instance().setMinLevel(LogLevel::DEBUG);
+
+    // Flushing between ticks never skips one. A preemption longer than a
+    // whole period still misses a deadline, whatever the loop does.
+    const TickStats& stats = sensor.tickStats();
+    REQUIRE(transport->bufferedBytes() > 0);
+    REQUIRE(stats.ticks >= 20);
+    if (stats.maxJitter < config.interval) {
+        REQUIRE(stats.skipped == 0);
+    }
+    sensor.close();
+    ::close(peer);
+}
+
+TEST_CASE("Sensor sheds samples while the TCP send buffer is above its high water mark", "[Sensor]") {
+    const uint16_t testPort = 45684;
+    StalledCollector collector(testPort);
+
+    TcpOptions options = bufferedLinkOptions();
+    options.highWaterMark = 1024U * 1024U;
+    options.lowWaterMark  = 0;
+    auto owned = std::make_unique<TcpTransport>("127.0.0.1", testPort, options);
+    TcpTransport* transport = owned.get();
+
+    SensorConfig config;
+    config.sensorId = "congested-01";
+    config.interval = std::chrono::milliseconds(5);
+    Sensor sensor(config, std::make_unique<ConstantDataSource>(), std::move(owned));
+    sensor.connect();
+    const int peer = collector.accept();   // never reads
+
+    const std::string chunk(64 * 1024, 'x');
+    while (!transport->congested()) {
+        transport->sendString(chunk);
+    }
+    const std::size_t buffered = transport->bufferedBytes();
+
+    std::atomic<bool> running{true};
+    std::thread worker([&] { sensor.run(running); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    running = false;
+    worker.join();
+
+    // Every tick was shed (the last one only released the loop): nothing more queued.
+    REQUIRE(sensor.tickStats().ticks >= 5);
+    REQUIRE(sensor.shedSamples() + 1 >= sensor.tickStats().ticks);
+    REQUIRE(transport->bufferedBytes() <= buffered);
+    REQUIRE(transport->congested());
+    sensor.close();
+    ::close(peer);
+}
@@ -0,0 +1,229 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SensorPipeline.hpp"
+#include "BoundedRing.hpp"
+#include "TickScheduler.hpp"
+#include "ConfigTypes.hpp"
+
+using namespace std::chrono_literals;
+
+// ---------------- BoundedRing ----------------
+
+TEST_CASE("SpscRing is FIFO and bounded", "[SpscRing]") {
+    SpscRing<int> ring(3);                 // rounded up to 4
+    REQUIRE(ring.capacity() == 4);
+
+    for (int value = 0; value < 4; ++value) {
+        REQUIRE(ring.tryPush(int{value}));
+    }
+    REQUIRE_FALSE(ring.tryPush(99));
+    REQUIRE(ring.sizeApprox() == 4);
+
+    int out = -1;
+    for (int expected = 0; expected < 4; ++expected) {
+        REQUIRE(ring.tryPop(out));
+        REQUIRE(out == expected);
+    }
+    REQUIRE_FALSE(ring.tryPop(out));
+    REQUIRE_THROWS_AS(SpscRing<int>(0), std::invalid_argument);
+}
+
+TEST_CASE("SpscRing tolerates producer-side eviction racing the consumer", "[SpscRing]") {
+    constexpr std::uint64_t kItems = 200000;
+    SpscRing<std::uint64_t> ring(8);
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        std::uint64_t evicted = 0;
+        for (std::uint64_t value = 1; value <= kItems; ++value) {
+            std::uint64_t item = value;
+            while (!ring.tryPush(std::move(item))) {
+                ring.tryPop(evicted);      // drop-oldest
+            }
+        }
+        done = true;
+    });
+
+    // Whatever survives must come out exactly once and in order.
+    std::uint64_t last = 0;
+    std::uint64_t value = 0;
+    bool ordered = true;
+    while (!done || ring.sizeApprox() > 0) {
+        if (ring.tryPop(value)) {
+            ordered = ordered && value > last;
+            last = value;
+        }
+    }
+    producer.join();
+    while (ring.tryPop(value)) {
+        ordered = ordered && value > last;
+        last = value;
+    }
+
+    REQUIRE(ordered);
+    REQUIRE(last == kItems);
+}
+
+TEST_CASE("MpscRing delivers every producer's entries once and in order", "[MpscRing]") {
+    constexpr int kProducers = 4;
+    constexpr std::uint64_t kItems = 50000;   // per producer
+    MpscRing<std::uint64_t> ring(16);
+
+    std::vector<std::thread> producers;
+    for (int id = 0; id < kProducers; ++id) {
+        producers.emplace_back([&ring, id] {
+            for (std::uint64_t value = 1; value <= kItems; ++value) {
+                const std::uint64_t tagged = static_cast<std::uint64_t>(id) << 32U | value;
+                while (!ring.tryEmplace([tagged](std::uint64_t& slot) { slot = tagged; })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<std::uint64_t> last(kProducers, 0);
+    std::uint64_t received = 0;
+    bool ordered = true;
+    while (received < kProducers * kItems) {
+        ring.tryConsume([&](std::uint64_t& tagged) {
+            const std::uint64_t value = tagged & 0xFFFFFFFFU;
+            std::uint64_t& previous = last[static_cast<std::size_t>(tagged >> 32U)];
+            ordered = ordered && value == previous + 1;
+            previous = value;
+            ++received;
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    REQUIRE(ordered);
+    REQUIRE(ring.sizeApprox() == 0);
+}
+
+// ---------------- SensorPipeline ----------------
+
+namespace {
+    PipelineConfig makePipelineConfig(QueuePolicy policy, std::size_t depth) {
+        PipelineConfig config;
+        config.enabled = true;
+        config.captureQueue = {depth, policy};
+        config.sendQueue    = {depth, policy};
+        return config;
+    }
+
+    void runFor(SensorPipeline& pipeline, TickScheduler& scheduler, std::chrono::milliseconds duration) {
+        std::atomic<bool> running{true};
+        std::thread stopper([&] {
+            std::this_thread::sleep_for(duration);
+            running = false;
+        });
+        pipeline.run(running, scheduler);
+        stopper.join();
+    }
+}
+
+TEST_CASE("SensorPipeline keeps capturing while the sender is slow", "[SensorPipeline]") {
+    std::atomic<int> sent{0};
+    SensorPipeline pipeline(
+        makePipelineConfig(QueuePolicy::DROP_OLDEST, 4),
+        [](Sample& sample) { sample.readings["value"] = 1.0; },
+        [](const Sample& sample, std::string& payload) { payload = std::to_string(sample.readings.size()); },
+        [&](const std::string&) {
+            std::this_thread::sleep_for(20ms);     // stalled collector
+            ++sent;
+        });
+
+    TickScheduler scheduler(2ms, OverrunPolicy::SKIP);
+    runFor(pipeline, scheduler, 300ms);
+
+    const PipelineStats stats = pipeline.stats();
+    // Capture ran at its own cadence (~150 ticks) even though only ~15 sends fit.
+    REQUIRE(stats.capture.processed >= 75);
+    REQUIRE(stats.send.processed == static_cast<std::uint64_t>(sent.load()));
+    REQUIRE(stats.send.processed < stats.capture.processed / 2);
+    REQUIRE(stats.capture.dropped + stats.encode.dropped > 0);
+    REQUIRE(stats.capture.processed ==
+            stats.capture.dropped + stats.encode.processed);
+    REQUIRE(stats.send.itemsPerBusySecond() < stats.capture.itemsPerBusySecond());
+}
+
+TEST_CASE("SensorPipeline with BLOCK policy delivers every sample in order", "[SensorPipeline]") {
+    std::int64_t nextId = 0;
+    std::vector<std::string> delivered;
+
+    SensorPipeline pipeline(
+        makePipelineConfig(QueuePolicy::BLOCK, 2),
+        [&](Sample& sample) { sample.timestampMs = nextId++; },
+        [](const Sample& sample, std::string& payload) { payload = std::to_string(sample.timestampMs); },
+        [&](const std::string& payload) {
+            std::this_thread::sleep_for(1ms);
+            delivered.push_back(payload);
+        });
+
+    TickScheduler scheduler(1ms, OverrunPolicy::SKIP);
+    runFor(pipeline, scheduler, 100ms);
+
+    const PipelineStats stats = pipeline.stats();
+    REQUIRE(stats.capture.dropped == 0);
+    REQUIRE(stats.encode.dropped == 0);
+    REQUIRE(delivered.size() == static_cast<std::size_t>(nextId));
+    for (std::size_t idx = 0; idx < delivered.size(); ++idx) {
+        REQUIRE(delivered[idx] == std::to_string(idx));
+    }
+}
+
+TEST_CASE("SensorPipeline DROP_NEWEST keeps the oldest samples", "[SensorPipeline]") {
+    std::atomic<bool> release{false};
+    std::vector<std::string> delivered;
+    std::int64_t nextId = 0;
+
+    PipelineConfig config = makePipelineConfig(QueuePolicy::DROP_NEWEST, 2);
+    config.sendQueue.depth = 16;     // only the capture queue should overflow
+
+    SensorPipeline pipeline(
+        config,
+        [&](Sample& sample) { sample.timestampMs = nextId++; },
+        [&](const Sample& sample, std::string& payload) {
+            while (!release) {
+                std::this_thread::sleep_for(1ms);   // hold the encoder until capture is done
+            }
+            payload = std::to_string(sample.timestampMs);
+        },
+        [&](const std::string& payload) { delivered.push_back(payload); });
+
+    TickScheduler scheduler(1ms, OverrunPolicy::SKIP);
+    std::atomic<bool> running{true};
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(50ms);
+        running = false;
+        release = true;
+    });
+    pipeline.run(running, scheduler);
+    stopper.join();
+
+    // Encoder held sample 0; the queue kept 1 and 2; everything newer was dropped.
+    REQUIRE(delivered == std::vector<std::string>{"0", "1", "2"});
+    REQUIRE(pipeline.stats().capture.dropped == static_cast<std::uint64_t>(nextId) - 3);
+    REQUIRE(pipeline.stats().encode.dropped == 0);
+}
+
+TEST_CASE("SensorPipeline rethrows a stage failure from run()", "[SensorPipeline]") {
+    SensorPipeline pipeline(
+        makePipelineConfig(QueuePolicy::DROP_OLDEST, 4),
+        [](Sample&) {},
+        [](const Sample&, std::string& payload) { payload = "x"; },
+        [](const std::string&) { throw std::runtime_error("send: connection closed by peer"); });
+
+    TickScheduler scheduler(1ms, OverrunPolicy::SKIP);
+    std::atomic<bool> running{true};
+    REQUIRE_THROWS_AS(pipeline.run(running, scheduler), std::runtime_error);
+    REQUIRE(running);   // the pipeline stopped on its own
+}
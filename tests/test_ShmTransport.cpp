@@ -0,0 +1,298 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ConfigTypes.hpp"
+#include "ConstBuffer.hpp"
+#include "ShmRing.hpp"
+#include "ShmTransport.hpp"
+#include "TcpTransport.hpp"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+    // Unique segment name, unlinked before and after the test.
+    struct TempShmName {
+        std::string name;
+        explicit TempShmName(const std::string& suffix)
+            : name("/sensor_test_" + std::to_string(::getpid()) + "_" + suffix) {
+            ShmRing::unlink(name);
+        }
+        ~TempShmName() { ShmRing::unlink(name); }
+    };
+
+    ShmRing::Clock::time_point in(std::chrono::milliseconds delay) { return ShmRing::Clock::now() + delay; }
+
+    bool writeString(ShmRing& ring, const std::string& message, ShmRing::Clock::time_point deadline) {
+        const ConstBuffer piece(message);
+        return ring.write(&piece, 1, deadline);
+    }
+}
+
+TEST_CASE("ShmRing delivers messages in order across many wraps", "[ShmTransport]") {
+    TempShmName shm("order");
+    ShmRing writer(shm.name, 4096);
+    ShmRing reader(shm.name, 0);
+    REQUIRE(writer.created());
+    REQUIRE_FALSE(reader.created());
+    REQUIRE(reader.capacity() == 4096);
+
+    // Odd sizes so that the wrap point moves around.
+    std::string out;
+    for (int idx = 0; idx < 2000; ++idx) {
+        const std::string message(static_cast<std::size_t>(idx % 700), static_cast<char>('a' + idx % 26));
+        REQUIRE(writeString(writer, message, in(0ms)));
+        if (idx % 3 == 2) {
+            for (int back = 2; back >= 0; --back) {
+                REQUIRE(reader.tryRead(out));
+                const int sent = idx - back;
+                REQUIRE(out == std::string(static_cast<std::size_t>(sent % 700), static_cast<char>('a' + sent % 26)));
+            }
+        }
+    }
+    REQUIRE(reader.tryRead(out));   // 1998 and 1999 are still queued
+    REQUIRE(out.size() == 1998 % 700);
+    REQUIRE(reader.tryRead(out));
+    REQUIRE(out.size() == 1999 % 700);
+    REQUIRE_FALSE(reader.tryRead(out));
+    REQUIRE(writer.bytesUsed() == 0);
+}
+
+TEST_CASE("ShmRing joins scatter-gather pieces and hands messages out in place", "[ShmTransport]") {
+    TempShmName shm("pieces");
+    ShmRing ring(shm.name, 4096);
+
+    const ConstBuffer pieces[] = {ConstBuffer(std::string_view("{\"t\":")), ConstBuffer(std::string_view("")),
+                                  ConstBuffer(std::string_view("21.5}"))};
+    REQUIRE(ring.write(pieces, 3, in(0ms)));
+
+    std::string seen;
+    REQUIRE(ring.tryConsume([&](std::string_view message) { seen = std::string(message); }));
+    REQUIRE(seen == "{\"t\":21.5}");
+    REQUIRE_FALSE(ring.tryConsume([](std::string_view) { FAIL("ring should be empty"); }));
+}
+
+TEST_CASE("ShmRing reports a full ring and rejects oversized messages", "[ShmTransport]") {
+    TempShmName shm("full");
+    ShmRing ring(shm.name, 4096);
+    const std::string message(1000, 'x');
+
+    int written = 0;
+    while (writeString(ring, message, in(0ms))) {
+        ++written;
+    }
+    REQUIRE(written == 4);   // 1008 bytes a record
+    REQUIRE_FALSE(writeString(ring, message, in(5ms)));
+
+    REQUIRE_THROWS_AS(writeString(ring, std::string(ring.maxMessageSize() + 1, 'x'), in(0ms)),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(ShmRing("no-slash", 4096), std::invalid_argument);
+}
+
+TEST_CASE("ShmRing wakes a blocked reader and a blocked writer", "[ShmTransport]") {
+    TempShmName shm("wake");
+    ShmRing writer(shm.name, 4096);
+    ShmRing reader(shm.name, 0);
+
+    std::string got;
+    std::thread consumer([&] { reader.readUntil(got, in(5000ms)); });
+    std::this_thread::sleep_for(20ms);   // let it go to sleep on the futex
+    REQUIRE(writeString(writer, "ping", in(0ms)));
+    consumer.join();
+    REQUIRE(got == "ping");
+
+    // Fill the ring, then let a reader free room while the writer waits.
+    const std::string message(1000, 'y');
+    while (writeString(writer, message, in(0ms))) {
+    }
+    std::thread drainer([&] {
+        std::this_thread::sleep_for(20ms);
+        std::string out;
+        reader.tryRead(out);
+    });
+    const auto begin = ShmRing::Clock::now();
+    REQUIRE(writeString(writer, message, in(5000ms)));
+    REQUIRE(ShmRing::Clock::now() - begin < 2000ms);
+    drainer.join();
+}
+
+TEST_CASE("ShmTransport sends into the ring and throws when the collector stalls", "[ShmTransport]") {
+    TempShmName shm("transport");
+    ShmOptions options;
+    options.name = shm.name;
+    options.capacityBytes = 4096;
+    options.writeTimeout = 10ms;
+
+    ShmTransport transport(options);
+    REQUIRE(transport.maxMessageSize() == 2048 - ShmRing::kLengthSize);
+    REQUIRE_THROWS_AS(transport.sendString("early"), std::runtime_error);
+
+    transport.connect();
+    REQUIRE(transport.isConnected());
+    REQUIRE(transport.sendString("hello") == 5);
+
+    ShmRing collector(shm.name, 0);
+    std::string out;
+    REQUIRE(collector.tryRead(out));
+    REQUIRE(out == "hello");
+
+    const std::string big(2000, 'z');
+    REQUIRE_THROWS_AS([&] {
+        for (int idx = 0; idx < 10; ++idx) {
+            transport.sendString(big);
+        }
+    }(), std::runtime_error);
+
+    // A restarted sensor appends after what is already queued.
+    transport.close();
+    REQUIRE_FALSE(transport.isConnected());
+    transport.connect();
+    REQUIRE(collector.tryRead(out));
+    REQUIRE(out == big);
+}
+
+// Run explicitly with: SensorTests "[ShmTransport][benchmark]"
+TEST_CASE("ShmTransport throughput and latency against TCP loopback", "[.][benchmark][ShmTransport]") {
+    constexpr std::size_t kMessageSize = 200;      // a typical JSON sample
+    constexpr std::size_t kThroughputMessages = 1000000;
+    constexpr std::size_t kLatencyMessages = 20000;
+    constexpr std::uint16_t kTcpPort = 50041;
+
+    const auto nowNs = [] {
+        return static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    };
+    std::string message(kMessageSize, 'm');
+    const auto stamp = [&] {
+        const std::int64_t sent = nowNs();
+        std::memcpy(message.data(), &sent, sizeof(sent));
+    };
+
+    struct Result {
+        double perSecond{0.0};
+        std::vector<std::int64_t> latencies;
+    };
+
+    // One run: 'send' in this thread, 'receiveAll' collecting 'count' messages in another.
+    const auto run = [&](auto&& send, auto&& receiveAll, std::size_t count, bool paced) {
+        Result result;
+        result.latencies.reserve(count);
+        std::thread receiver([&] { receiveAll(count, result.latencies); });
+        const auto begin = std::chrono::steady_clock::now();
+        for (std::size_t idx = 0; idx < count; ++idx) {
+            stamp();
+            send(message);
+            if (paced) {
+                const auto until = std::chrono::steady_clock::now() + 20us;
+                while (std::chrono::steady_clock::now() < until) {
+                }
+            }
+        }
+        receiver.join();
+        result.perSecond = static_cast<double>(count) /
+                           std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return result;
+    };
+    const auto report = [](const char* label, Result& throughput, Result& latency) {
+        std::sort(latency.latencies.begin(), latency.latencies.end());
+        const auto percentile = [&](double pct) {
+            return latency.latencies[static_cast<std::size_t>(pct * static_cast<double>(latency.latencies.size() - 1))];
+        };
+        WARN(label << throughput.perSecond << " msgs/s; one-way latency p50 " << percentile(0.5) / 1000.0
+             << " us, p99 " << percentile(0.99) / 1000.0 << " us");
+    };
+
+    // ----- shared memory -----
+    {
+        TempShmName shm("benchmark");
+        ShmOptions options;
+        options.name = shm.name;
+        options.capacityBytes = 1024 * 1024;
+        ShmTransport transport(options);
+        transport.connect();
+        ShmRing collector(shm.name, 0);
+
+        const auto receiveAll = [&](std::size_t count, std::vector<std::int64_t>& latencies) {
+            std::size_t received = 0;
+            while (received < count) {
+                const bool got = collector.tryConsume([&](std::string_view view) {
+                    std::int64_t sent = 0;
+                    std::memcpy(&sent, view.data(), sizeof(sent));
+                    latencies.push_back(nowNs() - sent);
+                });
+                if (got) {
+                    ++received;
+                } else {
+                    collector.waitReadable(ShmRing::Clock::now() + 100ms);
+                }
+            }
+        };
+        const auto send = [&](const std::string& payload) { transport.sendString(payload); };
+        Result throughput = run(send, receiveAll, kThroughputMessages, false);
+        Result latency = run(send, receiveAll, kLatencyMessages, true);
+        report("shm ring:     ", throughput, latency);
+    }
+
+    // ----- TCP loopback -----
+    {
+        const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(kTcpPort);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        REQUIRE(::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+        REQUIRE(::listen(listener, 1) == 0);
+
+        TcpTransport transport("127.0.0.1", kTcpPort);
+        transport.connect();
+        const int peer = ::accept(listener, nullptr, nullptr);
+        REQUIRE(peer >= 0);
+
+        const auto receiveAll = [&](std::size_t count, std::vector<std::int64_t>& latencies) {
+            std::vector<char> buffer(64 * 1024);
+            std::size_t have = 0;
+            std::size_t received = 0;
+            while (received < count) {
+                const ssize_t got = ::recv(peer, buffer.data() + have, buffer.size() - have, 0);
+                if (got <= 0) {
+                    return;
+                }
+                have += static_cast<std::size_t>(got);
+                std::size_t offset = 0;
+                for (; have - offset >= kMessageSize; offset += kMessageSize) {
+                    std::int64_t sent = 0;
+                    std::memcpy(&sent, buffer.data() + offset, sizeof(sent));
+                    latencies.push_back(nowNs() - sent);
+                    ++received;
+                }
+                std::memmove(buffer.data(), buffer.data() + offset, have - offset);
+                have -= offset;
+            }
+        };
+        const auto send = [&](const std::string& payload) { transport.sendString(payload); };
+        Result throughput = run(send, receiveAll, kThroughputMessages, false);
+        Result latency = run(send, receiveAll, kLatencyMessages, true);
+        report("tcp loopback: ", throughput, latency);
+
+        transport.close();
+        ::close(peer);
+        ::close(listener);
+    }
+}
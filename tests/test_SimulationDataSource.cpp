@@ -0,0 +1,185 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "SimulationDataSource.hpp"
+#include "ConfigTypes.hpp"
+#include "IDataSource.hpp"
+#include "Xoshiro256.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+    MetricRule rangeRule(double min, double max, double badProbability = 0.0) {
+        MetricRule rule;
+        rule.hasRange = true;
+        rule.min = min;
+        rule.max = max;
+        rule.badProbability = badProbability;
+        return rule;
+    }
+
+    MetricRule fixedRule(double value) {
+        MetricRule rule;
+        rule.hasFixed = true;
+        rule.fixed = value;
+        return rule;
+    }
+
+    DataSourceConfig sampleConfig() {
+        DataSourceConfig config;
+        config.metrics["temperature"] = rangeRule(0.0, 120.0, 0.03);
+        config.metrics["humidity"]    = rangeRule(20.0, 60.0);
+        config.metrics["firmware"]    = fixedRule(3.0);
+        return config;
+    }
+
+    bool inRange(double value, const MetricRule& rule) {
+        return value >= rule.min && value <= rule.max;
+    }
+}
+
+TEST_CASE("Xoshiro256 unit doubles stay in [0, 1)", "[SimulationDataSource]") {
+    Xoshiro256 rng(42);
+    std::vector<double> values(1003);
+    rng.fillUniform(values.data(), values.size(), 0.0, 1.0);
+
+    double sum = 0.0;
+    for (double value : values) {
+        REQUIRE(value >= 0.0);
+        REQUIRE(value < 1.0);
+        sum += value;
+    }
+    REQUIRE_THAT(sum / static_cast<double>(values.size()), WithinAbs(0.5, 0.05));
+}
+
+TEST_CASE("SimulationDataSource readAll honours fixed and ranged rules", "[SimulationDataSource]") {
+    const DataSourceConfig config = sampleConfig();
+    SimulationDataSource source(config, 7);
+
+    for (int idx = 0; idx < 200; ++idx) {
+        const Readings values = source.readAll();
+        REQUIRE(values.size() == 3);
+        REQUIRE(values.at("firmware") == 3.0);
+        REQUIRE(inRange(values.at("humidity"), config.metrics.at("humidity")));
+    }
+}
+
+TEST_CASE("SimulationDataSource readInto keeps exactly its own metrics", "[SimulationDataSource]") {
+    SimulationDataSource source(sampleConfig(), 7);
+    Readings values{{"stale", 1.0}};
+
+    source.readInto(values);
+    REQUIRE(values.size() == 3);
+    REQUIRE(values.count("stale") == 0);
+}
+
+TEST_CASE("SimulationDataSource batches are sorted, sized and deterministic", "[SimulationDataSource]") {
+    SimulationDataSource first(sampleConfig(), 1234);
+    SimulationDataSource second(sampleConfig(), 1234);
+    SampleBatch batchA;
+    SampleBatch batchB;
+
+    REQUIRE(first.readBatch(batchA, 1000) == 1000);
+    REQUIRE(second.readBatch(batchB, 1000) == 1000);
+
+    REQUIRE(batchA.names == std::vector<std::string>{"firmware", "humidity", "temperature"});
+    REQUIRE(batchA.rows == 1000);
+    for (const auto& column : batchA.columns) {
+        REQUIRE(column.size() == 1000);
+    }
+    REQUIRE(batchA.columns == batchB.columns);
+
+    for (double value : batchA.columns[0]) {
+        REQUIRE(value == 3.0);
+    }
+    for (double value : batchA.columns[1]) {
+        REQUIRE(inRange(value, rangeRule(20.0, 60.0)));
+    }
+
+    // Shrinking reuses the layout.
+    REQUIRE(first.readBatch(batchA, 10) == 10);
+    REQUIRE(batchA.names.size() == 3);
+    REQUIRE(batchA.columns[2].size() == 10);
+}
+
+TEST_CASE("SimulationDataSource emits outliers at the configured rate", "[SimulationDataSource]") {
+    DataSourceConfig config;
+    config.metrics["pressure"] = rangeRule(990.0, 1025.0, 0.05);
+    SimulationDataSource source(config, 99);
+
+    constexpr std::size_t kSamples = 200000;
+    SampleBatch batch;
+    source.readBatch(batch, kSamples);
+
+    std::size_t outliers = 0;
+    for (double value : batch.columns[0]) {
+        if (!inRange(value, config.metrics.at("pressure"))) {
+            ++outliers;
+        }
+    }
+    const double rate = static_cast<double>(outliers) / static_cast<double>(kSamples);
+    REQUIRE_THAT(rate, WithinAbs(0.05, 0.005));
+
+    // The per-sample path follows the same rule.
+    std::size_t singleOutliers = 0;
+    for (int idx = 0; idx < 20000; ++idx) {
+        if (!inRange(source.readAll().at("pressure"), config.metrics.at("pressure"))) {
+            ++singleOutliers;
+        }
+    }
+    REQUIRE_THAT(static_cast<double>(singleOutliers) / 20000.0, WithinAbs(0.05, 0.01));
+}
+
+TEST_CASE("SimulationDataSource probability 1 makes every value an outlier", "[SimulationDataSource]") {
+    DataSourceConfig config;
+    config.metrics["level"] = rangeRule(5.0, 5.0, 1.0);
+    SimulationDataSource source(config, 3);
+
+    SampleBatch batch;
+    source.readBatch(batch, 64);
+    for (double value : batch.columns[0]) {
+        REQUIRE(value != 5.0);
+    }
+}
+
+TEST_CASE("SimulationDataSource rejects invalid configs", "[SimulationDataSource]") {
+    REQUIRE_THROWS_AS(SimulationDataSource(DataSourceConfig{}, 1), std::invalid_argument);
+
+    DataSourceConfig inverted;
+    inverted.metrics["x"] = rangeRule(10.0, 1.0);
+    REQUIRE_THROWS_AS(SimulationDataSource(inverted, 1), std::invalid_argument);
+
+    DataSourceConfig empty;
+    empty.metrics["x"] = MetricRule{};
+    REQUIRE_THROWS_AS(SimulationDataSource(empty, 1), std::invalid_argument);
+
+    DataSourceConfig badProbability;
+    badProbability.metrics["x"] = rangeRule(0.0, 1.0, 1.5);
+    REQUIRE_THROWS_AS(SimulationDataSource(badProbability, 1), std::invalid_argument);
+}
+
+// Run explicitly with: SensorTests "[benchmark]"
+TEST_CASE("SimulationDataSource batch throughput", "[.][benchmark]") {
+    SimulationDataSource source(sampleConfig(), 5);
+    SampleBatch batch;
+    constexpr std::size_t kBatch = 4096;
+    constexpr int kRounds = 2000;
+
+    const auto begin = std::chrono::steady_clock::now();
+    std::size_t samples = 0;
+    for (int round = 0; round < kRounds; ++round) {
+        samples += source.readBatch(batch, kBatch);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    WARN("samples/s: " << static_cast<double>(samples) / seconds);
+    REQUIRE(samples == kBatch * kRounds);
+}
@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+#include <opencv2/core.hpp>
+
+#include "SnapshotWriter.hpp"
+#include "ConfigTypes.hpp"
+#include "HardwareDataSource.hpp"
+#include "MockCamera.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+
+    bool fileExists(const std::string& path) {
+        return static_cast<bool>(std::ifstream(path));
+    }
+
+    SnapshotConfig snapshotConfig(const std::string& path) {
+        SnapshotConfig config;
+        config.enabled = true;
+        config.path = path;
+        config.format = "png";
+        return config;
+    }
+}
+
+TEST_CASE("SnapshotWriter honours the frame rate limit", "[SnapshotWriter]") {
+    const std::string path = "snapshot_every_frames.png";
+    std::remove(path.c_str());
+
+    SnapshotConfig config = snapshotConfig(path);
+    config.everyFrames = 3;
+
+    const cv::Mat frame(4, 4, CV_8UC3, cv::Scalar(1, 2, 3));
+    std::uint64_t offered = 0;
+    {
+        SnapshotWriter writer(config);
+        for (int idx = 0; idx < 7; ++idx) {
+            if (writer.offer(frame)) {
+                ++offered;
+            }
+            // Let the writer drain so "busy" skips don't blur the rate check.
+            while (writer.stats().written + writer.stats().failed < offered) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        REQUIRE(writer.stats().written == offered);
+    }
+
+    REQUIRE(offered == 3);   // frames 1, 4 and 7
+    REQUIRE(fileExists(path));
+    REQUIRE_FALSE(fileExists(path + ".tmp"));
+    std::remove(path.c_str());
+}
+
+TEST_CASE("SnapshotWriter honours the time rate limit", "[SnapshotWriter]") {
+    const std::string path = "snapshot_every_time.png";
+    SnapshotConfig config = snapshotConfig(path);
+    config.every = std::chrono::hours(1);
+
+    const cv::Mat frame(4, 4, CV_8UC3, cv::Scalar(1, 2, 3));
+    {
+        SnapshotWriter writer(config);
+        REQUIRE(writer.offer(frame));          // first frame is always taken
+        REQUIRE_FALSE(writer.offer(frame));    // next one is an hour away
+    }
+    REQUIRE(fileExists(path));
+    std::remove(path.c_str());
+}
+
+TEST_CASE("SnapshotWriter rejects unusable configs", "[SnapshotWriter]") {
+    SnapshotConfig noLimit = snapshotConfig("x.png");
+    REQUIRE_THROWS_AS(SnapshotWriter(noLimit), std::invalid_argument);
+
+    SnapshotConfig badFormat = snapshotConfig("x.gif");
+    badFormat.format = "gif";
+    badFormat.everyFrames = 1;
+    REQUIRE_THROWS_AS(SnapshotWriter(badFormat), std::invalid_argument);
+
+    SnapshotConfig badQuality = snapshotConfig("x.jpg");
+    badQuality.format = "jpg";
+    badQuality.everyFrames = 1;
+    badQuality.jpegQuality = 0;
+    REQUIRE_THROWS_AS(SnapshotWriter(badQuality), std::invalid_argument);
+}
+
+TEST_CASE("HardwareDataSource writes no snapshot unless enabled", "[SnapshotWriter]") {
+    std::remove("last_frame.jpg");
+
+    std::shared_ptr<ICamera> camera = std::make_shared<MockCamera>();
+    camera->open(0);
+    HardwareDataSource ds(camera);
+    ds.readAll();
+
+    REQUIRE_FALSE(fileExists("last_frame.jpg"));
+}
+
+TEST_CASE("HardwareDataSource hands frames to an enabled snapshot writer", "[SnapshotWriter]") {
+    const std::string path = "snapshot_datasource.jpg";
+    std::remove(path.c_str());
+
+    SnapshotConfig config = snapshotConfig(path);
+    config.format = "jpg";
+    config.everyFrames = 100;
+
+    std::shared_ptr<ICamera> camera = std::make_shared<MockCamera>();
+    camera->open(0);
+    {
+        HardwareDataSource ds(camera, config);
+        ds.readAll();
+    }
+
+    REQUIRE(fileExists(path));
+    std::remove(path.c_str());
+}
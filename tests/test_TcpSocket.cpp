@@ -9,10 +9,14 @@
  */
 
 #include "TcpSocket.hpp"
+#include "ConfigTypes.hpp"
 #include <catch2/catch_all.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
+#include <chrono>
+#include <string>
 #include <thread>
+#include <vector>
 #include <netinet/in.h>
 #include <unistd.h>
 
@@ -35,6 +39,33 @@ static void runDummyServer(uint16_t port) {
     ::close(server_fd);
 }
 
+// Accepts one connection and returns everything the client wrote before closing.
+static std::string runRecordingServer(uint16_t port) {
+    int server_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    int opt = 1;
+    ::setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_port = htons(port);
+    ::bind(server_fd, (sockaddr*)&addr, sizeof(addr));
+    ::listen(server_fd, 1);
+
+    std::string received;
+    int client_fd = ::accept(server_fd, nullptr, nullptr);
+    if (client_fd >= 0) {
+        char buf[4096];
+        ssize_t n = 0;
+        while ((n = ::read(client_fd, buf, sizeof(buf))) > 0) {
+            received.append(buf, static_cast<std::size_t>(n));
+        }
+        ::close(client_fd);
+    }
+    ::close(server_fd);
+    return received;
+}
+
 TEST_CASE("TcpSocket connects and sends", "[TcpSocket]") {
     const uint16_t testPort = 45678;
 
@@ -73,3 +104,174 @@ TEST_CASE("TcpSocket throws when sending without connect", "[TcpSocket]") {
     TcpSocket client("127.0.0.1", 12345);
     REQUIRE_THROWS_WITH(client.sendString("fail"), "send: not connected");
 }
+
+TEST_CASE("TcpSocket sendBuffers writes every piece in order", "[TcpSocket]") {
+    const uint16_t testPort = 45679;
+
+    std::string received;
+    std::thread serverThread([&] { received = runRecordingServer(testPort); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // More pieces than one writev() window, some empty, some large enough
+    // that the kernel takes them in several partial writes.
+    std::vector<std::string> parts;
+    std::string expected;
+    for (int i = 0; i < 300; ++i) {
+        if (i % 50 == 0) {
+            parts.emplace_back(200000, static_cast<char>('a' + i % 26));
+        } else {
+            parts.push_back(i % 9 == 0 ? std::string() : std::to_string(i) + ",");
+        }
+        expected += parts.back();
+    }
+    std::vector<ConstBuffer> pieces(parts.begin(), parts.end());
+
+    TcpSocket client("127.0.0.1", testPort);
+    REQUIRE_NOTHROW(client.connect());
+    REQUIRE(client.sendBuffers(pieces.data(), pieces.size()) == expected.size());
+    REQUIRE(client.sendBuffers(nullptr, 0) == 0);
+    client.close();
+
+    serverThread.join();
+    REQUIRE(received == expected);
+}
+
+TEST_CASE("TcpSocket sendBuffers throws when not connected", "[TcpSocket]") {
+    TcpSocket client("127.0.0.1", 12345);
+    const ConstBuffer piece(std::string_view("fail"));
+    REQUIRE_THROWS_WITH(client.sendBuffers(&piece, 1), "send: not connected");
+}
+
+namespace {
+
+    // Listens on 'port'; accept() hands back the connected fd (or -1).
+    struct Listener {
+        explicit Listener(uint16_t port) {
+            fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            int opt = 1;
+            ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = htons(port);
+            REQUIRE(::bind(fd, (sockaddr*)&addr, sizeof(addr)) == 0);
+            REQUIRE(::listen(fd, 1) == 0);
+        }
+        ~Listener() { ::close(fd); }
+        int accept() const { return ::accept(fd, nullptr, nullptr); }
+        int fd{-1};
+    };
+
+    TcpOptions nonBlockingOptions() {
+        TcpOptions options;
+        options.nonBlocking     = true;
+        options.writeTimeout    = std::chrono::milliseconds(2000);
+        options.sendBufferBytes = 32U * 1024U * 1024U;
+        options.highWaterMark   = 8U * 1024U * 1024U;
+        options.lowWaterMark    = 1024U * 1024U;
+        return options;
+    }
+}
+
+TEST_CASE("TcpSocket rejects inconsistent non-blocking options", "[TcpSocket]") {
+    TcpOptions options = nonBlockingOptions();
+    options.lowWaterMark = options.highWaterMark + 1;
+    REQUIRE_THROWS_AS(TcpSocket("127.0.0.1", 1, options), std::invalid_argument);
+
+    options = nonBlockingOptions();
+    options.highWaterMark = options.sendBufferBytes + 1;
+    REQUIRE_THROWS_AS(TcpSocket("127.0.0.1", 1, options), std::invalid_argument);
+}
+
+TEST_CASE("TcpSocket non-blocking mode buffers for a slow reader and signals water marks", "[TcpSocket]") {
+    const uint16_t testPort = 45680;
+    Listener listener(testPort);
+
+    TcpSocket client("127.0.0.1", testPort, nonBlockingOptions());
+    std::size_t highAt = 0;
+    std::size_t lowAt = 0;
+    client.onHighWater([&](std::size_t buffered) { highAt = buffered; });
+    client.onLowWater([&](std::size_t buffered) { lowAt = buffered; });
+    REQUIRE_NOTHROW(client.connect());
+    const int peer = listener.accept();
+    REQUIRE(peer >= 0);
+
+    // The peer reads nothing yet: the kernel buffers fill up, the rest
+    // queues in user space and send() still returns straight away.
+    std::string expected;
+    const std::string chunk(64 * 1024, 'x');
+    for (int i = 0; i < 320; ++i) {
+        std::string message = std::to_string(i) + ":" + chunk;
+        expected += message;
+        REQUIRE(client.sendString(message) == message.size());
+    }
+    REQUIRE(client.bufferedBytes() > 0);
+    REQUIRE(client.aboveHighWater());
+    REQUIRE(highAt >= nonBlockingOptions().highWaterMark);
+
+    // Now the peer catches up; the event loop drains the buffer in order.
+    std::string received;
+    std::thread reader([&] {
+        char buf[65536];
+        ssize_t n = 0;
+        while ((n = ::read(peer, buf, sizeof(buf))) > 0) {
+            received.append(buf, static_cast<std::size_t>(n));
+        }
+    });
+    REQUIRE(client.flushUntil(TcpSocket::Clock::now() + std::chrono::seconds(10)));
+    REQUIRE(client.bufferedBytes() == 0);
+    REQUIRE_FALSE(client.aboveHighWater());
+    REQUIRE(lowAt <= nonBlockingOptions().lowWaterMark);
+
+    client.close();
+    reader.join();
+    ::close(peer);
+    REQUIRE(received == expected);
+}
+
+TEST_CASE("TcpSocket non-blocking send times out on a stalled collector", "[TcpSocket]") {
+    const uint16_t testPort = 45681;
+    Listener listener(testPort);
+
+    TcpOptions options = nonBlockingOptions();
+    options.sendBufferBytes = 1024U * 1024U;
+    options.highWaterMark   = 512U * 1024U;
+    options.lowWaterMark    = 0;
+    options.writeTimeout    = std::chrono::milliseconds(200);
+
+    TcpSocket client("127.0.0.1", testPort, options);
+    REQUIRE_NOTHROW(client.connect());
+    const int peer = listener.accept();   // never reads
+
+    const std::string chunk(64 * 1024, 'y');
+    const auto begin = std::chrono::steady_clock::now();
+    bool timedOut = false;
+    for (int i = 0; i < 100000 && !timedOut; ++i) {
+        try {
+            client.sendString(chunk);
+        } catch (const std::runtime_error& error) {
+            REQUIRE_THAT(error.what(), Catch::Matchers::ContainsSubstring("timed out"));
+            timedOut = true;
+        }
+    }
+    REQUIRE(timedOut);
+    REQUIRE_FALSE(client.isConnected());
+    REQUIRE(std::chrono::steady_clock::now() - begin < std::chrono::seconds(5));
+    ::close(peer);
+}
+
+TEST_CASE("TcpSocket blocking send honours the write timeout", "[TcpSocket]") {
+    const uint16_t testPort = 45682;
+    Listener listener(testPort);
+
+    TcpOptions options;
+    options.writeTimeout = std::chrono::milliseconds(200);
+    TcpSocket client("127.0.0.1", testPort, options);
+    REQUIRE_NOTHROW(client.connect());
+    const int peer = listener.accept();   // never reads
+
+    const std::string big(64U * 1024U * 1024U, 'z');   // far more than the kernel buffers
+    REQUIRE_THROWS_WITH(client.sendString(big), "send: write timed out");
+    REQUIRE_FALSE(client.isConnected());
+    ::close(peer);
+}
@@ -0,0 +1,137 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+#include "TickScheduler.hpp"
+#include "ConfigTypes.hpp"
+
+using namespace std::chrono_literals;
+
+TEST_CASE("TickScheduler rejects non-positive periods", "[TickScheduler]") {
+    REQUIRE_THROWS_AS(TickScheduler(0ns, OverrunPolicy::SKIP), std::invalid_argument);
+    REQUIRE_THROWS_AS(TickScheduler(-5ms, OverrunPolicy::CATCH_UP), std::invalid_argument);
+}
+
+TEST_CASE("TickScheduler releases ticks on an absolute grid", "[TickScheduler]") {
+    constexpr auto period = 20ms;
+    TickScheduler scheduler(period, OverrunPolicy::SKIP);
+    scheduler.start();
+
+    const auto first = scheduler.waitNext();
+    for (int tick = 1; tick <= 5; ++tick) {
+        // Work shorter than the period must not shift the following deadlines.
+        std::this_thread::sleep_for(5ms);
+        const auto deadline = scheduler.waitNext();
+        REQUIRE(deadline - first == period * tick);
+        REQUIRE(TickScheduler::Clock::now() >= deadline);
+    }
+
+    const auto& stats = scheduler.stats();
+    REQUIRE(stats.ticks == 6);
+    REQUIRE(stats.overruns == 0);
+    REQUIRE(stats.skipped == 0);
+    REQUIRE(stats.maxJitter >= stats.meanJitter());
+}
+
+TEST_CASE("TickScheduler SKIP drops missed deadlines and keeps phase", "[TickScheduler]") {
+    constexpr auto period = 20ms;
+    TickScheduler scheduler(period, OverrunPolicy::SKIP);
+    scheduler.start();
+
+    const auto first = scheduler.waitNext();
+    std::this_thread::sleep_for(50ms);   // overrun: deadlines at +20ms and +40ms are missed
+    const auto next = scheduler.waitNext();
+
+    REQUIRE(next - first == period * 3);
+    REQUIRE(scheduler.stats().overruns == 1);
+    REQUIRE(scheduler.stats().skipped == 2);
+    REQUIRE(scheduler.stats().ticks == 2);
+}
+
+TEST_CASE("TickScheduler releases a tick late, not skipped, when idle work overruns", "[TickScheduler]") {
+    constexpr auto period = 20ms;
+    TickScheduler scheduler(period, OverrunPolicy::SKIP);
+    scheduler.start();
+
+    const auto first = scheduler.waitNext();
+    std::this_thread::sleep_for(5ms);   // the tick's work
+    const auto idleSince = TickScheduler::Clock::now();
+    std::this_thread::sleep_for(30ms);  // idle work that ends 15 ms past the deadline
+    const auto next = scheduler.waitNext(idleSince);
+
+    REQUIRE(next - first == period);
+    REQUIRE(scheduler.stats().overruns == 0);
+    REQUIRE(scheduler.stats().skipped == 0);
+    REQUIRE(scheduler.stats().lastJitter >= 10ms);
+}
+
+TEST_CASE("TickScheduler CATCH_UP releases missed deadlines back-to-back", "[TickScheduler]") {
+    constexpr auto period = 20ms;
+    TickScheduler scheduler(period, OverrunPolicy::CATCH_UP);
+    scheduler.start();
+
+    const auto first = scheduler.waitNext();
+    std::this_thread::sleep_for(50ms);
+
+    // The two missed deadlines come out immediately, in order.
+    const auto second = scheduler.waitNext();
+    const auto third  = scheduler.waitNext();
+    REQUIRE(second - first == period);
+    REQUIRE(third - first == period * 2);
+    REQUIRE(scheduler.stats().overruns == 2);
+    REQUIRE(scheduler.stats().skipped == 0);
+    REQUIRE(scheduler.stats().maxJitter >= 10ms);
+
+    // Back on schedule: the next deadline lies in the future again.
+    const auto fourth = scheduler.waitNext();
+    REQUIRE(fourth - first == period * 3);
+    REQUIRE(scheduler.stats().overruns == 2);
+}
+
+TEST_CASE("TickScheduler start() resets statistics", "[TickScheduler]") {
+    TickScheduler scheduler(1ms, OverrunPolicy::SKIP);
+    scheduler.start();
+    scheduler.waitNext();
+    scheduler.waitNext();
+    REQUIRE(scheduler.stats().ticks == 2);
+
+    scheduler.start();
+    REQUIRE(scheduler.stats().ticks == 0);
+    REQUIRE(scheduler.stats().maxJitter == 0ns);
+}
+
+#ifdef __linux__
+TEST_CASE("TickScheduler stop() restores the thread's timer slack", "[TickScheduler]") {
+    // Timer slack is per thread: run on a fresh one with a known value.
+    int before = 0;
+    int lowered = 0;
+    int afterRestart = 0;
+    int afterStop = 0;
+    int afterSecondStop = 0;
+    std::thread loop([&] {
+        (void)::prctl(PR_SET_TIMERSLACK, 50000UL);
+        before = ::prctl(PR_GET_TIMERSLACK);
+
+        TickScheduler scheduler(1ms, OverrunPolicy::SKIP);
+        scheduler.start();
+        lowered = ::prctl(PR_GET_TIMERSLACK);
+        scheduler.start();                    // a restart keeps the first saved value
+        afterRestart = ::prctl(PR_GET_TIMERSLACK);
+        scheduler.stop();
+        afterStop = ::prctl(PR_GET_TIMERSLACK);
+        scheduler.stop();                     // nothing left to restore
+        afterSecondStop = ::prctl(PR_GET_TIMERSLACK);
+    });
+    loop.join();
+
+    REQUIRE(before == 50000);
+    REQUIRE(lowered == 1);
+    REQUIRE(afterRestart == 1);
+    REQUIRE(afterStop == 50000);
+    REQUIRE(afterSecondStop == 50000);
+}
+#endif
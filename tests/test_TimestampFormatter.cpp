@@ -0,0 +1,121 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ConfigTypes.hpp"
+#include "TimestampFormatter.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+namespace {
+
+    // 2023-11-14 22:13:20.123456789 UTC
+    constexpr std::int64_t kSample = 1700000000123456789;
+    constexpr std::int64_t kSecond = 1000000000;
+
+    std::string format(TimestampFormatter& formatter, std::int64_t timeNs) {
+        std::array<char, TimestampFormatter::kMaxLength> out{};
+        return {out.data(), formatter.format(timeNs, out.data())};
+    }
+
+    // What the Logger printed before the cache: localtime + strftime, every call.
+    std::string referenceLocal(std::int64_t timeNs) {
+        const auto seconds = static_cast<std::time_t>(timeNs / kSecond);
+        std::tm parts{};
+        std::array<char, 32> buf{};
+        localtime_r(&seconds, &parts);
+        return {buf.data(), std::strftime(buf.data(), buf.size(), "%Y-%m-%d %H:%M:%S", &parts)};
+    }
+}
+
+TEST_CASE("TimestampFormatter renders ISO-8601 UTC at each precision", "[TimestampFormatter]") {
+    TimestampFormatter seconds(TimestampPrecision::SECONDS, true);
+    TimestampFormatter millis(TimestampPrecision::MILLISECONDS, true);
+    TimestampFormatter micros(TimestampPrecision::MICROSECONDS, true);
+
+    REQUIRE(format(seconds, kSample) == "2023-11-14T22:13:20Z");
+    REQUIRE(format(millis, kSample) == "2023-11-14T22:13:20.123Z");
+    REQUIRE(format(micros, kSample) == "2023-11-14T22:13:20.123456Z");
+    REQUIRE(format(micros, kSample + 876543000) == "2023-11-14T22:13:20.999999Z");
+    REQUIRE(format(millis, 0) == "1970-01-01T00:00:00.000Z");
+    REQUIRE(format(millis, -1) == "1969-12-31T23:59:59.999Z");
+}
+
+TEST_CASE("TimestampFormatter matches strftime in local time across second changes", "[TimestampFormatter]") {
+    TimestampFormatter local;
+    TimestampFormatter localMillis(TimestampPrecision::MILLISECONDS, false);
+
+    // Forward, within the same second, and back again: the cache must follow.
+    for (const std::int64_t timeNs : {kSample, kSample + 1000, kSample + kSecond, kSample + 86400 * kSecond, kSample}) {
+        REQUIRE(format(local, timeNs) == referenceLocal(timeNs));
+        REQUIRE(format(localMillis, timeNs) == referenceLocal(timeNs) + "." +
+                                                   std::to_string(timeNs / 1000000 % 1000));
+    }
+}
+
+TEST_CASE("TimestampFormatter::now follows the system clock and never goes back", "[TimestampFormatter]") {
+    const auto system = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::int64_t previous = TimestampFormatter::now();
+    REQUIRE(previous - system < kSecond);
+    REQUIRE(system - previous < kSecond);
+
+    for (int idx = 0; idx < 100000; ++idx) {
+        const std::int64_t next = TimestampFormatter::now();
+        REQUIRE(next >= previous);
+        previous = next;
+    }
+}
+
+namespace {
+    std::int64_t gSystemNs = 0;   // what the WallClock under test reads as system_clock
+    std::int64_t fakeSystemNs() { return gSystemNs; }
+}
+
+TEST_CASE("TimestampFormatter::WallClock re-syncs in both directions", "[TimestampFormatter]") {
+    constexpr std::int64_t kMinute = 60 * kSecond;
+    TimestampFormatter::WallClock clock(kSample, 0);
+    REQUIRE(clock.read(kMinute - 1000, &fakeSystemNs) == kSample + kMinute - 1000);
+
+    // NTP nudged the system clock 5 ms back: held until steady time catches up.
+    gSystemNs = kSample + kMinute - 5000000;
+    REQUIRE(clock.read(kMinute, &fakeSystemNs) == kSample + kMinute - 1000);
+    REQUIRE(clock.read(kMinute + 1000000, &fakeSystemNs) == kSample + kMinute - 1000);
+    REQUIRE(clock.read(kMinute + 10000000, &fakeSystemNs) == kSample + kMinute + 5000000);
+
+    // Someone set the clock an hour back: followed at the next re-sync.
+    gSystemNs = kSample + 2 * kMinute - 3600 * kSecond;
+    REQUIRE(clock.read(2 * kMinute, &fakeSystemNs) == gSystemNs);
+    REQUIRE(clock.read(2 * kMinute + kSecond, &fakeSystemNs) == gSystemNs + kSecond);
+
+    // And forward again.
+    gSystemNs = kSample + 3 * kMinute;
+    REQUIRE(clock.read(3 * kMinute, &fakeSystemNs) == gSystemNs);
+}
+
+// Run explicitly with: SensorTests "[TimestampFormatter][benchmark]"
+TEST_CASE("TimestampFormatter cost against localtime and strftime", "[.][benchmark][TimestampFormatter]") {
+    constexpr int kCalls = 1000000;
+    constexpr std::int64_t kStep = 1000000;   // 1 ms between lines: the second changes every 1000 calls
+    TimestampFormatter formatter(TimestampPrecision::MICROSECONDS, false);
+    std::size_t sink = 0;
+
+    const auto perCall = [&](auto&& render) {
+        const auto begin = std::chrono::steady_clock::now();
+        for (int idx = 0; idx < kCalls; ++idx) {
+            sink += render(kSample + idx * kStep).size();
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - begin;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / kCalls;
+    };
+
+    const double libc = perCall([](std::int64_t timeNs) { return referenceLocal(timeNs); });
+    const double cached = perCall([&](std::int64_t timeNs) { return format(formatter, timeNs); });
+    const double clock = perCall([](std::int64_t) { return std::to_string(TimestampFormatter::now() & 1); });
+
+    WARN("localtime+strftime " << libc << " ns/call, cached formatter (us precision) " << cached
+         << " ns/call, now() + to_string " << clock << " ns/call");
+    REQUIRE(sink > 0);
+}
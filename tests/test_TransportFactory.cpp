@@ -3,6 +3,9 @@
 #include "ITransport.hpp"
 #include "TcpTransport.hpp"
 #include "UdpTransport.hpp"
+#include "ShmTransport.hpp"
+#include "UnixTransport.hpp"
+#include "FanoutTransport.hpp"
 
 #include <catch2/catch_all.hpp>
 #include <catch2/catch_test_macros.hpp>
@@ -56,6 +59,53 @@ TEST_CASE("TransportFactory creates UdpTransport", "[TransportFactory]") {
     REQUIRE(dynamic_cast<UdpTransport*>(transport.get()) != nullptr);
 }
 
+TEST_CASE("TransportFactory creates ShmTransport without a host", "[TransportFactory]") {
+    TransportConfig cfg;
+    cfg.kind = "shm";
+    cfg.shm.name = "/sensor_factory_test";
+
+    auto transport = TransportFactory::make(cfg);
+    REQUIRE(dynamic_cast<ShmTransport*>(transport.get()) != nullptr);
+    REQUIRE_FALSE(transport->isConnected());   // nothing is mapped before connect()
+}
+
+TEST_CASE("TransportFactory creates UnixTransport without a host", "[TransportFactory]") {
+    TransportConfig cfg;
+    cfg.kind = "unix";
+    cfg.unixSocket.path = "@sensor-factory-test";
+    cfg.unixSocket.datagram = true;
+
+    auto transport = TransportFactory::make(cfg);
+    REQUIRE(dynamic_cast<UnixTransport*>(transport.get()) != nullptr);
+    REQUIRE_FALSE(transport->isConnected());
+    REQUIRE(transport->maxMessageSize() > 0);
+}
+
+TEST_CASE("TransportFactory builds a fan-out from its sinks", "[TransportFactory]") {
+    TransportConfig primary;
+    primary.kind = "tcp";
+    primary.host = "127.0.0.1";
+    primary.port = 9000;
+    TransportConfig archive;
+    archive.kind = "udp";
+    archive.host = "127.0.0.1";
+    archive.port = 9001;
+
+    TransportConfig cfg;
+    cfg.kind = "fanout";
+    cfg.sinks.push_back({"primary", {}, primary});
+    cfg.sinks.push_back({"archive", {}, archive});
+
+    auto transport = TransportFactory::make(cfg);
+    auto* fanout = dynamic_cast<FanoutTransport*>(transport.get());
+    REQUIRE(fanout != nullptr);
+    REQUIRE(fanout->sinkCount() == 2);
+    REQUIRE(fanout->maxMessageSize() > 0);   // the UDP sink's datagram limit
+
+    cfg.sinks[1].transport = cfg;   // a fan-out inside a fan-out
+    REQUIRE_THROWS_AS(TransportFactory::make(cfg), std::runtime_error);
+}
+
 TEST_CASE("TransportFactory throws on unsupported kind", "[TransportFactory]") {
     TransportConfig cfg;
     cfg.kind = "bluetooth";
@@ -5,8 +5,12 @@
 #include <thread>
 #include <chrono>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <cstring>
 #include <sys/socket.h>
+#include <sys/time.h>
+#include <ctime>
 #include <netinet/in.h>
 #include <unistd.h>
 
@@ -338,3 +342,139 @@ TEST_CASE("UdpSocket connect fails when socket() cannot create", "[udp]") {
     REQUIRE_THROWS(client.connect());
 }
 
+TEST_CASE("UdpSocket sendBuffers gathers the pieces into one datagram", "[udp]") {
+    constexpr int testPort = 50032;
+    DummyUdpServer server(testPort);
+
+    UdpSocket client("127.0.0.1", testPort);
+    REQUIRE_NOTHROW(client.connect());
+
+    // More pieces than fit the inline iovec array, including empty ones.
+    std::vector<std::string> parts;
+    std::string expected;
+    for (int i = 0; i < 40; ++i) {
+        parts.push_back(i % 7 == 0 ? std::string() : "p" + std::to_string(i) + ";");
+        expected += parts.back();
+    }
+    std::vector<ConstBuffer> pieces(parts.begin(), parts.end());
+
+    REQUIRE(client.sendBuffers(pieces.data(), pieces.size()) == expected.size());
+    REQUIRE(server.receiveOnce() == expected);
+
+    // Then the next datagram starts fresh: the boundary was kept.
+    const ConstBuffer single[] = {ConstBuffer(std::string_view("solo"))};
+    REQUIRE(client.sendBuffers(single, 1) == 4);
+    REQUIRE(server.receiveOnce() == "solo");
+}
+
+TEST_CASE("UdpSocket sendBuffers before connect throws", "[udp]") {
+    UdpSocket client("127.0.0.1", 50033);
+    const ConstBuffer piece(std::string_view("x"));
+    REQUIRE_THROWS(client.sendBuffers(&piece, 1));
+}
+
+TEST_CASE("UdpSocket sendBurst delivers every datagram in order", "[udp]") {
+    constexpr int testPort = 50034;
+    DummyUdpServer server(testPort);
+
+    UdpSocket client("127.0.0.1", testPort);
+    REQUIRE_NOTHROW(client.connect());
+
+    // More than one sendmmsg() window.
+    std::vector<std::string> messages;
+    for (int i = 0; i < 150; ++i) {
+        messages.push_back("dgram-" + std::to_string(i));
+    }
+    std::vector<ConstBuffer> datagrams(messages.begin(), messages.end());
+
+    REQUIRE(client.sendBurst(datagrams.data(), datagrams.size()) == datagrams.size());
+    for (const auto& expected : messages) {
+        REQUIRE(server.receiveOnce() == expected);
+    }
+    REQUIRE(client.sendBurst(nullptr, 0) == 0);
+}
+
+TEST_CASE("UdpSocket sendBurst reports a partial burst", "[udp]") {
+    constexpr int testPort = 50035;
+    DummyUdpServer server(testPort);
+
+    UdpSocket client("127.0.0.1", testPort);
+    REQUIRE_NOTHROW(client.connect());
+
+    // Larger than any UDP datagram can be: the kernel refuses it (EMSGSIZE).
+    const std::string tooBig(70000, 'X');
+    const std::string first = "first";
+    const std::string second = "second";
+    const std::string after = "after";
+    const ConstBuffer burst[] = {first, second, tooBig, after};
+
+    REQUIRE(client.sendBurst(burst, 4) == 2);
+    REQUIRE(server.receiveOnce() == "first");
+    REQUIRE(server.receiveOnce() == "second");
+
+    // Resuming at the failed datagram surfaces its error.
+    REQUIRE_THROWS(client.sendBurst(&burst[2], 2));
+    REQUIRE_THROWS(UdpSocket("127.0.0.1", testPort).sendBurst(burst, 4));
+}
+
+// Run explicitly with: SensorTests "[benchmark]"
+TEST_CASE("UdpSocket sendBurst throughput against a loopback receiver", "[.][benchmark]") {
+    constexpr int testPort = 50036;
+    constexpr std::size_t kDatagrams = 200000;
+    constexpr std::size_t kBurst = 64;
+
+    // Receiver with a large buffer, drained on its own thread.
+    const int rx = ::socket(AF_INET, SOCK_DGRAM, 0);
+    int rcvbuf = 8 * 1024 * 1024;
+    ::setsockopt(rx, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    timeval timeout{0, 200000};
+    ::setsockopt(rx, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(testPort);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    REQUIRE(::bind(rx, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+
+    const std::string payload(200, 'p');   // a typical small batch / sample
+    std::vector<ConstBuffer> burst(kBurst, ConstBuffer(payload));
+
+    UdpSocket client("127.0.0.1", testPort);
+    client.connect();
+
+    auto threadCpu = [] {
+        timespec now{};
+        ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+    };
+
+    for (const bool useBurst : {false, true}) {
+        std::size_t received = 0;
+        std::thread receiver([&] {
+            char buffer[2048];
+            while (::recv(rx, buffer, sizeof(buffer), 0) >= 0) {
+                ++received;
+            }
+        });
+
+        const double cpuBegin = threadCpu();
+        const auto wallBegin = std::chrono::steady_clock::now();
+        std::size_t sent = 0;
+        while (sent < kDatagrams) {
+            if (useBurst) {
+                sent += client.sendBurst(burst.data(), burst.size());
+            } else {
+                sent += client.sendString(payload) > 0 ? 1 : 0;
+            }
+        }
+        const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallBegin).count();
+        const double cpu = threadCpu() - cpuBegin;
+        receiver.join();   // returns once the socket stays quiet for 200 ms
+
+        WARN((useBurst ? "sendmmsg x64: " : "send:         ")
+             << static_cast<double>(sent) / wall << " datagrams/s, "
+             << cpu * 1e9 / static_cast<double>(sent) << " ns CPU/datagram, "
+             << received << "/" << sent << " received");
+        REQUIRE(sent >= kDatagrams);
+    }
+    ::close(rx);
+}
@@ -0,0 +1,286 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include "ConfigTypes.hpp"
+#include "ConstBuffer.hpp"
+#include "TcpTransport.hpp"
+#include "UnixSocket.hpp"
+#include "UnixTransport.hpp"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace Catch::Matchers;
+
+namespace {
+
+    // Bound (and for streams listening) Unix socket the tests receive on.
+    struct UnixListener {
+        int fd{-1};
+        std::string path;   // as configured: "@name" or a file path
+
+        UnixListener(std::string address, int type) : path(std::move(address)) {
+            fd = ::socket(AF_UNIX, type, 0);
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            socklen_t len = 0;
+            if (path.front() == '@') {
+                std::memcpy(addr.sun_path + 1, path.data() + 1, path.size() - 1);
+                len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size());
+            } else {
+                ::unlink(path.c_str());
+                std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+                len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size() + 1);
+            }
+            REQUIRE(::bind(fd, reinterpret_cast<sockaddr*>(&addr), len) == 0);
+            if (type == SOCK_STREAM) {
+                REQUIRE(::listen(fd, 1) == 0);
+            }
+        }
+        ~UnixListener() {
+            ::close(fd);
+            if (path.front() != '@') {
+                ::unlink(path.c_str());
+            }
+        }
+    };
+
+    std::string uniqueName(const std::string& base) {
+        return base + "-" + std::to_string(::getpid());
+    }
+
+    UnixOptions optionsFor(const std::string& path, bool datagram = false) {
+        UnixOptions options;
+        options.path = path;
+        options.datagram = datagram;
+        return options;
+    }
+
+    std::string receiveAll(int fd) {
+        std::string received;
+        char buffer[4096];
+        ssize_t got = 0;
+        while ((got = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            received.append(buffer, static_cast<std::size_t>(got));
+        }
+        return received;
+    }
+}
+
+TEST_CASE("UnixSocket streams gathered pieces to a socket file", "[UnixSocket]") {
+    UnixListener listener("/tmp/" + uniqueName("sensor-unix-stream") + ".sock", SOCK_STREAM);
+
+    UnixSocket client(optionsFor(listener.path));
+    REQUIRE_FALSE(client.isConnected());
+    client.connect();
+    REQUIRE(client.isConnected());
+    const int peer = ::accept(listener.fd, nullptr, nullptr);
+    REQUIRE(peer >= 0);
+
+    const ConstBuffer pieces[] = {ConstBuffer(std::string_view("{\"temp\":")), ConstBuffer(std::string_view("")),
+                                  ConstBuffer(std::string_view("21.5}\n"))};
+    REQUIRE(client.sendBuffers(pieces, 3) == 14);
+    REQUIRE(client.sendString("{\"temp\":22}\n") == 12);
+    client.close();
+
+    REQUIRE(receiveAll(peer) == "{\"temp\":21.5}\n{\"temp\":22}\n");
+    ::close(peer);
+}
+
+TEST_CASE("UnixSocket sends one datagram per message to an abstract address", "[UnixSocket]") {
+    UnixListener listener("@" + uniqueName("sensor-unix-dgram"), SOCK_DGRAM);
+
+    UnixTransport transport(optionsFor(listener.path, true));
+    transport.connect();
+    REQUIRE(transport.maxMessageSize() > 0);
+
+    const ConstBuffer pieces[] = {ConstBuffer(std::string_view("he")), ConstBuffer(std::string_view("llo"))};
+    REQUIRE(transport.sendBuffers(pieces, 2) == 5);
+    REQUIRE(transport.sendString("world") == 5);
+
+    char buffer[64];
+    REQUIRE(::recv(listener.fd, buffer, sizeof(buffer), 0) == 5);
+    REQUIRE(std::string(buffer, 5) == "hello");
+    REQUIRE(::recv(listener.fd, buffer, sizeof(buffer), 0) == 5);
+    REQUIRE(std::string(buffer, 5) == "world");
+}
+
+TEST_CASE("UnixSocket passes its credentials with the first message", "[UnixSocket]") {
+    UnixListener listener("@" + uniqueName("sensor-unix-creds"), SOCK_STREAM);
+
+    UnixOptions options = optionsFor(listener.path);
+    options.sendCredentials = true;
+    options.peerUid = static_cast<std::uint32_t>(::geteuid());
+    UnixSocket client(options);
+    client.connect();
+    const int peer = ::accept(listener.fd, nullptr, nullptr);
+    const int on = 1;
+    REQUIRE(::setsockopt(peer, SOL_SOCKET, SO_PASSCRED, &on, sizeof(on)) == 0);
+    client.sendString("hello");
+
+    char data[16];
+    iovec iov{data, sizeof(data)};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(ucred))];
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    REQUIRE(::recvmsg(peer, &msg, 0) == 5);
+
+    const cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    REQUIRE(cmsg != nullptr);
+    REQUIRE(cmsg->cmsg_type == SCM_CREDENTIALS);
+    ucred creds{};
+    std::memcpy(&creds, CMSG_DATA(cmsg), sizeof(creds));
+    REQUIRE(creds.pid == ::getpid());
+    REQUIRE(creds.uid == ::geteuid());
+    ::close(peer);
+}
+
+TEST_CASE("UnixSocket refuses a collector running as another user", "[UnixSocket]") {
+    UnixListener listener("@" + uniqueName("sensor-unix-peer"), SOCK_STREAM);
+
+    UnixOptions options = optionsFor(listener.path);
+    options.peerUid = static_cast<std::uint32_t>(::geteuid()) + 1;
+    UnixSocket client(options);
+    REQUIRE_THROWS_WITH(client.connect(), ContainsSubstring("collector runs as uid"));
+    REQUIRE_FALSE(client.isConnected());
+}
+
+TEST_CASE("UnixSocket reports missing collectors and bad paths", "[UnixSocket]") {
+    UnixSocket missing(optionsFor("/tmp/" + uniqueName("sensor-unix-missing") + ".sock"));
+    REQUIRE_THROWS_AS(missing.connect(), std::runtime_error);
+    REQUIRE_THROWS_AS(missing.sendString("x"), std::runtime_error);
+
+    REQUIRE_THROWS_AS(UnixSocket(optionsFor("")), std::invalid_argument);
+    REQUIRE_THROWS_AS(UnixSocket(optionsFor(std::string(200, 'p'))), std::invalid_argument);
+}
+
+// Run explicitly with: SensorTests "[UnixSocket][benchmark]"
+TEST_CASE("UnixTransport throughput, latency and CPU against TCP loopback", "[.][benchmark][UnixSocket]") {
+    constexpr std::size_t kMessageSize = 200;      // a typical JSON sample
+    constexpr std::size_t kThroughputMessages = 500000;
+    constexpr std::size_t kLatencyMessages = 20000;
+    constexpr std::uint16_t kTcpPort = 50042;
+
+    const auto nowNs = [] {
+        return static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    };
+    const auto threadCpu = [] {
+        timespec now{};
+        ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+    };
+
+    // Reads fixed-size messages off 'fd' (stream or datagram) and records their latency.
+    const auto receiveAll = [&](int fd, std::size_t count, std::vector<std::int64_t>& latencies) {
+        std::vector<char> buffer(64 * 1024);
+        std::size_t have = 0;
+        for (std::size_t received = 0; received < count;) {
+            const ssize_t got = ::recv(fd, buffer.data() + have, buffer.size() - have, 0);
+            if (got <= 0) {
+                return;
+            }
+            have += static_cast<std::size_t>(got);
+            std::size_t offset = 0;
+            for (; have - offset >= kMessageSize; offset += kMessageSize, ++received) {
+                std::int64_t sent = 0;
+                std::memcpy(&sent, buffer.data() + offset, sizeof(sent));
+                latencies.push_back(nowNs() - sent);
+            }
+            std::memmove(buffer.data(), buffer.data() + offset, have - offset);
+            have -= offset;
+        }
+    };
+
+    // Throughput run, then a paced latency run, over one connected transport.
+    const auto measure = [&](const char* label, ITransport& transport, int receiverFd) {
+        std::string message(kMessageSize, 'm');
+        for (const bool paced : {false, true}) {
+            const std::size_t count = paced ? kLatencyMessages : kThroughputMessages;
+            std::vector<std::int64_t> latencies;
+            latencies.reserve(count);
+            std::thread receiver([&] { receiveAll(receiverFd, count, latencies); });
+
+            const double cpuBegin = threadCpu();
+            const auto begin = std::chrono::steady_clock::now();
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                const std::int64_t sent = nowNs();
+                std::memcpy(message.data(), &sent, sizeof(sent));
+                transport.sendString(message);
+                if (paced) {
+                    const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(20);
+                    while (std::chrono::steady_clock::now() < until) {
+                    }
+                }
+            }
+            const double cpu = threadCpu() - cpuBegin;
+            receiver.join();
+            const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            if (paced) {
+                std::sort(latencies.begin(), latencies.end());
+                WARN(label << "latency p50 " << static_cast<double>(latencies[latencies.size() / 2]) / 1000.0
+                     << " us, p99 " << static_cast<double>(latencies[latencies.size() * 99 / 100]) / 1000.0 << " us");
+            } else {
+                WARN(label << static_cast<double>(count) / wall << " msgs/s, "
+                     << cpu * 1e9 / static_cast<double>(count) << " ns sender CPU/msg");
+            }
+            REQUIRE(latencies.size() == count);
+        }
+    };
+
+    {
+        UnixListener listener("@" + uniqueName("sensor-bench-stream"), SOCK_STREAM);
+        UnixTransport transport(optionsFor(listener.path));
+        transport.connect();
+        const int peer = ::accept(listener.fd, nullptr, nullptr);
+        measure("unix stream:  ", transport, peer);
+        transport.close();
+        ::close(peer);
+    }
+    {
+        UnixListener listener("@" + uniqueName("sensor-bench-dgram"), SOCK_DGRAM);
+        int rcvbuf = 8 * 1024 * 1024;
+        ::setsockopt(listener.fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        UnixTransport transport(optionsFor(listener.path, true));
+        transport.connect();
+        measure("unix dgram:   ", transport, listener.fd);
+    }
+    {
+        const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(kTcpPort);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        REQUIRE(::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+        REQUIRE(::listen(listener, 1) == 0);
+        TcpTransport transport("127.0.0.1", kTcpPort);
+        transport.connect();
+        const int peer = ::accept(listener, nullptr, nullptr);
+        measure("tcp loopback: ", transport, peer);
+        transport.close();
+        ::close(peer);
+        ::close(listener);
+    }
+}